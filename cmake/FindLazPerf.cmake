@@ -4,6 +4,10 @@
 #
 #  LazPerf_FOUND - system has the zip library
 #  LazPerf_INCLUDE_DIRS - the zip include directories
+#  LazPerf_CHUNK_DECOMPRESSOR_FOUND - system has the laz-perf (3.0+) library with the chunk
+#                                     decompressor, required for LAS 1.4 point formats (COPC)
+#  LazPerf_CHUNK_INCLUDE_DIR - the include directory of this library
+#  LazPerf_LIBRARY - the laz-perf library
 #
 # Copyright (c) 2020, Peter Petrik, <zilolv@gmail.com>
 #
@@ -27,3 +31,26 @@ MARK_AS_ADVANCED(LazPerf_INCLUDE_DIR)
 IF (LazPerf_FOUND)
   MESSAGE(STATUS "Found laz-perf: ${LazPerf_INCLUDE_DIR}")
 ENDIF (LazPerf_FOUND)
+
+FIND_PATH(LazPerf_CHUNK_INCLUDE_DIR
+  lazperf/readers.hpp
+  "$ENV{LIB_DIR}/include"
+  "$ENV{INCLUDE}"
+  /usr/local/include
+  /usr/include
+)
+
+FIND_LIBRARY(LazPerf_LIBRARY
+  NAMES lazperf
+  PATHS
+  "$ENV{LIB_DIR}/lib"
+  /usr/local/lib
+  /usr/lib
+)
+
+MARK_AS_ADVANCED(LazPerf_CHUNK_INCLUDE_DIR LazPerf_LIBRARY)
+
+IF (LazPerf_CHUNK_INCLUDE_DIR AND LazPerf_LIBRARY)
+  SET(LazPerf_CHUNK_DECOMPRESSOR_FOUND TRUE)
+  MESSAGE(STATUS "Found laz-perf chunk decompressor: ${LazPerf_LIBRARY}")
+ENDIF (LazPerf_CHUNK_INCLUDE_DIR AND LazPerf_LIBRARY)
@@ -239,6 +239,8 @@ QgsPointCloudBlock *QgsPointCloud3DSymbolHandler::pointCloudBlock( QgsPointCloud
     bool loopAborted = false;
     QEventLoop loop;
     QgsPointCloudBlockRequest *req = pc->asyncNodeData( n, request );
+    if ( !req )
+      return nullptr;
     QObject::connect( req, &QgsPointCloudBlockRequest::finished, &loop, &QEventLoop::quit );
     QObject::connect( context.feedback(), &QgsFeedback::canceled, &loop, [ & ]()
     {
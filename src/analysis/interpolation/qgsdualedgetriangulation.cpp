@@ -3309,6 +3309,29 @@ QgsMesh QgsDualEdgeTriangulation::triangulationToMesh( QgsFeedback *feedback ) c
   return mesh;
 }
 
+QVector<int> QgsDualEdgeTriangulation::triangleIndexes() const
+{
+  QVector<int> indexes;
+  indexes.reserve( mHalfEdge.count() );
+  for ( int edge = 0; edge < mHalfEdge.count(); ++edge )
+  {
+    // each triangle is visited from its three half edges, keep it only from the one with the smallest index
+    const int nextEdge = mHalfEdge.at( edge )->getNext();
+    const int lastEdge = nextEdge >= 0 ? mHalfEdge.at( nextEdge )->getNext() : -1;
+    if ( nextEdge <= edge || lastEdge <= edge || mHalfEdge.at( lastEdge )->getNext() != edge )
+      continue;
+
+    const int point1 = mHalfEdge.at( edge )->getPoint();
+    const int point2 = mHalfEdge.at( nextEdge )->getPoint();
+    const int point3 = mHalfEdge.at( lastEdge )->getPoint();
+    if ( point1 < 0 || point2 < 0 || point3 < 0 )
+      continue;
+
+    indexes << point1 << point2 << point3;
+  }
+  return indexes;
+}
+
 double QgsDualEdgeTriangulation::swapMinAngle( int edge ) const
 {
   QgsPoint *p1 = point( mHalfEdge[edge]->getPoint() );
@@ -97,6 +97,16 @@ class ANALYSIS_EXPORT QgsDualEdgeTriangulation: public QgsTriangulation
 
     virtual QgsMesh triangulationToMesh( QgsFeedback *feedback = nullptr ) const override;
 
+    /**
+     * Returns the triangles inside of the convex hull, as the indexes of their three points
+     * one triangle after the other.
+     *
+     * Unlike triangulationToMesh(), the points are not copied.
+     *
+     * \since QGIS 3.22
+     */
+    QVector<int> triangleIndexes() const;
+
   private:
     //! X-coordinate of the upper right corner of the bounding box
     double mXMax = 0;
@@ -21,6 +21,20 @@
 #include "qgsfeedback.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Rows interpolated at once by each thread
+static constexpr int ROWS_PER_THREAD = 4;
+
+///@endcond
 
 QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputPath, const QgsRectangle &extent, int nCols, int nRows )
   : mInterpolator( i )
@@ -54,36 +68,73 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   outStream.setRealNumberPrecision( 8 );
   writeHeader( outStream );
 
-  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0; //calculate value in the center of the cell
-  double currentXValue;
-  double interpolatedValue;
+  // the cell centers are accumulated from the center of the first cell, so that the output is the same as it always was
+  QVector< double > xCenters( mNumColumns );
+  double currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0;
+  for ( double &x : xCenters )
+  {
+    x = currentXValue;
+    currentXValue += mCellSizeX;
+  }
+  QVector< double > yCenters( mNumRows );
+  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0;
+  for ( double &y : yCenters )
+  {
+    y = currentYValue;
+    currentYValue -= mCellSizeY;
+  }
 
-  for ( int i = 0; i < mNumRows; ++i )
+  // the first row is always interpolated alone, which caches the base data of the interpolator
+  const int threadCount = std::max( 1, QThread::idealThreadCount() );
+  std::vector< double > values;
+  std::vector< int > rowOffsets;
+  for ( int i = 0; i < mNumRows; i += static_cast< int >( rowOffsets.size() ) )
   {
-    currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
-    for ( int j = 0; j < mNumColumns; ++j )
+    const int batchSize = i == 0 ? 1 : std::min( threadCount * ROWS_PER_THREAD, mNumRows - i );
+    values.resize( static_cast< std::size_t >( batchSize ) * mNumColumns );
+    rowOffsets.resize( batchSize );
+    std::iota( rowOffsets.begin(), rowOffsets.end(), 0 );
+
+    if ( batchSize > 1 && threadCount > 1 && mInterpolator->isThreadSafe() )
     {
-      if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
+      QtConcurrent::blockingMap( rowOffsets, [this, &values, &xCenters, &yCenters, i, feedback]( int &rowOffset )
       {
-        outStream << interpolatedValue << ' ';
-      }
-      else
+        mInterpolator->interpolateRows( xCenters, yCenters.mid( i + rowOffset, 1 ),
+                                        values.data() + static_cast< std::size_t >( rowOffset ) * mNumColumns, feedback );
+      } );
+    }
+    else
+    {
+      // the interpolator may still fill the rows in parallel by itself
+      mInterpolator->interpolateRows( xCenters, yCenters.mid( i, batchSize ), values.data(), feedback );
+    }
+
+    if ( feedback && feedback->isCanceled() )
+    {
+      outputFile.remove();
+      return 3;
+    }
+
+    for ( int rowOffset = 0; rowOffset < batchSize; ++rowOffset )
+    {
+      const double *rowValues = values.data() + static_cast< std::size_t >( rowOffset ) * mNumColumns;
+      for ( int j = 0; j < mNumColumns; ++j )
       {
-        outStream << "-9999 ";
+        if ( !std::isnan( rowValues[j] ) )
+        {
+          outStream << rowValues[j] << ' ';
+        }
+        else
+        {
+          outStream << "-9999 ";
+        }
       }
-      currentXValue += mCellSizeX;
+      outStream << endl;
     }
-    outStream << endl;
-    currentYValue -= mCellSizeY;
 
     if ( feedback )
     {
-      if ( feedback->isCanceled() )
-      {
-        outputFile.remove();
-        return 3;
-      }
-      feedback->setProgress( 100.0 * i / static_cast< double >( mNumRows ) );
+      feedback->setProgress( 100.0 * ( i + batchSize - 1 ) / static_cast< double >( mNumRows ) );
     }
   }
 
@@ -17,34 +17,151 @@
 
 #include "qgsidwinterpolator.h"
 #include "qgis.h"
+#include "qgsrectangle.h"
+#include "kdbush.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
+
+///@cond PRIVATE
+
+//! Base data vertex stored in the spatial index
+struct QgsIDWVertex
+{
+  QgsIDWVertex( double x, double y, double z )
+    : coords( x, y )
+    , z( z )
+  {}
+
+  std::pair< double, double > coords;
+  double z = 0;
+};
+
+//! KD-tree of the base data vertices
+class QgsIDWVertexIndex : public kdbush::KDBush< std::pair< double, double >, QgsIDWVertex, std::size_t >
+{
+  public:
+
+    explicit QgsIDWVertexIndex( const QVector<QgsInterpolatorVertexData> &vertices )
+    {
+      points.reserve( vertices.size() );
+      for ( const QgsInterpolatorVertexData &vertex : vertices )
+      {
+        points.emplace_back( vertex.x, vertex.y, vertex.z );
+        extent.combineExtentWith( vertex.x, vertex.y );
+      }
+
+      if ( !points.empty() )
+        sortKD( 0, points.size() - 1, 0 );
+    }
+
+    std::size_t size() const
+    {
+      return points.size();
+    }
+
+    //! Extent of the vertices
+    QgsRectangle extent;
+};
+
+///@endcond
 
 QgsIDWInterpolator::QgsIDWInterpolator( const QList<LayerData> &layerData )
   : QgsInterpolator( layerData )
 {}
 
+QgsIDWInterpolator::~QgsIDWInterpolator() = default;
+
 int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
 {
   if ( !mDataIsCached )
   {
     cacheBaseData( feedback );
+    mIndex.reset();
   }
 
   double sumCounter = 0;
   double sumDenominator = 0;
 
-  for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+  if ( mMaximumNeighbors <= 0 && mSearchRadius <= 0 )
   {
-    double distance = std::sqrt( ( vertex.x - x ) * ( vertex.x - x ) + ( vertex.y - y ) * ( vertex.y - y ) );
-    if ( qgsDoubleNear( distance, 0.0 ) )
+    for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+    {
+      double distance = std::sqrt( ( vertex.x - x ) * ( vertex.x - x ) + ( vertex.y - y ) * ( vertex.y - y ) );
+      if ( qgsDoubleNear( distance, 0.0 ) )
+      {
+        result = vertex.z;
+        return 0;
+      }
+      double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+      sumCounter += ( currentWeight * vertex.z );
+      sumDenominator += currentWeight;
+    }
+  }
+  else
+  {
+    if ( !mIndex )
+      mIndex = std::make_unique< QgsIDWVertexIndex >( mCachedBaseData );
+    if ( mIndex->size() == 0 || !std::isfinite( x ) || !std::isfinite( y ) )
+      return 1;
+
+    // squared distance and value of the neighbors
+    std::vector< std::pair< double, double > > neighbors;
+    auto addNeighbor = [&neighbors, x, y]( const QgsIDWVertex & vertex )
+    {
+      const double dx = vertex.coords.first - x;
+      const double dy = vertex.coords.second - y;
+      neighbors.emplace_back( dx * dx + dy * dy, vertex.z );
+    };
+
+    const std::size_t maximumNeighbors = mMaximumNeighbors > 0 ? static_cast< std::size_t >( mMaximumNeighbors ) : 0;
+    if ( mSearchRadius > 0 )
+    {
+      mIndex->within( x, y, mSearchRadius, addNeighbor );
+    }
+    else
+    {
+      // search within a radius which should contain the wanted count of points if they are evenly distributed,
+      // and double it until enough points are found. Vertices which cannot be found, such as vertices with
+      // NaN coordinates, may be missing once the radius reaches the farthest corner of the extent.
+      const std::size_t wanted = std::min( maximumNeighbors, mIndex->size() );
+      const QgsRectangle &extent = mIndex->extent;
+      const double area = extent.width() * extent.height();
+      double radius = area > 0 ? std::sqrt( wanted * area / ( mIndex->size() * M_PI ) ) : std::max( extent.width(), extent.height() );
+      const double distanceToExtent = std::sqrt( std::pow( std::max( { extent.xMinimum() - x, 0.0, x - extent.xMaximum() } ), 2 )
+                                      + std::pow( std::max( { extent.yMinimum() - y, 0.0, y - extent.yMaximum() } ), 2 ) );
+      radius = std::max( radius + distanceToExtent, std::numeric_limits< double >::min() );
+      const double distanceToFarthestCorner = std::sqrt( std::pow( std::max( x - extent.xMinimum(), extent.xMaximum() - x ), 2 )
+                                              + std::pow( std::max( y - extent.yMinimum(), extent.yMaximum() - y ), 2 ) );
+      while ( true )
+      {
+        neighbors.clear();
+        mIndex->within( x, y, radius, addNeighbor );
+        if ( neighbors.size() >= wanted || radius >= distanceToFarthestCorner || !std::isfinite( radius ) )
+          break;
+        radius *= 2;
+      }
+    }
+
+    if ( maximumNeighbors > 0 && neighbors.size() > maximumNeighbors )
+    {
+      std::nth_element( neighbors.begin(), neighbors.begin() + maximumNeighbors, neighbors.end() );
+      neighbors.resize( maximumNeighbors );
+    }
+
+    for ( const std::pair< double, double > &neighbor : neighbors )
     {
-      result = vertex.z;
-      return 0;
+      double distance = std::sqrt( neighbor.first );
+      if ( qgsDoubleNear( distance, 0.0 ) )
+      {
+        result = neighbor.second;
+        return 0;
+      }
+      double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+      sumCounter += ( currentWeight * neighbor.second );
+      sumDenominator += currentWeight;
     }
-    double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
-    sumCounter += ( currentWeight * vertex.z );
-    sumDenominator += currentWeight;
   }
 
   if ( sumDenominator == 0.0 )
@@ -21,6 +21,10 @@
 #include "qgsinterpolator.h"
 #include "qgis_analysis.h"
 
+#include <memory>
+
+class QgsIDWVertexIndex;
+
 /**
  * \ingroup analysis
  * \class QgsIDWInterpolator
@@ -35,7 +39,10 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
      */
     QgsIDWInterpolator( const QList<QgsInterpolator::LayerData> &layerData );
 
+    ~QgsIDWInterpolator() override;
+
     int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) override;
+    bool isThreadSafe() const override { return true; }
 
     /**
      * Sets the distance \a coefficient, the parameter that sets how the values are
@@ -60,11 +67,60 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
     */
     double distanceCoefficient() const { return mDistanceCoefficient; }
 
+    /**
+     * Sets the maximum \a count of points used to interpolate each point: only the nearest points
+     * are used. A \a count of 0 (the default) uses all the points.
+     *
+     * Limiting the count of points or the search radius allows the interpolation to only
+     * visit the nearby points through a spatial index, instead of all the points.
+     *
+     * \see maximumNeighbors()
+     * \see setSearchRadius()
+     * \since QGIS 3.22
+     */
+    void setMaximumNeighbors( int count ) { mMaximumNeighbors = count; }
+
+    /**
+     * Returns the maximum count of points used to interpolate each point, or 0 if all the points are used.
+     *
+     * \see setMaximumNeighbors()
+     * \since QGIS 3.22
+     */
+    int maximumNeighbors() const { return mMaximumNeighbors; }
+
+    /**
+     * Sets the search \a radius: only the points within this distance of an interpolated point are used
+     * to interpolate it, and points without any such point have no value. A \a radius of 0 (the default)
+     * uses points at any distance.
+     *
+     * \see searchRadius()
+     * \see setMaximumNeighbors()
+     * \since QGIS 3.22
+     */
+    void setSearchRadius( double radius ) { mSearchRadius = radius; }
+
+    /**
+     * Returns the search radius, or 0 if points at any distance are used.
+     *
+     * \see setSearchRadius()
+     * \since QGIS 3.22
+     */
+    double searchRadius() const { return mSearchRadius; }
+
   private:
 
     QgsIDWInterpolator() = delete;
 
+#ifdef SIP_RUN
+    QgsIDWInterpolator( const QgsIDWInterpolator &other );
+#endif
+
     double mDistanceCoefficient = 2.0;
+    int mMaximumNeighbors = 0;
+    double mSearchRadius = 0;
+
+    //! Spatial index of the cached base data, only built when the neighbors are limited
+    std::unique_ptr< QgsIDWVertexIndex > mIndex;
 };
 
 #endif
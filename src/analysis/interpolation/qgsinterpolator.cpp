@@ -22,12 +22,32 @@
 #include "qgsgeometry.h"
 #include "qgsfeedback.h"
 
+#include <limits>
+
 QgsInterpolator::QgsInterpolator( const QList<LayerData> &layerData )
   : mLayerData( layerData )
 {
 
 }
 
+bool QgsInterpolator::interpolateRows( const QVector< double > &xCenters, const QVector< double > &yCenters, double *values, QgsFeedback *feedback )
+{
+  const int columns = xCenters.size();
+  for ( int i = 0; i < yCenters.size(); ++i )
+  {
+    double *rowValues = values + static_cast< std::size_t >( i ) * columns;
+    for ( int j = 0; j < columns; ++j )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return false;
+
+      if ( interpolatePoint( xCenters.at( j ), yCenters.at( i ), rowValues[j], feedback ) != 0 )
+        rowValues[j] = std::numeric_limits< double >::quiet_NaN();
+    }
+  }
+  return true;
+}
+
 QgsInterpolator::Result QgsInterpolator::cacheBaseData( QgsFeedback *feedback )
 {
   if ( mLayerData.empty() )
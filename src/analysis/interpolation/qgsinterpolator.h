@@ -134,6 +134,32 @@ class ANALYSIS_EXPORT QgsInterpolator
      */
     virtual int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback = nullptr ) = 0;
 
+    /**
+     * Returns TRUE if interpolatePoint() can be called from several threads at the same time,
+     * once a first point has been interpolated (which caches the base data).
+     *
+     * The default implementation returns FALSE.
+     *
+     * \since QGIS 3.22
+     */
+    virtual bool isThreadSafe() const { return false; }
+
+    /**
+     * Interpolates the values at the centers of the cells of a block of rows of a grid.
+     *
+     * \a xCenters holds the x coordinates of the centers of the columns, in increasing order, and \a yCenters the
+     * y coordinates of the centers of the rows, in decreasing order. The values are stored one row after the other
+     * in \a values, which must have room for a value per cell. The cells which could not be interpolated are set to NaN.
+     *
+     * The default implementation calls interpolatePoint() for each cell, interpolators may implement a faster
+     * way to fill whole rows.
+     *
+     * \returns FALSE if the interpolation was canceled
+     * \note not available in Python bindings
+     * \since QGIS 3.22
+     */
+    virtual bool interpolateRows( const QVector< double > &xCenters, const QVector< double > &yCenters, double *values, QgsFeedback *feedback = nullptr ) SIP_SKIP;
+
     //! \note not available in Python bindings
     QList<LayerData> layerData() const { return mLayerData; } SIP_SKIP
 
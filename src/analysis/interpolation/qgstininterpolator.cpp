@@ -31,6 +31,56 @@
 #include "qgsmulticurve.h"
 #include "qgscurvepolygon.h"
 #include "qgsmultisurface.h"
+#include "qgsrectangle.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+///@cond PRIVATE
+
+//! Size of the side of the grid covered by the Hilbert curve ordering the points to insert
+static constexpr quint32 HILBERT_GRID_SIZE = 1 << 16;
+
+//! Row bands rasterized at once by each thread
+static constexpr int ROW_BANDS_PER_THREAD = 4;
+
+//! Returns the index of the cell ( \a x, \a y ) along a Hilbert curve covering a grid of HILBERT_GRID_SIZE by HILBERT_GRID_SIZE cells
+static quint64 hilbertIndex( quint32 x, quint32 y )
+{
+  quint64 index = 0;
+  for ( quint32 s = HILBERT_GRID_SIZE / 2; s > 0; s /= 2 )
+  {
+    const quint32 rx = ( x & s ) > 0 ? 1 : 0;
+    const quint32 ry = ( y & s ) > 0 ? 1 : 0;
+    index += static_cast< quint64 >( s ) * s * ( ( 3 * rx ) ^ ry );
+
+    // rotate the quadrant
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        x = HILBERT_GRID_SIZE - 1 - x;
+        y = HILBERT_GRID_SIZE - 1 - y;
+      }
+      std::swap( x, y );
+    }
+  }
+  return index;
+}
+
+//! Rows of a grid rasterized by a thread
+struct TinRowBand
+{
+  int firstRow = 0;
+  int rowCount = 0;
+};
+
+///@endcond
 
 QgsTinInterpolator::QgsTinInterpolator( const QList<LayerData> &inputData, TinInterpolation interpolation, QgsFeedback *feedback )
   : QgsInterpolator( inputData )
@@ -143,6 +193,8 @@ void QgsTinInterpolator::initialize()
     }
   }
 
+  insertPoints();
+
   if ( mInterpolation == CloughTocher )
   {
     CloughTocherInterpolator *ctInterpolator = new CloughTocherInterpolator();
@@ -311,6 +363,9 @@ int QgsTinInterpolator::insertData( const QgsFeature &f, QgsInterpolator::ValueS
                   break;
               }
             }
+            // the points read so far must be in the triangulation before the line is forced into it
+            if ( insertPoints() != 0 )
+              return -1;
             mTriangulation->addLine( linePoints, type );
           }
           break;
@@ -348,10 +403,231 @@ int QgsTinInterpolator::addPointsFromGeometry( const QgsGeometry &g, ValueSource
         z = p.m();
         break;
     }
-    if ( mTriangulation->addPoint( QgsPoint( p.x(), p.y(), z ) ) == -100 )
+    mPointsToInsert << QgsPoint( p.x(), p.y(), z );
+  }
+  return 0;
+}
+
+int QgsTinInterpolator::insertPoints()
+{
+  if ( mPointsToInsert.isEmpty() )
+    return 0;
+
+  // the triangulation locates each new point by walking from the previously inserted one,
+  // which is only fast if consecutive points are close to each other
+  QgsRectangle extent;
+  for ( const QgsPoint &point : std::as_const( mPointsToInsert ) )
+    extent.combineExtentWith( point.x(), point.y() );
+  const double width = extent.width() > 0 ? extent.width() : 1;
+  const double height = extent.height() > 0 ? extent.height() : 1;
+
+  std::vector< std::pair< quint64, int > > order;
+  order.reserve( mPointsToInsert.size() );
+  for ( int i = 0; i < mPointsToInsert.size(); ++i )
+  {
+    const QgsPoint &point = mPointsToInsert.at( i );
+    const quint32 x = static_cast< quint32 >( ( point.x() - extent.xMinimum() ) / width * ( HILBERT_GRID_SIZE - 1 ) );
+    const quint32 y = static_cast< quint32 >( ( point.y() - extent.yMinimum() ) / height * ( HILBERT_GRID_SIZE - 1 ) );
+    order.emplace_back( hilbertIndex( x, y ), i );
+  }
+  std::sort( order.begin(), order.end() );
+
+  int result = 0;
+  for ( std::size_t i = 0; i < order.size(); ++i )
+  {
+    if ( mFeedback && mFeedback->isCanceled() )
+      break;
+
+    if ( mTriangulation->addPoint( mPointsToInsert.at( order[i].second ) ) == -100 )
+    {
+      result = -1;
+    }
+  }
+
+  mPointsToInsert.clear();
+  mPointsToInsert.squeeze();
+  return result;
+}
+
+void QgsTinInterpolator::buildTriangleStrips()
+{
+  QgsDualEdgeTriangulation *triangulation = dynamic_cast< QgsDualEdgeTriangulation * >( mTriangulation );
+  if ( !triangulation )
+    return;
+
+  mTriangleIndexes = triangulation->triangleIndexes();
+  const int triangleCount = mTriangleIndexes.size() / 3;
+  if ( triangleCount == 0 )
+    return;
+
+  // about sqrt(n) strips of sqrt(n) triangles, so that most triangles only overlap one or two strips
+  const int stripCount = std::max( 1, static_cast< int >( std::sqrt( static_cast< double >( triangleCount ) ) ) );
+  const double height = triangulation->yMax() - triangulation->yMin();
+  mTriangleStripHeight = height > 0 ? height / stripCount : 1;
+  mTriangleStrips.assign( stripCount, std::vector< int >() );
+
+  for ( int triangle = 0; triangle < triangleCount; ++triangle )
+  {
+    double yMin = std::numeric_limits< double >::max();
+    double yMax = std::numeric_limits< double >::lowest();
+    for ( int k = 0; k < 3; ++k )
     {
-      return -1;
+      const double y = triangulation->point( mTriangleIndexes.at( 3 * triangle + k ) )->y();
+      yMin = std::min( yMin, y );
+      yMax = std::max( yMax, y );
     }
+
+    const int firstStrip = std::clamp( static_cast< int >( ( triangulation->yMax() - yMax ) / mTriangleStripHeight ), 0, stripCount - 1 );
+    const int lastStrip = std::clamp( static_cast< int >( ( triangulation->yMax() - yMin ) / mTriangleStripHeight ), 0, stripCount - 1 );
+    for ( int strip = firstStrip; strip <= lastStrip; ++strip )
+      mTriangleStrips[strip].push_back( triangle );
   }
-  return 0;
+}
+
+bool QgsTinInterpolator::interpolateRows( const QVector< double > &xCenters, const QVector< double > &yCenters, double *values, QgsFeedback *feedback )
+{
+  if ( mInterpolation != Linear )
+    return QgsInterpolator::interpolateRows( xCenters, yCenters, values, feedback );
+
+  const int columns = xCenters.size();
+  const int rowCount = yCenters.size();
+
+  if ( !mIsInitialized )
+  {
+    initialize();
+  }
+
+  std::fill( values, values + static_cast< std::size_t >( rowCount ) * columns, std::numeric_limits< double >::quiet_NaN() );
+
+  QgsDualEdgeTriangulation *triangulation = dynamic_cast< QgsDualEdgeTriangulation * >( mTriangulation );
+  if ( !mTriangleInterpolator || !triangulation )
+    return !feedback || !feedback->isCanceled();
+
+  if ( mTriangleStrips.empty() )
+    buildTriangleStrips();
+  if ( mTriangleStrips.empty() )
+    return !feedback || !feedback->isCanceled();
+
+  const int stripCount = static_cast< int >( mTriangleStrips.size() );
+  const double triangulationYMax = triangulation->yMax();
+  auto stripOf = [triangulationYMax, stripCount, this]( double y )
+  {
+    return static_cast< int >( std::clamp( ( triangulationYMax - y ) / mTriangleStripHeight, 0.0, stripCount - 1.0 ) );
+  };
+  // tolerance of a billionth of a cell, so that cells centered on an edge are filled by one of its triangles despite rounding
+  auto spacing = []( const QVector< double > &centers )
+  {
+    return centers.size() > 1 ? std::fabs( centers.last() - centers.first() ) / ( centers.size() - 1 ) : 0.0;
+  };
+  const double toleranceX = 1e-9 * spacing( xCenters );
+  const double toleranceY = 1e-9 * ( rowCount > 1 ? spacing( yCenters ) : spacing( xCenters ) );
+
+  // fills the cells of the band covered by a triangle, with the plane through its vertices
+  auto rasterizeTriangle = [&]( int triangle, const TinRowBand & band )
+  {
+    const QgsPoint *p1 = triangulation->point( mTriangleIndexes.at( 3 * triangle ) );
+    const QgsPoint *p2 = triangulation->point( mTriangleIndexes.at( 3 * triangle + 1 ) );
+    const QgsPoint *p3 = triangulation->point( mTriangleIndexes.at( 3 * triangle + 2 ) );
+
+    const double denominatorA = ( p1->x() - p2->x() ) * ( p2->y() - p3->y() ) - ( p2->x() - p3->x() ) * ( p1->y() - p2->y() );
+    const double denominatorB = ( p1->y() - p2->y() ) * ( p2->x() - p3->x() ) - ( p2->y() - p3->y() ) * ( p1->x() - p2->x() );
+    if ( denominatorA == 0 || denominatorB == 0 )
+      return; // degenerated triangle
+
+    const double a = ( p1->z() * ( p2->y() - p3->y() ) + p2->z() * ( p3->y() - p1->y() ) + p3->z() * ( p1->y() - p2->y() ) ) / denominatorA;
+    const double b = ( p1->z() * ( p2->x() - p3->x() ) + p2->z() * ( p3->x() - p1->x() ) + p3->z() * ( p1->x() - p2->x() ) ) / denominatorB;
+    const double c = p1->z() - a * p1->x() - b * p1->y();
+
+    const double yMin = std::min( { p1->y(), p2->y(), p3->y() } );
+    const double yMax = std::max( { p1->y(), p2->y(), p3->y() } );
+    // the rows of the band between the top and the bottom of the triangle, the y centers are decreasing
+    const auto bandBegin = yCenters.constBegin() + band.firstRow;
+    const auto bandEnd = bandBegin + band.rowCount;
+    const int rowStart = static_cast< int >( std::lower_bound( bandBegin, bandEnd, yMax + toleranceY, std::greater< double >() ) - yCenters.constBegin() );
+    const int rowEnd = static_cast< int >( std::upper_bound( bandBegin, bandEnd, yMin - toleranceY, std::greater< double >() ) - yCenters.constBegin() );
+
+    const QgsPoint *vertices[3] = { p1, p2, p3 };
+    for ( int row = rowStart; row < rowEnd; ++row )
+    {
+      const double y = yCenters.at( row );
+
+      // span of the triangle along the row
+      double xLeft = std::numeric_limits< double >::max();
+      double xRight = std::numeric_limits< double >::lowest();
+      for ( int k = 0; k < 3; ++k )
+      {
+        const QgsPoint *start = vertices[k];
+        const QgsPoint *end = vertices[( k + 1 ) % 3];
+        if ( start->y() == end->y() )
+        {
+          if ( start->y() == y )
+          {
+            xLeft = std::min( { xLeft, start->x(), end->x() } );
+            xRight = std::max( { xRight, start->x(), end->x() } );
+          }
+          continue;
+        }
+        if ( y < std::min( start->y(), end->y() ) || y > std::max( start->y(), end->y() ) )
+          continue;
+
+        const double x = start->x() + ( y - start->y() ) * ( end->x() - start->x() ) / ( end->y() - start->y() );
+        xLeft = std::min( xLeft, x );
+        xRight = std::max( xRight, x );
+      }
+      if ( xLeft > xRight )
+        continue;
+
+      const int columnStart = static_cast< int >( std::lower_bound( xCenters.constBegin(), xCenters.constEnd(), xLeft - toleranceX ) - xCenters.constBegin() );
+      const int columnEnd = static_cast< int >( std::upper_bound( xCenters.constBegin(), xCenters.constEnd(), xRight + toleranceX ) - xCenters.constBegin() );
+      double *rowValues = values + static_cast< std::size_t >( row ) * columns;
+      for ( int column = columnStart; column < columnEnd; ++column )
+      {
+        const double x = xCenters.at( column );
+        rowValues[column] = a * x + b * y + c;
+      }
+    }
+  };
+
+  auto rasterizeBand = [&]( TinRowBand & band )
+  {
+    const double bandYMax = yCenters.at( band.firstRow );
+    const double bandYMin = yCenters.at( band.firstRow + band.rowCount - 1 );
+    if ( bandYMax < triangulation->yMin() || bandYMin > triangulationYMax )
+      return;
+
+    const int firstStrip = stripOf( bandYMax );
+    const int lastStrip = stripOf( bandYMin );
+    for ( int strip = firstStrip; strip <= lastStrip; ++strip )
+    {
+      for ( int triangle : mTriangleStrips[strip] )
+      {
+        if ( feedback && feedback->isCanceled() )
+          return;
+
+        // a triangle overlapping several strips is only rasterized from the first one of the band
+        double triangleYMax = std::numeric_limits< double >::lowest();
+        for ( int k = 0; k < 3; ++k )
+          triangleYMax = std::max( triangleYMax, triangulation->point( mTriangleIndexes.at( 3 * triangle + k ) )->y() );
+        if ( std::max( stripOf( triangleYMax ), firstStrip ) != strip )
+          continue;
+
+        rasterizeTriangle( triangle, band );
+      }
+    }
+  };
+
+  const int bandCount = std::min( rowCount, std::max( 1, QThread::idealThreadCount() ) * ROW_BANDS_PER_THREAD );
+  std::vector< TinRowBand > bands( bandCount );
+  for ( int i = 0; i < bandCount; ++i )
+  {
+    bands[i].firstRow = static_cast< int >( static_cast< qint64 >( rowCount ) * i / bandCount );
+    bands[i].rowCount = static_cast< int >( static_cast< qint64 >( rowCount ) * ( i + 1 ) / bandCount ) - bands[i].firstRow;
+  }
+
+  if ( bands.size() == 1 )
+    rasterizeBand( bands.front() );
+  else
+    QtConcurrent::blockingMap( bands, rasterizeBand );
+
+  return !feedback || !feedback->isCanceled();
 }
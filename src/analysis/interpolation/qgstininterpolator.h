@@ -21,6 +21,9 @@
 #include "qgsinterpolator.h"
 #include <QString>
 #include "qgis_analysis.h"
+#include "qgspoint.h"
+
+#include <vector>
 
 class QgsFeatureSink;
 class QgsTriangulation;
@@ -55,6 +58,15 @@ class ANALYSIS_EXPORT QgsTinInterpolator: public QgsInterpolator
 
     int interpolatePoint( double x, double y, double &result SIP_OUT, QgsFeedback *feedback ) override;
 
+    /**
+     * With linear interpolation, the triangles are rasterized row band by row band in parallel,
+     * instead of locating the triangle containing each cell.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.22
+     */
+    bool interpolateRows( const QVector< double > &xCenters, const QVector< double > &yCenters, double *values, QgsFeedback *feedback = nullptr ) override SIP_SKIP;
+
     /**
      * Returns the fields output by features when saving the triangulation.
      * These fields should be used when creating
@@ -86,6 +98,25 @@ class ANALYSIS_EXPORT QgsTinInterpolator: public QgsInterpolator
     //! Type of interpolation
     TinInterpolation mInterpolation;
 
+    //! Points read from the sources, inserted together in spatial order before the next line and once all the sources are read
+    QVector< QgsPoint > mPointsToInsert;
+
+    //! Indexes of the points of the triangles, for the rasterization of the linear interpolation
+    QVector< int > mTriangleIndexes;
+    //! Triangles overlapping each horizontal strip of the triangulation extent, from the top to the bottom
+    std::vector< std::vector< int > > mTriangleStrips;
+    //! Height of the strips of mTriangleStrips
+    double mTriangleStripHeight = 0;
+
+    /**
+     * Inserts mPointsToInsert in the triangulation, ordered along a Hilbert curve so that consecutive points are close
+     * \returns 0 in case of success, -1 if some points could not be inserted because of numerical problems
+     */
+    int insertPoints();
+
+    //! Builds mTriangleIndexes and mTriangleStrips
+    void buildTriangleStrips();
+
     //! Create dual edge triangulation
     void initialize();
 
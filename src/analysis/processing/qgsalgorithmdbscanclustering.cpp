@@ -16,11 +16,37 @@
  ***************************************************************************/
 
 #include "qgsalgorithmdbscanclustering.h"
-#include "qgsspatialindexkdbush.h"
-#include <unordered_set>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+#include <QThread>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
+//! Cell of the grid the points are binned in
+struct DbscanCell
+{
+  qint64 column = 0;
+  qint64 row = 0;
+  std::size_t first = 0; //!< Position of the first point of the cell in the sorted points
+  std::size_t count = 0;
+  bool hasCorePoints = false;
+  std::vector< int > links; //!< Following cells with core points within eps of the core points of this cell
+};
+
+//! Column and row of a cell of the grid
+typedef std::pair< qint64, qint64 > DbscanCellKey;
+
+struct DbscanCellKeyHash
+{
+  std::size_t operator()( const DbscanCellKey &key ) const
+  {
+    return std::hash< qint64 >()( key.first ) * 31 + std::hash< qint64 >()( key.second );
+  }
+};
+
 QString QgsDbscanClusteringAlgorithm::name() const
 {
   return QStringLiteral( "dbscanclustering" );
@@ -90,22 +116,6 @@ QgsDbscanClusteringAlgorithm *QgsDbscanClusteringAlgorithm::createInstance() con
   return new QgsDbscanClusteringAlgorithm();
 }
 
-struct KDBushDataEqualById
-{
-  bool operator()( const QgsSpatialIndexKDBushData &a, const QgsSpatialIndexKDBushData &b ) const
-  {
-    return  a.id == b.id;
-  }
-};
-
-struct KDBushDataHashById
-{
-  std::size_t operator()( const QgsSpatialIndexKDBushData &a ) const
-  {
-    return std::hash< QgsFeatureId > {}( a.id );
-  }
-};
-
 QVariantMap QgsDbscanClusteringAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
@@ -129,19 +139,46 @@ QVariantMap QgsDbscanClusteringAlgorithm::processAlgorithm( const QVariantMap &p
   if ( !sink )
     throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "OUTPUT" ) ) );
 
-  // build spatial index
-  feedback->pushInfo( QObject::tr( "Building spatial index" ) );
-  QgsSpatialIndexKDBush index( *source, feedback );
-  if ( feedback->isCanceled() )
-    return QVariantMap();
+  // collect points
+  feedback->pushInfo( QObject::tr( "Collecting input points" ) );
+  const long featureCount = source->featureCount();
+  const double step = featureCount > 0 ? 30.0 / featureCount : 1;
+  std::vector< Point > points;
+  if ( featureCount > 0 )
+    points.reserve( featureCount );
+
+  QgsFeatureIterator features = source->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QgsFeature feat;
+  int i = 0;
+  while ( features.nextFeature( feat ) )
+  {
+    if ( feedback->isCanceled() )
+      return QVariantMap();
+
+    feedback->setProgress( ++i * step );
+    if ( !feat.hasGeometry() )
+      continue;
+
+    if ( QgsWkbTypes::flatType( feat.geometry().wkbType() ) == QgsWkbTypes::Point )
+    {
+      const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( feat.geometry().constGet() );
+      if ( !point->isEmpty() )
+        points.push_back( Point{ feat.id(), point->x(), point->y() } );
+    }
+    else
+    {
+      // not a point geometry
+      feedback->reportError( QObject::tr( "Feature %1 is a %2 feature, not a point." ).arg( feat.id() ).arg( QgsWkbTypes::displayString( feat.geometry().wkbType() ) ) );
+    }
+  }
 
   // dbscan!
   feedback->pushInfo( QObject::tr( "Analysing clusters" ) );
   std::unordered_map< QgsFeatureId, int> idToCluster;
-  idToCluster.reserve( index.size() );
-  QgsFeatureIterator features = source->getFeatures( QgsFeatureRequest().setNoAttributes() );
-  const long featureCount = source->featureCount();
-  dbscan( minSize, eps, borderPointsAreNoise, featureCount, features, index, idToCluster, feedback );
+  idToCluster.reserve( points.size() );
+  dbscan( minSize, eps, borderPointsAreNoise, points, idToCluster, feedback );
+  if ( feedback->isCanceled() )
+    return QVariantMap();
 
   // cluster size
   std::unordered_map< int, int> clusterSize;
@@ -150,8 +187,7 @@ QVariantMap QgsDbscanClusteringAlgorithm::processAlgorithm( const QVariantMap &p
   // write clusters
   const double writeStep = featureCount > 0 ? 10.0 / featureCount : 1;
   features = source->getFeatures();
-  int i = 0;
-  QgsFeature feat;
+  i = 0;
   while ( features.nextFeature( feat ) )
   {
     i++;
@@ -185,118 +221,255 @@ QVariantMap QgsDbscanClusteringAlgorithm::processAlgorithm( const QVariantMap &p
 void QgsDbscanClusteringAlgorithm::dbscan( const std::size_t minSize,
     const double eps,
     const bool borderPointsAreNoise,
-    const long featureCount,
-    QgsFeatureIterator features,
-    QgsSpatialIndexKDBush &index,
+    const std::vector< Point > &points,
     std::unordered_map< QgsFeatureId, int> &idToCluster,
     QgsProcessingFeedback *feedback )
 {
-  const double step = featureCount > 0 ? 90.0 / featureCount : 1;
+  if ( points.empty() )
+    return;
+
+  // bin the points in a grid of cells with a diagonal of eps: the points of a cell are all neighbors
+  // of each other, and the neighbors of a point are at most two cells away. With an eps of 0 the
+  // neighbors are the coincident points, so each cell holds the points at one position
+  const double cellSize = eps / M_SQRT2;
+  const qint64 cellReach = eps > 0 ? 2 : 0;
+  const double squaredEps = eps * eps;
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  for ( const Point &point : points )
+  {
+    xMin = std::min( xMin, point.x );
+    yMin = std::min( yMin, point.y );
+  }
 
-  std::unordered_set< QgsFeatureId > visited;
-  visited.reserve( index.size() );
+  std::vector< DbscanCellKey > pointKeys( points.size() );
+  for ( std::size_t i = 0; i < points.size(); ++i )
+  {
+    if ( eps > 0 )
+    {
+      pointKeys[i] = DbscanCellKey( static_cast< qint64 >( std::floor( ( points[i].x - xMin ) / cellSize ) ),
+                                    static_cast< qint64 >( std::floor( ( points[i].y - yMin ) / cellSize ) ) );
+    }
+    else
+    {
+      // the bits of the coordinates, adding 0 so that -0 and 0 are at the same position
+      const double x = points[i].x + 0.0;
+      const double y = points[i].y + 0.0;
+      std::memcpy( &pointKeys[i].first, &x, sizeof( double ) );
+      std::memcpy( &pointKeys[i].second, &y, sizeof( double ) );
+    }
+  }
 
-  QgsFeature feat;
-  int i = 0;
-  int clusterCount = 0;
+  // points sorted by cell, in their original order within each cell
+  std::vector< int > sortedPoints( points.size() );
+  std::iota( sortedPoints.begin(), sortedPoints.end(), 0 );
+  std::stable_sort( sortedPoints.begin(), sortedPoints.end(), [&pointKeys]( int a, int b ) { return pointKeys[a] < pointKeys[b]; } );
 
-  while ( features.nextFeature( feat ) )
+  std::vector< DbscanCell > cells;
+  std::unordered_map< DbscanCellKey, int, DbscanCellKeyHash > keyToCell;
+  std::vector< int > pointCells( points.size() );
+  for ( std::size_t i = 0; i < sortedPoints.size(); ++i )
   {
-    if ( feedback->isCanceled() )
+    const int point = sortedPoints[i];
+    if ( cells.empty() || pointKeys[ sortedPoints[ cells.back().first ] ] != pointKeys[point] )
     {
-      break;
+      DbscanCell cell;
+      cell.column = pointKeys[point].first;
+      cell.row = pointKeys[point].second;
+      cell.first = i;
+      keyToCell[ pointKeys[point] ] = static_cast< int >( cells.size() );
+      cells.emplace_back( std::move( cell ) );
     }
+    cells.back().count++;
+    pointCells[point] = static_cast< int >( cells.size() ) - 1;
+  }
+  pointKeys.clear();
+  pointKeys.shrink_to_fit();
 
-    if ( !feat.hasGeometry() )
+  // cells which may contain neighbors of the points of a cell, including itself
+  auto neighborCells = [&keyToCell, cellReach]( const DbscanCell & cell )
+  {
+    std::vector< int > result;
+    for ( qint64 column = cell.column - cellReach; column <= cell.column + cellReach; ++column )
     {
-      feedback->setProgress( ++i * step );
-      continue;
+      for ( qint64 row = cell.row - cellReach; row <= cell.row + cellReach; ++row )
+      {
+        auto it = keyToCell.find( DbscanCellKey( column, row ) );
+        if ( it != keyToCell.end() )
+          result.push_back( it->second );
+      }
     }
+    std::sort( result.begin(), result.end() );
+    result.erase( std::unique( result.begin(), result.end() ), result.end() );
+    return result;
+  };
+  auto isNeighbor = [&points, squaredEps]( int a, int b )
+  {
+    const double dx = points[a].x - points[b].x;
+    const double dy = points[a].y - points[b].y;
+    return dx * dx + dy * dy <= squaredEps;
+  };
+
+  const bool parallel = QThread::idealThreadCount() > 1 && cells.size() > 1;
+  auto forEachCell = [&cells, parallel]( const std::function< void( DbscanCell & ) > &function )
+  {
+    if ( parallel )
+      QtConcurrent::blockingMap( cells, function );
+    else
+      std::for_each( cells.begin(), cells.end(), function );
+  };
+
+  // core points, with at least minSize neighbors within eps (including themselves)
+  std::vector< char > isCore( points.size(), false );
+  forEachCell( [&]( DbscanCell & cell )
+  {
+    if ( feedback->isCanceled() )
+      return;
 
-    if ( visited.find( feat.id() ) != visited.end() )
+    if ( cell.count >= minSize )
     {
-      // already visited!
-      continue;
+      for ( std::size_t i = cell.first; i < cell.first + cell.count; ++i )
+        isCore[ sortedPoints[i] ] = true;
+      cell.hasCorePoints = true;
+      return;
     }
 
-    QgsPointXY point;
-    if ( QgsWkbTypes::flatType( feat.geometry().wkbType() ) == QgsWkbTypes::Point )
-      point = QgsPointXY( *qgsgeometry_cast< const QgsPoint * >( feat.geometry().constGet() ) );
-    else
+    const std::vector< int > candidates = neighborCells( cell );
+    for ( std::size_t i = cell.first; i < cell.first + cell.count; ++i )
     {
-      // not a point geometry
-      feedback->reportError( QObject::tr( "Feature %1 is a %2 feature, not a point." ).arg( feat.id() ).arg( QgsWkbTypes::displayString( feat.geometry().wkbType() ) ) );
-      feedback->setProgress( ++i * step );
-      continue;
+      const int point = sortedPoints[i];
+      std::size_t neighborCount = 0;
+      for ( auto candidate = candidates.begin(); candidate != candidates.end() && neighborCount < minSize; ++candidate )
+      {
+        const DbscanCell &candidateCell = cells[ *candidate ];
+        for ( std::size_t j = candidateCell.first; j < candidateCell.first + candidateCell.count && neighborCount < minSize; ++j )
+        {
+          if ( isNeighbor( point, sortedPoints[j] ) )
+            neighborCount++;
+        }
+      }
+      if ( neighborCount >= minSize )
+      {
+        isCore[point] = true;
+        cell.hasCorePoints = true;
+      }
     }
+  } );
+  if ( feedback->isCanceled() )
+    return;
+  feedback->setProgress( 50 );
 
-    std::unordered_set< QgsSpatialIndexKDBushData, KDBushDataHashById, KDBushDataEqualById> within;
+  // links between the cells whose core points are within eps of each other
+  forEachCell( [&]( DbscanCell & cell )
+  {
+    if ( feedback->isCanceled() || !cell.hasCorePoints )
+      return;
 
-    if ( minSize > 1 )
+    const int cellIndex = static_cast< int >( &cell - cells.data() );
+    for ( int candidate : neighborCells( cell ) )
     {
-      index.within( point, eps, [ &within]( const QgsSpatialIndexKDBushData & data )
-      {
-        within.insert( data );
-      } );
-      if ( within.size() < minSize )
+      const DbscanCell &candidateCell = cells[ candidate ];
+      if ( candidate <= cellIndex || !candidateCell.hasCorePoints )
         continue;
 
-      visited.insert( feat.id() );
+      bool linked = false;
+      for ( std::size_t i = cell.first; i < cell.first + cell.count && !linked; ++i )
+      {
+        if ( !isCore[ sortedPoints[i] ] )
+          continue;
+        for ( std::size_t j = candidateCell.first; j < candidateCell.first + candidateCell.count && !linked; ++j )
+        {
+          linked = isCore[ sortedPoints[j] ] && isNeighbor( sortedPoints[i], sortedPoints[j] );
+        }
+      }
+      if ( linked )
+        cell.links.push_back( candidate );
+    }
+  } );
+  if ( feedback->isCanceled() )
+    return;
+  feedback->setProgress( 70 );
+
+  // merge the linked cells
+  std::vector< int > parents( cells.size() );
+  std::iota( parents.begin(), parents.end(), 0 );
+  auto findRoot = [&parents]( int cell )
+  {
+    while ( parents[cell] != cell )
+    {
+      parents[cell] = parents[ parents[cell] ];
+      cell = parents[cell];
     }
-    else
+    return cell;
+  };
+  for ( std::size_t cell = 0; cell < cells.size(); ++cell )
+  {
+    for ( int link : cells[cell].links )
     {
-      // optimised case for minSize == 1, we can skip the initial check
-      within.insert( QgsSpatialIndexKDBushData( feat.id(), point.x(), point.y() ) );
+      const int root = findRoot( static_cast< int >( cell ) );
+      const int linkRoot = findRoot( link );
+      if ( root != linkRoot )
+        parents[ std::max( root, linkRoot ) ] = std::min( root, linkRoot );
     }
+  }
 
-    // start new cluster
-    clusterCount++;
-    idToCluster[ feat.id() ] = clusterCount;
-    feedback->setProgress( ++i * step );
+  // number the clusters in the order of their first core point, as a sequential scan of the points would do
+  std::vector< int > pointClusters( points.size(), 0 );
+  std::vector< int > rootClusters( cells.size(), 0 );
+  int clusterCount = 0;
+  for ( std::size_t i = 0; i < points.size(); ++i )
+  {
+    if ( !isCore[i] )
+      continue;
+
+    const int root = findRoot( pointCells[i] );
+    if ( rootClusters[root] == 0 )
+      rootClusters[root] = ++clusterCount;
+    pointClusters[i] = rootClusters[root];
+  }
+  feedback->setProgress( 80 );
 
-    while ( !within.empty() )
+  // border points join the first cluster with a core point within eps
+  if ( !borderPointsAreNoise )
+  {
+    forEachCell( [&]( DbscanCell & cell )
     {
       if ( feedback->isCanceled() )
-      {
-        break;
-      }
-
-      QgsSpatialIndexKDBushData j = *within.begin();
-      within.erase( within.begin() );
+        return;
 
-      if ( visited.find( j.id ) != visited.end() )
+      std::vector< int > candidates;
+      for ( std::size_t i = cell.first; i < cell.first + cell.count; ++i )
       {
-        // already visited!
-        continue;
-      }
+        const int point = sortedPoints[i];
+        if ( isCore[point] )
+          continue;
 
-      visited.insert( j.id );
-      feedback->setProgress( ++i * step );
+        if ( candidates.empty() )
+          candidates = neighborCells( cell );
 
-      // check from this point
-      QgsPointXY point2 = j.point();
-
-      std::unordered_set< QgsSpatialIndexKDBushData, KDBushDataHashById, KDBushDataEqualById > within2;
-      index.within( point2, eps, [&within2]( const QgsSpatialIndexKDBushData & data )
-      {
-        within2.insert( data );
-      } );
-      if ( within2.size() >= minSize )
-      {
-        // expand neighbourhood
-        std::copy_if( within2.begin(),
-                      within2.end(),
-                      std::inserter( within, within.end() ),
-                      [&visited]( const QgsSpatialIndexKDBushData & needle )
+        int cluster = 0;
+        for ( int candidate : candidates )
         {
-          return visited.find( needle.id ) == visited.end();
-        } );
-      }
-      if ( !borderPointsAreNoise || within2.size() >= minSize )
-      {
-        idToCluster[ j.id ] = clusterCount;
+          const DbscanCell &candidateCell = cells[ candidate ];
+          if ( !candidateCell.hasCorePoints )
+            continue;
+          for ( std::size_t j = candidateCell.first; j < candidateCell.first + candidateCell.count; ++j )
+          {
+            const int other = sortedPoints[j];
+            if ( isCore[other] && ( cluster == 0 || pointClusters[other] < cluster ) && isNeighbor( point, other ) )
+              cluster = pointClusters[other];
+          }
+        }
+        pointClusters[point] = cluster;
       }
-    }
+    } );
+  }
+  feedback->setProgress( 90 );
+
+  for ( std::size_t i = 0; i < points.size(); ++i )
+  {
+    if ( pointClusters[i] > 0 )
+      idToCluster[ points[i].id ] = pointClusters[i];
   }
 }
 
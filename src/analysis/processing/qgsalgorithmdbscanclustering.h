@@ -24,8 +24,7 @@
 #include "qgis_analysis.h"
 #include "qgsprocessingalgorithm.h"
 #include <unordered_map>
-
-class QgsSpatialIndexKDBush;
+#include <vector>
 
 ///@cond PRIVATE
 
@@ -54,14 +53,23 @@ class ANALYSIS_EXPORT QgsDbscanClusteringAlgorithm : public QgsProcessingAlgorit
     QVariantMap processAlgorithm( const QVariantMap &parameters,
                                   QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
   private:
+
+    //! Point feature to cluster
+    struct Point
+    {
+      QgsFeatureId id;
+      double x;
+      double y;
+    };
+
     static void dbscan( std::size_t minSize,
                         double eps,
                         bool borderPointsAreNoise,
-                        long featureCount,
-                        QgsFeatureIterator features,
-                        QgsSpatialIndexKDBush &index,
+                        const std::vector< Point > &points,
                         std::unordered_map< QgsFeatureId, int> &idToCluster,
                         QgsProcessingFeedback *feedback );
+
+    friend class TestQgsProcessingAlgs;
 };
 
 ///@endcond PRIVATE
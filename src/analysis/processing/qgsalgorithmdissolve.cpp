@@ -17,14 +17,149 @@
 
 #include "qgsalgorithmdissolve.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <QMutex>
+#include <QThread>
+#include <QtConcurrentMap>
+
 ///@cond PRIVATE
 
+//! Groups collected at once by each thread
+static constexpr int GROUPS_PER_THREAD = 4;
+
+//! Maximum count of geometries united at once by a node of the cascaded union tree
+static constexpr int CASCADED_UNION_NODE_SIZE = 256;
+
+//! Geometries of a group of features and the result of their collection
+struct CollectedGroup
+{
+  QgsAttributes attributes;           //!< Attributes of the first feature of the group
+  QVector< QgsGeometry > geometries;  //!< Geometries of the features of the group
+  QgsGeometry result;                 //!< Collected geometry
+  QString error;                      //!< Error raised while collecting the geometries, if any
+};
+
+//! Collects the geometries of each of the \a groups with \a collector, in parallel if \a parallel is TRUE
+static void collectGroups( std::vector< CollectedGroup > &groups, const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, bool parallel )
+{
+  auto collectGroup = [&collector]( CollectedGroup & group )
+  {
+    if ( group.geometries.isEmpty() )
+      return;
+
+    try
+    {
+      group.result = collector( group.geometries );
+    }
+    catch ( QgsProcessingException &e )
+    {
+      group.error = e.what();
+    }
+    group.geometries.clear();
+  };
+
+  if ( parallel && groups.size() > 1 )
+    QtConcurrent::blockingMap( groups, collectGroup );
+  else
+    std::for_each( groups.begin(), groups.end(), collectGroup );
+}
+
+//! Returns the position of \a point along a Z-order curve covering \a extent
+static quint32 zOrderKey( const QgsPointXY &point, const QgsRectangle &extent )
+{
+  const double width = extent.width() > 0 ? extent.width() : 1;
+  const double height = extent.height() > 0 ? extent.height() : 1;
+  const quint32 x = static_cast< quint32 >( std::clamp( ( point.x() - extent.xMinimum() ) / width, 0.0, 1.0 ) * 0xffff );
+  const quint32 y = static_cast< quint32 >( std::clamp( ( point.y() - extent.yMinimum() ) / height, 0.0, 1.0 ) * 0xffff );
+
+  // interleave the bits of x and y
+  quint32 key = 0;
+  for ( int bit = 0; bit < 16; ++bit )
+  {
+    key |= ( ( x >> bit ) & 1 ) << ( 2 * bit );
+    key |= ( ( y >> bit ) & 1 ) << ( 2 * bit + 1 );
+  }
+  return key;
+}
+
+/**
+ * Unites \a geometries with a cascaded union tree.
+ *
+ * The geometries are sorted along a Z-order curve so that each node of the tree unites geometries which are close
+ * to each other, and the nodes of each level of the tree are united in parallel. Returns a geometry with an error
+ * if one of the unions failed.
+ */
+static QgsGeometry cascadedUnion( const QVector< QgsGeometry > &geometries, QgsFeedback *feedback )
+{
+  if ( geometries.size() <= CASCADED_UNION_NODE_SIZE )
+    return QgsGeometry::unaryUnion( geometries );
+
+  QgsRectangle extent;
+  std::vector< std::pair< quint32, QgsGeometry > > sorted;
+  sorted.reserve( geometries.size() );
+  for ( const QgsGeometry &geometry : geometries )
+    extent.combineExtentWith( geometry.boundingBox() );
+  for ( const QgsGeometry &geometry : geometries )
+    sorted.emplace_back( zOrderKey( geometry.boundingBox().center(), extent ), geometry );
+  std::stable_sort( sorted.begin(), sorted.end(), []( const std::pair< quint32, QgsGeometry > &a, const std::pair< quint32, QgsGeometry > &b )
+  {
+    return a.first < b.first;
+  } );
+
+  std::vector< QVector< QgsGeometry > > nodes;
+  for ( std::size_t i = 0; i < sorted.size(); i += CASCADED_UNION_NODE_SIZE )
+  {
+    QVector< QgsGeometry > node;
+    for ( std::size_t j = i; j < std::min( sorted.size(), i + CASCADED_UNION_NODE_SIZE ); ++j )
+      node << sorted[j].second;
+    nodes.emplace_back( node );
+  }
+  sorted.clear();
+
+  while ( true )
+  {
+    std::vector< QgsGeometry > united( nodes.size() );
+    QtConcurrent::blockingMap( nodes, [&nodes, &united, feedback]( QVector< QgsGeometry > &node )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return;
+      united[ &node - nodes.data() ] = QgsGeometry::unaryUnion( node );
+    } );
+
+    if ( feedback && feedback->isCanceled() )
+      return QgsGeometry();
+
+    for ( const QgsGeometry &geometry : united )
+    {
+      if ( !geometry.lastError().isEmpty() )
+        return geometry;
+    }
+
+    if ( united.size() == 1 )
+      return united.front();
+
+    // the next level unites the results of the nodes in groups of two, which keeps neighbours together
+    nodes.clear();
+    for ( std::size_t i = 0; i < united.size(); i += 2 )
+    {
+      QVector< QgsGeometry > node;
+      node << united[i];
+      if ( i + 1 < united.size() )
+        node << united[i + 1];
+      nodes.emplace_back( node );
+    }
+  }
+}
+
+
 //
 // QgsCollectorAlgorithm
 //
 
 QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags )
+    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags, bool parallel )
 {
   std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !source )
@@ -54,6 +189,21 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
     QVector< QgsGeometry > geomQueue;
     QgsFeature outputFeature;
 
+    // the results of the blocks are merged by pairs of the same level, as in a binary counter, so that each
+    // geometry is only collected again a logarithmic number of times rather than once per block
+    std::vector< std::pair< int, QgsGeometry > > partialResults;
+    auto addPartialResult = [&partialResults, &collector]( QgsGeometry geometry )
+    {
+      int level = 0;
+      while ( !partialResults.empty() && partialResults.back().first == level )
+      {
+        geometry = collector( QVector< QgsGeometry >() << partialResults.back().second << geometry );
+        partialResults.pop_back();
+        ++level;
+      }
+      partialResults.emplace_back( level, geometry );
+    };
+
     while ( it.nextFeature( f ) )
     {
       if ( feedback->isCanceled() )
@@ -70,12 +220,11 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       if ( f.hasGeometry() && !f.geometry().isNull() )
       {
         geomQueue.append( f.geometry() );
-        if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
+        if ( maxQueueLength > 0 && geomQueue.length() >= maxQueueLength )
         {
           // queue too long, combine it
-          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          addPartialResult( collector( geomQueue ) );
           geomQueue.clear();
-          geomQueue << tempOutputGeometry;
         }
       }
 
@@ -83,6 +232,10 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       current++;
     }
 
+    for ( auto partialIt = partialResults.rbegin(); partialIt != partialResults.rend(); ++partialIt )
+      geomQueue << partialIt->second;
+    partialResults.clear();
+
     outputFeature.setGeometry( collector( geomQueue ) );
     sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
   }
@@ -97,59 +250,138 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
         fieldIndexes << index;
     }
 
-    QHash< QVariant, QgsAttributes > attributeHash;
-    QHash< QVariant, QVector< QgsGeometry > > geometryHash;
+    const bool sortedInput = parameterDefinition( QStringLiteral( "SORTED_INPUT" ) ) && parameterAsBoolean( parameters, QStringLiteral( "SORTED_INPUT" ), context );
+    const std::size_t batchSize = parallel ? static_cast< std::size_t >( std::max( 1, QThread::idealThreadCount() ) * GROUPS_PER_THREAD ) : 1;
 
-    while ( it.nextFeature( f ) )
+    // collects the groups of the batch and writes them in the order of the batch
+    std::vector< CollectedGroup > batch;
+    auto flushBatch = [ &batch, &collector, &sink, parallel ]
     {
-      if ( feedback->isCanceled() )
+      collectGroups( batch, collector, parallel );
+      for ( CollectedGroup &group : batch )
       {
-        break;
+        if ( !group.error.isEmpty() )
+          throw QgsProcessingException( group.error );
+
+        QgsFeature outputFeature;
+        if ( !group.result.isNull() )
+        {
+          if ( !group.result.isMultipart() )
+          {
+            group.result.convertToMultiType();
+          }
+          outputFeature.setGeometry( group.result );
+        }
+        outputFeature.setAttributes( group.attributes );
+        sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
       }
+      batch.clear();
+    };
 
+    auto groupKey = [&fieldIndexes]( const QgsFeature & feature )
+    {
       QVariantList indexAttributes;
-      const auto constFieldIndexes = fieldIndexes;
-      for ( int index : constFieldIndexes )
+      for ( int index : std::as_const( fieldIndexes ) )
       {
-        indexAttributes << f.attribute( index );
+        indexAttributes << feature.attribute( index );
       }
+      return indexAttributes;
+    };
 
-      if ( !attributeHash.contains( indexAttributes ) )
+    if ( sortedInput )
+    {
+      // the features of a group follow each other, so each group is complete as soon as the next one starts
+      QVariantList currentKey;
+      bool hasGroup = false;
+      CollectedGroup group;
+      while ( it.nextFeature( f ) )
       {
-        // keep attributes of first feature
-        attributeHash.insert( indexAttributes, f.attributes() );
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        const QVariantList indexAttributes = groupKey( f );
+        if ( !hasGroup || indexAttributes != currentKey )
+        {
+          if ( hasGroup )
+          {
+            batch.emplace_back( std::move( group ) );
+            if ( batch.size() >= batchSize )
+              flushBatch();
+          }
+
+          // keep attributes of first feature
+          group = CollectedGroup();
+          group.attributes = f.attributes();
+          currentKey = indexAttributes;
+          hasGroup = true;
+        }
+
+        if ( f.hasGeometry() && !f.geometry().isNull() )
+        {
+          group.geometries.append( f.geometry() );
+        }
+
+        feedback->setProgress( current * step );
+        current++;
       }
 
-      if ( f.hasGeometry() && !f.geometry().isNull() )
+      if ( hasGroup && !feedback->isCanceled() )
       {
-        geometryHash[ indexAttributes ].append( f.geometry() );
+        batch.emplace_back( std::move( group ) );
+        flushBatch();
       }
     }
-
-    int numberFeatures = attributeHash.count();
-    QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
-    for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
+    else
     {
-      if ( feedback->isCanceled() )
+      QHash< QVariant, QgsAttributes > attributeHash;
+      QHash< QVariant, QVector< QgsGeometry > > geometryHash;
+
+      while ( it.nextFeature( f ) )
       {
-        break;
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        const QVariantList indexAttributes = groupKey( f );
+        if ( !attributeHash.contains( indexAttributes ) )
+        {
+          // keep attributes of first feature
+          attributeHash.insert( indexAttributes, f.attributes() );
+        }
+
+        if ( f.hasGeometry() && !f.geometry().isNull() )
+        {
+          geometryHash[ indexAttributes ].append( f.geometry() );
+        }
       }
 
-      QgsFeature outputFeature;
-      if ( geometryHash.contains( attrIt.key() ) )
+      int numberFeatures = attributeHash.count();
+      QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
+      for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
       {
-        QgsGeometry geom = collector( geometryHash.value( attrIt.key() ) );
-        if ( !geom.isMultipart() )
+        if ( feedback->isCanceled() )
+        {
+          break;
+        }
+
+        CollectedGroup group;
+        group.attributes = attrIt.value();
+        group.geometries = geometryHash.take( attrIt.key() );
+        batch.emplace_back( std::move( group ) );
+        current++;
+
+        if ( batch.size() >= batchSize )
         {
-          geom.convertToMultiType();
+          flushBatch();
+          feedback->setProgress( current * 100.0 / numberFeatures );
         }
-        outputFeature.setGeometry( geom );
       }
-      outputFeature.setAttributes( attrIt.value() );
-      sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
 
-      feedback->setProgress( current * 100.0 / numberFeatures );
-      current++;
+      if ( !feedback->isCanceled() )
+        flushBatch();
     }
   }
 
@@ -195,6 +427,11 @@ void QgsDissolveAlgorithm::initAlgorithm( const QVariantMap & )
   addParameter( new QgsProcessingParameterField( QStringLiteral( "FIELD" ), QObject::tr( "Dissolve field(s)" ), QVariant(),
                 QStringLiteral( "INPUT" ), QgsProcessingParameterField::Any, true, true ) );
 
+  std::unique_ptr< QgsProcessingParameterBoolean > sortedParam = std::make_unique< QgsProcessingParameterBoolean >( QStringLiteral( "SORTED_INPUT" ),
+      QObject::tr( "Input is sorted by dissolve field(s)" ), false, true );
+  sortedParam->setFlags( sortedParam->flags() | QgsProcessingParameterDefinition::FlagAdvanced );
+  addParameter( sortedParam.release() );
+
   addParameter( new QgsProcessingParameterFeatureSink( QStringLiteral( "OUTPUT" ), QObject::tr( "Dissolved" ) ) );
 }
 
@@ -204,7 +441,10 @@ QString QgsDissolveAlgorithm::shortHelpString() const
                       "be specified to dissolve features belonging to the same class (having the same value for the specified attributes), alternatively "
                       "all features can be dissolved in a single one.\n\n"
                       "All output geometries will be converted to multi geometries. "
-                      "In case the input is a polygon layer, common boundaries of adjacent polygons being dissolved will get erased." );
+                      "In case the input is a polygon layer, common boundaries of adjacent polygons being dissolved will get erased.\n\n"
+                      "If the input is sorted by the dissolve field(s), the 'Input is sorted' option dissolves each group as soon "
+                      "as its features are read, instead of keeping all the features in memory. Features of a group which are not "
+                      "next to each other in the input will then give several output features." );
 }
 
 QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
@@ -214,9 +454,11 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
+  // groups are dissolved in parallel, so the feedback messages must be serialized
+  QMutex feedbackMutex;
   return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
   {
-    QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
+    QgsGeometry result( cascadedUnion( parts, feedback ) );
     if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
       result = result.mergeLines();
     // Geos may fail in some cases, let's try a slower but safer approach
@@ -226,7 +468,10 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
       if ( feedback->isCanceled() )
         return result;
 
-      feedback->pushDebugInfo( QObject::tr( "GEOS exception: taking the slower route ..." ) );
+      {
+        QMutexLocker locker( &feedbackMutex );
+        feedback->pushDebugInfo( QObject::tr( "GEOS exception: taking the slower route ..." ) );
+      }
       result = QgsGeometry();
       for ( const auto &p : parts )
       {
@@ -239,12 +484,15 @@ QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameter
     }
     if ( ! result.lastError().isEmpty() )
     {
-      feedback->reportError( result.lastError(), true );
+      {
+        QMutexLocker locker( &feedbackMutex );
+        feedback->reportError( result.lastError(), true );
+      }
       if ( result.isEmpty() )
         throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
     }
     return result;
-  }, 10000 );
+  }, 10000, QgsProcessingFeatureSource::Flags(), true );
 }
 
 //
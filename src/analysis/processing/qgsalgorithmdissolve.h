@@ -33,8 +33,16 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Collects the geometries of the features of each group with \a collector.
+     *
+     * If \a parallel is TRUE, several groups are collected at the same time and \a collector must be thread safe.
+     * If the algorithm has a SORTED_INPUT parameter set to TRUE, the input is expected to be sorted by the
+     * group fields, and each group is collected as soon as all its features are read.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags() );
+                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags(),
+                                   bool parallel = false );
 };
 
 /**
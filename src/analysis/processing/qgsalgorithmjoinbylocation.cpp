@@ -22,9 +22,128 @@
 #include "qgsapplication.h"
 #include "qgsfeature.h"
 #include "qgsfeaturesource.h"
+#include "qgsspatialindex.h"
+#include "qgspoint.h"
+#include "qgspolygon.h"
+#include "qgslinestring.h"
+#include "qgsgeometrycollection.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
+//! Input features tested at once against the indexed join layer, for each thread
+constexpr int FEATURES_PER_THREAD = 1024;
+
+//! Largest join polygon against which input points are located by walking its rings, instead of with its prepared engine
+constexpr int MAX_POINT_IN_POLYGON_VERTICES = 256;
+
+//! Location of an input point relative to a join polygon
+enum class PointLocation
+{
+  Exterior,
+  Interior,
+  Unknown, //!< Not a linear polygon, or on or too close to its boundary to be located without the robust predicates of GEOS
+};
+
+static PointLocation locatePointInRings( double x, double y, const QgsPolygon *polygon )
+{
+  bool inside = false;
+  for ( int ringIndex = 0; ringIndex <= polygon->numInteriorRings(); ++ringIndex )
+  {
+    const QgsLineString *ring = qgsgeometry_cast< const QgsLineString * >( ringIndex == 0 ? polygon->exteriorRing() : polygon->interiorRing( ringIndex - 1 ) );
+    if ( !ring )
+      return PointLocation::Unknown;
+
+    const double *ringX = ring->xData();
+    const double *ringY = ring->yData();
+    for ( int i = 1; i < ring->numPoints(); ++i )
+    {
+      const double x1 = ringX[i - 1];
+      const double y1 = ringY[i - 1];
+      const double x2 = ringX[i];
+      const double y2 = ringY[i];
+      const bool crossesY = ( y1 > y ) != ( y2 > y );
+      if ( !crossesY && ( y < std::min( y1, y2 ) || y > std::max( y1, y2 ) ) )
+        continue;
+
+      // side of the point relative to the segment, which is left to GEOS when rounding could change its sign
+      const double left = ( x2 - x1 ) * ( y - y1 );
+      const double right = ( y2 - y1 ) * ( x - x1 );
+      const double side = left - right;
+      if ( std::fabs( side ) <= 1e-14 * ( std::fabs( left ) + std::fabs( right ) ) )
+      {
+        if ( x >= std::min( x1, x2 ) && x <= std::max( x1, x2 ) )
+          return PointLocation::Unknown;
+        if ( crossesY )
+          return PointLocation::Unknown;
+        continue;
+      }
+
+      // count the segments crossing the horizontal ray going right from the point
+      if ( crossesY && ( side > 0 ) == ( y2 > y1 ) )
+        inside = !inside;
+    }
+  }
+  return inside ? PointLocation::Interior : PointLocation::Exterior;
+}
+
+/**
+ * Locates a point relative to a linear polygon or multipolygon, by counting the crossings of its rings.
+ */
+static PointLocation locatePointInPolygon( double x, double y, const QgsAbstractGeometry *geometry )
+{
+  switch ( QgsWkbTypes::flatType( geometry->wkbType() ) )
+  {
+    case QgsWkbTypes::Polygon:
+      return locatePointInRings( x, y, qgsgeometry_cast< const QgsPolygon * >( geometry ) );
+
+    case QgsWkbTypes::MultiPolygon:
+    {
+      const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry );
+      for ( int i = 0; i < collection->numGeometries(); ++i )
+      {
+        const QgsPolygon *polygon = qgsgeometry_cast< const QgsPolygon * >( collection->geometryN( i ) );
+        if ( !polygon )
+          return PointLocation::Unknown;
+
+        const PointLocation location = locatePointInRings( x, y, polygon );
+        if ( location != PointLocation::Exterior )
+          return location;
+      }
+      return PointLocation::Exterior;
+    }
+
+    default:
+      return PointLocation::Unknown;
+  }
+}
+
+/**
+ * Returns TRUE if an input point at the given \a location relative to a join polygon matches one of the \a predicates.
+ */
+static bool pointMatchesPredicates( const QList< int > &predicates, PointLocation location )
+{
+  for ( const int predicate : predicates )
+  {
+    switch ( predicate )
+    {
+      case 0:
+      // intersects
+      case 5:
+        // within
+        if ( location == PointLocation::Interior )
+          return true;
+        break;
+      default:
+        // a point which is not on the boundary of a polygon never touches it, and never contains, equals, overlaps or crosses it
+        break;
+    }
+  }
+  return false;
+}
+
 
 void QgsJoinByLocationAlgorithm::initAlgorithm( const QVariantMap & )
 {
@@ -190,6 +309,12 @@ QVariantMap QgsJoinByLocationAlgorithm::processAlgorithm( const QVariantMap &par
         // joining FEWER features to a layer with MORE features. So we iterate over the FEW features and find matches from the MANY
         processAlgorithmByIteratingOverInputSource( context, feedback );
       }
+      else if ( mJoinSource->featureCount() > 0 && mJoinSource->featureCount() <= mMaxIndexedJoinFeatures )
+      {
+        // the join layer is the smaller one, so keep it in memory with its prepared geometries, and stream the
+        // input features through it instead of requesting the input features for each join feature
+        processAlgorithmWithJoinIndex( context, feedback );
+      }
       else
       {
         // default -- iterate over the join source and match back to the base source. We do this on the assumption that the most common
@@ -204,7 +329,11 @@ QVariantMap QgsJoinByLocationAlgorithm::processAlgorithm( const QVariantMap &par
     }
 
     case JoinToLargestOverlap:
-      processAlgorithmByIteratingOverInputSource( context, feedback );
+      if ( mJoinSource->featureCount() > 0 && mJoinSource->featureCount() <= mMaxIndexedJoinFeatures
+           && mJoinSource->featureCount() <= mBaseSource->featureCount() )
+        processAlgorithmWithJoinIndex( context, feedback );
+      else
+        processAlgorithmByIteratingOverInputSource( context, feedback );
       break;
   }
 
@@ -388,6 +517,271 @@ void QgsJoinByLocationAlgorithm::processAlgorithmByIteratingOverInputSource( Qgs
   }
 }
 
+void QgsJoinByLocationAlgorithm::processAlgorithmWithJoinIndex( QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // read the join features once, and index their bounding boxes
+  QVector< QgsFeature > joinFeatures;
+  joinFeatures.reserve( static_cast< int >( mJoinSource->featureCount() ) );
+  QHash< QgsFeatureId, int > joinFeatureIndexes;
+  const QgsFeatureIterator joinIter = mJoinSource->getFeatures( QgsFeatureRequest().setDestinationCrs( mBaseSource->sourceCrs(), context.transformContext() ).setSubsetOfAttributes( mJoinedFieldIndices ) );
+  const QgsSpatialIndex joinIndex( joinIter, [&joinFeatures, &joinFeatureIndexes, feedback]( const QgsFeature & feature )->bool
+  {
+    if ( feature.hasGeometry() )
+    {
+      joinFeatureIndexes.insert( feature.id(), joinFeatures.size() );
+      joinFeatures.append( feature );
+    }
+    return !feedback->isCanceled();
+  } );
+
+  if ( feedback->isCanceled() )
+    return;
+
+  // prepared engines of the join features, created when a join feature is first tested and reused for the
+  // next batch when it tests the join feature again. Each batch tests a join feature on a single thread, so
+  // an engine is never shared. The join features of the previous batch are kept to release their engines.
+  std::vector< std::unique_ptr< QgsGeometryEngine > > joinEngines( static_cast< std::size_t >( joinFeatures.size() ) );
+  std::vector< int > previousJoinFeatures;
+  std::vector< int > batchJoinFeatures;
+
+  // a candidate pair of an input feature and a join feature, with the result of its test
+  struct Candidate
+  {
+    int baseFeature = 0;
+    int joinFeature = 0;
+    bool matches = false;
+    double overlap = 0;
+  };
+
+  // candidates of one batch sharing the same join feature, in a range of the candidate vector
+  struct CandidateRange
+  {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+  };
+
+  std::vector< QgsFeature > baseFeatures;
+  std::vector< Candidate > candidates;
+  std::vector< CandidateRange > ranges;
+
+  auto testCandidates = [this, &baseFeatures, &candidates, &joinFeatures, &joinEngines]( const CandidateRange & range )
+  {
+    const int joinFeature = candidates[ range.begin ].joinFeature;
+    const QgsAbstractGeometry *joinGeometry = joinFeatures.at( joinFeature ).geometry().constGet();
+    std::unique_ptr< QgsGeometryEngine > &engine = joinEngines[ static_cast< std::size_t >( joinFeature ) ];
+
+    // input points are located directly in small polygons, without converting each of them to a GEOS geometry
+    const bool locatePoints = QgsWkbTypes::geometryType( joinGeometry->wkbType() ) == QgsWkbTypes::PolygonGeometry
+                              && joinGeometry->nCoordinates() <= MAX_POINT_IN_POLYGON_VERTICES;
+
+    for ( std::size_t i = range.begin; i < range.end; ++i )
+    {
+      Candidate &candidate = candidates[i];
+      const QgsFeature &baseFeature = baseFeatures[ static_cast< std::size_t >( candidate.baseFeature ) ];
+      if ( locatePoints )
+      {
+        if ( const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( baseFeature.geometry().constGet() ) )
+        {
+          const PointLocation location = point->isEmpty() ? PointLocation::Unknown : locatePointInPolygon( point->x(), point->y(), joinGeometry );
+          if ( location != PointLocation::Unknown )
+          {
+            // the overlap of a point is always null
+            candidate.matches = pointMatchesPredicates( mPredicates, location );
+            continue;
+          }
+        }
+      }
+
+      if ( !engine )
+      {
+        engine.reset( QgsGeometry::createGeometryEngine( joinGeometry ) );
+        engine->prepareGeometry();
+      }
+
+      candidate.matches = featureFilter( baseFeature, engine.get(), false );
+      if ( candidate.matches && mJoinMethod == JoinToLargestOverlap )
+      {
+        // calculate area of overlap
+        std::unique_ptr< QgsAbstractGeometry > intersection( engine->intersection( baseFeature.geometry().constGet() ) );
+        if ( !intersection )
+          continue;
+
+        switch ( QgsWkbTypes::geometryType( intersection->wkbType() ) )
+        {
+          case QgsWkbTypes::LineGeometry:
+            candidate.overlap = intersection->length();
+            break;
+
+          case QgsWkbTypes::PolygonGeometry:
+            candidate.overlap = intersection->area();
+            break;
+
+          case QgsWkbTypes::UnknownGeometry:
+          case QgsWkbTypes::PointGeometry:
+          case QgsWkbTypes::NullGeometry:
+            break;
+        }
+      }
+    }
+  };
+
+  QgsAttributes emptyAttributes;
+  emptyAttributes.reserve( mJoinedFieldIndices.count() );
+  for ( int i = 0; i < mJoinedFieldIndices.count(); ++i )
+    emptyAttributes << QVariant();
+
+  auto addJoinedFeature = [this]( const QgsFeature & baseFeature, const QgsFeature & joinFeature )
+  {
+    if ( !mJoinedFeatures )
+      return;
+
+    QgsAttributes joinAttributes = baseFeature.attributes();
+    joinAttributes.reserve( joinAttributes.size() + mJoinedFieldIndices.size() );
+    for ( int ix : std::as_const( mJoinedFieldIndices ) )
+    {
+      joinAttributes.append( joinFeature.attribute( ix ) );
+    }
+
+    QgsFeature outputFeature( baseFeature );
+    outputFeature.setAttributes( joinAttributes );
+    mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+  };
+
+  const int threadCount = std::max( 1, QThread::idealThreadCount() );
+  const std::size_t batchSize = static_cast< std::size_t >( threadCount ) * FEATURES_PER_THREAD;
+  baseFeatures.reserve( batchSize );
+
+  QgsFeatureIterator it = mBaseSource->getFeatures();
+  QgsFeature f;
+  const double step = mBaseSource->featureCount() > 0 ? 100.0 / mBaseSource->featureCount() : 1;
+  long long i = 0;
+  bool hasMore = true;
+  while ( hasMore )
+  {
+    if ( feedback->isCanceled() )
+      break;
+
+    baseFeatures.clear();
+    while ( baseFeatures.size() < batchSize && ( hasMore = it.nextFeature( f ) ) )
+      baseFeatures.emplace_back( f );
+
+    // find the candidates in the bounding box index, then group them by join feature so that
+    // each prepared join geometry is tested against all of its input features at once
+    candidates.clear();
+    for ( std::size_t baseFeature = 0; baseFeature < baseFeatures.size(); ++baseFeature )
+    {
+      if ( !baseFeatures[ baseFeature ].hasGeometry() )
+        continue;
+
+      const QList< QgsFeatureId > ids = joinIndex.intersects( baseFeatures[ baseFeature ].geometry().boundingBox() );
+      for ( QgsFeatureId id : ids )
+      {
+        Candidate candidate;
+        candidate.baseFeature = static_cast< int >( baseFeature );
+        candidate.joinFeature = joinFeatureIndexes.value( id );
+        candidates.emplace_back( candidate );
+      }
+    }
+    std::sort( candidates.begin(), candidates.end(), []( const Candidate & a, const Candidate & b )
+    {
+      return a.joinFeature < b.joinFeature || ( a.joinFeature == b.joinFeature && a.baseFeature < b.baseFeature );
+    } );
+
+    ranges.clear();
+    for ( std::size_t start = 0; start < candidates.size(); )
+    {
+      std::size_t end = start + 1;
+      while ( end < candidates.size() && candidates[ end ].joinFeature == candidates[ start ].joinFeature )
+        ++end;
+      ranges.emplace_back( CandidateRange{ start, end } );
+      start = end;
+    }
+
+    if ( threadCount == 1 || ranges.size() == 1 )
+      std::for_each( ranges.begin(), ranges.end(), testCandidates );
+    else
+      QtConcurrent::blockingMap( ranges, testCandidates );
+
+    // only keep the engines of the join features tested by this batch, which are likely to be tested by the
+    // next one, so that the prepared geometries in memory are bounded by the size of a batch
+    batchJoinFeatures.clear();
+    for ( const CandidateRange &range : std::as_const( ranges ) )
+      batchJoinFeatures.emplace_back( candidates[ range.begin ].joinFeature );
+    for ( int joinFeature : std::as_const( previousJoinFeatures ) )
+    {
+      if ( !std::binary_search( batchJoinFeatures.cbegin(), batchJoinFeatures.cend(), joinFeature ) )
+        joinEngines[ static_cast< std::size_t >( joinFeature ) ].reset();
+    }
+    std::swap( previousJoinFeatures, batchJoinFeatures );
+
+    // write the input features in their order, with their matches in the order of the join layer
+    std::sort( candidates.begin(), candidates.end(), []( const Candidate & a, const Candidate & b )
+    {
+      return a.baseFeature < b.baseFeature || ( a.baseFeature == b.baseFeature && a.joinFeature < b.joinFeature );
+    } );
+
+    auto candidateIt = candidates.cbegin();
+    for ( std::size_t baseFeature = 0; baseFeature < baseFeatures.size(); ++baseFeature )
+    {
+      const QgsFeature &feature = baseFeatures[ baseFeature ];
+      bool ok = false;
+      const Candidate *bestMatch = nullptr;
+      for ( ; candidateIt != candidates.cend() && candidateIt->baseFeature == static_cast< int >( baseFeature ); ++candidateIt )
+      {
+        if ( !candidateIt->matches )
+          continue;
+
+        switch ( mJoinMethod )
+        {
+          case OneToMany:
+            addJoinedFeature( feature, joinFeatures.at( candidateIt->joinFeature ) );
+            mJoinedCount++;
+            break;
+
+          case JoinToFirst:
+            if ( !ok )
+            {
+              addJoinedFeature( feature, joinFeatures.at( candidateIt->joinFeature ) );
+              mJoinedCount++;
+            }
+            break;
+
+          case JoinToLargestOverlap:
+            if ( !bestMatch || candidateIt->overlap > bestMatch->overlap )
+              bestMatch = &( *candidateIt );
+            break;
+        }
+        ok = true;
+      }
+
+      if ( bestMatch )
+      {
+        addJoinedFeature( feature, joinFeatures.at( bestMatch->joinFeature ) );
+        mJoinedCount++;
+      }
+
+      if ( !ok )
+      {
+        // didn't find a match...
+        if ( mJoinedFeatures && !mDiscardNonMatching )
+        {
+          QgsAttributes attributes = feature.attributes();
+          attributes.append( emptyAttributes );
+          QgsFeature outputFeature( feature );
+          outputFeature.setAttributes( attributes );
+          mJoinedFeatures->addFeature( outputFeature, QgsFeatureSink::FastInsert );
+        }
+
+        if ( mUnjoinedFeatures )
+          mUnjoinedFeatures->addFeature( feature, QgsFeatureSink::FastInsert );
+      }
+    }
+
+    i += static_cast< long long >( baseFeatures.size() );
+    feedback->setProgress( i * step );
+  }
+}
+
 void QgsJoinByLocationAlgorithm::sortPredicates( QList<int> &predicates )
 {
   // Sort predicate list so that faster predicates are earlier in the list
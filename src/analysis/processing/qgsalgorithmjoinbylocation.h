@@ -58,6 +58,7 @@ class QgsJoinByLocationAlgorithm : public QgsProcessingAlgorithm
 
     void processAlgorithmByIteratingOverJoinedSource( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
     void processAlgorithmByIteratingOverInputSource( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+    void processAlgorithmWithJoinIndex( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
 
     enum JoinMethod
     {
@@ -75,8 +76,12 @@ class QgsJoinByLocationAlgorithm : public QgsProcessingAlgorithm
     std::unique_ptr< QgsFeatureSink > mUnjoinedFeatures;
     JoinMethod mJoinMethod = OneToMany;
     QList<int> mPredicates;
+    //! Largest join layer which is read in memory and indexed, instead of being queried from its source
+    long long mMaxIndexedJoinFeatures = 5000000;
 
     static void sortPredicates( QList<int > &predicates );
+
+    friend class TestQgsProcessingAlgs;
 };
 
 ///@endcond PRIVATE
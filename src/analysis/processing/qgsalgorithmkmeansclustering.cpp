@@ -17,11 +17,50 @@
 
 #include "qgsalgorithmkmeansclustering.h"
 #include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+#include <QThread>
+#include <QtConcurrentMap>
 
 ///@cond PRIVATE
 
 const int KMEANS_MAX_ITERATIONS = 1000;
 
+//! Number of points handled by each parallel task
+const std::size_t KMEANS_CHUNK_SIZE = 1 << 16;
+
+//! Safety margin on the triangle inequality bounds, against rounding errors on the distances
+const double KMEANS_PRUNING_TOLERANCE = 1 + 1e-9;
+
+static std::size_t chunkCount( std::size_t n )
+{
+  return std::max< std::size_t >( 1, ( n + KMEANS_CHUNK_SIZE - 1 ) / KMEANS_CHUNK_SIZE );
+}
+
+/**
+ * Calls \a function for each chunk of KMEANS_CHUNK_SIZE of the \a n points, in parallel.
+ * The chunks do not depend on the number of threads, so that results reduced in chunk order are reproducible.
+ */
+static void forEachChunk( std::size_t n, const std::function< void( std::size_t chunk, std::size_t begin, std::size_t end ) > &function )
+{
+  const std::size_t count = chunkCount( n );
+  if ( count == 1 || QThread::idealThreadCount() <= 1 )
+  {
+    for ( std::size_t chunk = 0; chunk < count; ++chunk )
+      function( chunk, chunk * KMEANS_CHUNK_SIZE, std::min( n, ( chunk + 1 ) * KMEANS_CHUNK_SIZE ) );
+    return;
+  }
+
+  std::vector< std::size_t > chunks( count );
+  std::iota( chunks.begin(), chunks.end(), 0 );
+  QtConcurrent::blockingMap( chunks, [&function, n]( std::size_t & chunk )
+  {
+    function( chunk, chunk * KMEANS_CHUNK_SIZE, std::min( n, ( chunk + 1 ) * KMEANS_CHUNK_SIZE ) );
+  } );
+}
+
 QString QgsKMeansClusteringAlgorithm::name() const
 {
   return QStringLiteral( "kmeansclustering" );
@@ -257,34 +296,58 @@ void QgsKMeansClusteringAlgorithm::initClusters( std::vector<Feature> &points, s
     std::vector< double > distances( n );
 
     // initialize array with distance to first object
-    for ( std::size_t j = 0; j < n; j++ )
+    forEachChunk( n, [&]( std::size_t, std::size_t begin, std::size_t end )
     {
-      distances[j] = points[j].point.sqrDist( centers[0] );
-    }
+      for ( std::size_t j = begin; j < end; j++ )
+      {
+        distances[j] = points[j].point.sqrDist( centers[0] );
+      }
+    } );
     distances[p1] = -1;
     distances[p2] = -1;
 
+    // farthest point of each chunk
+    std::vector< std::size_t > chunkCandidates( chunkCount( n ) );
+    std::vector< double > chunkMaxDistances( chunkCount( n ) );
+
     // loop i on clusters, skip 0 and 1 as found already
     for ( int i = 2; i < k; i++ )
     {
-      std::size_t candidateCenter = 0;
-      double maxDistance = std::numeric_limits<double>::lowest();
-
-      // loop j on points
-      for ( std::size_t j = 0; j < n; j++ )
+      forEachChunk( n, [&]( std::size_t chunk, std::size_t begin, std::size_t end )
       {
-        // accepted clusters are already marked with distance = -1
-        if ( distances[j] < 0 )
-          continue;
+        std::size_t candidateCenter = 0;
+        double maxDistance = std::numeric_limits<double>::lowest();
 
-        // update minimal distance with previously accepted cluster
-        distances[j] = std::min( points[j].point.sqrDist( centers[i - 1] ), distances[j] );
+        // loop j on points
+        for ( std::size_t j = begin; j < end; j++ )
+        {
+          // accepted clusters are already marked with distance = -1
+          if ( distances[j] < 0 )
+            continue;
+
+          // update minimal distance with previously accepted cluster
+          distances[j] = std::min( points[j].point.sqrDist( centers[i - 1] ), distances[j] );
+
+          // greedily take a point that's farthest from any of accepted clusters
+          if ( distances[j] > maxDistance )
+          {
+            candidateCenter = j;
+            maxDistance = distances[j];
+          }
+        }
+        chunkCandidates[chunk] = candidateCenter;
+        chunkMaxDistances[chunk] = maxDistance;
+      } );
 
-        // greedily take a point that's farthest from any of accepted clusters
-        if ( distances[j] > maxDistance )
+      // the first farthest point, as if the points were scanned in a single pass
+      std::size_t candidateCenter = 0;
+      double maxDistance = std::numeric_limits<double>::lowest();
+      for ( std::size_t chunk = 0; chunk < chunkCandidates.size(); ++chunk )
+      {
+        if ( chunkMaxDistances[chunk] > maxDistance )
         {
-          candidateCenter = j;
-          maxDistance = distances[j];
+          candidateCenter = chunkCandidates[chunk];
+          maxDistance = chunkMaxDistances[chunk];
         }
       }
 
@@ -332,51 +395,107 @@ void QgsKMeansClusteringAlgorithm::findNearest( std::vector<QgsKMeansClusteringA
 {
   changed = false;
   std::size_t n = points.size();
-  for ( std::size_t i = 0; i < n; i++ )
-  {
-    Feature &point = points[i];
+  if ( n == 0 )
+    return;
 
-    // Initialize with distance to first cluster
-    double currentDistance = point.point.sqrDist( centers[0] );
-    int currentCluster = 0;
+  // distances between the centers: by the triangle inequality, a center c2 cannot be nearer to a
+  // point than c1 if d(c1, c2) > 2 * d(point, c1)
+  std::vector< double > centerDistances( static_cast< std::size_t >( k ) * k );
+  std::vector< double > halfNearestCenterDistances( k, std::numeric_limits< double >::max() );
+  for ( int i = 0; i < k; i++ )
+  {
+    for ( int j = 0; j < k; j++ )
+    {
+      const double distance = std::sqrt( centers[i].sqrDist( centers[j] ) );
+      centerDistances[ static_cast< std::size_t >( i ) * k + j ] = distance;
+      if ( i != j )
+        halfNearestCenterDistances[i] = std::min( halfNearestCenterDistances[i], distance / 2 );
+    }
+  }
 
-    // Check all other cluster centers and find the nearest
-    for ( int cluster = 1; cluster < k; cluster++ )
+  std::vector< char > chunkChanged( chunkCount( n ), 0 );
+  forEachChunk( n, [&]( std::size_t chunk, std::size_t begin, std::size_t end )
+  {
+    for ( std::size_t i = begin; i < end; i++ )
     {
-      const double distance = point.point.sqrDist( centers[cluster] );
-      if ( distance < currentDistance )
+      Feature &point = points[i];
+
+      // Initialize with distance to the current cluster, or to the first one
+      const int initialCluster = point.cluster >= 0 ? point.cluster : 0;
+      double currentDistance = point.point.sqrDist( centers[initialCluster] );
+      int currentCluster = initialCluster;
+
+      // Check the other cluster centers which may be nearer, and find the nearest
+      // (the first one in case of ties, as if all the centers were checked in order)
+      const double initialDistance = std::sqrt( currentDistance ) * KMEANS_PRUNING_TOLERANCE;
+      if ( initialDistance >= halfNearestCenterDistances[initialCluster] )
+      {
+        const double *distancesToInitial = centerDistances.data() + static_cast< std::size_t >( initialCluster ) * k;
+        for ( int cluster = 0; cluster < k; cluster++ )
+        {
+          if ( cluster == initialCluster || distancesToInitial[cluster] > 2 * initialDistance )
+            continue;
+
+          const double distance = point.point.sqrDist( centers[cluster] );
+          if ( distance < currentDistance || ( distance == currentDistance && cluster < currentCluster ) )
+          {
+            currentDistance = distance;
+            currentCluster = cluster;
+          }
+        }
+      }
+
+      // Store the nearest cluster this object is in
+      if ( point.cluster != currentCluster )
       {
-        currentDistance = distance;
-        currentCluster = cluster;
+        chunkChanged[chunk] = true;
+        point.cluster = currentCluster;
       }
     }
+  } );
 
-    // Store the nearest cluster this object is in
-    if ( point.cluster != currentCluster )
-    {
-      changed = true;
-      point.cluster = currentCluster;
-    }
-  }
+  changed = std::any_of( chunkChanged.begin(), chunkChanged.end(), []( char chunkHasChanged ) { return chunkHasChanged; } );
 }
 
 // ported from https://github.com/postgis/postgis/blob/svn-trunk/liblwgeom/lwkmeans.c
 
 void QgsKMeansClusteringAlgorithm::updateMeans( const std::vector<Feature> &points, std::vector<QgsPointXY> &centers, std::vector<uint> &weights, const int k )
 {
-  uint n = points.size();
+  const std::size_t n = points.size();
+
+  // sums of each chunk, added in chunk order. The means do not depend on the number of threads, but with
+  // more than KMEANS_CHUNK_SIZE points they are summed in another order than a single sequential sum, so
+  // they may differ from it by rounding.
+  const std::size_t chunks = chunkCount( n );
+  std::vector< QgsPointXY > chunkSums( chunks * k );
+  std::vector< uint > chunkWeights( chunks * k, 0 );
+  forEachChunk( n, [&]( std::size_t chunk, std::size_t begin, std::size_t end )
+  {
+    QgsPointXY *sums = chunkSums.data() + chunk * k;
+    uint *sumWeights = chunkWeights.data() + chunk * k;
+    for ( std::size_t i = begin; i < end; i++ )
+    {
+      int cluster = points[i].cluster;
+      sums[cluster] += QgsVector( points[i].point.x(),
+                                  points[i].point.y() );
+      sumWeights[cluster] += 1;
+    }
+  } );
+
   std::fill( weights.begin(), weights.end(), 0 );
   for ( int i = 0; i < k; i++ )
   {
     centers[i].setX( 0.0 );
     centers[i].setY( 0.0 );
   }
-  for ( uint i = 0; i < n; i++ )
+  for ( std::size_t chunk = 0; chunk < chunks; chunk++ )
   {
-    int cluster = points[i].cluster;
-    centers[cluster] += QgsVector( points[i].point.x(),
-                                   points[i].point.y() );
-    weights[cluster] += 1;
+    for ( int i = 0; i < k; i++ )
+    {
+      const QgsPointXY &sum = chunkSums[ chunk * k + i ];
+      centers[i] += QgsVector( sum.x(), sum.y() );
+      weights[i] += chunkWeights[ chunk * k + i ];
+    }
   }
   for ( int i = 0; i < k; i++ )
   {
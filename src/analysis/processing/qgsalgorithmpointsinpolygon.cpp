@@ -20,9 +20,145 @@
 #include "qgsgeometryengine.h"
 #include "qgsvectorlayer.h"
 #include "qgsapplication.h"
+#include "qgsgeometrycollection.h"
+#include "qgslinestring.h"
+#include "qgspolygon.h"
+
+#include <QThread>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 ///@cond PRIVATE
 
+//! Maximum number of points read in memory, larger layers are requested for each polygon
+constexpr long long MAX_LOADED_POINTS = 5000000;
+
+//! Average number of loaded points in a cell of the grid
+constexpr double POINTS_PER_CELL = 16;
+
+//! Loaded points tested by a single task
+constexpr std::size_t POINTS_PER_TASK = 1 << 16;
+
+/**
+ * Relative error bound of the orientation determinant, above the one of the classic floating point filter
+ * (as used by GEOS). Points closer to an edge than this are left to the geometry engine.
+ */
+constexpr double ORIENTATION_ERROR_BOUND = 1e-15;
+
+//! A ring of a polygon part, read from the coordinates of its line string
+struct PolygonRing
+{
+  const double *x = nullptr;
+  const double *y = nullptr;
+  int count = 0;
+};
+
+enum class PointLocation
+{
+  Interior,
+  Exterior, //!< Outside of the polygon, or on its boundary
+  Undecided, //!< Too close to an edge to be decided in floating point arithmetic
+};
+
+//! Loaded points tested by a task, and the points found in the polygon
+struct PointCountTask
+{
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  double count = 0;
+  std::vector< int > classes;
+  std::vector< std::size_t > invalidWeights;
+  std::vector< std::size_t > undecided;
+};
+
+/**
+ * Collects the rings of each part of the \a geometry in \a parts.
+ * Returns FALSE if the geometry has curved parts or rings.
+ */
+static bool polygonRings( const QgsAbstractGeometry *geometry, std::vector< std::vector< PolygonRing > > &parts )
+{
+  if ( const QgsGeometryCollection *collection = qgsgeometry_cast< const QgsGeometryCollection * >( geometry ) )
+  {
+    for ( int i = 0; i < collection->numGeometries(); ++i )
+    {
+      if ( !polygonRings( collection->geometryN( i ), parts ) )
+        return false;
+    }
+    return true;
+  }
+
+  const QgsPolygon *polygon = qgsgeometry_cast< const QgsPolygon * >( geometry );
+  if ( !polygon )
+    return false;
+  if ( !polygon->exteriorRing() )
+    return true;
+
+  std::vector< PolygonRing > rings;
+  for ( int i = -1; i < polygon->numInteriorRings(); ++i )
+  {
+    const QgsLineString *ring = qgsgeometry_cast< const QgsLineString * >( i < 0 ? polygon->exteriorRing() : polygon->interiorRing( i ) );
+    if ( !ring )
+      return false;
+
+    PolygonRing polygonRing;
+    polygonRing.x = ring->xData();
+    polygonRing.y = ring->yData();
+    polygonRing.count = ring->numPoints();
+    rings.emplace_back( polygonRing );
+  }
+  parts.emplace_back( std::move( rings ) );
+  return true;
+}
+
+/**
+ * Locates the point \a px, \a py in the polygon \a parts with the crossing number of a ray going towards +x,
+ * each part being the union of its rings under the even-odd rule.
+ */
+static PointLocation locatePoint( double px, double py, const std::vector< std::vector< PolygonRing > > &parts )
+{
+  for ( const std::vector< PolygonRing > &rings : parts )
+  {
+    bool inside = false;
+    for ( const PolygonRing &ring : rings )
+    {
+      // iterate over all the edges, including the one closing the ring
+      for ( int i = 0, j = ring.count - 1; i < ring.count; j = i++ )
+      {
+        const double ax = ring.x[j];
+        const double ay = ring.y[j];
+        const double bx = ring.x[i];
+        const double by = ring.y[i];
+
+        if ( ax == px && ay == py )
+          return PointLocation::Exterior; // on a vertex
+
+        if ( ( ay > py ) != ( by > py ) )
+        {
+          // the edge crosses the horizontal line of the point, the orientation of the point tells on which side
+          const double detLeft = ( ax - px ) * ( by - py );
+          const double detRight = ( ay - py ) * ( bx - px );
+          const double det = detLeft - detRight;
+          if ( std::fabs( det ) <= ORIENTATION_ERROR_BOUND * ( std::fabs( detLeft ) + std::fabs( detRight ) ) )
+            return PointLocation::Undecided;
+
+          if ( ( det > 0 ) == ( by > ay ) )
+            inside = !inside;
+        }
+        else if ( ay == py && by == py && ( ax < px ) != ( bx < px ) )
+        {
+          return PointLocation::Exterior; // on a horizontal edge
+        }
+      }
+    }
+
+    if ( inside )
+      return PointLocation::Interior;
+  }
+  return PointLocation::Exterior;
+}
+
 void QgsPointsInPolygonAlgorithm::initParameters( const QVariantMap &configuration )
 {
   mIsInPlace = configuration.value( QStringLiteral( "IN_PLACE" ) ).toBool();
@@ -162,8 +298,22 @@ bool QgsPointsInPolygonAlgorithm::prepareAlgorithm( const QVariantMap &parameter
     mPointAttributes.append( mClassFieldIndex );
   }
 
+  // single points are read once and counted from memory, unless there are too many of them
+  const long long pointCount = mPointSource->featureCount();
+  mCanLoadPoints = !QgsWkbTypes::isMultiType( mPointSource->wkbType() ) && pointCount >= 0 && pointCount <= MAX_LOADED_POINTS;
   if ( mPointSource->hasSpatialIndex() == QgsFeatureSource::SpatialIndexNotPresent )
-    feedback->pushWarning( QObject::tr( "No spatial index exists for points layer, performance will be severely degraded" ) );
+  {
+    // every request for a polygon would read the whole points layer
+    mRequestedPointsBeforeLoading = 0;
+    if ( !mCanLoadPoints )
+      feedback->pushWarning( QObject::tr( "No spatial index exists for points layer, performance will be severely degraded" ) );
+  }
+  else
+  {
+    // the points are only loaded once the requests for the polygons have returned as many points, so that
+    // a few small polygons are still counted from the spatial index of the points layer
+    mRequestedPointsBeforeLoading = pointCount;
+  }
 
   return true;
 }
@@ -184,54 +334,69 @@ QgsFeatureList QgsPointsInPolygonAlgorithm::processFeature( const QgsFeature &fe
   else
   {
     const QgsGeometry polyGeom = feature.geometry();
-    std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( polyGeom.constGet() ) );
-    engine->prepareGeometry();
 
-    double count = 0;
-    QSet< QVariant> classes;
+    if ( mCanLoadPoints && !mPointsLoaded && mRequestedPoints >= mRequestedPointsBeforeLoading )
+    {
+      mPointsLoaded = true;
+      mUseLoadedPoints = loadPoints( context, feedback );
+    }
 
-    QgsFeatureRequest req = QgsFeatureRequest().setFilterRect( polyGeom.boundingBox() ).setDestinationCrs( mCrs, context.transformContext() );
-    req.setSubsetOfAttributes( mPointAttributes );
-    QgsFeatureIterator it = mPointSource->getFeatures( req );
+    QgsAttributes attrs = feature.attributes();
+    double score = 0;
 
-    bool ok = false;
-    QgsFeature pointFeature;
-    while ( it.nextFeature( pointFeature ) )
+    if ( mUseLoadedPoints )
+    {
+      score = countLoadedPoints( polyGeom, feedback );
+    }
+    else
     {
-      if ( feedback->isCanceled() )
-        break;
+      std::unique_ptr< QgsGeometryEngine > engine( QgsGeometry::createGeometryEngine( polyGeom.constGet() ) );
+      engine->prepareGeometry();
+
+      double count = 0;
+      QSet< QVariant> classes;
 
-      if ( engine->contains( pointFeature.geometry().constGet() ) )
+      QgsFeatureRequest req = QgsFeatureRequest().setFilterRect( polyGeom.boundingBox() ).setDestinationCrs( mCrs, context.transformContext() );
+      req.setSubsetOfAttributes( mPointAttributes );
+      QgsFeatureIterator it = mPointSource->getFeatures( req );
+
+      bool ok = false;
+      QgsFeature pointFeature;
+      while ( it.nextFeature( pointFeature ) )
       {
-        if ( mWeightFieldIndex >= 0 )
+        if ( feedback->isCanceled() )
+          break;
+
+        mRequestedPoints++;
+        if ( engine->contains( pointFeature.geometry().constGet() ) )
         {
-          const QVariant weight = pointFeature.attribute( mWeightFieldIndex );
-          double pointWeight = weight.toDouble( &ok );
-          // Ignore fields with non-numeric values
-          if ( ok )
-            count += pointWeight;
+          if ( mWeightFieldIndex >= 0 )
+          {
+            const QVariant weight = pointFeature.attribute( mWeightFieldIndex );
+            double pointWeight = weight.toDouble( &ok );
+            // Ignore fields with non-numeric values
+            if ( ok )
+              count += pointWeight;
+            else
+              feedback->reportError( QObject::tr( "Weight field value “%1” is not a numeric value" ).arg( weight.toString() ) );
+          }
+          else if ( mClassFieldIndex >= 0 )
+          {
+            const QVariant pointClass = pointFeature.attribute( mClassFieldIndex );
+            classes.insert( pointClass );
+          }
           else
-            feedback->reportError( QObject::tr( "Weight field value “%1” is not a numeric value" ).arg( weight.toString() ) );
-        }
-        else if ( mClassFieldIndex >= 0 )
-        {
-          const QVariant pointClass = pointFeature.attribute( mClassFieldIndex );
-          classes.insert( pointClass );
-        }
-        else
-        {
-          count++;
+          {
+            count++;
+          }
         }
       }
-    }
-
-    QgsAttributes attrs = feature.attributes();
-    double score = 0;
 
-    if ( mClassFieldIndex >= 0 )
-      score = classes.size();
-    else
-      score = count;
+      if ( mClassFieldIndex >= 0 )
+        score = classes.size();
+      else
+        score = count;
+    }
 
     if ( mDestFieldIndex < 0 )
       attrs.append( score );
@@ -243,6 +408,243 @@ QgsFeatureList QgsPointsInPolygonAlgorithm::processFeature( const QgsFeature &fe
   }
 }
 
+bool QgsPointsInPolygonAlgorithm::loadPoints( QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  if ( QgsWkbTypes::isMultiType( mPointSource->wkbType() ) )
+    return false;
+
+  std::vector< double > pointX;
+  std::vector< double > pointY;
+  std::vector< double > pointWeight;
+  std::vector< int > pointClass;
+  QHash< std::size_t, QString > invalidWeights;
+  QHash< QVariant, int > classIds;
+  double xMin = std::numeric_limits< double >::max();
+  double yMin = std::numeric_limits< double >::max();
+  double xMax = std::numeric_limits< double >::lowest();
+  double yMax = std::numeric_limits< double >::lowest();
+
+  QgsFeatureRequest req = QgsFeatureRequest().setDestinationCrs( mCrs, context.transformContext() );
+  req.setSubsetOfAttributes( mPointAttributes );
+  QgsFeatureIterator it = mPointSource->getFeatures( req );
+  QgsFeature pointFeature;
+  while ( it.nextFeature( pointFeature ) )
+  {
+    if ( feedback->isCanceled() )
+      return false;
+
+    if ( !pointFeature.hasGeometry() )
+      continue;
+
+    const QgsGeometry pointGeom = pointFeature.geometry();
+    const QgsPoint *point = qgsgeometry_cast< const QgsPoint * >( pointGeom.constGet() );
+    if ( !point )
+      return false;
+    if ( point->isEmpty() )
+      continue;
+
+    // the feature count of the layer may be an estimate
+    if ( static_cast< long long >( pointX.size() ) >= MAX_LOADED_POINTS )
+      return false;
+
+    if ( mWeightFieldIndex >= 0 )
+    {
+      const QVariant weight = pointFeature.attribute( mWeightFieldIndex );
+      bool ok = false;
+      const double value = weight.toDouble( &ok );
+      if ( !ok )
+        invalidWeights.insert( pointX.size(), weight.toString() );
+      pointWeight.emplace_back( ok ? value : std::numeric_limits< double >::quiet_NaN() );
+    }
+    else if ( mClassFieldIndex >= 0 )
+    {
+      const QVariant value = pointFeature.attribute( mClassFieldIndex );
+      auto classIt = classIds.constFind( value );
+      if ( classIt == classIds.constEnd() )
+        classIt = classIds.insert( value, classIds.size() );
+      pointClass.emplace_back( classIt.value() );
+    }
+
+    pointX.emplace_back( point->x() );
+    pointY.emplace_back( point->y() );
+    xMin = std::min( xMin, point->x() );
+    yMin = std::min( yMin, point->y() );
+    xMax = std::max( xMax, point->x() );
+    yMax = std::max( yMax, point->y() );
+  }
+
+  const std::size_t pointCount = pointX.size();
+  if ( pointCount == 0 )
+    return true;
+
+  // square cells holding POINTS_PER_CELL points on average, with at most as many columns or rows as cells
+  const double cellCount = std::max( 1.0, static_cast< double >( pointCount ) / POINTS_PER_CELL );
+  const double width = xMax - xMin;
+  const double height = yMax - yMin;
+  mCellSize = std::max( { std::sqrt( width * height / cellCount ), width / cellCount, height / cellCount } );
+  if ( mCellSize <= 0 )
+    mCellSize = 1;
+  mGridExtent = QgsRectangle( xMin, yMin, xMax, yMax );
+  mGridColumns = std::min( static_cast< int >( width / mCellSize ) + 1, static_cast< int >( cellCount ) + 1 );
+  mGridRows = std::min( static_cast< int >( height / mCellSize ) + 1, static_cast< int >( cellCount ) + 1 );
+
+  // sort the points by cell, cells being stored row by row
+  const std::size_t cells = static_cast< std::size_t >( mGridColumns ) * static_cast< std::size_t >( mGridRows );
+  std::vector< std::size_t > pointCell( pointCount );
+  mCellStart.assign( cells + 1, 0 );
+  for ( std::size_t i = 0; i < pointCount; ++i )
+  {
+    const int column = std::min( static_cast< int >( ( pointX[i] - xMin ) / mCellSize ), mGridColumns - 1 );
+    const int row = std::min( static_cast< int >( ( pointY[i] - yMin ) / mCellSize ), mGridRows - 1 );
+    pointCell[i] = static_cast< std::size_t >( row ) * mGridColumns + column;
+    ++mCellStart[ pointCell[i] + 1 ];
+  }
+  std::partial_sum( mCellStart.begin(), mCellStart.end(), mCellStart.begin() );
+
+  std::vector< std::size_t > nextPosition( mCellStart.begin(), mCellStart.end() - 1 );
+  mPointX.resize( pointCount );
+  mPointY.resize( pointCount );
+  mPointWeight.resize( pointWeight.size() );
+  mPointClass.resize( pointClass.size() );
+  for ( std::size_t i = 0; i < pointCount; ++i )
+  {
+    const std::size_t position = nextPosition[ pointCell[i] ]++;
+    mPointX[ position ] = pointX[i];
+    mPointY[ position ] = pointY[i];
+    if ( !pointWeight.empty() )
+    {
+      mPointWeight[ position ] = pointWeight[i];
+      if ( std::isnan( pointWeight[i] ) && invalidWeights.contains( i ) )
+        mInvalidWeights.insert( position, invalidWeights.value( i ) );
+    }
+    if ( !pointClass.empty() )
+      mPointClass[ position ] = pointClass[i];
+  }
+
+  return true;
+}
+
+double QgsPointsInPolygonAlgorithm::countLoadedPoints( const QgsGeometry &polygon, QgsProcessingFeedback *feedback ) const
+{
+  const QgsRectangle bounds = polygon.boundingBox();
+  if ( mPointX.empty() || !bounds.intersects( mGridExtent ) )
+    return 0;
+
+  // clamped before the conversion, the bounds of a polygon can be arbitrarily far from the grid
+  const auto cellIndex = [this]( double offset, int cellCount )
+  {
+    return static_cast< int >( std::clamp( std::floor( offset / mCellSize ), 0.0, static_cast< double >( cellCount - 1 ) ) );
+  };
+
+  // the cells of a row covering the polygon bounding box are consecutive, so are their points
+  const int firstColumn = cellIndex( bounds.xMinimum() - mGridExtent.xMinimum(), mGridColumns );
+  const int lastColumn = cellIndex( bounds.xMaximum() - mGridExtent.xMinimum(), mGridColumns );
+  const int firstRow = cellIndex( bounds.yMinimum() - mGridExtent.yMinimum(), mGridRows );
+  const int lastRow = cellIndex( bounds.yMaximum() - mGridExtent.yMinimum(), mGridRows );
+
+  std::vector< PointCountTask > tasks;
+  for ( int row = firstRow; row <= lastRow; ++row )
+  {
+    const std::size_t rowCell = static_cast< std::size_t >( row ) * mGridColumns;
+    const std::size_t end = mCellStart[ rowCell + lastColumn + 1 ];
+    for ( std::size_t begin = mCellStart[ rowCell + firstColumn ]; begin < end; begin += POINTS_PER_TASK )
+    {
+      PointCountTask task;
+      task.begin = begin;
+      task.end = std::min( begin + POINTS_PER_TASK, end );
+      tasks.emplace_back( std::move( task ) );
+    }
+  }
+
+  auto addContainedPoint = [this]( PointCountTask & task, std::size_t point )
+  {
+    if ( mWeightFieldIndex >= 0 )
+    {
+      // Ignore fields with non-numeric values
+      if ( std::isnan( mPointWeight[ point ] ) && mInvalidWeights.contains( point ) )
+        task.invalidWeights.emplace_back( point );
+      else
+        task.count += mPointWeight[ point ];
+    }
+    else if ( mClassFieldIndex >= 0 )
+    {
+      task.classes.emplace_back( mPointClass[ point ] );
+    }
+    else
+    {
+      task.count++;
+    }
+  };
+
+  std::vector< std::vector< PolygonRing > > parts;
+  const bool isLinear = polygonRings( polygon.constGet(), parts );
+  auto countPoints = [this, &bounds, &parts, isLinear, &addContainedPoint]( PointCountTask & task )
+  {
+    for ( std::size_t point = task.begin; point < task.end; ++point )
+    {
+      const double x = mPointX[ point ];
+      const double y = mPointY[ point ];
+      if ( x < bounds.xMinimum() || x > bounds.xMaximum() || y < bounds.yMinimum() || y > bounds.yMaximum() )
+        continue;
+
+      switch ( isLinear ? locatePoint( x, y, parts ) : PointLocation::Undecided )
+      {
+        case PointLocation::Interior:
+          addContainedPoint( task, point );
+          break;
+
+        case PointLocation::Exterior:
+          break;
+
+        case PointLocation::Undecided:
+          task.undecided.emplace_back( point );
+          break;
+      }
+    }
+  };
+
+  if ( tasks.size() > 1 && QThread::idealThreadCount() > 1 )
+    QtConcurrent::blockingMap( tasks, countPoints );
+  else
+    std::for_each( tasks.begin(), tasks.end(), countPoints );
+
+  // the points which could not be located from the coordinates are tested by the geometry engine
+  PointCountTask undecidedTask;
+  std::unique_ptr< QgsGeometryEngine > engine;
+  for ( const PointCountTask &task : tasks )
+  {
+    for ( std::size_t point : task.undecided )
+    {
+      if ( !engine )
+      {
+        engine.reset( QgsGeometry::createGeometryEngine( polygon.constGet() ) );
+        engine->prepareGeometry();
+      }
+
+      const QgsPoint pointGeom( mPointX[ point ], mPointY[ point ] );
+      if ( engine->contains( &pointGeom ) )
+        addContainedPoint( undecidedTask, point );
+    }
+  }
+  tasks.emplace_back( std::move( undecidedTask ) );
+
+  double count = 0;
+  QSet< int > classes;
+  for ( const PointCountTask &task : tasks )
+  {
+    count += task.count;
+    for ( int pointClass : task.classes )
+      classes.insert( pointClass );
+    for ( std::size_t point : task.invalidWeights )
+      feedback->reportError( QObject::tr( "Weight field value “%1” is not a numeric value" ).arg( mInvalidWeights.value( point ) ) );
+  }
+
+  if ( mClassFieldIndex >= 0 )
+    return classes.size();
+  else
+    return count;
+}
+
 QgsFields QgsPointsInPolygonAlgorithm::outputFields( const QgsFields &inputFields ) const
 {
   if ( mIsInPlace )
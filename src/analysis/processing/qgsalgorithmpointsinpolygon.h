@@ -22,6 +22,9 @@
 
 #include "qgis.h"
 #include "qgsprocessingalgorithm.h"
+#include "qgsrectangle.h"
+
+#include <vector>
 
 ///@cond PRIVATE
 
@@ -60,6 +63,16 @@ class QgsPointsInPolygonAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     bool supportInPlaceEdit( const QgsMapLayer *layer ) const override;
 
   private:
+
+    /**
+     * Reads the points in memory, in the CRS of the polygons, and sorts them in a grid of cells.
+     * Returns FALSE if the points layer has features which are not single points, or too many points.
+     */
+    bool loadPoints( QgsProcessingContext &context, QgsProcessingFeedback *feedback );
+
+    //! Returns the count, the sum of weights or the number of classes of the loaded points contained in \a polygon
+    double countLoadedPoints( const QgsGeometry &polygon, QgsProcessingFeedback *feedback ) const;
+
     bool mIsInPlace = false;
     QString mFieldName;
     QString mWeightFieldName;
@@ -72,6 +85,28 @@ class QgsPointsInPolygonAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QgsAttributeList mPointAttributes;
     std::unique_ptr< QgsProcessingFeatureSource > mPointSource;
 
+    bool mCanLoadPoints = false;
+    //! Number of points returned by the requests for each polygon, before the points are loaded
+    long long mRequestedPoints = 0;
+    long long mRequestedPointsBeforeLoading = 0;
+    bool mPointsLoaded = false;
+    bool mUseLoadedPoints = false;
+    //! Coordinates of the loaded points, sorted by grid cell
+    std::vector< double > mPointX;
+    std::vector< double > mPointY;
+    //! Weight of each loaded point, NaN for a non-numeric weight
+    std::vector< double > mPointWeight;
+    //! Class of each loaded point, as an index in the distinct class values
+    std::vector< int > mPointClass;
+    //! Non-numeric weight values, by loaded point
+    QHash< std::size_t, QString > mInvalidWeights;
+    //! Position of the first point of each grid cell in the point vectors, followed by the number of points
+    std::vector< std::size_t > mCellStart;
+    QgsRectangle mGridExtent;
+    double mCellSize = 1;
+    int mGridColumns = 0;
+    int mGridRows = 0;
+
 };
 
 ///@endcond PRIVATE
@@ -91,19 +91,116 @@ bool QgsTransformAlgorithm::prepareAlgorithm( const QVariantMap &parameters, Qgs
   return true;
 }
 
-QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback *feedback )
+void QgsTransformAlgorithm::createTransform()
 {
-  QgsFeature feature = f;
-  if ( !mCreatedTransform )
+  if ( mCreatedTransform )
+    return;
+
+  mCreatedTransform = true;
+  if ( !mCoordOp.isEmpty() )
+    mTransformContext.addCoordinateOperation( sourceCrs(), mDestCrs, mCoordOp, false );
+  mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
+
+  mTransform.disableFallbackOperationHandler( true );
+}
+
+void QgsTransformAlgorithm::reportFallbackTransform( QgsProcessingFeedback *feedback )
+{
+  if ( !mWarnedAboutFallbackTransform && mTransform.fallbackOperationOccurred() )
+  {
+    if ( feedback )
+      feedback->reportError( QObject::tr( "An alternative, ballpark-only transform was used when transforming coordinates for one or more features. "
+                                          "(Possibly an incorrect choice of operation was made for transformations between these reference systems - check "
+                                          "that the selected operation is valid for the full extent of the input layer.)" ) );
+    mWarnedAboutFallbackTransform = true; // only warn once to avoid flooding the log
+  }
+}
+
+QVariantMap QgsTransformAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
+{
+  // features are reprojected in batches rather than one at a time, so that the geometries
+  // of a batch can be transformed in parallel
+  prepareSource( parameters, context );
+  QgsProcessingFeatureSource *input = source();
+
+  QString dest;
+  std::unique_ptr< QgsFeatureSink > sink( parameterAsSink( parameters, QStringLiteral( "OUTPUT" ), context, dest,
+                                          outputFields( input->fields() ),
+                                          outputWkbType( input->wkbType() ),
+                                          outputCrs( input->sourceCrs() ),
+                                          sinkFlags() ) );
+  if ( !sink )
+    throw QgsProcessingException( invalidSinkError( parameters, QStringLiteral( "OUTPUT" ) ) );
+
+  createTransform();
+
+  const long count = input->featureCount();
+  const double step = count > 0 ? 100.0 / count : 1;
+  long current = 0;
+
+  const int batchSize = 1000;
+  QgsFeatureList features;
+  features.reserve( batchSize );
+  QgsFeature f;
+  QgsFeatureIterator it = input->getFeatures( request(), sourceFlags() );
+  while ( !feedback->isCanceled() )
+  {
+    features.clear();
+    while ( features.size() < batchSize && it.nextFeature( f ) )
+      features << f;
+
+    if ( features.isEmpty() )
+      break;
+
+    transformFeatures( features, feedback );
+    sink->addFeatures( features, QgsFeatureSink::FastInsert );
+
+    current += features.size();
+    feedback->setProgress( current * step );
+  }
+
+  QVariantMap outputs;
+  outputs.insert( QStringLiteral( "OUTPUT" ), dest );
+  return outputs;
+}
+
+void QgsTransformAlgorithm::transformFeatures( QgsFeatureList &features, QgsProcessingFeedback *feedback )
+{
+  QVector< QgsGeometry > geometries;
+  geometries.reserve( features.size() );
+  for ( const QgsFeature &feature : std::as_const( features ) )
+    geometries << feature.geometry();
+
+  const QList< int > failed = mTransform.transformGeometries( geometries );
+
+  int nextFailed = 0;
+  for ( int i = 0; i < features.size(); ++i )
   {
-    mCreatedTransform = true;
-    if ( !mCoordOp.isEmpty() )
-      mTransformContext.addCoordinateOperation( sourceCrs(), mDestCrs, mCoordOp, false );
-    mTransform = QgsCoordinateTransform( sourceCrs(), mDestCrs, mTransformContext );
+    QgsFeature &feature = features[i];
+    if ( !feature.hasGeometry() )
+      continue;
 
-    mTransform.disableFallbackOperationHandler( true );
+    if ( nextFailed < failed.size() && failed.at( nextFailed ) == i )
+    {
+      if ( feedback )
+        feedback->reportError( QObject::tr( "Encountered a transform error when reprojecting feature with id %1." ).arg( feature.id() ) );
+      feature.clearGeometry();
+      nextFailed++;
+    }
+    else
+    {
+      feature.setGeometry( geometries.at( i ) );
+    }
   }
 
+  reportFallbackTransform( feedback );
+}
+
+QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsProcessingContext &, QgsProcessingFeedback *feedback )
+{
+  QgsFeature feature = f;
+  createTransform();
+
   if ( feature.hasGeometry() )
   {
     QgsGeometry g = feature.geometry();
@@ -118,13 +215,7 @@ QgsFeatureList QgsTransformAlgorithm::processFeature( const QgsFeature &f, QgsPr
         feature.clearGeometry();
       }
 
-      if ( !mWarnedAboutFallbackTransform && mTransform.fallbackOperationOccurred() )
-      {
-        feedback->reportError( QObject::tr( "An alternative, ballpark-only transform was used when transforming coordinates for one or more features. "
-                                            "(Possibly an incorrect choice of operation was made for transformations between these reference systems - check "
-                                            "that the selected operation is valid for the full extent of the input layer.)" ) );
-        mWarnedAboutFallbackTransform = true; // only warn once to avoid flooding the log
-      }
+      reportFallbackTransform( feedback );
     }
     catch ( QgsCsException & )
     {
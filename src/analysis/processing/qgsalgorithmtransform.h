@@ -50,10 +50,19 @@ class QgsTransformAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QgsProcessingFeatureSource::Flag sourceFlags() const override;
 
     bool prepareAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
+    QVariantMap processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
     QgsFeatureList processFeature( const QgsFeature &feature,  QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 
   private:
 
+    //! Creates the transform on first use
+    void createTransform();
+
+    //! Reprojects a batch of \a features, distributing the geometries over multiple threads
+    void transformFeatures( QgsFeatureList &features, QgsProcessingFeedback *feedback );
+
+    void reportFallbackTransform( QgsProcessingFeedback *feedback );
+
     bool mCreatedTransform = false;
     QgsCoordinateReferenceSystem mDestCrs;
     QgsCoordinateTransform mTransform;
@@ -18,6 +18,13 @@
 #include "qgsgeometryengine.h"
 #include "qgsprocessingalgorithm.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
 ///@cond PRIVATE
 
 bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes::GeometryType geometryType )
@@ -82,6 +89,98 @@ static bool sanitizeDifferenceResult( QgsGeometry &geom, QgsWkbTypes::GeometryTy
 }
 
 
+//! Features of the first layer overlaid at once by each thread
+static constexpr int OVERLAY_FEATURES_PER_THREAD = 64;
+
+//! Overlay of one feature of the first layer with the features of the second layer
+struct OverlayJob
+{
+  QgsFeature feature;                   //!< Feature of the first layer
+  QVector< QgsFeatureId > candidateIds; //!< Features of the second layer whose bounding box intersects the feature, by ascending id
+  QVector< QgsGeometry > candidates;    //!< Geometries of the candidate features
+  QgsFeatureList output;                //!< Features to write to the sink
+  QString error;                        //!< Error raised by the overlay, if any
+};
+
+/**
+ * Reads the features of \a fitA in batches and overlays the features of each batch in parallel with \a overlay.
+ *
+ * The candidates of each feature are taken from \a indexB, which must store the geometries of the features.
+ * They are sorted by ascending feature id. The features output by \a overlay are written to \a sink in the order
+ * of the features of \a fitA, so the result does not depend on the number of threads, which is the maximum thread
+ * count of the global thread pool, nor on the size of the batches.
+ */
+static void overlayInBatches( QgsFeatureIterator &fitA, const QgsSpatialIndex &indexB, const std::function< void( OverlayJob & ) > &overlay,
+                              QgsFeatureSink &sink, QgsProcessingFeedback *feedback, long &count, long totalCount )
+{
+  const int threadCount = std::max( 1, QThreadPool::globalInstance()->maxThreadCount() );
+  const int batchSize = threadCount * OVERLAY_FEATURES_PER_THREAD;
+
+  auto overlayJob = [&overlay]( OverlayJob & job )
+  {
+    try
+    {
+      overlay( job );
+    }
+    catch ( QgsProcessingException &e )
+    {
+      job.error = e.what();
+    }
+  };
+
+  std::vector< OverlayJob > jobs;
+  jobs.reserve( batchSize );
+  QgsFeature featA;
+  bool hasMoreFeatures = true;
+  while ( hasMoreFeatures )
+  {
+    // the features and the spatial index are only read from this thread
+    jobs.clear();
+    while ( static_cast< int >( jobs.size() ) < batchSize && ( hasMoreFeatures = fitA.nextFeature( featA ) ) )
+    {
+      OverlayJob job;
+      job.feature = featA;
+      if ( featA.hasGeometry() )
+      {
+        job.candidateIds = indexB.intersects( featA.geometry().boundingBox() ).toVector();
+        std::sort( job.candidateIds.begin(), job.candidateIds.end() );
+        job.candidates.reserve( job.candidateIds.size() );
+        for ( QgsFeatureId id : std::as_const( job.candidateIds ) )
+        {
+          // the geometries of the index are implicitly shared, and their lazily computed bounding boxes
+          // are not thread safe, so each job gets its own copy
+          const QgsGeometry geometry = indexB.geometry( id );
+          job.candidates << ( geometry.constGet() ? QgsGeometry( geometry.constGet()->clone() ) : geometry );
+        }
+      }
+      jobs.emplace_back( std::move( job ) );
+    }
+
+    if ( jobs.empty() || feedback->isCanceled() )
+      break;
+
+    if ( threadCount == 1 || jobs.size() == 1 )
+      std::for_each( jobs.begin(), jobs.end(), overlayJob );
+    else
+      QtConcurrent::blockingMap( jobs, overlayJob );
+
+    if ( feedback->isCanceled() )
+      break;
+
+    for ( OverlayJob &job : jobs )
+    {
+      if ( !job.error.isEmpty() )
+        throw QgsProcessingException( job.error );
+
+      sink.addFeatures( job.output, QgsFeatureSink::FastInsert );
+    }
+
+    count += static_cast< long >( jobs.size() );
+    feedback->setProgress( count / static_cast< double >( totalCount ) * 100. );
+  }
+}
+
+
 void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long &count, long totalCount, QgsOverlayUtils::DifferenceOutput outputAttrs )
 {
   QgsWkbTypes::GeometryType geometryType = QgsWkbTypes::geometryType( QgsWkbTypes::multiType( sourceA.wkbType() ) );
@@ -89,108 +188,95 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
   requestB.setNoAttributes();
   if ( outputAttrs != OutputBA )
     requestB.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-  QgsSpatialIndex indexB( sourceB.getFeatures( requestB ), feedback );
+  // keep the geometries of B in memory, so that the candidates of each feature of A do not need to be requested again
+  const QgsSpatialIndex indexB( sourceB.getFeatures( requestB ), feedback, QgsSpatialIndex::FlagStoreFeatureGeometries );
   if ( feedback->isCanceled() )
     return;
 
-  int fieldsCountA = sourceA.fields().count();
-  int fieldsCountB = sourceB.fields().count();
-  QgsAttributes attrs;
-  attrs.resize( outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB ) );
+  const int fieldsCountA = sourceA.fields().count();
+  const int fieldsCountB = sourceB.fields().count();
+  const int attrsCount = outputAttrs == OutputA ? fieldsCountA : ( fieldsCountA + fieldsCountB );
 
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
-  QgsFeatureRequest requestA;
-  requestA.setInvalidGeometryCheck( context.invalidGeometryCheck() );
-  if ( outputAttrs == OutputBA )
-    requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
-  QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
-  while ( fitA.nextFeature( featA ) )
+  auto overlay = [ = ]( OverlayJob & job )
   {
-    if ( feedback->isCanceled() )
-      break;
-
-    if ( featA.hasGeometry() )
+    const QgsFeature &featA = job.feature;
+    if ( !featA.hasGeometry() )
     {
-      QgsGeometry geom( featA.geometry() );
-      QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
+      // TODO: should we write out features that do not have geometry?
+      job.output << featA;
+      return;
+    }
 
-      QgsFeatureRequest request;
-      request.setFilterFids( intersects );
-      request.setNoAttributes();
-      if ( outputAttrs != OutputBA )
-        request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
+    QgsGeometry geom( featA.geometry() );
 
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
-      {
-        // use prepared geometries for faster intersection tests
-        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-        engine->prepareGeometry();
-      }
+    std::unique_ptr< QgsGeometryEngine > engine;
+    if ( !job.candidates.isEmpty() )
+    {
+      // use prepared geometries for faster intersection tests
+      engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
+      engine->prepareGeometry();
+    }
 
-      QVector<QgsGeometry> geometriesB;
-      QgsFeature featB;
-      QgsFeatureIterator fitB = sourceB.getFeatures( request );
-      while ( fitB.nextFeature( featB ) )
-      {
-        if ( feedback->isCanceled() )
-          break;
+    QVector<QgsGeometry> geometriesB;
+    for ( const QgsGeometry &geomB : std::as_const( job.candidates ) )
+    {
+      if ( feedback->isCanceled() )
+        return;
 
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
-      }
+      if ( engine->intersects( geomB.constGet() ) )
+        geometriesB << geomB;
+    }
 
-      if ( !geometriesB.isEmpty() )
+    if ( !geometriesB.isEmpty() )
+    {
+      QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
+      if ( !geomB.lastError().isEmpty() )
       {
-        QgsGeometry geomB = QgsGeometry::unaryUnion( geometriesB );
-        if ( !geomB.lastError().isEmpty() )
-        {
-          // This may happen if input geometries from a layer do not line up well (for example polygons
-          // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
-          // It is possible to get rid of this issue in two steps:
-          // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
-          // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
-          throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
-        }
-        geom = geom.difference( geomB );
+        // This may happen if input geometries from a layer do not line up well (for example polygons
+        // that are nearly touching each other, but there is a very tiny overlap or gap at one of the edges).
+        // It is possible to get rid of this issue in two steps:
+        // 1. snap geometries with a small tolerance (e.g. 1cm) using QgsGeometrySnapperSingleSource
+        // 2. fix geometries (removes polygons collapsed to lines etc.) using MakeValid
+        throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: unary union failed." ), geomB.lastError() ) );
       }
+      geom = geom.difference( geomB );
+    }
 
-      if ( !sanitizeDifferenceResult( geom, geometryType ) )
-        continue;
-
-      const QgsAttributes attrsA( featA.attributes() );
-      switch ( outputAttrs )
-      {
-        case OutputA:
-          attrs = attrsA;
-          break;
-        case OutputAB:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i] = attrsA[i];
-          break;
-        case OutputBA:
-          for ( int i = 0; i < fieldsCountA; ++i )
-            attrs[i + fieldsCountB] = attrsA[i];
-          break;
-      }
+    if ( !sanitizeDifferenceResult( geom, geometryType ) )
+      return;
 
-      QgsFeature outFeat;
-      outFeat.setGeometry( geom );
-      outFeat.setAttributes( attrs );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
-    }
-    else
+    QgsAttributes attrs( attrsCount );
+    const QgsAttributes attrsA( featA.attributes() );
+    switch ( outputAttrs )
     {
-      // TODO: should we write out features that do not have geometry?
-      sink.addFeature( featA, QgsFeatureSink::FastInsert );
+      case OutputA:
+        attrs = attrsA;
+        break;
+      case OutputAB:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i] = attrsA[i];
+        break;
+      case OutputBA:
+        for ( int i = 0; i < fieldsCountA; ++i )
+          attrs[i + fieldsCountB] = attrsA[i];
+        break;
     }
 
-    ++count;
-    feedback->setProgress( count / static_cast< double >( totalCount ) * 100. );
-  }
+    QgsFeature outFeat;
+    outFeat.setGeometry( geom );
+    outFeat.setAttributes( attrs );
+    job.output << outFeat;
+  };
+
+  QgsFeatureRequest requestA;
+  requestA.setInvalidGeometryCheck( context.invalidGeometryCheck() );
+  if ( outputAttrs == OutputBA )
+    requestA.setDestinationCrs( sourceB.sourceCrs(), context.transformContext() );
+  QgsFeatureIterator fitA = sourceA.getFeatures( requestA );
+  overlayInBatches( fitA, indexB, overlay, sink, feedback, count, totalCount );
 }
 
 
@@ -200,37 +286,32 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
   int attrCount = fieldIndicesA.count() + fieldIndicesB.count();
 
   QgsFeatureRequest request;
-  request.setNoAttributes();
+  request.setSubsetOfAttributes( fieldIndicesB );
   request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
 
-  QgsFeature outFeat;
-  QgsSpatialIndex indexB( sourceB.getFeatures( request ), feedback );
+  // keep the geometries and attributes of B in memory, so that the candidates of each feature of A do not need to be requested again
+  QHash< QgsFeatureId, QgsAttributes > attributesB;
+  const QgsSpatialIndex indexB( sourceB.getFeatures( request ), [&attributesB, feedback]( const QgsFeature & f )->bool
+  {
+    attributesB.insert( f.id(), f.attributes() );
+    return !feedback->isCanceled();
+  }, QgsSpatialIndex::FlagStoreFeatureGeometries );
   if ( feedback->isCanceled() )
     return;
 
   if ( totalCount == 0 )
     totalCount = 1;  // avoid division by zero
 
-  QgsFeature featA;
-  QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
-  while ( fitA.nextFeature( featA ) )
+  auto overlay = [ =, &attributesB ]( OverlayJob & job )
   {
-    if ( feedback->isCanceled() )
-      break;
-
+    const QgsFeature &featA = job.feature;
     if ( !featA.hasGeometry() )
-      continue;
+      return;
 
     QgsGeometry geom( featA.geometry() );
-    QgsFeatureIds intersects = qgis::listToSet( indexB.intersects( geom.boundingBox() ) );
-
-    QgsFeatureRequest request;
-    request.setFilterFids( intersects );
-    request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
-    request.setSubsetOfAttributes( fieldIndicesB );
 
     std::unique_ptr< QgsGeometryEngine > engine;
-    if ( !intersects.isEmpty() )
+    if ( !job.candidates.isEmpty() )
     {
       // use prepared geometries for faster intersection tests
       engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
@@ -242,14 +323,12 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
     for ( int i = 0; i < fieldIndicesA.count(); ++i )
       outAttributes[i] = attrsA[fieldIndicesA[i]];
 
-    QgsFeature featB;
-    QgsFeatureIterator fitB = sourceB.getFeatures( request );
-    while ( fitB.nextFeature( featB ) )
+    for ( int j = 0; j < job.candidates.size(); ++j )
     {
       if ( feedback->isCanceled() )
-        break;
+        return;
 
-      QgsGeometry tmpGeom( featB.geometry() );
+      const QgsGeometry &tmpGeom = job.candidates.at( j );
       if ( !engine->intersects( tmpGeom.constGet() ) )
         continue;
 
@@ -257,18 +336,19 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
-      const QgsAttributes attrsB( featB.attributes() );
+      const QgsAttributes attrsB( attributesB.value( job.candidateIds.at( j ) ) );
       for ( int i = 0; i < fieldIndicesB.count(); ++i )
         outAttributes[fieldIndicesA.count() + i] = attrsB[fieldIndicesB[i]];
 
+      QgsFeature outFeat;
       outFeat.setGeometry( intGeom );
       outFeat.setAttributes( outAttributes );
-      sink.addFeature( outFeat, QgsFeatureSink::FastInsert );
+      job.output << outFeat;
     }
+  };
 
-    ++count;
-    feedback->setProgress( count / static_cast<double >( totalCount ) * 100. );
-  }
+  QgsFeatureIterator fitA = sourceA.getFeatures( QgsFeatureRequest().setSubsetOfAttributes( fieldIndicesA ) );
+  overlayInBatches( fitA, indexB, overlay, sink, feedback, count, totalCount );
 }
 
 void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatureSink &sink, QgsProcessingFeedback *feedback )
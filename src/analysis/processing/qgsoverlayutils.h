@@ -41,8 +41,19 @@ namespace QgsOverlayUtils
     OutputBA,  //!< Write attributes of both layers, inverted (first attributes of B, then attributes of A)
   };
 
+  /**
+   * Writes to \a sink the parts of the features of \a sourceA which are not covered by the features of \a sourceB.
+   *
+   * The features of \a sourceA are overlaid in parallel batches, and written in the order they are read.
+   */
   void difference( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long &count, long totalCount, DifferenceOutput outputAttrs );
 
+  /**
+   * Writes to \a sink the intersections of the features of \a sourceA with the features of \a sourceB.
+   *
+   * The features of \a sourceA are overlaid in parallel batches, and their intersections are written in the order
+   * the features of \a sourceA are read, then by ascending feature id of \a sourceB.
+   */
   void intersection( const QgsFeatureSource &sourceA, const QgsFeatureSource &sourceB, QgsFeatureSink &sink, QgsProcessingContext &context, QgsProcessingFeedback *feedback, long &count, long totalCount, const QList<int> &fieldIndicesA, const QList<int> &fieldIndicesB );
 
   //! Makes sure that what came out from intersection of two geometries is good to be used in the output
@@ -18,10 +18,16 @@
 #include <gdalwarper.h>
 #include <ogr_srs_api.h>
 #include <cpl_conv.h>
+#include <cpl_string.h>
 #include <limits>
+#include <atomic>
+#include <vector>
 
 #include <QPair>
 #include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 
 #include "qgscoordinatereferencesystem.h"
 #include "qgsrectangle.h"
@@ -363,6 +369,10 @@ bool QgsAlignRaster::run()
 
   //dump();
 
+  const int concurrentCount = mMaximumConcurrentRasters > 0 ? mMaximumConcurrentRasters : QThread::idealThreadCount();
+  if ( concurrentCount > 1 && !mRasters.isEmpty() )
+    return runConcurrently( concurrentCount );
+
   const auto constMRasters = mRasters;
   for ( const Item &r : constMRasters )
   {
@@ -418,12 +428,57 @@ int QgsAlignRaster::suggestedReferenceLayer() const
 }
 
 
-bool QgsAlignRaster::createAndWarp( const Item &raster )
+///@cond PRIVATE
+
+//! Minimum size in bytes of the chunks warped by GDAL when rasters are aligned concurrently (GDAL default)
+static constexpr double MIN_WARP_MEMORY_LIMIT = 64 * 1024 * 1024;
+//! Size in bytes of the chunks warped at the same time by all the rasters aligned concurrently
+static constexpr double TOTAL_WARP_MEMORY_LIMIT = 1024 * 1024 * 1024;
+//! Interval between two progress reports when rasters are aligned concurrently
+static constexpr int PROGRESS_INTERVAL_MS = 100;
+
+//! Progress of one raster aligned concurrently with other rasters
+struct QgsAlignRasterProgress
 {
+  std::atomic<double> complete{ 0 };
+  std::atomic_bool *canceled = nullptr;
+};
+
+static int CPL_STDCALL _concurrentProgress( double dfComplete, const char *pszMessage, void *pProgressArg )
+{
+  Q_UNUSED( pszMessage )
+
+  QgsAlignRasterProgress *progress = static_cast< QgsAlignRasterProgress * >( pProgressArg );
+  progress->complete = dfComplete;
+  return !*progress->canceled;
+}
+
+//! Returns whether the aligned raster must be written as a warped VRT instead of a GeoTIFF
+static bool isVrtOutput( const QString &filename )
+{
+  return filename.endsWith( QLatin1String( ".vrt" ), Qt::CaseInsensitive );
+}
+
+/**
+ * Creates the aligned raster of \a raster on the grid defined by \a crsWkt, \a geoTransform, \a xSize and \a ySize.
+ *
+ * A \a warpThreadCount greater than 1 splits the warping of each chunk between several threads, and a \a warpMemoryLimit
+ * greater than 0 sets the size in bytes of the chunks. Returns FALSE and sets \a errorMessage on error.
+ */
+static bool warpRaster( const QgsAlignRaster::Item &raster, const QString &crsWkt, const double *geoTransform, int xSize, int ySize, double cellArea,
+                        GDALProgressFunc progressFunction, void *progressArg, int warpThreadCount, double warpMemoryLimit, QString &errorMessage )
+{
+  const bool vrtOutput = isVrtOutput( raster.outputFilename );
+  if ( vrtOutput && raster.rescaleValues )
+  {
+    errorMessage = QObject::tr( "Rescaling of values is not supported for a VRT output: %1" ).arg( raster.outputFilename );
+    return false;
+  }
+
   GDALDriverH hDriver = GDALGetDriverByName( "GTiff" );
-  if ( !hDriver )
+  if ( !hDriver && !vrtOutput )
   {
-    mErrorMessage = QStringLiteral( "GDALGetDriverByName(GTiff) failed." );
+    errorMessage = QStringLiteral( "GDALGetDriverByName(GTiff) failed." );
     return false;
   }
 
@@ -431,7 +486,7 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
   gdal::dataset_unique_ptr hSrcDS( GDALOpen( raster.inputFilename.toLocal8Bit().constData(), GA_ReadOnly ) );
   if ( !hSrcDS )
   {
-    mErrorMessage = QObject::tr( "Unable to open input file: %1" ).arg( raster.inputFilename );
+    errorMessage = QObject::tr( "Unable to open input file: %1" ).arg( raster.inputFilename );
     return false;
   }
 
@@ -440,22 +495,26 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
   int bandCount = GDALGetRasterCount( hSrcDS.get() );
   GDALDataType eDT = GDALGetRasterDataType( GDALGetRasterBand( hSrcDS.get(), 1 ) );
 
-  // Create the output file.
-  gdal::dataset_unique_ptr hDstDS( GDALCreate( hDriver, raster.outputFilename.toLocal8Bit().constData(), mXSize, mYSize,
-                                   bandCount, eDT, nullptr ) );
-  if ( !hDstDS )
+  // Create the output file. A VRT output is created once the warp options are known
+  gdal::dataset_unique_ptr hDstDS;
+  if ( !vrtOutput )
   {
-    mErrorMessage = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
-    return false;
-  }
+    hDstDS.reset( GDALCreate( hDriver, raster.outputFilename.toLocal8Bit().constData(), xSize, ySize,
+                              bandCount, eDT, nullptr ) );
+    if ( !hDstDS )
+    {
+      errorMessage = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+      return false;
+    }
 
-  // Write out the projection definition.
-  GDALSetProjection( hDstDS.get(), mCrsWkt.toLatin1().constData() );
-  GDALSetGeoTransform( hDstDS.get(), mGeoTransform );
+    // Write out the projection definition.
+    GDALSetProjection( hDstDS.get(), crsWkt.toLatin1().constData() );
+    GDALSetGeoTransform( hDstDS.get(), const_cast< double * >( geoTransform ) );
+  }
 
   // Copy the color table, if required.
   GDALColorTableH hCT = GDALGetRasterColorTable( GDALGetRasterBand( hSrcDS.get(), 1 ) );
-  if ( hCT )
+  if ( hCT && hDstDS )
     GDALSetRasterColorTable( GDALGetRasterBand( hDstDS.get(), 1 ), hCT );
 
   // -----------------------------------------------------------------------
@@ -476,22 +535,64 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
 
   psWarpOptions->eResampleAlg = static_cast< GDALResampleAlg >( raster.resampleMethod );
 
+  if ( warpThreadCount > 1 )
+    psWarpOptions->papszWarpOptions = CSLSetNameValue( psWarpOptions->papszWarpOptions, "NUM_THREADS", QString::number( warpThreadCount ).toLatin1().constData() );
+  if ( warpMemoryLimit > 0 )
+    psWarpOptions->dfWarpMemoryLimit = warpMemoryLimit;
+
   // our progress function
-  psWarpOptions->pfnProgress = _progress;
-  psWarpOptions->pProgressArg = this;
+  psWarpOptions->pfnProgress = progressFunction;
+  psWarpOptions->pProgressArg = progressArg;
 
   // Establish reprojection transformer.
-  psWarpOptions->pTransformerArg =
-    GDALCreateGenImgProjTransformer( hSrcDS.get(), GDALGetProjectionRef( hSrcDS.get() ),
-                                     hDstDS.get(), GDALGetProjectionRef( hDstDS.get() ),
-                                     FALSE, 0.0, 1 );
+  if ( vrtOutput )
+  {
+    // the destination of the transformer is the grid of the VRT, which does not exist yet
+    psWarpOptions->pTransformerArg =
+      GDALCreateGenImgProjTransformer( hSrcDS.get(), GDALGetProjectionRef( hSrcDS.get() ),
+                                       nullptr, crsWkt.toLatin1().constData(),
+                                       FALSE, 0.0, 1 );
+    if ( psWarpOptions->pTransformerArg )
+      GDALSetGenImgProjTransformerDstGeoTransform( psWarpOptions->pTransformerArg, geoTransform );
+  }
+  else
+  {
+    psWarpOptions->pTransformerArg =
+      GDALCreateGenImgProjTransformer( hSrcDS.get(), GDALGetProjectionRef( hSrcDS.get() ),
+                                       hDstDS.get(), GDALGetProjectionRef( hDstDS.get() ),
+                                       FALSE, 0.0, 1 );
+  }
   psWarpOptions->pfnTransformer = GDALGenImgProjTransform;
 
+  if ( vrtOutput )
+  {
+    if ( !psWarpOptions->pTransformerArg )
+    {
+      errorMessage = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+      return false;
+    }
+
+    // the warped VRT takes ownership of the transformer, and only stores how to warp the source raster.
+    // It is written to its description when it is closed
+    gdal::dataset_unique_ptr hVrtDS( GDALCreateWarpedVRT( hSrcDS.get(), xSize, ySize, const_cast< double * >( geoTransform ), psWarpOptions.get() ) );
+    if ( !hVrtDS )
+    {
+      GDALDestroyGenImgProjTransformer( psWarpOptions->pTransformerArg );
+      errorMessage = QObject::tr( "Unable to create output file: %1" ).arg( raster.outputFilename );
+      return false;
+    }
+    GDALSetDescription( hVrtDS.get(), raster.outputFilename.toLocal8Bit().constData() );
+    GDALSetProjection( hVrtDS.get(), crsWkt.toLatin1().constData() );
+    if ( hCT )
+      GDALSetRasterColorTable( GDALGetRasterBand( hVrtDS.get(), 1 ), hCT );
+    return true;
+  }
+
   double rescaleArg[2];
   if ( raster.rescaleValues )
   {
     rescaleArg[0] = raster.srcCellSizeInDestCRS; // source cell size
-    rescaleArg[1] = mCellSizeX * mCellSizeY;  // destination cell size
+    rescaleArg[1] = cellArea;  // destination cell size
     psWarpOptions->pfnPreWarpChunkProcessor = rescalePreWarpChunkProcessor;
     psWarpOptions->pfnPostWarpChunkProcessor = rescalePostWarpChunkProcessor;
     psWarpOptions->pPreWarpProcessorArg = rescaleArg;
@@ -503,12 +604,76 @@ bool QgsAlignRaster::createAndWarp( const Item &raster )
   // Initialize and execute the warp operation.
   GDALWarpOperation oOperation;
   oOperation.Initialize( psWarpOptions.get() );
-  oOperation.ChunkAndWarpImage( 0, 0, mXSize, mYSize );
+  if ( warpThreadCount > 1 )
+    oOperation.ChunkAndWarpMulti( 0, 0, xSize, ySize );
+  else
+    oOperation.ChunkAndWarpImage( 0, 0, xSize, ySize );
 
   GDALDestroyGenImgProjTransformer( psWarpOptions->pTransformerArg );
   return true;
 }
 
+///@endcond
+
+bool QgsAlignRaster::createAndWarp( const Item &raster )
+{
+  return warpRaster( raster, mCrsWkt, mGeoTransform, mXSize, mYSize, mCellSizeX * mCellSizeY, _progress, this, 1, 0, mErrorMessage );
+}
+
+bool QgsAlignRaster::runConcurrently( int concurrentCount )
+{
+  const int rasterCount = mRasters.count();
+  concurrentCount = std::min( concurrentCount, rasterCount );
+
+  // share the cores and the warp memory between the rasters aligned at the same time
+  const int warpThreadCount = std::max( 1, QThread::idealThreadCount() / concurrentCount );
+  const double warpMemoryLimit = std::max( MIN_WARP_MEMORY_LIMIT, TOTAL_WARP_MEMORY_LIMIT / concurrentCount );
+
+  std::atomic_bool canceled{ false };
+  std::vector< QgsAlignRasterProgress > progress( rasterCount );
+  std::vector< QString > errors( rasterCount );
+  std::vector< char > results( rasterCount, false );
+
+  QThreadPool pool;
+  pool.setMaxThreadCount( concurrentCount );
+  for ( int i = 0; i < rasterCount; ++i )
+  {
+    progress[i].canceled = &canceled;
+    QtConcurrent::run( &pool, [ =, &progress, &errors, &results ]
+    {
+      results[i] = warpRaster( mRasters.at( i ), mCrsWkt, mGeoTransform, mXSize, mYSize, mCellSizeX * mCellSizeY,
+      _concurrentProgress, &progress[i], warpThreadCount, warpMemoryLimit, errors[i] );
+    } );
+  }
+
+  // progress is reported from this thread, as handlers are not required to be thread safe
+  auto reportProgress = [this, &progress, &canceled, rasterCount]
+  {
+    if ( !mProgressHandler )
+      return;
+
+    double complete = 0;
+    for ( const QgsAlignRasterProgress &p : progress )
+      complete += p.complete;
+    if ( !mProgressHandler->progress( complete / rasterCount ) )
+      canceled = true;
+  };
+
+  while ( !pool.waitForDone( PROGRESS_INTERVAL_MS ) )
+    reportProgress();
+  reportProgress();
+
+  for ( int i = 0; i < rasterCount; ++i )
+  {
+    if ( !results[i] )
+    {
+      mErrorMessage = errors[i];
+      return false;
+    }
+  }
+  return true;
+}
+
 bool QgsAlignRaster::suggestedWarpOutput( const QgsAlignRaster::RasterInfo &info, const QString &destWkt, QSizeF *cellSize, QPointF *gridOffset, QgsRectangle *rect )
 {
   // Create a transformer that maps from source pixel/line coordinates
@@ -140,7 +140,13 @@ class ANALYSIS_EXPORT QgsAlignRaster
 
       //! filename of the source raster
       QString inputFilename;
-      //! filename of the newly created aligned raster (will be overwritten if exists already)
+      /**
+       * filename of the newly created aligned raster (will be overwritten if exists already)
+       *
+       * With a .vrt extension, a warped VRT is written instead of a GeoTIFF: it only describes how to
+       * warp the source raster, and the aligned values are computed when the VRT is read (rescaling of
+       * values is not supported in this case). A path in /vsimem/ keeps the output in memory.
+       */
       QString outputFilename;
       //! resampling method to be used
       QgsAlignRaster::ResampleAlg resampleMethod;
@@ -173,6 +179,28 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! Gets associated progress handler. May be NULLPTR (default)
     ProgressHandler *progressHandler() const { return mProgressHandler; }
 
+    /**
+     * Sets the maximum \a count of rasters aligned at the same time by run().
+     *
+     * With the default value of 1 the rasters are aligned one after the other. With a greater value the
+     * rasters are aligned concurrently, and the warping of each raster also uses several threads so that
+     * all the cores are used. A \a count of 0 aligns as many rasters at the same time as there are cores.
+     *
+     * When rasters are aligned concurrently, the progress handler is still called from the thread calling run().
+     *
+     * \see maximumConcurrentRasters()
+     * \since QGIS 3.22
+     */
+    void setMaximumConcurrentRasters( int count ) { mMaximumConcurrentRasters = count; }
+
+    /**
+     * Returns the maximum count of rasters aligned at the same time by run().
+     *
+     * \see setMaximumConcurrentRasters()
+     * \since QGIS 3.22
+     */
+    int maximumConcurrentRasters() const { return mMaximumConcurrentRasters; }
+
     //! Sets list of rasters that will be aligned
     void setRasters( const List &list ) { mRasters = list; }
     //! Gets list of rasters that will be aligned
@@ -271,6 +299,12 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! Internal function for processing of one raster (1. create output, 2. do the alignment)
     bool createAndWarp( const Item &raster );
 
+    /**
+     * Internal function aligning up to \a concurrentCount rasters at the same time
+     * \since QGIS 3.22
+     */
+    bool runConcurrently( int concurrentCount );
+
     //! Determine suggested output of raster warp to a different CRS. Returns TRUE on success
     static bool suggestedWarpOutput( const RasterInfo &info, const QString &destWkt, QSizeF *cellSize = nullptr, QPointF *gridOffset = nullptr, QgsRectangle *rect = nullptr );
 
@@ -281,6 +315,9 @@ class ANALYSIS_EXPORT QgsAlignRaster
     //! Object that facilitates reporting of progress / cancellation
     ProgressHandler *mProgressHandler = nullptr;
 
+    //! Maximum count of rasters aligned at the same time
+    int mMaximumConcurrentRasters = 1;
+
     //! Last error message from run()
     QString mErrorMessage;
 
@@ -18,8 +18,38 @@
 #include "qgsfeatureiterator.h"
 #include "qgsgeometry.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <map>
+
 #define NO_DATA -9999
 
+///@cond PRIVATE
+
+//! Size in pixels of the side of the tiles the surface is drawn by
+static constexpr int TILE_SIZE = 512;
+
+//! Number of points buffered before they are drawn on the surface
+static constexpr std::size_t MAX_PENDING_POINTS = 1 << 20;
+
+//! Number of tiles drawn at once by each thread
+static constexpr int TILES_PER_THREAD = 2;
+
+//! Part of the output raster and the pending points overlapping it
+struct KdeTile
+{
+  int xOffset = 0;
+  int yOffset = 0;
+  int width = 0;
+  int height = 0;
+  const std::vector< int > *points = nullptr;
+  std::vector< float > data;
+  bool valid = true;
+};
+
+///@endcond
+
 QgsKernelDensityEstimation::QgsKernelDensityEstimation( const QgsKernelDensityEstimation::Parameters &parameters, const QString &outputFile, const QString &outputFormat )
   : mSource( parameters.source )
   , mOutputFile( outputFile )
@@ -89,6 +119,10 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::prepare()
   if ( !createEmptyLayer( driver, mBounds, rows, cols ) )
     return FileCreationError;
 
+  mRows = rows;
+  mColumns = cols;
+  mPendingPoints.clear();
+
   // open the raster in GA_Update mode
   mDatasetH.reset( GDALOpen( mOutputFile.toUtf8().constData(), GA_Update ) );
   if ( !mDatasetH )
@@ -136,7 +170,6 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
     radius = feature.attribute( mRadiusField ).toDouble();
     buffer = radiusSizeInPixels( radius );
   }
-  int blockSize = 2 * buffer + 1; //Block SIDE would be more appropriate
 
   // calculate weight
   double weight = 1.0;
@@ -145,8 +178,6 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
     weight = feature.attribute( mWeightField ).toDouble();
   }
 
-  Result result = Success;
-
   //loop through all points in multipoint
   for ( QgsMultiPointXY::const_iterator pointIt = multiPoints.constBegin(); pointIt != multiPoints.constEnd(); ++pointIt )
   {
@@ -156,60 +187,185 @@ QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::addFeature( const
       continue;
     }
 
-    // calculate the pixel position
-    unsigned int xPosition = ( ( ( *pointIt ).x() - mBounds.xMinimum() ) / mPixelSize ) - buffer;
-    unsigned int yPosition = ( ( ( *pointIt ).y() - mBounds.yMinimum() ) / mPixelSize ) - buffer;
-    unsigned int yPositionIO = ( ( mBounds.yMaximum() - ( *pointIt ).y() ) / mPixelSize ) - buffer;
+    PendingPoint point;
+    point.x = pointIt->x();
+    point.y = pointIt->y();
+    point.weight = weight;
+    point.radius = radius;
+    point.buffer = buffer;
+    mPendingPoints.push_back( point );
+  }
+
+  if ( mPendingPoints.size() >= MAX_PENDING_POINTS )
+    return drawPendingPoints();
 
+  return Success;
+}
+
+QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::drawPendingPoints()
+{
+  if ( mPendingPoints.empty() )
+    return Success;
+
+  // bin the points by the tiles overlapped by their kernel, keeping them in the order they were added
+  const int tileColumns = ( mColumns + TILE_SIZE - 1 ) / TILE_SIZE;
+  std::map< qint64, std::vector< int > > tilePoints;
+  for ( int i = 0; i < static_cast< int >( mPendingPoints.size() ); ++i )
+  {
+    const PendingPoint &point = mPendingPoints[i];
+    const int blockSize = 2 * point.buffer + 1;
+    const int xPosition = static_cast< int >( ( ( point.x - mBounds.xMinimum() ) / mPixelSize ) - point.buffer );
+    const int yPositionIO = static_cast< int >( ( ( mBounds.yMaximum() - point.y ) / mPixelSize ) - point.buffer );
+
+    const int firstColumn = std::max( xPosition, 0 );
+    const int lastColumn = std::min( xPosition + blockSize, mColumns ) - 1;
+    const int firstRow = std::max( yPositionIO, 0 );
+    const int lastRow = std::min( yPositionIO + blockSize, mRows ) - 1;
+    if ( firstColumn > lastColumn || firstRow > lastRow )
+      continue;
 
-    // get the data
-    float *dataBuffer = ( float * ) CPLMalloc( sizeof( float ) * blockSize * blockSize );
-    if ( GDALRasterIO( mRasterBandH, GF_Read, xPosition, yPositionIO, blockSize, blockSize,
-                       dataBuffer, blockSize, blockSize, GDT_Float32, 0, 0 ) != CE_None )
+    for ( int tileRow = firstRow / TILE_SIZE; tileRow <= lastRow / TILE_SIZE; ++tileRow )
     {
-      result = RasterIoError;
+      for ( int tileColumn = firstColumn / TILE_SIZE; tileColumn <= lastColumn / TILE_SIZE; ++tileColumn )
+      {
+        tilePoints[ static_cast< qint64 >( tileRow ) * tileColumns + tileColumn ].push_back( i );
+      }
     }
+  }
 
-    for ( int xp = 0; xp < blockSize; xp++ )
+  // draws the points of a tile, in the order they were added
+  auto drawTile = [this]( KdeTile & tile )
+  {
+    if ( !tile.valid )
+      return;
+
+    std::vector< double > squaredDistancesX;
+    std::vector< double > squaredDistancesY;
+    for ( int index : *tile.points )
     {
-      for ( int yp = 0; yp < blockSize; yp++ )
+      const PendingPoint &point = mPendingPoints[index];
+      const int blockSize = 2 * point.buffer + 1;
+      const int xPosition = static_cast< int >( ( ( point.x - mBounds.xMinimum() ) / mPixelSize ) - point.buffer );
+      const int yPosition = static_cast< int >( ( ( point.y - mBounds.yMinimum() ) / mPixelSize ) - point.buffer );
+      const int yPositionIO = static_cast< int >( ( ( mBounds.yMaximum() - point.y ) / mPixelSize ) - point.buffer );
+
+      // part of the kernel block within the tile
+      const int xpStart = std::max( 0, tile.xOffset - xPosition );
+      const int xpEnd = std::min( blockSize, tile.xOffset + tile.width - xPosition );
+      const int ypStart = std::max( 0, tile.yOffset - yPositionIO );
+      const int ypEnd = std::min( blockSize, tile.yOffset + tile.height - yPositionIO );
+
+      // the distance from the point to the pixel centroids is separable, precompute its components
+      squaredDistancesX.resize( blockSize );
+      squaredDistancesY.resize( blockSize );
+      for ( int xp = xpStart; xp < xpEnd; ++xp )
       {
-        double pixelCentroidX = ( xPosition + xp + 0.5 ) * mPixelSize + mBounds.xMinimum();
-        double pixelCentroidY = ( yPosition + yp + 0.5 ) * mPixelSize + mBounds.yMinimum();
-
-        double distance = std::sqrt( std::pow( pixelCentroidX - ( *pointIt ).x(), 2.0 ) + std::pow( pixelCentroidY - ( *pointIt ).y(), 2.0 ) );
+        const double pixelCentroidX = ( xPosition + xp + 0.5 ) * mPixelSize + mBounds.xMinimum();
+        squaredDistancesX[xp] = std::pow( pixelCentroidX - point.x, 2.0 );
+      }
+      for ( int yp = ypStart; yp < ypEnd; ++yp )
+      {
+        const double pixelCentroidY = ( yPosition + yp + 0.5 ) * mPixelSize + mBounds.yMinimum();
+        squaredDistancesY[yp] = std::pow( pixelCentroidY - point.y, 2.0 );
+      }
 
-        // is pixel outside search bandwidth of feature?
-        if ( distance > radius )
+      for ( int yp = ypStart; yp < ypEnd; ++yp )
+      {
+        float *row = tile.data.data() + static_cast< std::size_t >( yPositionIO + yp - tile.yOffset ) * tile.width;
+        for ( int xp = xpStart; xp < xpEnd; ++xp )
         {
-          continue;
+          const double distance = std::sqrt( squaredDistancesX[xp] + squaredDistancesY[yp] );
+
+          // is pixel outside search bandwidth of feature?
+          if ( distance > point.radius )
+          {
+            continue;
+          }
+
+          const double pixelValue = point.weight * calculateKernelValue( distance, point.radius, mShape, mOutputValues );
+          float &pixel = row[ xPosition + xp - tile.xOffset ];
+          if ( pixel == NO_DATA )
+          {
+            pixel = 0;
+          }
+          pixel += pixelValue;
         }
+      }
+    }
+  };
 
-        double pixelValue = weight * calculateKernelValue( distance, radius, mShape, mOutputValues );
-        int pos = xp + blockSize * yp;
-        if ( dataBuffer[ pos ] == NO_DATA )
-        {
-          dataBuffer[ pos ] = 0;
-        }
-        dataBuffer[ pos ] += pixelValue;
+  Result result = Success;
+  const int threadCount = std::max( 1, QThread::idealThreadCount() );
+  const std::size_t tilesPerBatch = static_cast< std::size_t >( threadCount ) * TILES_PER_THREAD;
+
+  // tiles are read and written on this thread, and drawn in parallel by batches
+  std::vector< KdeTile > tiles;
+  tiles.reserve( tilesPerBatch );
+  auto drawTiles = [&]
+  {
+    for ( KdeTile &tile : tiles )
+    {
+      tile.data.resize( static_cast< std::size_t >( tile.width ) * tile.height );
+      if ( GDALRasterIO( mRasterBandH, GF_Read, tile.xOffset, tile.yOffset, tile.width, tile.height,
+                         tile.data.data(), tile.width, tile.height, GDT_Float32, 0, 0 ) != CE_None )
+      {
+        tile.valid = false;
+        result = RasterIoError;
       }
     }
-    if ( GDALRasterIO( mRasterBandH, GF_Write, xPosition, yPositionIO, blockSize, blockSize,
-                       dataBuffer, blockSize, blockSize, GDT_Float32, 0, 0 ) != CE_None )
+
+    if ( threadCount == 1 || tiles.size() == 1 )
     {
-      result = RasterIoError;
+      for ( KdeTile &tile : tiles )
+        drawTile( tile );
     }
-    CPLFree( dataBuffer );
+    else
+    {
+      QtConcurrent::blockingMap( tiles, drawTile );
+    }
+
+    for ( KdeTile &tile : tiles )
+    {
+      if ( tile.valid && GDALRasterIO( mRasterBandH, GF_Write, tile.xOffset, tile.yOffset, tile.width, tile.height,
+                                       tile.data.data(), tile.width, tile.height, GDT_Float32, 0, 0 ) != CE_None )
+      {
+        result = RasterIoError;
+      }
+    }
+    tiles.clear();
+  };
+
+  for ( auto it = tilePoints.cbegin(); it != tilePoints.cend(); ++it )
+  {
+    KdeTile tile;
+    tile.xOffset = static_cast< int >( it->first % tileColumns ) * TILE_SIZE;
+    tile.yOffset = static_cast< int >( it->first / tileColumns ) * TILE_SIZE;
+    tile.width = std::min( TILE_SIZE, mColumns - tile.xOffset );
+    tile.height = std::min( TILE_SIZE, mRows - tile.yOffset );
+    tile.points = &it->second;
+    tiles.emplace_back( std::move( tile ) );
+
+    if ( tiles.size() == tilesPerBatch )
+      drawTiles();
   }
+  if ( !tiles.empty() )
+    drawTiles();
 
+  mPendingPoints.clear();
   return result;
 }
 
 QgsKernelDensityEstimation::Result QgsKernelDensityEstimation::finalise()
 {
+  Result result = Success;
+  if ( mRasterBandH )
+    result = drawPendingPoints();
+
+  mPendingPoints.clear();
+  mPendingPoints.shrink_to_fit();
   mDatasetH.reset();
   mRasterBandH = nullptr;
-  return Success;
+  return result;
 }
 
 int QgsKernelDensityEstimation::radiusSizeInPixels( double radius ) const
@@ -19,6 +19,7 @@
 #include "qgsrectangle.h"
 #include "qgsogrutils.h"
 #include <QString>
+#include <vector>
 
 // GDAL includes
 #include <gdal.h>
@@ -122,13 +123,19 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
 
     /**
      * Adds a single feature to the KDE surface. prepare() must be called before adding features.
+     *
+     * Since QGIS 3.22 the points are buffered and drawn on the surface by tiles of the output raster,
+     * with the tiles computed in parallel. The surface is only complete once finalise() has been called,
+     * and errors writing the raster may be reported by a later call to addFeature() or by finalise().
+     *
      * \see prepare()
      * \see finalise()
      */
     Result addFeature( const QgsFeature &feature );
 
     /**
-     * Finalises the output file. Must be called after adding all features via addFeature().
+     * Finalises the output file, drawing the remaining buffered points. Must be called after adding all
+     * features via addFeature().
      * \see prepare()
      * \see addFeature()
      */
@@ -151,6 +158,19 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
 
     QgsRectangle calculateBounds() const;
 
+    //! Point waiting to be drawn on the surface
+    struct PendingPoint
+    {
+      double x = 0;
+      double y = 0;
+      double weight = 1;
+      double radius = 0;
+      int buffer = 0;
+    };
+
+    //! Draws the pending points on the output raster, tile by tile
+    Result drawPendingPoints();
+
     QgsFeatureSource *mSource = nullptr;
 
     QString mOutputFile;
@@ -167,6 +187,10 @@ class ANALYSIS_EXPORT QgsKernelDensityEstimation
     OutputValues mOutputValues;
 
     int mBufferSize;
+    int mRows = 0;
+    int mColumns = 0;
+
+    std::vector< PendingPoint > mPendingPoints;
 
     gdal::dataset_unique_ptr mDatasetH;
     GDALRasterBandH mRasterBandH;
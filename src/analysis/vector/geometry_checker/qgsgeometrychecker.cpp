@@ -221,6 +221,15 @@ bool QgsGeometryChecker::fixError( QgsGeometryCheckError *error, int method, boo
       continue;
     }
 
+    // Feature errors only depend on their own feature: if it was neither changed nor rechecked,
+    // the error cannot be affected by the changes nor match a new error
+    if ( err->check()->checkType() <= QgsGeometryCheck::FeatureCheck &&
+         !changes.value( err->layerId() ).contains( err->featureId() ) &&
+         !recheckFeatures.value( err->layerId() ).contains( err->featureId() ) )
+    {
+      continue;
+    }
+
     QgsGeometryCheckError::Status oldStatus = err->status();
 
     bool handled = err->handleChanges( changes );
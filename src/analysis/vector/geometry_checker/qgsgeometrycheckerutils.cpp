@@ -28,6 +28,8 @@
 #include "qgsfeedback.h"
 
 #include <qmath.h>
+#include <QCoreApplication>
+#include <QThread>
 
 QgsGeometryCheckerUtils::LayerFeature::LayerFeature( const QgsFeaturePool *pool,
     const QgsFeature &feature,
@@ -265,6 +267,15 @@ std::unique_ptr<QgsGeometryEngine> QgsGeometryCheckerUtils::createGeomEngine( co
   return std::make_unique<QgsGeos>( geometry, tolerance );
 }
 
+int QgsGeometryCheckerUtils::parallelBatchSize( int featuresPerThread )
+{
+  const int threadCount = QThread::idealThreadCount();
+  if ( threadCount <= 1 || !QCoreApplication::instance() || QThread::currentThread() == QCoreApplication::instance()->thread() )
+    return 1;
+
+  return threadCount * featuresPerThread;
+}
+
 QgsAbstractGeometry *QgsGeometryCheckerUtils::getGeomPart( QgsAbstractGeometry *geom, int partIdx )
 {
   if ( dynamic_cast<QgsGeometryCollection *>( geom ) )
@@ -221,6 +221,17 @@ class ANALYSIS_EXPORT QgsGeometryCheckerUtils
 
     static void filter1DTypes( QgsAbstractGeometry *geom );
 
+    /**
+     * Returns the number of features a check reads before checking them in parallel, with \a featuresPerThread
+     * features for each thread, or 1 if the features have to be checked one after the other on the current thread.
+     *
+     * Features are only checked in parallel off the main thread, where a check implemented in Python
+     * would block the workers (e.g. when rechecking after a fix).
+     *
+     * \since QGIS 3.22
+     */
+    static int parallelBatchSize( int featuresPerThread );
+
     /**
      * Returns the number of points in a polyline, accounting for duplicate start and end point if the polyline is closed
      * \returns The number of distinct points of the polyline
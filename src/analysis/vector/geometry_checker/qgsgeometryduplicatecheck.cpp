@@ -21,12 +21,35 @@
 #include "qgsfeaturepool.h"
 #include "qgsvectorlayer.h"
 
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+//! Number of features compared with their neighbors at once by each thread
+static constexpr int FEATURES_PER_THREAD = 16;
+
+//! Feature compared by a thread with the features of its layer and of the next layers, and its duplicates
+struct DuplicateCheckJob
+{
+  DuplicateCheckJob( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA, const QList<QString> &layerIdsB )
+    : layerFeatureA( layerFeatureA )
+    , layerIdsB( layerIdsB )
+  {}
+
+  QgsGeometryCheckerUtils::LayerFeature layerFeatureA;
+  QList<QString> layerIdsB;
+  QMap<QString, QList<QgsFeatureId>> duplicates;
+  QStringList messages;
+};
+
+///@endcond
+
 QString QgsGeometryDuplicateCheckError::duplicatesString( const QMap<QString, QgsFeaturePool *> &featurePools, const QMap<QString, QList<QgsFeatureId>> &duplicates )
 {
   QStringList str;
   for ( auto it = duplicates.constBegin(); it != duplicates.constEnd(); ++it )
   {
-    str.append( featurePools[it.key()]->layer()->name() + ":" );
+    str.append( featurePools[it.key()]->layerName() + ":" );
     QStringList ids;
     ids.reserve( it.value().length() );
     for ( QgsFeatureId id : it.value() )
@@ -44,27 +67,30 @@ void QgsGeometryDuplicateCheck::collectErrors( const QMap<QString, QgsFeaturePoo
   QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds( featurePools ) : ids.toMap();
   QgsGeometryCheckerUtils::LayerFeatures layerFeaturesA( featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true );
   QList<QString> layerIds = featureIds.keys();
-  for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA )
-  {
-    // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
-    layerIds.removeOne( layerFeatureA.layer()->id() );
 
+  // Features A are read sequentially and compared with their neighbors by batches in parallel,
+  // each of them with its own engine
+  const std::size_t batchSize = static_cast< std::size_t >( QgsGeometryCheckerUtils::parallelBatchSize( FEATURES_PER_THREAD ) );
+  const bool parallel = batchSize > 1;
+
+  auto processJob = [this, &featurePools]( DuplicateCheckJob & job )
+  {
+    const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA = job.layerFeatureA;
     const QgsGeometry geomA = layerFeatureA.geometry();
     const QgsRectangle bboxA = geomA.boundingBox();
     std::unique_ptr< QgsGeometryEngine > geomEngineA = QgsGeometryCheckerUtils::createGeomEngine( geomA.constGet(), mContext->tolerance );
     if ( !geomEngineA->isValid() )
     {
-      messages.append( tr( "Duplicate check failed for (%1): the geometry is invalid" ).arg( layerFeatureA.id() ) );
-      continue;
+      job.messages.append( tr( "Duplicate check failed for (%1): the geometry is invalid" ).arg( layerFeatureA.id() ) );
+      return;
     }
-    QMap<QString, QList<QgsFeatureId>> duplicates;
 
     const QgsWkbTypes::GeometryType geomType = geomA.type();
-    const QgsGeometryCheckerUtils::LayerFeatures layerFeaturesB( featurePools, QList<QString>() << layerFeatureA.layer()->id() << layerIds, bboxA, {geomType}, mContext );
+    const QgsGeometryCheckerUtils::LayerFeatures layerFeaturesB( featurePools, job.layerIdsB, bboxA, {geomType}, mContext );
     for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB )
     {
       // only report overlaps within same layer once
-      if ( layerFeatureA.layer()->id() == layerFeatureB.layer()->id() && layerFeatureB.feature().id() >= layerFeatureA.feature().id() )
+      if ( layerFeatureA.layerId() == layerFeatureB.layerId() && layerFeatureB.feature().id() >= layerFeatureA.feature().id() )
       {
         continue;
       }
@@ -74,18 +100,46 @@ void QgsGeometryDuplicateCheck::collectErrors( const QMap<QString, QgsFeaturePoo
       const bool equal = geomEngineA->isEqual( geomB.constGet(), &errMsg );
       if ( equal && errMsg.isEmpty() )
       {
-        duplicates[layerFeatureB.layer()->id()].append( layerFeatureB.feature().id() );
+        job.duplicates[layerFeatureB.layerId()].append( layerFeatureB.feature().id() );
       }
       else if ( !errMsg.isEmpty() )
       {
-        messages.append( tr( "Duplicate check failed for (%1, %2): %3" ).arg( layerFeatureA.id(), layerFeatureB.id(), errMsg ) );
+        job.messages.append( tr( "Duplicate check failed for (%1, %2): %3" ).arg( layerFeatureA.id(), layerFeatureB.id(), errMsg ) );
       }
     }
-    if ( !duplicates.isEmpty() )
+  };
+
+  std::vector< DuplicateCheckJob > jobs;
+  jobs.reserve( batchSize );
+  auto processJobs = [this, &jobs, &errors, &messages, &featurePools, &processJob, parallel]
+  {
+    if ( parallel && jobs.size() > 1 )
+      QtConcurrent::blockingMap( jobs, processJob );
+    else
+      std::for_each( jobs.begin(), jobs.end(), processJob );
+
+    // errors are added in the order of the features A
+    for ( const DuplicateCheckJob &job : jobs )
     {
-      errors.append( new QgsGeometryDuplicateCheckError( this, layerFeatureA, geomA.constGet()->centroid(), featurePools, duplicates ) );
+      messages.append( job.messages );
+      if ( !job.duplicates.isEmpty() )
+      {
+        errors.append( new QgsGeometryDuplicateCheckError( this, job.layerFeatureA, job.layerFeatureA.geometry().constGet()->centroid(), featurePools, job.duplicates ) );
+      }
     }
+    jobs.clear();
+  };
+
+  for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA )
+  {
+    // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
+    layerIds.removeOne( layerFeatureA.layerId() );
+
+    jobs.emplace_back( layerFeatureA, QList<QString>() << layerFeatureA.layerId() << layerIds );
+    if ( jobs.size() == batchSize )
+      processJobs();
   }
+  processJobs();
 }
 
 void QgsGeometryDuplicateCheck::fixError( const QMap<QString, QgsFeaturePool *> &featurePools, QgsGeometryCheckError *error, int method, const QMap<QString, int> & /*mergeAttributeIndices*/, Changes &changes ) const
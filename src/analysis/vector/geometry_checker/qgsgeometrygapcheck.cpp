@@ -30,6 +30,27 @@
 
 #include "geos_c.h"
 
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+//! Number of gaps whose neighbors are searched by each thread
+static constexpr int GAPS_PER_THREAD = 4;
+
+//! Gap whose neighboring features are searched by a thread
+struct GapCheckJob
+{
+  explicit GapCheckJob( const QgsAbstractGeometry *gapGeom )
+    : gapGeom( gapGeom )
+  {}
+
+  const QgsAbstractGeometry *gapGeom = nullptr;
+  QMap<QString, QgsFeatureIds> neighboringIds;
+  QgsRectangle gapAreaBBox;
+};
+
+///@endcond
+
 QgsGeometryGapCheck::QgsGeometryGapCheck( const QgsGeometryCheckContext *context, const QVariantMap &configuration )
   : QgsGeometryCheck( context, configuration )
   ,  mGapThresholdMapUnits( configuration.value( QStringLiteral( "gapThreshold" ) ).toDouble() )
@@ -143,7 +164,10 @@ void QgsGeometryGapCheck::collectErrors( const QMap<QString, QgsFeaturePool *> &
     return;
   }
 
-  // For each gap polygon which does not lie on the boundary, get neighboring polygons and add error
+  // For each gap polygon which does not lie on the boundary, get neighboring polygons and add error.
+  // The union is computed at once, as splitting it would split the gaps, but the neighbors of the gaps are
+  // searched in parallel, each gap with its own prepared engine.
+  std::vector< GapCheckJob > jobs;
   QgsGeometryPartIterator parts = diffGeom->parts();
   while ( parts.hasNext() )
   {
@@ -161,37 +185,50 @@ void QgsGeometryGapCheck::collectErrors( const QMap<QString, QgsFeaturePool *> &
       continue;
     }
 
-    QgsRectangle gapAreaBBox = gapGeom->boundingBox();
+    jobs.emplace_back( gapGeom );
+  }
 
+  const QList<QString> layerIds = featureIds.keys();
+  auto processJob = [this, &featurePools, &layerIds]( GapCheckJob & job )
+  {
     // Get neighboring polygons
-    QMap<QString, QgsFeatureIds> neighboringIds;
-    const QgsGeometryCheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds.keys(), gapAreaBBox, compatibleGeometryTypes(), mContext );
-    std::unique_ptr< QgsGeometryEngine > gapGeomEngine = QgsGeometryCheckerUtils::createGeomEngine( gapGeom, mContext->tolerance );
+    job.gapAreaBBox = job.gapGeom->boundingBox();
+    const QgsGeometryCheckerUtils::LayerFeatures layerFeatures( featurePools, layerIds, job.gapAreaBBox, compatibleGeometryTypes(), mContext );
+    std::unique_ptr< QgsGeometryEngine > gapGeomEngine = QgsGeometryCheckerUtils::createGeomEngine( job.gapGeom, mContext->tolerance );
     gapGeomEngine->prepareGeometry();
     for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeature : layerFeatures )
     {
       const QgsGeometry geom = layerFeature.geometry();
       if ( gapGeomEngine->distance( geom.constGet() ) < mContext->tolerance )
       {
-        neighboringIds[layerFeature.layer()->id()].insert( layerFeature.feature().id() );
-        gapAreaBBox.combineExtentWith( geom.boundingBox() );
+        job.neighboringIds[layerFeature.layerId()].insert( layerFeature.feature().id() );
+        job.gapAreaBBox.combineExtentWith( geom.boundingBox() );
       }
     }
+  };
 
-    if ( neighboringIds.isEmpty() )
+  if ( jobs.size() > 1 && QgsGeometryCheckerUtils::parallelBatchSize( GAPS_PER_THREAD ) > 1 )
+    QtConcurrent::blockingMap( jobs, processJob );
+  else
+    std::for_each( jobs.begin(), jobs.end(), processJob );
+
+  // the errors are added on this thread, which tests the gaps with the prepared engine of the allowed gaps
+  for ( const GapCheckJob &job : jobs )
+  {
+    if ( job.neighboringIds.isEmpty() )
     {
       continue;
     }
 
-    if ( allowedGapsGeomEngine && allowedGapsGeomEngine->contains( gapGeom ) )
+    if ( allowedGapsGeomEngine && allowedGapsGeomEngine->contains( job.gapGeom ) )
     {
       continue;
     }
 
     // Add error
-    double area = gapGeom->area();
-    QgsRectangle gapBbox = gapGeom->boundingBox();
-    errors.append( new QgsGeometryGapCheckError( this, QString(), QgsGeometry( gapGeom->clone() ), neighboringIds, area, gapBbox, gapAreaBBox ) );
+    double area = job.gapGeom->area();
+    QgsRectangle gapBbox = job.gapGeom->boundingBox();
+    errors.append( new QgsGeometryGapCheckError( this, QString(), QgsGeometry( job.gapGeom->clone() ), job.neighboringIds, area, gapBbox, job.gapAreaBBox ) );
   }
 }
 
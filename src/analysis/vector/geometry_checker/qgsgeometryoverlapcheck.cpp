@@ -21,6 +21,29 @@
 #include "qgsfeedback.h"
 #include "qgsapplication.h"
 
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+//! Number of features compared with their neighbors at once by each thread
+static constexpr int FEATURES_PER_THREAD = 16;
+
+//! Feature compared by a thread with the features of its layer and of the next layers, and the errors found
+struct OverlapCheckJob
+{
+  OverlapCheckJob( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA, const QList<QString> &layerIdsB )
+    : layerFeatureA( layerFeatureA )
+    , layerIdsB( layerIdsB )
+  {}
+
+  QgsGeometryCheckerUtils::LayerFeature layerFeatureA;
+  QList<QString> layerIdsB;
+  QList<QgsGeometryCheckError *> errors;
+  QStringList messages;
+};
+
+///@endcond
+
 QgsGeometryOverlapCheck::QgsGeometryOverlapCheck( const QgsGeometryCheckContext *context, const QVariantMap &configuration )
   : QgsGeometryCheck( context, configuration )
   , mOverlapThresholdMapUnits( configurationValue<double>( QStringLiteral( "maxOverlapArea" ) ) )
@@ -34,25 +57,26 @@ void QgsGeometryOverlapCheck::collectErrors( const QMap<QString, QgsFeaturePool
   QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds( featurePools ) : ids.toMap();
   const QgsGeometryCheckerUtils::LayerFeatures layerFeaturesA( featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext, true );
   QList<QString> layerIds = featureIds.keys();
-  for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA )
-  {
-    if ( feedback && feedback->isCanceled() )
-      break;
 
-    // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
-    layerIds.removeOne( layerFeatureA.layer()->id() );
+  // Features A are read sequentially and compared with their neighbors by batches in parallel,
+  // each of them with its own prepared engine
+  const std::size_t batchSize = static_cast< std::size_t >( QgsGeometryCheckerUtils::parallelBatchSize( FEATURES_PER_THREAD ) );
+  const bool parallel = batchSize > 1;
 
+  auto processJob = [this, &featurePools, feedback]( OverlapCheckJob & job )
+  {
+    const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA = job.layerFeatureA;
     const QgsGeometry geomA = layerFeatureA.geometry();
     QgsRectangle bboxA = geomA.boundingBox();
     std::unique_ptr< QgsGeometryEngine > geomEngineA = QgsGeometryCheckerUtils::createGeomEngine( geomA.constGet(), mContext->tolerance );
     geomEngineA->prepareGeometry();
     if ( !geomEngineA->isValid() )
     {
-      messages.append( tr( "Overlap check failed for (%1): the geometry is invalid" ).arg( layerFeatureA.id() ) );
-      continue;
+      job.messages.append( tr( "Overlap check failed for (%1): the geometry is invalid" ).arg( layerFeatureA.id() ) );
+      return;
     }
 
-    const QgsGeometryCheckerUtils::LayerFeatures layerFeaturesB( featurePools, QList<QString>() << layerFeatureA.layer()->id() << layerIds, bboxA, compatibleGeometryTypes(), mContext );
+    const QgsGeometryCheckerUtils::LayerFeatures layerFeaturesB( featurePools, job.layerIdsB, bboxA, compatibleGeometryTypes(), mContext );
     for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureB : layerFeaturesB )
     {
       if ( feedback && feedback->isCanceled() )
@@ -79,17 +103,49 @@ void QgsGeometryOverlapCheck::collectErrors( const QMap<QString, QgsFeaturePool
             double area = interPart->area();
             if ( area > mContext->reducedTolerance && ( area < mOverlapThresholdMapUnits || mOverlapThresholdMapUnits == 0.0 ) )
             {
-              errors.append( new QgsGeometryOverlapCheckError( this, layerFeatureA, QgsGeometry( interPart->clone() ), interPart->centroid(), area, layerFeatureB ) );
+              job.errors.append( new QgsGeometryOverlapCheckError( this, layerFeatureA, QgsGeometry( interPart->clone() ), interPart->centroid(), area, layerFeatureB ) );
             }
           }
         }
         else if ( !errMsg.isEmpty() )
         {
-          messages.append( tr( "Overlap check between features %1 and %2 %3" ).arg( layerFeatureA.id(), layerFeatureB.id(), errMsg ) );
+          job.messages.append( tr( "Overlap check between features %1 and %2 %3" ).arg( layerFeatureA.id(), layerFeatureB.id(), errMsg ) );
         }
       }
     }
+  };
+
+  std::vector< OverlapCheckJob > jobs;
+  jobs.reserve( batchSize );
+  auto processJobs = [&jobs, &errors, &messages, &processJob, parallel]
+  {
+    if ( parallel && jobs.size() > 1 )
+      QtConcurrent::blockingMap( jobs, processJob );
+    else
+      std::for_each( jobs.begin(), jobs.end(), processJob );
+
+    // errors are added in the order of the features A
+    for ( const OverlapCheckJob &job : jobs )
+    {
+      errors.append( job.errors );
+      messages.append( job.messages );
+    }
+    jobs.clear();
+  };
+
+  for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeatureA : layerFeaturesA )
+  {
+    if ( feedback && feedback->isCanceled() )
+      break;
+
+    // Ensure each pair of layers only gets compared once: remove the current layer from the layerIds, but add it to the layerList for layerFeaturesB
+    layerIds.removeOne( layerFeatureA.layerId() );
+
+    jobs.emplace_back( layerFeatureA, QList<QString>() << layerFeatureA.layerId() << layerIds );
+    if ( jobs.size() == batchSize )
+      processJobs();
   }
+  processJobs();
 }
 
 void QgsGeometryOverlapCheck::fixError( const QMap<QString, QgsFeaturePool *> &featurePools, QgsGeometryCheckError *error, int method, const QMap<QString, int> & /*mergeAttributeIndices*/, Changes &changes ) const
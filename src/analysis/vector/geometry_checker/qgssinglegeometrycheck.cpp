@@ -17,7 +17,25 @@ email                : matthias@opengis.ch
 #include "qgsgeometrycheckcontext.h"
 #include "qgspoint.h"
 
+#include <QtConcurrentMap>
 
+///@cond PRIVATE
+
+//! Number of features checked at once by each thread
+static constexpr int FEATURES_PER_THREAD = 64;
+
+//! Feature checked by a thread and the errors found
+struct SingleGeometryCheckJob
+{
+  explicit SingleGeometryCheckJob( const QgsGeometryCheckerUtils::LayerFeature &layerFeature )
+    : layerFeature( layerFeature )
+  {}
+
+  QgsGeometryCheckerUtils::LayerFeature layerFeature;
+  QList<QgsSingleGeometryCheckError *> errors;
+};
+
+///@endcond
 
 void QgsSingleGeometryCheck::collectErrors( const QMap<QString, QgsFeaturePool *> &featurePools,
     QList<QgsGeometryCheckError *> &errors,
@@ -26,12 +44,40 @@ void QgsSingleGeometryCheck::collectErrors( const QMap<QString, QgsFeaturePool *
   Q_UNUSED( messages )
   QMap<QString, QgsFeatureIds> featureIds = ids.isEmpty() ? allLayerFeatureIds( featurePools ) : ids.toMap();
   QgsGeometryCheckerUtils::LayerFeatures layerFeatures( featurePools, featureIds, compatibleGeometryTypes(), feedback, mContext );
+
+  // Features are read from the pools sequentially and checked by batches in parallel
+  const std::size_t batchSize = static_cast< std::size_t >( QgsGeometryCheckerUtils::parallelBatchSize( FEATURES_PER_THREAD ) );
+  const bool parallel = batchSize > 1;
+
+  std::vector< SingleGeometryCheckJob > jobs;
+  jobs.reserve( batchSize );
+  auto processJobs = [this, &jobs, &errors, parallel]
+  {
+    auto processJob = [this]( SingleGeometryCheckJob & job )
+    {
+      job.errors = processGeometry( job.layerFeature.geometry() );
+    };
+    if ( parallel && jobs.size() > 1 )
+      QtConcurrent::blockingMap( jobs, processJob );
+    else
+      std::for_each( jobs.begin(), jobs.end(), processJob );
+
+    // errors are added in the order of the features
+    for ( const SingleGeometryCheckJob &job : jobs )
+    {
+      for ( const auto error : job.errors )
+        errors.append( convertToGeometryCheckError( error, job.layerFeature ) );
+    }
+    jobs.clear();
+  };
+
   for ( const QgsGeometryCheckerUtils::LayerFeature &layerFeature : layerFeatures )
   {
-    const auto singleErrors = processGeometry( layerFeature.geometry() );
-    for ( const auto error : singleErrors )
-      errors.append( convertToGeometryCheckError( error, layerFeature ) );
+    jobs.emplace_back( layerFeature );
+    if ( jobs.size() == batchSize )
+      processJobs();
   }
+  processJobs();
 }
 
 QgsGeometryCheckErrorSingle *QgsSingleGeometryCheck::convertToGeometryCheckError( QgsSingleGeometryCheckError *singleGeometryCheckError, const QgsGeometryCheckerUtils::LayerFeature &layerFeature ) const
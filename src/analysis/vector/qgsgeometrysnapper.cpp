@@ -18,6 +18,7 @@
 #include "qgsgeometry.h"
 #include "qgsvectorlayer.h"
 #include "qgsgeometrysnapper.h"
+#include "qgsgeometrysnapper_p.h"
 #include "qgsvectordataprovider.h"
 #include "qgsgeometryutils.h"
 #include "qgsmapsettings.h"
@@ -26,6 +27,9 @@
 #include "qgscurve.h"
 
 #include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <geos_c.h>
 
 ///@cond PRIVATE
@@ -425,10 +429,139 @@ QgsSnapIndex::SnapItem *QgsSnapIndex::getSnapItem( const QgsPoint &pos, double t
 QgsGeometrySnapper::QgsGeometrySnapper( QgsFeatureSource *referenceSource )
   : mReferenceSource( referenceSource )
 {
-  // Build spatial index
-  mIndex = QgsSpatialIndex( *mReferenceSource );
+  // Read the reference geometries once, instead of fetching them from the source for every snapped feature
+  QMap< QgsFeatureId, QgsGeometry > geometries;
+  QgsFeatureIterator it = mReferenceSource->getFeatures( QgsFeatureRequest().setNoAttributes() );
+  QgsFeature feature;
+  while ( it.nextFeature( feature ) )
+  {
+    if ( feature.hasGeometry() && !feature.geometry().isEmpty() )
+      geometries.insert( feature.id(), feature.geometry() );
+  }
+  QVector< QgsGeometry > referenceGeometries;
+  referenceGeometries.reserve( geometries.size() );
+  for ( auto geomIt = geometries.constBegin(); geomIt != geometries.constEnd(); ++geomIt )
+    referenceGeometries.append( geomIt.value() );
+
+  mReferenceIndex = std::make_unique< QgsSnapperReferenceIndex >( referenceGeometries );
+}
+
+QgsGeometrySnapper::~QgsGeometrySnapper() = default;
+
+///@cond PRIVATE
+
+//! Maximum number of children of a node of the reference geometry index
+constexpr std::size_t REFERENCE_INDEX_NODE_SIZE = 16;
+
+QgsSnapperReferenceIndex::QgsSnapperReferenceIndex( const QVector< QgsGeometry > &geometries )
+  : mGeometries( geometries )
+{
+  const std::size_t count = static_cast< std::size_t >( mGeometries.size() );
+  if ( count == 0 )
+    return;
+
+  std::vector< QgsRectangle > boxes;
+  boxes.reserve( count );
+  for ( const QgsGeometry &geometry : std::as_const( mGeometries ) )
+    boxes.emplace_back( geometry.boundingBox() );
+
+  // Sort-tile-recursive packing: sort the boxes by center x, cut them in vertical slices
+  // and sort each slice by center y, so that consecutive leaves are close to each other
+  std::vector< std::size_t > order( count );
+  std::iota( order.begin(), order.end(), 0 );
+  std::sort( order.begin(), order.end(), [&boxes]( std::size_t a, std::size_t b )
+  {
+    return boxes[a].center().x() < boxes[b].center().x();
+  } );
+  const std::size_t leafNodeCount = ( count + REFERENCE_INDEX_NODE_SIZE - 1 ) / REFERENCE_INDEX_NODE_SIZE;
+  const std::size_t sliceCount = static_cast< std::size_t >( std::ceil( std::sqrt( static_cast< double >( leafNodeCount ) ) ) );
+  const std::size_t sliceSize = REFERENCE_INDEX_NODE_SIZE * ( ( leafNodeCount + sliceCount - 1 ) / sliceCount );
+  for ( std::size_t sliceStart = 0; sliceStart < count; sliceStart += sliceSize )
+  {
+    const std::size_t sliceEnd = std::min( sliceStart + sliceSize, count );
+    std::sort( order.begin() + sliceStart, order.begin() + sliceEnd, [&boxes]( std::size_t a, std::size_t b )
+    {
+      return boxes[a].center().y() < boxes[b].center().y();
+    } );
+  }
+
+  mBoxes.reserve( count + count / ( REFERENCE_INDEX_NODE_SIZE - 1 ) + 1 );
+  mChildren.reserve( mBoxes.capacity() );
+  for ( std::size_t i : order )
+  {
+    mBoxes.emplace_back( boxes[i] );
+    mChildren.emplace_back( i );
+  }
+  mLevelEnds.emplace_back( count );
+
+  // Group consecutive nodes of each level under a parent node, until a single root is left
+  std::size_t levelStart = 0;
+  std::size_t levelEnd = count;
+  while ( levelEnd - levelStart > 1 )
+  {
+    for ( std::size_t i = levelStart; i < levelEnd; i += REFERENCE_INDEX_NODE_SIZE )
+    {
+      // not combineExtentWith(), which would skip a degenerate box at the origin
+      double xMin = mBoxes[i].xMinimum();
+      double yMin = mBoxes[i].yMinimum();
+      double xMax = mBoxes[i].xMaximum();
+      double yMax = mBoxes[i].yMaximum();
+      const std::size_t childEnd = std::min( i + REFERENCE_INDEX_NODE_SIZE, levelEnd );
+      for ( std::size_t child = i + 1; child < childEnd; ++child )
+      {
+        const QgsRectangle &childBox = mBoxes[child];
+        xMin = std::min( xMin, childBox.xMinimum() );
+        yMin = std::min( yMin, childBox.yMinimum() );
+        xMax = std::max( xMax, childBox.xMaximum() );
+        yMax = std::max( yMax, childBox.yMaximum() );
+      }
+      mBoxes.emplace_back( xMin, yMin, xMax, yMax, false );
+      mChildren.emplace_back( i );
+    }
+    levelStart = levelEnd;
+    levelEnd = mBoxes.size();
+    mLevelEnds.emplace_back( levelEnd );
+  }
 }
 
+QList< QgsGeometry > QgsSnapperReferenceIndex::intersects( const QgsRectangle &searchBounds ) const
+{
+  QList< QgsGeometry > result;
+  if ( mBoxes.empty() )
+    return result;
+
+  std::vector< std::size_t > ids;
+  std::vector< std::pair< std::size_t, std::size_t > > stack; // node position, level
+  stack.emplace_back( mBoxes.size() - 1, mLevelEnds.size() - 1 );
+  while ( !stack.empty() )
+  {
+    const std::pair< std::size_t, std::size_t > node = stack.back();
+    stack.pop_back();
+    if ( !mBoxes[node.first].intersects( searchBounds ) )
+      continue;
+
+    if ( node.second == 0 )
+    {
+      ids.emplace_back( mChildren[node.first] );
+      continue;
+    }
+
+    const std::size_t childStart = mChildren[node.first];
+    const std::size_t childEnd = std::min( childStart + REFERENCE_INDEX_NODE_SIZE, mLevelEnds[node.second - 1] );
+    for ( std::size_t child = childStart; child < childEnd; ++child )
+      stack.emplace_back( child, node.second - 1 );
+  }
+
+  // keep the reference geometries in feature id order, so that the result does not depend on the index layout
+  std::sort( ids.begin(), ids.end() );
+  result.reserve( static_cast< int >( ids.size() ) );
+  for ( std::size_t id : ids )
+    result.append( mGeometries.at( static_cast< int >( id ) ) );
+  return result;
+}
+
+///@endcond
+
 QgsFeatureList QgsGeometrySnapper::snapFeatures( const QgsFeatureList &features, double snapTolerance, SnapMode mode )
 {
   QgsFeatureList list = features;
@@ -446,45 +579,13 @@ void QgsGeometrySnapper::processFeature( QgsFeature &feature, double snapToleran
 QgsGeometry QgsGeometrySnapper::snapGeometry( const QgsGeometry &geometry, double snapTolerance, SnapMode mode ) const
 {
   // Get potential reference features and construct snap index
-  QList<QgsGeometry> refGeometries;
-  mIndexMutex.lock();
   QgsRectangle searchBounds = geometry.boundingBox();
   searchBounds.grow( snapTolerance );
-  QgsFeatureIds refFeatureIds = qgis::listToSet( mIndex.intersects( searchBounds ) );
-  mIndexMutex.unlock();
+  const QList<QgsGeometry> refGeometries = mReferenceIndex->intersects( searchBounds );
 
-  if ( refFeatureIds.isEmpty() )
+  if ( refGeometries.isEmpty() )
     return QgsGeometry( geometry );
 
-  refGeometries.reserve( refFeatureIds.size() );
-  QgsFeatureIds missingFeatureIds;
-  const QgsFeatureIds cachedIds = qgis::listToSet( mCachedReferenceGeometries.keys() );
-  for ( QgsFeatureId id : refFeatureIds )
-  {
-    if ( cachedIds.contains( id ) )
-    {
-      refGeometries.append( mCachedReferenceGeometries[id] );
-    }
-    else
-    {
-      missingFeatureIds << id;
-    }
-  }
-
-  if ( missingFeatureIds.size() > 0 )
-  {
-
-    mReferenceLayerMutex.lock();
-    QgsFeatureRequest refFeatureRequest = QgsFeatureRequest().setFilterFids( missingFeatureIds ).setNoAttributes();
-    QgsFeatureIterator refFeatureIt = mReferenceSource->getFeatures( refFeatureRequest );
-    QgsFeature refFeature;
-    while ( refFeatureIt.nextFeature( refFeature ) )
-    {
-      refGeometries.append( refFeature.geometry() );
-    }
-    mReferenceLayerMutex.unlock();
-  }
-
   return snapGeometry( geometry, snapTolerance, refGeometries, mode );
 }
 
@@ -28,8 +28,11 @@
 #include <QFuture>
 #include <QStringList>
 #include <geos_c.h>
+#include <vector>
+#include <memory>
 
 class QgsVectorLayer;
+class QgsSnapperReferenceIndex;
 
 /**
  * \class QgsGeometrySnapper
@@ -64,6 +67,8 @@ class ANALYSIS_EXPORT QgsGeometrySnapper : public QObject
      */
     QgsGeometrySnapper( QgsFeatureSource *referenceSource );
 
+    ~QgsGeometrySnapper() override;
+
     /**
      * Snaps a geometry to the reference layer and returns the result. The geometry must be in the same
      * CRS as the reference layer, and must have the same type as the reference layer geometry. The snap tolerance
@@ -105,16 +110,13 @@ class ANALYSIS_EXPORT QgsGeometrySnapper : public QObject
     enum PointFlag { SnappedToRefNode, SnappedToRefSegment, Unsnapped };
 
     QgsFeatureSource *mReferenceSource = nullptr;
-    QHash<QgsFeatureId, QgsGeometry> mCachedReferenceGeometries;
 
-    QgsSpatialIndex mIndex;
-    mutable QMutex mIndexMutex;
-    mutable QMutex mReferenceLayerMutex;
+    //! Reference geometries and their index, built once and read concurrently by snapFeatures()
+    std::unique_ptr< QgsSnapperReferenceIndex > mReferenceIndex;
 
     void processFeature( QgsFeature &feature, double snapTolerance, SnapMode mode );
 
     static int polyLineSize( const QgsAbstractGeometry *geom, int iPart, int iRing );
-
 };
 
 
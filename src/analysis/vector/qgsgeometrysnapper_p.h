@@ -0,0 +1,73 @@
+/***************************************************************************
+ *  qgsgeometrysnapper_p.h                                                 *
+ *  -------------------                                                    *
+ *  copyright            : (C) 2026 by QGIS contributors                   *
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGS_GEOMETRY_SNAPPER_PRIVATE_H
+#define QGS_GEOMETRY_SNAPPER_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_analysis.h"
+#include "qgsgeometry.h"
+#include "qgsrectangle.h"
+
+#include <QList>
+#include <QVector>
+#include <vector>
+
+/**
+ * Packed R-tree over the reference geometries of QgsGeometrySnapper.
+ *
+ * The index is built once in the constructor and only read afterwards, so that
+ * features can be snapped concurrently without any locking.
+ */
+class ANALYSIS_EXPORT QgsSnapperReferenceIndex
+{
+  public:
+
+    //! Builds the index over the reference \a geometries, which are sorted by feature id
+    explicit QgsSnapperReferenceIndex( const QVector< QgsGeometry > &geometries );
+
+    /**
+     * Returns the reference geometries whose bounding box intersects \a searchBounds,
+     * in the order of the geometries passed to the constructor.
+     */
+    QList< QgsGeometry > intersects( const QgsRectangle &searchBounds ) const;
+
+  private:
+
+    //! Reference geometries, sorted by feature id
+    QVector< QgsGeometry > mGeometries;
+    //! Boxes of the packed R-tree over the reference geometries, leaves first and root last
+    std::vector< QgsRectangle > mBoxes;
+    //! Reference geometry of each leaf, position of the first child of each node
+    std::vector< std::size_t > mChildren;
+    //! End position of each level of the packed R-tree in mBoxes
+    std::vector< std::size_t > mLevelEnds;
+};
+
+/// @endcond
+
+#endif // QGS_GEOMETRY_SNAPPER_PRIVATE_H
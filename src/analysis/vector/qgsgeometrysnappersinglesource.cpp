@@ -23,7 +23,11 @@
 #include "qgsgeometryutils.h"
 #include "qgslinestring.h"
 #include "qgspolygon.h"
-#include "qgsspatialindex.h"
+#include "kdbush.hpp"
+
+#include <QHash>
+#include <QThread>
+#include <QtConcurrentMap>
 
 //! record about vertex coordinates and index of anchor to which it is snapped
 struct AnchorPoint
@@ -49,10 +53,65 @@ struct AnchorAlongSegment
 };
 
 
-static void buildSnapIndex( QgsFeatureIterator &fi, QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, QgsFeedback *feedback, long long &count, long long totalCount )
+//! Exact coordinates of a vertex, used to find the point of a vertex
+typedef QPair< double, double > VertexKey;
+
+//! Returns the key of a vertex at \a x, \a y, with a negative zero stored as zero
+static VertexKey vertexKey( double x, double y )
+{
+  return VertexKey( x == 0 ? 0 : x, y == 0 ? 0 : y );
+}
+
+
+//! item of the point index, with the index of the point in the vector of anchor points
+struct AnchorPointIndexItem
+{
+  AnchorPointIndexItem( double x, double y, int point )
+    : coords( x, y )
+    , point( point )
+  {}
+
+  std::pair< double, double > coords;
+  int point;
+};
+
+
+/**
+ * Static index of the anchor points, built once all the vertices are known. Unlike
+ * a QgsSpatialIndex, it can be queried from several threads at once.
+ */
+class AnchorPointIndex : public kdbush::KDBush< std::pair< double, double >, AnchorPointIndexItem, std::size_t >
+{
+  public:
+    explicit AnchorPointIndex( const QVector<AnchorPoint> &pnts )
+    {
+      points.reserve( pnts.size() );
+      for ( int i = 0; i < pnts.size(); ++i )
+        points.emplace_back( pnts[i].x, pnts[i].y, i );
+      if ( !points.empty() )
+        sortKD( 0, points.size() - 1, 0 );
+    }
+
+    //! Returns the indexes of the points within the rectangle \a xmin, \a ymin, \a xmax, \a ymax
+    QVector<int> pointsInRectangle( double xmin, double ymin, double xmax, double ymax ) const
+    {
+      QVector<int> result;
+      range( xmin, ymin, xmax, ymax, [&result]( const AnchorPointIndexItem & item )
+      {
+        result.append( item.point );
+      } );
+      return result;
+    }
+};
+
+
+//! Features snapped at once in step 3, for each thread
+constexpr int FEATURES_PER_THREAD = 64;
+
+
+static void buildSnapIndex( QgsFeatureIterator &fi, QHash<VertexKey, int> &pointIds, QVector<AnchorPoint> &pnts, QgsFeedback *feedback, long long &count, long long totalCount )
 {
   QgsFeature f;
-  int pntId = 0;
 
   while ( fi.nextFeature( f ) )
   {
@@ -64,20 +123,18 @@ static void buildSnapIndex( QgsFeatureIterator &fi, QgsSpatialIndex &index, QVec
     for ( auto it = g.vertices_begin(); it != g.vertices_end(); ++it )
     {
       QgsPoint pt = *it;
-      QgsRectangle rect( pt.x(), pt.y(), pt.x(), pt.y() );
+      const VertexKey key = vertexKey( pt.x(), pt.y() );
 
-      QList<QgsFeatureId> ids = index.intersects( rect );
-      if ( ids.isEmpty() )
+      if ( !pointIds.contains( key ) )
       {
-        // add to tree and to structure
-        index.addFeature( pntId, pt.boundingBox() );
+        // add to lookup and to structure
+        pointIds.insert( key, pnts.size() );
 
         AnchorPoint xp;
         xp.x = pt.x();
         xp.y = pt.y();
         xp.anchor = -1;
         pnts.append( xp );
-        pntId++;
       }
     }
 
@@ -87,7 +144,7 @@ static void buildSnapIndex( QgsFeatureIterator &fi, QgsSpatialIndex &index, QVec
 }
 
 
-static void assignAnchors( QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, double thresh )
+static void assignAnchors( const AnchorPointIndex &index, QVector<AnchorPoint> &pnts, double thresh )
 {
   double thresh2 = thresh * thresh;
   int nanchors = 0, ntosnap = 0;
@@ -101,10 +158,8 @@ static void assignAnchors( QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, d
 
     // Find points in threshold
     double x = pnts[point].x, y = pnts[point].y;
-    QgsRectangle rect( x - thresh, y - thresh, x + thresh, y + thresh );
-
-    const QList<QgsFeatureId> ids = index.intersects( rect );
-    for ( QgsFeatureId pointb : ids )
+    const QVector<int> ids = index.pointsInRectangle( x - thresh, y - thresh, x + thresh, y + thresh );
+    for ( int pointb : ids )
     {
       if ( pointb == point )
         continue;
@@ -135,13 +190,14 @@ static void assignAnchors( QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, d
 }
 
 
-static bool snapPoint( QgsPoint *pt, QgsSpatialIndex &index, QVector<AnchorPoint> &pnts )
+static bool snapPoint( QgsPoint *pt, const QHash<VertexKey, int> &pointIds, const QVector<AnchorPoint> &pnts )
 {
   // Find point ( should always find one point )
-  QList<QgsFeatureId> fids = index.intersects( QgsRectangle( pt->x(), pt->y(), pt->x(), pt->y() ) );
-  Q_ASSERT( fids.count() == 1 );
+  const int spoint = pointIds.value( vertexKey( pt->x(), pt->y() ), -1 );
+  Q_ASSERT( spoint >= 0 );
+  if ( spoint < 0 )
+    return false;
 
-  int spoint = fids[0];
   int anchor = pnts[spoint].anchor;
 
   if ( anchor >= 0 )
@@ -156,7 +212,7 @@ static bool snapPoint( QgsPoint *pt, QgsSpatialIndex &index, QVector<AnchorPoint
 }
 
 
-static bool snapLineString( QgsLineString *linestring, QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, double thresh )
+static bool snapLineString( QgsLineString *linestring, const QHash<VertexKey, int> &pointIds, const AnchorPointIndex &index, const QVector<AnchorPoint> &pnts, double thresh )
 {
   QVector<QgsPoint> newPoints;
   QVector<int> anchors;  // indexes of anchors for vertices
@@ -169,14 +225,12 @@ static bool snapLineString( QgsLineString *linestring, QgsSpatialIndex &index, Q
   {
     double x = linestring->xAt( v );
     double y = linestring->yAt( v );
-    QgsRectangle rect( x, y, x, y );
 
     // Find point ( should always find one point )
-    QList<QgsFeatureId> fids = index.intersects( rect );
-    Q_ASSERT( fids.count() == 1 );
+    const int spoint = pointIds.value( vertexKey( x, y ), -1 );
+    Q_ASSERT( spoint >= 0 );
 
-    int spoint = fids.first();
-    int anchor = pnts[spoint].anchor;
+    int anchor = spoint >= 0 ? pnts[spoint].anchor : -1;
     if ( anchor >= 0 )
     {
       // to be snapped
@@ -208,18 +262,14 @@ static bool snapLineString( QgsLineString *linestring, QgsSpatialIndex &index, Q
     if ( ymin > ymax )
       std::swap( ymin, ymax );
 
-    QgsRectangle rect( xmin - thresh, ymin - thresh, xmax + thresh, ymax + thresh );
-
     // Find points
-    const QList<QgsFeatureId> fids = index.intersects( rect );
+    const QVector<int> fids = index.pointsInRectangle( xmin - thresh, ymin - thresh, xmax + thresh, ymax + thresh );
 
     QVector<AnchorAlongSegment> newVerticesAlongSegment;
 
     // Snap to anchor in threshold different from end points
-    for ( QgsFeatureId fid : fids )
+    for ( int spoint : fids )
     {
-      int spoint = fid;
-
       if ( spoint == anchors[v] || spoint == anchors[v + 1] )
         continue; // end point
       if ( pnts[spoint].anchor >= 0 )
@@ -270,31 +320,31 @@ static bool snapLineString( QgsLineString *linestring, QgsSpatialIndex &index, Q
 }
 
 
-static bool snapGeometry( QgsAbstractGeometry *g, QgsSpatialIndex &index, QVector<AnchorPoint> &pnts, double thresh )
+static bool snapGeometry( QgsAbstractGeometry *g, const QHash<VertexKey, int> &pointIds, const AnchorPointIndex &index, const QVector<AnchorPoint> &pnts, double thresh )
 {
   bool changed = false;
   if ( QgsLineString *linestring = qgsgeometry_cast<QgsLineString *>( g ) )
   {
-    changed |= snapLineString( linestring, index, pnts, thresh );
+    changed |= snapLineString( linestring, pointIds, index, pnts, thresh );
   }
   else if ( QgsPolygon *polygon = qgsgeometry_cast<QgsPolygon *>( g ) )
   {
     if ( QgsLineString *exteriorRing = qgsgeometry_cast<QgsLineString *>( polygon->exteriorRing() ) )
-      changed |= snapLineString( exteriorRing, index, pnts, thresh );
+      changed |= snapLineString( exteriorRing, pointIds, index, pnts, thresh );
     for ( int i = 0; i < polygon->numInteriorRings(); ++i )
     {
       if ( QgsLineString *interiorRing = qgsgeometry_cast<QgsLineString *>( polygon->interiorRing( i ) ) )
-        changed |= snapLineString( interiorRing, index, pnts, thresh );
+        changed |= snapLineString( interiorRing, pointIds, index, pnts, thresh );
     }
   }
   else if ( QgsGeometryCollection *collection = qgsgeometry_cast<QgsGeometryCollection *>( g ) )
   {
     for ( int i = 0; i < collection->numGeometries(); ++i )
-      changed |= snapGeometry( collection->geometryN( i ), index, pnts, thresh );
+      changed |= snapGeometry( collection->geometryN( i ), pointIds, index, pnts, thresh );
   }
   else if ( QgsPoint *pt = qgsgeometry_cast<QgsPoint *>( g ) )
   {
-    changed |= snapPoint( pt, index, pnts );
+    changed |= snapPoint( pt, pointIds, pnts );
   }
 
   return changed;
@@ -308,19 +358,22 @@ int QgsGeometrySnapperSingleSource::run( const QgsFeatureSource &source, QgsFeat
   long long count = 0;
   long long totalCount = source.featureCount() * 2;
 
-  // step 1: record all point locations in a spatial index + extra data structure to keep
+  // step 1: record all point locations in a lookup + extra data structure to keep
   // reference to which other point they have been snapped to (in the next phase).
 
-  QgsSpatialIndex index;
+  QHash<VertexKey, int> pointIds;
   QVector<AnchorPoint> pnts;
   QgsFeatureRequest request;
   request.setNoAttributes();
   QgsFeatureIterator fi = source.getFeatures( request );
-  buildSnapIndex( fi, index, pnts, feedback, count, totalCount );
+  buildSnapIndex( fi, pointIds, pnts, feedback, count, totalCount );
 
   if ( feedback->isCanceled() )
     return 0;
 
+  // all the vertices are known now, so the spatial index of the points can be built at once
+  const AnchorPointIndex index( pnts );
+
   // step 2: go through all registered points and if not yet marked mark it as anchor and
   // assign this anchor to all not yet marked points in threshold
 
@@ -330,25 +383,59 @@ int QgsGeometrySnapperSingleSource::run( const QgsFeatureSource &source, QgsFeat
   // Go through all lines and:
   //   1) for all vertices: if not anchor snap it to its anchor
   //   2) for all segments: snap it to all anchors in threshold (except anchors of vertices of course)
+  // The anchors are final after step 2, so the features are snapped in parallel batches and
+  // written to the sink in their original order.
+
+  struct SnapJob
+  {
+    QgsFeature feature;
+    bool changed = false;
+  };
+
+  const int threadCount = std::max( 1, QThread::idealThreadCount() );
+  const std::size_t batchSize = static_cast< std::size_t >( threadCount ) * FEATURES_PER_THREAD;
+  auto snapJob = [&pointIds, &index, &pnts, thresh]( SnapJob & job )
+  {
+    QgsGeometry geom = job.feature.geometry();
+    if ( snapGeometry( geom.get(), pointIds, index, pnts, thresh ) )
+    {
+      job.feature.setGeometry( geom );
+      job.changed = true;
+    }
+  };
 
   int modified = 0;
+  std::vector< SnapJob > jobs;
+  jobs.reserve( batchSize );
   QgsFeature f;
   fi = source.getFeatures();
-  while ( fi.nextFeature( f ) )
+  bool hasMore = true;
+  while ( hasMore )
   {
     if ( feedback->isCanceled() )
       break;
 
-    QgsGeometry geom = f.geometry();
-    if ( snapGeometry( geom.get(), index, pnts, thresh ) )
+    jobs.clear();
+    while ( jobs.size() < batchSize && ( hasMore = fi.nextFeature( f ) ) )
     {
-      f.setGeometry( geom );
-      ++modified;
+      jobs.emplace_back();
+      jobs.back().feature = f;
     }
 
-    sink.addFeature( f, QgsFeatureSink::FastInsert );
+    if ( threadCount == 1 || jobs.size() == 1 )
+      std::for_each( jobs.begin(), jobs.end(), snapJob );
+    else
+      QtConcurrent::blockingMap( jobs, snapJob );
+
+    for ( SnapJob &job : jobs )
+    {
+      if ( job.changed )
+        ++modified;
 
-    ++count;
+      sink.addFeature( job.feature, QgsFeatureSink::FastInsert );
+    }
+
+    count += static_cast< long long >( jobs.size() );
     feedback->setProgress( 100. * count / totalCount );
   }
 
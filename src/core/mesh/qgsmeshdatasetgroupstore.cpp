@@ -22,6 +22,13 @@
 #include "qgsmeshvirtualdatasetgroup.h"
 #include "qgslogger.h"
 
+#include "qgsproviderregistry.h"
+
+#include <QThread>
+#include <QtConcurrentRun>
+#include <algorithm>
+#include <limits>
+
 QList<int> QgsMeshDatasetGroupStore::datasetGroupIndexes() const
 {
   return mRegistery.keys();
@@ -45,9 +52,15 @@ int QgsMeshDatasetGroupStore::extraDatasetGroupCount() const
 QgsMeshDatasetGroupStore::QgsMeshDatasetGroupStore( QgsMeshLayer *layer ):
   mLayer( layer ),
   mExtraDatasets( new QgsMeshExtraDatasetStore ),
-  mDatasetGroupTreeRootItem( new QgsMeshDatasetGroupTreeItem )
+  mDatasetGroupTreeRootItem( new QgsMeshDatasetGroupTreeItem ),
+  mDatasetCache( 0 )
 {}
 
+QgsMeshDatasetGroupStore::~QgsMeshDatasetGroupStore()
+{
+  waitForPrefetching();
+}
+
 void QgsMeshDatasetGroupStore::setPersistentProvider( QgsMeshDataProvider *provider, const QStringList &extraDatasetUri )
 {
   removePersistentProvider();
@@ -88,6 +101,10 @@ bool QgsMeshDatasetGroupStore::addPersistentDatasets( const QString &path )
 {
   if ( !mPersistentProvider )
     return false;
+
+  // the provider used by the prefetching would not have the new dataset groups
+  resetPrefetchProvider();
+
   return mPersistentProvider->addDataset( path ) ;
 }
 
@@ -190,6 +207,17 @@ QgsMeshDatasetValue QgsMeshDatasetGroupStore::datasetValue( const QgsMeshDataset
 QgsMeshDataBlock QgsMeshDatasetGroupStore::datasetValues( const QgsMeshDatasetIndex &index, int valueIndex, int count ) const
 {
   QgsMeshDatasetGroupStore::DatasetGroup  group = datasetGroup( index.group() );
+  if ( group.first && group.first == mPersistentProvider && mDatasetCacheSize > 0 )
+  {
+    QgsMeshDatasetBlockCacheKey key;
+    key.group = group.second;
+    key.dataset = index.dataset();
+    key.firstIndex = valueIndex;
+    key.count = count;
+    key.type = QgsMeshDatasetBlockCacheKey::Values;
+    return cachedProviderBlock( key );
+  }
+
   if ( group.first )
     return group.first->datasetValues( QgsMeshDatasetIndex( group.second, index.dataset() ), valueIndex, count );
   else
@@ -208,6 +236,17 @@ QgsMesh3dDataBlock QgsMeshDatasetGroupStore::dataset3dValues( const QgsMeshDatas
 QgsMeshDataBlock QgsMeshDatasetGroupStore::areFacesActive( const QgsMeshDatasetIndex &index, int faceIndex, int count ) const
 {
   QgsMeshDatasetGroupStore::DatasetGroup  group = datasetGroup( index.group() );
+  if ( group.first && group.first == mPersistentProvider && mDatasetCacheSize > 0 )
+  {
+    QgsMeshDatasetBlockCacheKey key;
+    key.group = group.second;
+    key.dataset = index.dataset();
+    key.firstIndex = faceIndex;
+    key.count = count;
+    key.type = QgsMeshDatasetBlockCacheKey::ActiveFlags;
+    return cachedProviderBlock( key );
+  }
+
   if ( group.first )
     return group.first->areFacesActive( QgsMeshDatasetIndex( group.second, index.dataset() ), faceIndex, count );
   else
@@ -402,6 +441,8 @@ void QgsMeshDatasetGroupStore::removePersistentProvider()
   if ( !mPersistentProvider )
     return;
 
+  clearDatasetCache();
+
   disconnect( mPersistentProvider, &QgsMeshDataProvider::datasetGroupsAdded, this, &QgsMeshDatasetGroupStore::onPersistentDatasetAdded );
 
   QMap < int, DatasetGroup>::iterator it = mRegistery.begin();
@@ -416,6 +457,218 @@ void QgsMeshDatasetGroupStore::removePersistentProvider()
   mPersistentProvider = nullptr;
 }
 
+void QgsMeshDatasetGroupStore::setDatasetCache( qint64 size, int prefetchCount )
+{
+  waitForPrefetching();
+
+  // the blocks are accounted in kilobytes, a cache holding less than a kilobyte would keep nothing
+  mDatasetCacheSize = size >= 1024 ? size : 0;
+  mDatasetPrefetchCount = std::max( prefetchCount, 0 );
+
+  QMutexLocker locker( &mDatasetCacheMutex );
+  mDatasetCache.setMaxCost( static_cast< int >( std::min< qint64 >( mDatasetCacheSize / 1024, std::numeric_limits< int >::max() ) ) );
+}
+
+void QgsMeshDatasetGroupStore::clearDatasetCache()
+{
+  resetPrefetchProvider();
+
+  QMutexLocker locker( &mDatasetCacheMutex );
+  mDatasetCache.clear();
+}
+
+bool QgsMeshDatasetGroupStore::datasetValuesCached( const QgsMeshDatasetIndex &index, int valueIndex, int count ) const
+{
+  const QgsMeshDatasetGroupStore::DatasetGroup group = datasetGroup( index.group() );
+  if ( !group.first || group.first != mPersistentProvider )
+    return false;
+
+  QgsMeshDatasetBlockCacheKey key;
+  key.group = group.second;
+  key.dataset = index.dataset();
+  key.firstIndex = valueIndex;
+  key.count = count;
+  key.type = QgsMeshDatasetBlockCacheKey::Values;
+
+  QMutexLocker locker( &mDatasetCacheMutex );
+  return mDatasetCache.contains( key );
+}
+
+void QgsMeshDatasetGroupStore::waitForDatasetPrefetching() const
+{
+  QFuture<void> future;
+  {
+    QMutexLocker locker( &mDatasetCacheMutex );
+    future = mPrefetchFuture;
+  }
+  future.waitForFinished();
+}
+
+///@cond PRIVATE
+
+//! Reads from \a provider the block identified by \a key
+static QgsMeshDataBlock readProviderBlock( QgsMeshDataProvider *provider, const QgsMeshDatasetBlockCacheKey &key )
+{
+  const QgsMeshDatasetIndex index( key.group, key.dataset );
+  switch ( key.type )
+  {
+    case QgsMeshDatasetBlockCacheKey::Values:
+      return provider->datasetValues( index, key.firstIndex, key.count );
+    case QgsMeshDatasetBlockCacheKey::ActiveFlags:
+      return provider->areFacesActive( index, key.firstIndex, key.count );
+  }
+  return QgsMeshDataBlock();
+}
+
+//! Returns the size in kilobytes of the values of \a block, rounded up
+static int blockCost( const QgsMeshDataBlock &block )
+{
+  qint64 size = 0;
+  switch ( block.type() )
+  {
+    case QgsMeshDataBlock::ActiveFlagInteger:
+      size = static_cast< qint64 >( block.count() ) * sizeof( int );
+      break;
+    case QgsMeshDataBlock::ScalarDouble:
+      size = static_cast< qint64 >( block.count() ) * sizeof( double );
+      break;
+    case QgsMeshDataBlock::Vector2DDouble:
+      size = static_cast< qint64 >( block.count() ) * 2 * sizeof( double );
+      break;
+  }
+  return static_cast< int >( std::min< qint64 >( ( size + 1023 ) / 1024, std::numeric_limits< int >::max() ) );
+}
+
+///@endcond
+
+QgsMeshDataBlock QgsMeshDatasetGroupStore::cachedProviderBlock( const QgsMeshDatasetBlockCacheKey &key ) const
+{
+  QgsMeshDataBlock block;
+  bool cached = false;
+  {
+    QMutexLocker locker( &mDatasetCacheMutex );
+    if ( const QgsMeshDataBlock *cachedBlock = mDatasetCache.object( key ) )
+    {
+      block = *cachedBlock;
+      cached = true;
+    }
+  }
+
+  if ( !cached )
+  {
+    block = readProviderBlock( mPersistentProvider, key );
+    if ( block.isValid() )
+    {
+      QMutexLocker locker( &mDatasetCacheMutex );
+      mDatasetCache.insert( key, new QgsMeshDataBlock( block ), blockCost( block ) );
+    }
+  }
+
+  prefetchFollowingDatasets( key );
+
+  return block;
+}
+
+void QgsMeshDatasetGroupStore::prefetchFollowingDatasets( const QgsMeshDatasetBlockCacheKey &key ) const
+{
+  if ( mDatasetPrefetchCount <= 0 || !mPersistentProvider )
+    return;
+
+  // the active flags are always needed by the renderers with the values, read them with the values
+  QList<QgsMeshDatasetBlockCacheKey> keys;
+  const int datasetCount = mPersistentProvider->datasetCount( key.group );
+  const int faceCount = mPersistentProvider->faceCount();
+  for ( int dataset = key.dataset + 1; dataset <= key.dataset + mDatasetPrefetchCount && dataset < datasetCount; ++dataset )
+  {
+    QgsMeshDatasetBlockCacheKey followingKey = key;
+    followingKey.dataset = dataset;
+    keys << followingKey;
+
+    if ( key.type == QgsMeshDatasetBlockCacheKey::Values )
+    {
+      followingKey.type = QgsMeshDatasetBlockCacheKey::ActiveFlags;
+      followingKey.firstIndex = 0;
+      followingKey.count = faceCount;
+      keys << followingKey;
+    }
+  }
+
+  QMutexLocker locker( &mDatasetCacheMutex );
+  if ( mPrefetchFuture.isRunning() || mPrefetchProviderFailed )
+    return;
+
+  // nothing to read if all the blocks are already in the cache
+  keys.erase( std::remove_if( keys.begin(), keys.end(), [this]( const QgsMeshDatasetBlockCacheKey & k ) { return mDatasetCache.contains( k ); } ), keys.end() );
+  if ( keys.isEmpty() )
+    return;
+
+  // the persistent provider is used by the layer in the calling thread, the blocks are read with another instance
+  const QString providerKey = mPersistentProvider->name();
+  const QString uri = mPersistentProvider->dataSourceUri();
+  const QStringList extraDatasetUris = mPersistentProvider->extraDatasets();
+  const int datasetGroupCount = mPersistentProvider->datasetGroupCount();
+  QgsDataProvider::ProviderOptions options;
+  options.transformContext = mPersistentProvider->transformContext();
+  QThread *storeThread = thread();
+
+  mPrefetchCanceled = false;
+  mPrefetchFuture = QtConcurrent::run( [this, providerKey, uri, extraDatasetUris, datasetGroupCount, options, storeThread, keys]
+  {
+    if ( !mPrefetchProvider )
+    {
+      std::unique_ptr< QgsMeshDataProvider > provider( qobject_cast< QgsMeshDataProvider * >( QgsProviderRegistry::instance()->createProvider( providerKey, uri, options ) ) );
+      if ( provider && provider->isValid() )
+      {
+        for ( const QString &extraDatasetUri : extraDatasetUris )
+          provider->addDataset( extraDatasetUri );
+      }
+
+      // the group indexes must be the same as the ones of the persistent provider
+      if ( !provider || !provider->isValid() || provider->datasetGroupCount() != datasetGroupCount )
+      {
+        mPrefetchProviderFailed = true;
+        return;
+      }
+
+      // the provider is deleted by the store
+      provider->moveToThread( storeThread );
+      mPrefetchProvider = std::move( provider );
+    }
+
+    for ( const QgsMeshDatasetBlockCacheKey &k : keys )
+    {
+      if ( mPrefetchCanceled )
+        return;
+
+      {
+        QMutexLocker locker( &mDatasetCacheMutex );
+        if ( mDatasetCache.contains( k ) )
+          continue;
+      }
+
+      const QgsMeshDataBlock block = readProviderBlock( mPrefetchProvider.get(), k );
+      if ( block.isValid() )
+      {
+        QMutexLocker locker( &mDatasetCacheMutex );
+        mDatasetCache.insert( k, new QgsMeshDataBlock( block ), blockCost( block ) );
+      }
+    }
+  } );
+}
+
+void QgsMeshDatasetGroupStore::waitForPrefetching() const
+{
+  mPrefetchCanceled = true;
+  waitForDatasetPrefetching();
+}
+
+void QgsMeshDatasetGroupStore::resetPrefetchProvider()
+{
+  waitForPrefetching();
+  mPrefetchProvider.reset();
+  mPrefetchProviderFailed = false;
+}
+
 int QgsMeshDatasetGroupStore::newIndex()
 {
   int index = 0;
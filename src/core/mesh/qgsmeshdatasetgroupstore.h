@@ -20,11 +20,51 @@
 
 #define SIP_NO_FILE
 
+#include "qgis_core.h"
 #include "qgsmeshdataprovider.h"
 #include "qgsmeshdataset.h"
 
+#include <QCache>
+#include <QFuture>
+#include <QMutex>
+#include <atomic>
+
 class QgsMeshLayer;
 
+/**
+ * \ingroup core
+ *
+ * \brief Key of a block of values read from a mesh data provider, in the dataset cache of QgsMeshDatasetGroupStore
+ *
+ * \since QGIS 3.22
+ */
+struct QgsMeshDatasetBlockCacheKey
+{
+  //! Type of block
+  enum BlockType
+  {
+    Values, //!< Dataset values, see QgsMeshDataProvider::datasetValues()
+    ActiveFlags, //!< Active flags of the faces, see QgsMeshDataProvider::areFacesActive()
+  };
+
+  int group = -1; //!< Index of the dataset group in the data provider
+  int dataset = -1; //!< Index of the dataset in the group
+  int firstIndex = 0; //!< Index of the first value of the block
+  int count = 0; //!< Count of values of the block
+  BlockType type = Values;
+
+  bool operator==( const QgsMeshDatasetBlockCacheKey &other ) const
+  {
+    return group == other.group && dataset == other.dataset && firstIndex == other.firstIndex && count == other.count && type == other.type;
+  }
+};
+
+//! Hash function for QgsMeshDatasetBlockCacheKey
+inline uint qHash( const QgsMeshDatasetBlockCacheKey &key )
+{
+  return qHash( key.group ) ^ qHash( key.dataset << 8 ) ^ qHash( key.firstIndex ) ^ qHash( key.count << 2 ) ^ qHash( static_cast< int >( key.type ) );
+}
+
 /**
  * \ingroup core
  *
@@ -116,7 +156,7 @@ class QgsMeshExtraDatasetStore: public QgsMeshDatasetSourceInterface
  *
  * \since QGIS 3.16
  */
-class QgsMeshDatasetGroupStore: public QObject
+class CORE_EXPORT QgsMeshDatasetGroupStore: public QObject
 {
     Q_OBJECT
 
@@ -127,6 +167,8 @@ class QgsMeshDatasetGroupStore: public QObject
     //! Constructor
     QgsMeshDatasetGroupStore( QgsMeshLayer *layer );
 
+    ~QgsMeshDatasetGroupStore() override;
+
     //!  Sets the persistent mesh data provider with the path of its extra dataset
     void setPersistentProvider( QgsMeshDataProvider *provider, const QStringList &extraDatasetUri );
 
@@ -210,6 +252,28 @@ class QgsMeshDatasetGroupStore: public QObject
     //! Reads the store's information from a DOM document
     void readXml( const QDomElement &storeElem, const QgsReadWriteContext &context );
 
+    /**
+     * Sets the maximum \a size in bytes of the blocks of values read from the persistent provider that are kept in memory,
+     * and the count of datasets following a requested dataset in the same group that are read in advance in a background
+     * thread (\a prefetchCount).
+     *
+     * A \a size smaller than 1024 bytes, the unit in which the cache is accounted, disables the cache and the reading in advance.
+     *
+     * The datasets are read in advance with a second instance of the persistent provider, only used by
+     * the background thread, because data providers are not thread safe.
+     *
+     * \since QGIS 3.22
+     */
+    void setDatasetCache( qint64 size, int prefetchCount );
+
+    /**
+     * Removes all the blocks from the dataset cache, after the blocks being read in advance are read.
+     * The instance of the provider used to read in advance is deleted too, so that the data source is read again.
+     *
+     * \since QGIS 3.22
+     */
+    void clearDatasetCache();
+
   signals:
     //! Emitted after dataset groups are added
     void datasetGroupsAdded( QList<int> indexes );
@@ -225,8 +289,38 @@ class QgsMeshDatasetGroupStore: public QObject
     QMap < int, DatasetGroup> mRegistery;
     std::unique_ptr<QgsMeshDatasetGroupTreeItem> mDatasetGroupTreeRootItem;
 
+    qint64 mDatasetCacheSize = 0;
+    int mDatasetPrefetchCount = 0;
+    //! Blocks of the persistent provider, with their size in kilobytes as cost
+    mutable QCache<QgsMeshDatasetBlockCacheKey, QgsMeshDataBlock> mDatasetCache;
+    mutable QMutex mDatasetCacheMutex; //!< Protects the dataset cache
+    mutable QFuture<void> mPrefetchFuture;
+    mutable std::atomic_bool mPrefetchCanceled{ false };
+    //! Instance of the persistent provider only used by the prefetching, created by the first prefetching
+    mutable std::unique_ptr<QgsMeshDataProvider> mPrefetchProvider;
+    //! Whether the instance of the persistent provider used by the prefetching could not be created
+    mutable std::atomic_bool mPrefetchProviderFailed{ false };
+
     void removePersistentProvider();
 
+    //! Returns the block of the persistent provider identified by \a key from the dataset cache, reads it if it is not cached
+    QgsMeshDataBlock cachedProviderBlock( const QgsMeshDatasetBlockCacheKey &key ) const;
+
+    //! Starts reading in a background thread the blocks of the datasets following the one of \a key
+    void prefetchFollowingDatasets( const QgsMeshDatasetBlockCacheKey &key ) const;
+
+    //! Stops reading blocks in advance and waits for the block being read
+    void waitForPrefetching() const;
+
+    //! Waits for the datasets being read in advance in the background thread
+    void waitForDatasetPrefetching() const;
+
+    //! Returns whether the \a count values from \a valueIndex of the dataset with \a index are in the dataset cache
+    bool datasetValuesCached( const QgsMeshDatasetIndex &index, int valueIndex, int count ) const;
+
+    //! Stops reading blocks in advance and deletes the instance of the persistent provider used by the prefetching
+    void resetPrefetchProvider();
+
     DatasetGroup datasetGroup( int index ) const;
     int newIndex();
 
@@ -245,6 +339,8 @@ class QgsMeshDatasetGroupStore: public QObject
     void unregisterGroupNotPresentInTree();
 
     void syncItemToDatasetGroup( int groupIndex );
+
+    friend class TestQgsMeshLayer;
 };
 
 #endif // QGSMESHDATASETGROUPSTORE_H
@@ -141,6 +141,8 @@ bool QgsMeshLayer::hasSimplifiedMeshes() const
 
 QgsMeshLayer::~QgsMeshLayer()
 {
+  // waits for the datasets read in advance from the provider before deleting it
+  mDatasetGroupStore->setPersistentProvider( nullptr, QStringList() );
   delete mDataProvider;
 }
 
@@ -163,6 +165,8 @@ QgsMeshLayer *QgsMeshLayer::clone() const
   }
   QgsMeshLayer *layer = new QgsMeshLayer( source(), name(), mProviderKey,  options );
   QgsMapLayer::clone( layer );
+  layer->setDatasetCacheSize( mDatasetCacheSize );
+  layer->setDatasetPrefetchCount( mDatasetPrefetchCount );
   return layer;
 }
 
@@ -894,6 +898,7 @@ bool QgsMeshLayer::startFrameEditing( const QgsCoordinateTransform &transform )
   }
 
   mDatasetGroupStore.reset( new QgsMeshDatasetGroupStore( this ) );
+  mDatasetGroupStore->setDatasetCache( mDatasetCacheSize, mDatasetPrefetchCount );
   mDatasetGroupStore->addDatasetGroup( new QgsMeshVerticesElevationDatasetGroup( tr( "vertices elevation" ), mNativeMesh.get() ) );
   resetDatasetGroupTreeItem();
 
@@ -1058,6 +1063,28 @@ void QgsMeshLayer::setMeshSimplificationSettings( const QgsMeshSimplificationSet
   mSimplificationSettings = simplifySettings;
 }
 
+void QgsMeshLayer::setDatasetCacheSize( qint64 size )
+{
+  mDatasetCacheSize = std::max< qint64 >( size, 0 );
+  mDatasetGroupStore->setDatasetCache( mDatasetCacheSize, mDatasetPrefetchCount );
+}
+
+qint64 QgsMeshLayer::datasetCacheSize() const
+{
+  return mDatasetCacheSize;
+}
+
+void QgsMeshLayer::setDatasetPrefetchCount( int count )
+{
+  mDatasetPrefetchCount = std::max( count, 0 );
+  mDatasetGroupStore->setDatasetCache( mDatasetCacheSize, mDatasetPrefetchCount );
+}
+
+int QgsMeshLayer::datasetPrefetchCount() const
+{
+  return mDatasetPrefetchCount;
+}
+
 static QgsColorRamp *_createDefaultColorRamp()
 {
   QgsColorRamp *ramp = QgsStyle::defaultStyle()->colorRamp( QStringLiteral( "Plasma" ) );
@@ -1299,6 +1326,15 @@ bool QgsMeshLayer::readXml( const QDomNode &layer_node, QgsReadWriteContext &con
     mStaticVectorDatasetIndex = elemStaticDataset.attribute( QStringLiteral( "vector" ) ).toInt();
   }
 
+  // read dataset cache
+  QDomElement elemDatasetCache = layer_node.firstChildElement( QStringLiteral( "dataset-cache" ) );
+  if ( !elemDatasetCache.isNull() )
+  {
+    mDatasetCacheSize = std::max< qint64 >( elemDatasetCache.attribute( QStringLiteral( "size" ), QStringLiteral( "0" ) ).toLongLong(), 0 );
+    mDatasetPrefetchCount = std::max( elemDatasetCache.attribute( QStringLiteral( "prefetch-count" ), QStringLiteral( "0" ) ).toInt(), 0 );
+    mDatasetGroupStore->setDatasetCache( mDatasetCacheSize, mDatasetPrefetchCount );
+  }
+
   return isValid(); // should be true if read successfully
 }
 
@@ -1341,6 +1377,11 @@ bool QgsMeshLayer::writeXml( QDomNode &layer_node, QDomDocument &document, const
   elemStaticDataset.setAttribute( QStringLiteral( "vector" ), mStaticVectorDatasetIndex );
   layer_node.appendChild( elemStaticDataset );
 
+  QDomElement elemDatasetCache = document.createElement( QStringLiteral( "dataset-cache" ) );
+  elemDatasetCache.setAttribute( QStringLiteral( "size" ), mDatasetCacheSize );
+  elemDatasetCache.setAttribute( QStringLiteral( "prefetch-count" ), mDatasetPrefetchCount );
+  layer_node.appendChild( elemDatasetCache );
+
   // write dataset group store
   layer_node.appendChild( mDatasetGroupStore->writeXml( document, context ) );
 
@@ -1353,6 +1394,7 @@ void QgsMeshLayer::reload()
 {
   if ( !mMeshEditor && mDataProvider && mDataProvider->isValid() )
   {
+    mDatasetGroupStore->clearDatasetCache();
     mDataProvider->reloadData();
 
     //reload the mesh structure
@@ -313,6 +313,50 @@ class CORE_EXPORT QgsMeshLayer : public QgsMapLayer
      */
     void setMeshSimplificationSettings( const QgsMeshSimplificationSettings &meshSimplificationSettings ) SIP_SKIP;
 
+    /**
+     * Sets the maximum \a size in bytes of the dataset values read from the data provider that are kept in memory.
+     *
+     * When the cache is enabled, moving back and forth between datasets of a group, for example with the temporal
+     * controller, does not read the values again from the data provider. A \a size of 0 (the default) disables the cache.
+     * The cache is accounted in kilobytes, so a \a size smaller than 1024 bytes disables the cache too.
+     *
+     * \see datasetCacheSize()
+     * \see setDatasetPrefetchCount()
+     * \since QGIS 3.22
+     */
+    void setDatasetCacheSize( qint64 size );
+
+    /**
+     * Returns the maximum size in bytes of the dataset values read from the data provider that are kept in memory.
+     *
+     * \see setDatasetCacheSize()
+     * \since QGIS 3.22
+     */
+    qint64 datasetCacheSize() const;
+
+    /**
+     * Sets the \a count of datasets following a requested dataset in the same group that are read in advance
+     * in a background thread, so that they are in the dataset cache when the next time steps are rendered.
+     *
+     * Only used when the dataset cache is enabled, see setDatasetCacheSize(). Reading in advance is disabled
+     * when \a count is 0 (the default).
+     *
+     * \note the datasets are read in advance with a second instance of the data provider, which
+     * loads the mesh again.
+     *
+     * \see datasetPrefetchCount()
+     * \since QGIS 3.22
+     */
+    void setDatasetPrefetchCount( int count );
+
+    /**
+     * Returns the count of datasets following a requested dataset in the same group that are read in advance.
+     *
+     * \see setDatasetPrefetchCount()
+     * \since QGIS 3.22
+     */
+    int datasetPrefetchCount() const;
+
     /**
      * Returns (date) time in hours formatted to human readable form
      * \param hours time in double in hours
@@ -866,6 +910,9 @@ class CORE_EXPORT QgsMeshLayer : public QgsMapLayer
     int mStaticScalarDatasetIndex = 0;
     int mStaticVectorDatasetIndex = 0;
 
+    qint64 mDatasetCacheSize = 0;
+    int mDatasetPrefetchCount = 0;
+
     QgsMeshEditor *mMeshEditor = nullptr;
 
     int closestEdge( const QgsPointXY &point, double searchRadius, QgsPointXY &projectedPoint ) const;
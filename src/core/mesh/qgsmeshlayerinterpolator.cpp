@@ -20,6 +20,9 @@
 #include <memory>
 #include <limits>
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include "qgsmeshlayerinterpolator.h"
 
 #include "qgis.h"
@@ -74,7 +77,6 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
   const double noDataValue = std::numeric_limits<double>::quiet_NaN();
   outputBlock->setNoDataValue( noDataValue );
   outputBlock->setIsNoData();  // assume initially that all values are unset
-  double *data = reinterpret_cast<double *>( outputBlock->bits() );
 
   QList<int> spatialIndexTriangles;
   int indexCount;
@@ -99,13 +101,16 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
   if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
     Q_ASSERT( mDatasetValues.count() == mTriangularMesh.vertices().count() );
 
+  // first collect the active triangles intersecting the extent, with their rectangle in pixels
+  std::vector<ScreenTriangle> screenTriangles;
+  screenTriangles.reserve( static_cast< std::size_t >( indexCount ) );
   for ( int i = 0; i < indexCount; ++i )
   {
     if ( feedback && feedback->isCanceled() )
-      break;
+      return outputBlock.release();
 
     if ( mContext.renderingStopped() )
-      break;
+      return outputBlock.release();
 
     int triangleIndex;
     if ( mSpatialIndexActive )
@@ -118,8 +123,7 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
     if ( face.isEmpty() )
       continue;
 
-    const int v1 = face[0], v2 = face[1], v3 = face[2];
-    const QgsPointXY &p1 = vertices[v1], &p2 = vertices[v2], &p3 = vertices[v3];
+    const QgsPointXY &p1 = vertices[face[0]], &p2 = vertices[face[1]], &p3 = vertices[face[2]];
 
     const int nativeFaceIndex = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
     const bool isActive = mActiveFaceFlagValues.active( nativeFaceIndex );
@@ -131,59 +135,143 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
       continue;
 
     // Get the BBox of the element in pixels
-    int topLim, bottomLim, leftLim, rightLim;
-    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox, leftLim, rightLim, topLim, bottomLim );
+    ScreenTriangle screenTriangle;
+    screenTriangle.triangleIndex = triangleIndex;
+    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox,
+        screenTriangle.leftLim, screenTriangle.rightLim, screenTriangle.topLim, screenTriangle.bottomLim );
+    if ( screenTriangle.leftLim > screenTriangle.rightLim || screenTriangle.topLim > screenTriangle.bottomLim )
+      continue;
 
-    double value( 0 ), value1( 0 ), value2( 0 ), value3( 0 );
-    const int faceIdx = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
+    screenTriangles.push_back( screenTriangle );
+  }
 
-    if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
+  // then rasterize them in bands of rows, each band on its own thread. Triangles are rasterized in the same
+  // order in all bands, so pixels shared by two triangles get the same value as with a single band.
+  const int rowCount = std::min( height, mOutputSize.height() );
+  const int bandCount = std::max( 1, std::min( QThread::idealThreadCount(), rowCount / MIN_ROWS_PER_BAND ) );
+  const int rowsPerBand = ( rowCount + bandCount - 1 ) / bandCount;
+
+  std::vector<RowBand> bands;
+  for ( int startRow = 0; startRow < rowCount; startRow += rowsPerBand )
+    bands.push_back( { startRow, std::min( startRow + rowsPerBand, rowCount ) - 1 } );
+
+  QgsRasterBlock *block = outputBlock.get();
+  const auto rasterizeBand = [this, block, width, feedback, &screenTriangles]( const RowBand & band )
+  {
+    rasterizeTriangles( block, width, band, screenTriangles, feedback );
+  };
+
+  if ( bands.empty() )
+    return outputBlock.release();
+  else if ( bands.size() == 1 )
+    rasterizeBand( bands.front() );
+  else
+    QtConcurrent::blockingMap( bands, rasterizeBand );
+
+  return outputBlock.release();
+}
+
+void QgsMeshLayerInterpolator::rasterizeTriangles( QgsRasterBlock *block, int width, const RowBand &band, const std::vector<ScreenTriangle> &screenTriangles, QgsRasterBlockFeedback *feedback ) const
+{
+  double *data = reinterpret_cast<double *>( block->bits() );
+  const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+  const QgsMapToPixel &mapToPixel = mContext.mapToPixel();
+
+  // pixel to map coordinates is affine, so moving one pixel right always adds the same vector
+  const QgsPointXY origin = mapToPixel.toMapCoordinates( 0, 0 );
+  const QgsPointXY nextColumn = mapToPixel.toMapCoordinates( 1, 0 );
+  const double columnStepX = nextColumn.x() - origin.x();
+  const double columnStepY = nextColumn.y() - origin.y();
+
+  // same tolerance as the one used by QgsMeshLayerUtils to detect points on the border of a triangle
+  constexpr double eps = 1e-6;
+
+  const bool dataOnVertices = mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices;
+
+  int processed = 0;
+  for ( const ScreenTriangle &screenTriangle : screenTriangles )
+  {
+    if ( ( ++processed % 1000 ) == 0 && ( ( feedback && feedback->isCanceled() ) || mContext.renderingStopped() ) )
+      return;
+
+    const int topLim = std::max( screenTriangle.topLim, band.startRow );
+    const int bottomLim = std::min( screenTriangle.bottomLim, band.endRow );
+    if ( topLim > bottomLim )
+      continue;
+
+    const QgsMeshFace &face = mTriangularMesh.triangles()[screenTriangle.triangleIndex];
+    const int v1 = face[0], v2 = face[1], v3 = face[2];
+    const QgsPointXY &p1 = vertices[v1], &p2 = vertices[v2], &p3 = vertices[v3];
+
+    double value( 0 ), value1( 0 ), value2( 0 ), value3( 0 );
+    if ( dataOnVertices )
     {
       value1 = mDatasetValues[v1];
       value2 = mDatasetValues[v2];
       value3 = mDatasetValues[v3];
     }
     else
-      value = mDatasetValues[faceIdx];
+    {
+      value = mDatasetValues[mTriangularMesh.trianglesToNativeFaces()[screenTriangle.triangleIndex]];
+    }
+
+    // barycentric coordinates are affine functions of the point: lam = gradient . ( point - p1 )
+    const double v0x = p3.x() - p1.x();
+    const double v0y = p3.y() - p1.y();
+    const double v1x = p2.x() - p1.x();
+    const double v1y = p2.y() - p1.y();
+    const double dot00 = v0x * v0x + v0y * v0y;
+    const double dot01 = v0x * v1x + v0y * v1y;
+    const double dot11 = v1x * v1x + v1y * v1y;
+    const double denom = dot00 * dot11 - dot01 * dot01;
+    if ( denom == 0 )
+      continue;
+
+    const double invDenom = 1.0 / denom;
+    const double gradient1X = ( dot11 * v0x - dot01 * v1x ) * invDenom;
+    const double gradient1Y = ( dot11 * v0y - dot01 * v1y ) * invDenom;
+    const double gradient2X = ( dot00 * v1x - dot01 * v0x ) * invDenom;
+    const double gradient2Y = ( dot00 * v1y - dot01 * v0y ) * invDenom;
+
+    const double lam1Step = gradient1X * columnStepX + gradient1Y * columnStepY;
+    const double lam2Step = gradient2X * columnStepX + gradient2Y * columnStepY;
+
+    const int leftLim = screenTriangle.leftLim;
+    const int columnCount = screenTriangle.rightLim - leftLim + 1;
 
-    // interpolate in the bounding box of the face
     for ( int j = topLim; j <= bottomLim; j++ )
     {
-      double *line = data + ( j * width );
-      for ( int k = leftLim; k <= rightLim; k++ )
+      const QgsPointXY rowStart = mapToPixel.toMapCoordinates( leftLim, j );
+      const double dx = rowStart.x() - p1.x();
+      const double dy = rowStart.y() - p1.y();
+      const double lam1Start = gradient1X * dx + gradient1Y * dy;
+      const double lam2Start = gradient2X * dx + gradient2Y * dy;
+
+      double *line = data + ( static_cast< qgssize >( j ) * width ) + leftLim;
+      for ( int k = 0; k < columnCount; k++ )
       {
+        const double lam1 = lam1Start + lam1Step * k;
+        const double lam2 = lam2Start + lam2Step * k;
+        const double lam3 = 1.0 - lam1 - lam2;
+
+        // outside of the triangle, even with the tolerance
+        if ( lam1 <= -eps || lam2 <= -eps || lam3 <= -eps )
+          continue;
+
         double val;
-        const QgsPointXY p = mContext.mapToPixel().toMapCoordinates( k, j );
-        if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
-          val = QgsMeshLayerUtils::interpolateFromVerticesData(
-                  p1,
-                  p2,
-                  p3,
-                  value1,
-                  value2,
-                  value3,
-                  p );
+        if ( dataOnVertices )
+          val = std::max( lam1, 0.0 ) * value3 + std::max( lam2, 0.0 ) * value2 + std::max( lam3, 0.0 ) * value1;
         else
-        {
-          val = QgsMeshLayerUtils::interpolateFromFacesData(
-                  p1,
-                  p2,
-                  p3,
-                  value,
-                  p
-                );
-        }
+          val = value;
+
         if ( !std::isnan( val ) )
         {
           line[k] = val;
-          outputBlock->setIsData( j, k );
+          block->setIsData( j, leftLim + k );
         }
       }
     }
-
   }
-
-  return outputBlock.release();
 }
 
 void QgsMeshLayerInterpolator::setSpatialIndexActive( bool active ) {mSpatialIndexActive = active;}
@@ -28,6 +28,7 @@ class QgsMeshDatasetIndex;
 #include "qgis_sip.h"
 
 #include <QSize>
+#include <vector>
 #include "qgsmaplayerrenderer.h"
 #include "qgstriangularmesh.h"
 #include "qgsrasterinterface.h"
@@ -71,6 +72,34 @@ class QgsMeshLayerInterpolator : public QgsRasterInterface SIP_SKIP
     void setSpatialIndexActive( bool active );
 
   private:
+    //! Active triangle intersecting the requested extent, with its bounding rectangle in pixels
+    struct ScreenTriangle
+    {
+      int triangleIndex = -1;
+      int leftLim = 0;
+      int rightLim = -1;
+      int topLim = 0;
+      int bottomLim = -1;
+    };
+
+    //! Range of rows of the output block, both rows included
+    struct RowBand
+    {
+      int startRow = 0;
+      int endRow = -1;
+    };
+
+    //! Minimum number of rows rasterized by a thread, smaller blocks are not worth splitting
+    static constexpr int MIN_ROWS_PER_BAND = 32;
+
+    /**
+     * Rasterizes the rows of \a band covered by \a screenTriangles in the data of \a block.
+     * Barycentric coordinates are computed once at the start of each row and then incremented
+     * from pixel to pixel.
+     */
+    void rasterizeTriangles( QgsRasterBlock *block, int width, const RowBand &band,
+                             const std::vector<ScreenTriangle> &screenTriangles, QgsRasterBlockFeedback *feedback ) const;
+
     const QgsTriangularMesh &mTriangularMesh;
     const QVector<double> &mDatasetValues;
     const QgsMeshDataBlock &mActiveFaceFlagValues;
@@ -0,0 +1,407 @@
+/***************************************************************************
+                         qgscopcpointcloudindex.cpp
+                         --------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgscopcpointcloudindex.h"
+
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "qgseptdecoder.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgspointcloudrequest.h"
+#include "qgspointcloudattribute.h"
+#include "qgslogger.h"
+#include "qgsmessagelog.h"
+
+///@cond PRIVATE
+
+//! Size of the LAS 1.4 header
+constexpr int LAS_HEADER_SIZE = 375;
+//! Size of the header of a variable length record
+constexpr int VLR_HEADER_SIZE = 54;
+//! Size of the header of an extended variable length record
+constexpr int EVLR_HEADER_SIZE = 60;
+//! Size of the COPC info variable length record
+constexpr int COPC_INFO_SIZE = 160;
+//! Size of an entry of a COPC hierarchy page
+constexpr int HIERARCHY_ENTRY_SIZE = 32;
+//! Maximum depth of the hierarchy pages, protects from cycles in corrupted files
+constexpr int MAX_HIERARCHY_PAGE_DEPTH = 64;
+
+template< typename T >
+static T readValue( const QByteArray &data, int position )
+{
+  return qFromLittleEndian< T >( reinterpret_cast< const uchar * >( data.constData() ) + position );
+}
+
+static double readDouble( const QByteArray &data, int position )
+{
+  double value;
+  memcpy( &value, data.constData() + position, sizeof( double ) );
+  return value;
+}
+
+//! Returns the null terminated string stored in the \a size bytes at \a position
+static QString readString( const QByteArray &data, int position, int size )
+{
+  const QByteArray field = data.mid( position, size );
+  const int end = field.indexOf( '\0' );
+  return QString::fromLatin1( end >= 0 ? field.left( end ) : field ).trimmed();
+}
+
+QgsCopcPointCloudIndex::QgsCopcPointCloudIndex() = default;
+
+QgsCopcPointCloudIndex::~QgsCopcPointCloudIndex()
+{
+  if ( mMappedData )
+    mFile->unmap( const_cast< uchar * >( mMappedData ) );
+}
+
+void QgsCopcPointCloudIndex::load( const QString &fileName )
+{
+  mFile = std::make_unique< QFile >( fileName );
+  if ( !mFile->open( QIODevice::ReadOnly ) )
+  {
+    QgsMessageLog::logMessage( tr( "Unable to open %1 for reading" ).arg( fileName ) );
+    mIsValid = false;
+    return;
+  }
+
+  mUri = QFileInfo( fileName ).absoluteFilePath();
+  mFileSize = mFile->size();
+  // nodes are read concurrently, which is straightforward with a memory mapping
+  mMappedData = mFile->map( 0, mFileSize );
+  if ( !mMappedData )
+    QgsDebugMsgLevel( QStringLiteral( "Unable to map %1 in memory, using positional reads" ).arg( fileName ), 2 );
+
+  mIsValid = loadHeader();
+}
+
+QByteArray QgsCopcPointCloudIndex::readBytes( quint64 offset, quint64 size ) const
+{
+  if ( offset + size > static_cast< quint64 >( mFileSize ) || offset + size < offset )
+    return QByteArray();
+  // QByteArray sizes are int
+  if ( size > static_cast< quint64 >( std::numeric_limits< int >::max() ) )
+    return QByteArray();
+
+  if ( mMappedData )
+    return QByteArray::fromRawData( reinterpret_cast< const char * >( mMappedData + offset ), static_cast< int >( size ) );
+
+  QMutexLocker locker( &mFileMutex );
+  if ( !mFile->seek( static_cast< qint64 >( offset ) ) )
+    return QByteArray();
+  const QByteArray data = mFile->read( static_cast< qint64 >( size ) );
+  return static_cast< quint64 >( data.size() ) == size ? data : QByteArray();
+}
+
+bool QgsCopcPointCloudIndex::loadHeader()
+{
+  const QByteArray header = readBytes( 0, LAS_HEADER_SIZE );
+  if ( header.isEmpty() || !header.startsWith( "LASF" ) )
+    return false;
+
+  const int versionMajor = static_cast< quint8 >( header.at( 24 ) );
+  const int versionMinor = static_cast< quint8 >( header.at( 25 ) );
+  if ( versionMajor != 1 || versionMinor < 4 )
+    return false;
+
+  const quint16 headerSize = readValue< quint16 >( header, 94 );
+  const quint32 vlrCount = readValue< quint32 >( header, 100 );
+  // the two high bits of the point format flag compressed data
+  mPointFormat = static_cast< quint8 >( header.at( 104 ) ) & 0x3f;
+  mPointRecordLength = readValue< quint16 >( header, 105 );
+  if ( mPointFormat < 6 || mPointFormat > 8 )
+  {
+    QgsDebugMsg( QStringLiteral( "Unsupported point format %1" ).arg( mPointFormat ) );
+    return false;
+  }
+
+  mScale.set( readDouble( header, 131 ), readDouble( header, 139 ), readDouble( header, 147 ) );
+  mOffset.set( readDouble( header, 155 ), readDouble( header, 163 ), readDouble( header, 171 ) );
+  mHeaderMaximum.set( readDouble( header, 179 ), readDouble( header, 195 ), readDouble( header, 211 ) );
+  mHeaderMinimum.set( readDouble( header, 187 ), readDouble( header, 203 ), readDouble( header, 219 ) );
+  const quint64 evlrOffset = readValue< quint64 >( header, 235 );
+  const quint32 evlrCount = readValue< quint32 >( header, 243 );
+  mPointCount = static_cast< qint64 >( readValue< quint64 >( header, 247 ) );
+
+  mExtent.set( mHeaderMinimum.x(), mHeaderMinimum.y(), mHeaderMaximum.x(), mHeaderMaximum.y() );
+  mZMin = mHeaderMinimum.z();
+  mZMax = mHeaderMaximum.z();
+
+  // the COPC info must be the first variable length record
+  const QByteArray copcInfoHeader = readBytes( headerSize, VLR_HEADER_SIZE );
+  if ( copcInfoHeader.isEmpty() || readString( copcInfoHeader, 2, 16 ) != QLatin1String( "copc" ) || readValue< quint16 >( copcInfoHeader, 18 ) != 1 )
+  {
+    QgsDebugMsg( QStringLiteral( "Missing COPC info record" ) );
+    return false;
+  }
+  const QByteArray copcInfo = readBytes( headerSize + VLR_HEADER_SIZE, COPC_INFO_SIZE );
+  if ( copcInfo.isEmpty() )
+    return false;
+
+  const QgsVector3D center( readDouble( copcInfo, 0 ), readDouble( copcInfo, 8 ), readDouble( copcInfo, 16 ) );
+  const double halfSize = readDouble( copcInfo, 24 );
+  const double spacing = readDouble( copcInfo, 32 );
+  const quint64 rootHierarchyOffset = readValue< quint64 >( copcInfo, 40 );
+  const quint64 rootHierarchySize = readValue< quint64 >( copcInfo, 48 );
+
+  // the CRS is stored as WKT, either in a variable length record or in an extended one
+  quint64 recordOffset = headerSize;
+  for ( quint32 i = 0; i < vlrCount; ++i )
+  {
+    const QByteArray recordHeader = readBytes( recordOffset, VLR_HEADER_SIZE );
+    if ( recordHeader.isEmpty() )
+      return false;
+    const quint16 recordLength = readValue< quint16 >( recordHeader, 20 );
+    if ( readString( recordHeader, 2, 16 ) == QLatin1String( "LASF_Projection" ) && readValue< quint16 >( recordHeader, 18 ) == 2112 )
+      mWkt = readString( readBytes( recordOffset + VLR_HEADER_SIZE, recordLength ), 0, recordLength );
+    recordOffset += VLR_HEADER_SIZE + recordLength;
+  }
+  recordOffset = evlrOffset;
+  for ( quint32 i = 0; i < evlrCount && mWkt.isEmpty(); ++i )
+  {
+    const QByteArray recordHeader = readBytes( recordOffset, EVLR_HEADER_SIZE );
+    if ( recordHeader.isEmpty() )
+      break;
+    const quint64 recordLength = readValue< quint64 >( recordHeader, 20 );
+    if ( readString( recordHeader, 2, 16 ) == QLatin1String( "LASF_Projection" ) && readValue< quint16 >( recordHeader, 18 ) == 2112 )
+      mWkt = readString( readBytes( recordOffset + EVLR_HEADER_SIZE, recordLength ), 0, static_cast< int >( recordLength ) );
+    recordOffset += EVLR_HEADER_SIZE + recordLength;
+  }
+
+  QgsPointCloudAttributeCollection attributes;
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "X" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Y" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Z" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Intensity" ), QgsPointCloudAttribute::UShort ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "ReturnNumber" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "NumberOfReturns" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "ScanDirectionFlag" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "EdgeOfFlightLine" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Classification" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "ScanAngleRank" ), QgsPointCloudAttribute::Short ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "UserData" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "PointSourceId" ), QgsPointCloudAttribute::UShort ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Synthetic" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "KeyPoint" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Withheld" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Overlap" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "ScannerChannel" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "GpsTime" ), QgsPointCloudAttribute::Double ) );
+  if ( mPointFormat == 7 || mPointFormat == 8 )
+  {
+    attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Red" ), QgsPointCloudAttribute::UShort ) );
+    attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Green" ), QgsPointCloudAttribute::UShort ) );
+    attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Blue" ), QgsPointCloudAttribute::UShort ) );
+  }
+  if ( mPointFormat == 8 )
+  {
+    attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Infrared" ), QgsPointCloudAttribute::UShort ) );
+  }
+  setAttributes( attributes );
+
+  // bounds (cube - octree volume)
+  mRootBounds = QgsPointCloudDataBounds(
+                  ( center.x() - halfSize - mOffset.x() ) / mScale.x(),
+                  ( center.y() - halfSize - mOffset.y() ) / mScale.y(),
+                  ( center.z() - halfSize - mOffset.z() ) / mScale.z(),
+                  ( center.x() + halfSize - mOffset.x() ) / mScale.x(),
+                  ( center.y() + halfSize - mOffset.y() ) / mScale.y(),
+                  ( center.z() + halfSize - mOffset.z() ) / mScale.z()
+                );
+
+  // the spacing is the distance between the points of the root node
+  mSpan = spacing > 0 ? std::max( 1, static_cast< int >( std::round( 2 * halfSize / spacing ) ) ) : 128;
+
+  mOriginalMetadata.insert( QStringLiteral( "major_version" ), versionMajor );
+  mOriginalMetadata.insert( QStringLiteral( "minor_version" ), versionMinor );
+  mOriginalMetadata.insert( QStringLiteral( "dataformat_id" ), mPointFormat );
+  mOriginalMetadata.insert( QStringLiteral( "system_id" ), readString( header, 26, 32 ) );
+  mOriginalMetadata.insert( QStringLiteral( "software_id" ), readString( header, 58, 32 ) );
+  mOriginalMetadata.insert( QStringLiteral( "creation_doy" ), readValue< quint16 >( header, 90 ) );
+  mOriginalMetadata.insert( QStringLiteral( "creation_year" ), readValue< quint16 >( header, 92 ) );
+  mOriginalMetadata.insert( QStringLiteral( "count" ), mPointCount );
+
+  return loadHierarchyPage( rootHierarchyOffset, rootHierarchySize, 0 );
+}
+
+bool QgsCopcPointCloudIndex::loadHierarchyPage( quint64 offset, quint64 size, int depth )
+{
+  if ( depth > MAX_HIERARCHY_PAGE_DEPTH )
+    return false;
+
+  const QByteArray page = readBytes( offset, size );
+  if ( page.isEmpty() && size > 0 )
+  {
+    QgsDebugMsg( QStringLiteral( "Unable to read hierarchy page at %1" ).arg( offset ) );
+    return false;
+  }
+
+  for ( int position = 0; position + HIERARCHY_ENTRY_SIZE <= page.size(); position += HIERARCHY_ENTRY_SIZE )
+  {
+    const IndexedPointCloudNode node( readValue< qint32 >( page, position ),
+                                      readValue< qint32 >( page, position + 4 ),
+                                      readValue< qint32 >( page, position + 8 ),
+                                      readValue< qint32 >( page, position + 12 ) );
+    const quint64 entryOffset = readValue< quint64 >( page, position + 16 );
+    const qint32 byteSize = readValue< qint32 >( page, position + 24 );
+    const qint32 pointCount = readValue< qint32 >( page, position + 28 );
+
+    if ( pointCount < 0 )
+    {
+      // the node hierarchy continues in a child page
+      if ( !loadHierarchyPage( entryOffset, static_cast< quint64 >( std::max( byteSize, 0 ) ), depth + 1 ) )
+        return false;
+      continue;
+    }
+
+    QMutexLocker locker( &mHierarchyMutex );
+    mHierarchy[ node ] = pointCount;
+    ChunkPosition chunk;
+    chunk.offset = entryOffset;
+    chunk.size = byteSize;
+    mChunkPositions.insert( node, chunk );
+  }
+  return true;
+}
+
+QgsPointCloudBlock *QgsCopcPointCloudIndex::nodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
+{
+  mHierarchyMutex.lock();
+  const bool found = mHierarchy.contains( n );
+  const int pointCount = mHierarchy.value( n );
+  const ChunkPosition chunk = mChunkPositions.value( n );
+  mHierarchyMutex.unlock();
+  if ( !found )
+    return nullptr;
+
+  if ( QgsPointCloudBlock *cached = nodeDataFromCache( n, request ) )
+    return cached;
+
+  std::unique_ptr< QgsPointCloudBlock > block;
+  if ( pointCount == 0 )
+  {
+    block = std::make_unique< QgsPointCloudBlock >( 0, request.attributes(), QByteArray(), scale(), offset() );
+  }
+  else
+  {
+    const QByteArray data = readBytes( chunk.offset, static_cast< quint64 >( std::max( chunk.size, 0 ) ) );
+    if ( data.isEmpty() )
+    {
+      QgsDebugMsg( QStringLiteral( "Unable to read the chunk of node %1" ).arg( n.toString() ) );
+      return nullptr;
+    }
+    block.reset( QgsEptDecoder::decompressCopc( data, mPointFormat, mPointRecordLength, pointCount, request.attributes(), scale(), offset() ) );
+  }
+
+  storeNodeDataToCache( block.get(), n, request );
+  return block.release();
+}
+
+QgsPointCloudBlockRequest *QgsCopcPointCloudIndex::asyncNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
+{
+  // local files are read synchronously with nodeData(), callers only request nodes
+  // asynchronously from remote indexes
+  Q_UNUSED( n );
+  Q_UNUSED( request );
+  return nullptr; // unsupported
+}
+
+QgsCoordinateReferenceSystem QgsCopcPointCloudIndex::crs() const
+{
+  return QgsCoordinateReferenceSystem::fromWkt( mWkt );
+}
+
+qint64 QgsCopcPointCloudIndex::pointCount() const
+{
+  return mPointCount;
+}
+
+QVariant QgsCopcPointCloudIndex::metadataStatistic( const QString &attribute, QgsStatisticalSummary::Statistic statistic ) const
+{
+  // only the ranges of the coordinates are stored in the LAS header
+  int axis = -1;
+  if ( attribute == QLatin1String( "X" ) )
+    axis = 0;
+  else if ( attribute == QLatin1String( "Y" ) )
+    axis = 1;
+  else if ( attribute == QLatin1String( "Z" ) )
+    axis = 2;
+  else
+    return QVariant();
+
+  const double minimum = axis == 0 ? mHeaderMinimum.x() : axis == 1 ? mHeaderMinimum.y() : mHeaderMinimum.z();
+  const double maximum = axis == 0 ? mHeaderMaximum.x() : axis == 1 ? mHeaderMaximum.y() : mHeaderMaximum.z();
+  switch ( statistic )
+  {
+    case QgsStatisticalSummary::Count:
+      return mPointCount;
+
+    case QgsStatisticalSummary::Min:
+      return minimum;
+
+    case QgsStatisticalSummary::Max:
+      return maximum;
+
+    case QgsStatisticalSummary::Range:
+      return maximum - minimum;
+
+    case QgsStatisticalSummary::Mean:
+    case QgsStatisticalSummary::StDev:
+    case QgsStatisticalSummary::CountMissing:
+    case QgsStatisticalSummary::Sum:
+    case QgsStatisticalSummary::Median:
+    case QgsStatisticalSummary::StDevSample:
+    case QgsStatisticalSummary::Minority:
+    case QgsStatisticalSummary::Majority:
+    case QgsStatisticalSummary::Variety:
+    case QgsStatisticalSummary::FirstQuartile:
+    case QgsStatisticalSummary::ThirdQuartile:
+    case QgsStatisticalSummary::InterQuartileRange:
+    case QgsStatisticalSummary::First:
+    case QgsStatisticalSummary::Last:
+    case QgsStatisticalSummary::All:
+      return QVariant();
+  }
+  return QVariant();
+}
+
+QVariantList QgsCopcPointCloudIndex::metadataClasses( const QString &attribute ) const
+{
+  Q_UNUSED( attribute );
+  return QVariantList();
+}
+
+QVariant QgsCopcPointCloudIndex::metadataClassStatistic( const QString &attribute, const QVariant &value, QgsStatisticalSummary::Statistic statistic ) const
+{
+  Q_UNUSED( attribute );
+  Q_UNUSED( value );
+  Q_UNUSED( statistic );
+  return QVariant();
+}
+
+bool QgsCopcPointCloudIndex::isValid() const
+{
+  return mIsValid;
+}
+
+///@endcond
@@ -0,0 +1,102 @@
+/***************************************************************************
+                         qgscopcpointcloudindex.h
+                         --------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSCOPCPOINTCLOUDINDEX_H
+#define QGSCOPCPOINTCLOUDINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+
+#include <memory>
+
+#include "qgspointcloudindex.h"
+#include "qgsvector3d.h"
+#include "qgis_sip.h"
+
+///@cond PRIVATE
+#define SIP_NO_FILE
+
+class QgsCoordinateReferenceSystem;
+
+/**
+ * Point cloud index reading a Cloud Optimized Point Cloud (COPC) file.
+ *
+ * A COPC file is a LAZ 1.4 file whose point chunks are the nodes of an octree. The header and
+ * the hierarchy are read when the file is loaded, the chunk of a node is only read and
+ * decompressed when its data is requested. The file is mapped in memory when possible, and
+ * read with positional reads otherwise.
+ */
+class CORE_EXPORT QgsCopcPointCloudIndex: public QgsPointCloudIndex
+{
+    Q_OBJECT
+  public:
+
+    explicit QgsCopcPointCloudIndex();
+    ~QgsCopcPointCloudIndex();
+
+    void load( const QString &fileName ) override;
+
+    QgsPointCloudBlock *nodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) override;
+    QgsPointCloudBlockRequest *asyncNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) override;
+
+    QgsCoordinateReferenceSystem crs() const override;
+    qint64 pointCount() const override;
+    QVariant metadataStatistic( const QString &attribute, QgsStatisticalSummary::Statistic statistic ) const override;
+    QVariantList metadataClasses( const QString &attribute ) const override;
+    QVariant metadataClassStatistic( const QString &attribute, const QVariant &value, QgsStatisticalSummary::Statistic statistic ) const override;
+    QVariantMap originalMetadata() const override { return mOriginalMetadata; }
+
+    bool isValid() const override;
+    QgsPointCloudIndex::AccessType accessType() const override { return QgsPointCloudIndex::Local; };
+
+  private:
+    //! Reads the LAS header and the variable length records, including the COPC info
+    bool loadHeader();
+    //! Reads the hierarchy page at \a offset and its child pages
+    bool loadHierarchyPage( quint64 offset, quint64 size, int depth );
+    //! Returns \a size bytes of the file from \a offset, or an empty array if the range is not in the file
+    QByteArray readBytes( quint64 offset, quint64 size ) const;
+
+    struct ChunkPosition
+    {
+      quint64 offset = 0;
+      qint32 size = 0;
+    };
+
+    bool mIsValid = false;
+
+    std::unique_ptr< QFile > mFile;
+    qint64 mFileSize = 0;
+    const uchar *mMappedData = nullptr; //!< Whole file content, if the file could be mapped in memory
+    mutable QMutex mFileMutex; //!< Protects the reads when the file could not be mapped
+
+    int mPointFormat = 0;
+    int mPointRecordLength = 0;
+    qint64 mPointCount = 0;
+    QString mWkt;
+
+    QgsVector3D mHeaderMinimum;
+    QgsVector3D mHeaderMaximum;
+
+    QHash< IndexedPointCloudNode, ChunkPosition > mChunkPositions; //!< Position of the compressed chunk of each node in the file
+    QVariantMap mOriginalMetadata;
+};
+
+///@endcond
+#endif // QGSCOPCPOINTCLOUDINDEX_H
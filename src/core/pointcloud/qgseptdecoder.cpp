@@ -34,6 +34,11 @@
 #include "laz-perf/io.hpp"
 #include "laz-perf/common/common.hpp"
 
+#ifdef HAVE_COPC
+#include <QtEndian>
+#include <lazperf/readers.hpp>
+#endif
+
 ///@cond PRIVATE
 
 template <typename T>
@@ -501,4 +506,228 @@ QgsPointCloudBlock *QgsEptDecoder::decompressLaz( const QByteArray &byteArrayDat
   return __decompressLaz<std::istringstream>( file, attributes, requestedAttributes, scale, offset );
 }
 
+#ifdef HAVE_COPC
+
+QgsPointCloudBlock *QgsEptDecoder::decompressCopc( const QByteArray &data, int pointFormat, int pointRecordLength, int pointCount,
+    const QgsPointCloudAttributeCollection &requestedAttributes,
+    const QgsVector3D &scale, const QgsVector3D &offset )
+{
+  // size of the standard fields of the LAS 1.4 point formats, the rest of a record holds extra bytes
+  int standardRecordLength = 0;
+  switch ( pointFormat )
+  {
+    case 6:
+      standardRecordLength = 30;
+      break;
+    case 7:
+      standardRecordLength = 36;
+      break;
+    case 8:
+      standardRecordLength = 38;
+      break;
+    default:
+      return nullptr;  // unsupported
+  }
+  if ( pointRecordLength < standardRecordLength || pointCount < 0 )
+    return nullptr;
+
+#ifdef QGISDEBUG
+  auto start = common::tick();
+#endif
+
+  enum class CopcAttribute
+  {
+    X,
+    Y,
+    Z,
+    Intensity,
+    ReturnNumber,
+    NumberOfReturns,
+    Synthetic,
+    KeyPoint,
+    Withheld,
+    Overlap,
+    ScannerChannel,
+    ScanDirectionFlag,
+    EdgeOfFlightLine,
+    Classification,
+    UserData,
+    ScanAngleRank,
+    PointSourceId,
+    GpsTime,
+    Red,
+    Green,
+    Blue,
+    Infrared,
+    MissingOrUnknown
+  };
+
+  struct RequestedAttributeDetails
+  {
+    RequestedAttributeDetails( CopcAttribute attribute, QgsPointCloudAttribute::DataType type, int size )
+      : attribute( attribute )
+      , type( type )
+      , size( size )
+    {}
+
+    CopcAttribute attribute;
+    QgsPointCloudAttribute::DataType type;
+    int size;
+  };
+
+  static const QHash< QString, CopcAttribute > sAttributeNames
+  {
+    { QStringLiteral( "x" ), CopcAttribute::X },
+    { QStringLiteral( "y" ), CopcAttribute::Y },
+    { QStringLiteral( "z" ), CopcAttribute::Z },
+    { QStringLiteral( "intensity" ), CopcAttribute::Intensity },
+    { QStringLiteral( "returnnumber" ), CopcAttribute::ReturnNumber },
+    { QStringLiteral( "numberofreturns" ), CopcAttribute::NumberOfReturns },
+    { QStringLiteral( "synthetic" ), CopcAttribute::Synthetic },
+    { QStringLiteral( "keypoint" ), CopcAttribute::KeyPoint },
+    { QStringLiteral( "withheld" ), CopcAttribute::Withheld },
+    { QStringLiteral( "overlap" ), CopcAttribute::Overlap },
+    { QStringLiteral( "scannerchannel" ), CopcAttribute::ScannerChannel },
+    { QStringLiteral( "scandirectionflag" ), CopcAttribute::ScanDirectionFlag },
+    { QStringLiteral( "edgeofflightline" ), CopcAttribute::EdgeOfFlightLine },
+    { QStringLiteral( "classification" ), CopcAttribute::Classification },
+    { QStringLiteral( "userdata" ), CopcAttribute::UserData },
+    { QStringLiteral( "scananglerank" ), CopcAttribute::ScanAngleRank },
+    { QStringLiteral( "pointsourceid" ), CopcAttribute::PointSourceId },
+    { QStringLiteral( "gpstime" ), CopcAttribute::GpsTime },
+    { QStringLiteral( "red" ), CopcAttribute::Red },
+    { QStringLiteral( "green" ), CopcAttribute::Green },
+    { QStringLiteral( "blue" ), CopcAttribute::Blue },
+    { QStringLiteral( "infrared" ), CopcAttribute::Infrared },
+  };
+
+  const QVector<QgsPointCloudAttribute> requestedAttributesVector = requestedAttributes.attributes();
+  std::vector< RequestedAttributeDetails > requestedAttributeDetails;
+  requestedAttributeDetails.reserve( requestedAttributesVector.size() );
+  for ( const QgsPointCloudAttribute &requestedAttribute : requestedAttributesVector )
+  {
+    CopcAttribute attribute = sAttributeNames.value( requestedAttribute.name().toLower(), CopcAttribute::MissingOrUnknown );
+    // colors and infrared are only stored in some point formats
+    if ( ( pointFormat == 6 && ( attribute == CopcAttribute::Red || attribute == CopcAttribute::Green || attribute == CopcAttribute::Blue ) )
+         || ( pointFormat != 8 && attribute == CopcAttribute::Infrared ) )
+      attribute = CopcAttribute::MissingOrUnknown;
+    requestedAttributeDetails.emplace_back( RequestedAttributeDetails( attribute, requestedAttribute.type(), requestedAttribute.size() ) );
+  }
+
+  const size_t requestedPointRecordSize = requestedAttributes.pointRecordSize();
+  QByteArray blockData;
+  blockData.resize( requestedPointRecordSize * pointCount );
+  char *dataBuffer = blockData.data();
+  std::size_t outputOffset = 0;
+
+  QByteArray recordArray( pointRecordLength, 0 );
+  const uchar *record = reinterpret_cast< const uchar * >( recordArray.constData() );
+
+  try
+  {
+    lazperf::reader::chunk_decompressor decompressor( pointFormat, pointRecordLength - standardRecordLength, data.constData() );
+
+    for ( int i = 0; i < pointCount; ++i )
+    {
+      decompressor.decompress( recordArray.data() );
+
+      for ( const RequestedAttributeDetails &requestedAttribute : requestedAttributeDetails )
+      {
+        switch ( requestedAttribute.attribute )
+        {
+          case CopcAttribute::X:
+            _storeToStream<qint32>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<qint32>( record ) );
+            break;
+          case CopcAttribute::Y:
+            _storeToStream<qint32>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<qint32>( record + 4 ) );
+            break;
+          case CopcAttribute::Z:
+            _storeToStream<qint32>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<qint32>( record + 8 ) );
+            break;
+          case CopcAttribute::Intensity:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 12 ) );
+            break;
+          case CopcAttribute::ReturnNumber:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[14] & 0x0f );
+            break;
+          case CopcAttribute::NumberOfReturns:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[14] >> 4 );
+            break;
+          case CopcAttribute::Synthetic:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[15] & 0x01 );
+            break;
+          case CopcAttribute::KeyPoint:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, ( record[15] >> 1 ) & 0x01 );
+            break;
+          case CopcAttribute::Withheld:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, ( record[15] >> 2 ) & 0x01 );
+            break;
+          case CopcAttribute::Overlap:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, ( record[15] >> 3 ) & 0x01 );
+            break;
+          case CopcAttribute::ScannerChannel:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, ( record[15] >> 4 ) & 0x03 );
+            break;
+          case CopcAttribute::ScanDirectionFlag:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, ( record[15] >> 6 ) & 0x01 );
+            break;
+          case CopcAttribute::EdgeOfFlightLine:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[15] >> 7 );
+            break;
+          case CopcAttribute::Classification:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[16] );
+            break;
+          case CopcAttribute::UserData:
+            _storeToStream<unsigned char>( dataBuffer, outputOffset, requestedAttribute.type, record[17] );
+            break;
+          case CopcAttribute::ScanAngleRank:
+            _storeToStream<qint16>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<qint16>( record + 18 ) );
+            break;
+          case CopcAttribute::PointSourceId:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 20 ) );
+            break;
+          case CopcAttribute::GpsTime:
+          {
+            double gpsTime;
+            memcpy( &gpsTime, record + 22, sizeof( double ) );
+            _storeToStream<double>( dataBuffer, outputOffset, requestedAttribute.type, gpsTime );
+            break;
+          }
+          case CopcAttribute::Red:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 30 ) );
+            break;
+          case CopcAttribute::Green:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 32 ) );
+            break;
+          case CopcAttribute::Blue:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 34 ) );
+            break;
+          case CopcAttribute::Infrared:
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, qFromLittleEndian<quint16>( record + 36 ) );
+            break;
+          case CopcAttribute::MissingOrUnknown:
+            // just store 0 for unknown/missing attributes
+            _storeToStream<unsigned short>( dataBuffer, outputOffset, requestedAttribute.type, 0 );
+            break;
+        }
+
+        outputOffset += requestedAttribute.size;
+      }
+    }
+  }
+  catch ( std::exception &e )
+  {
+    QgsDebugMsg( QStringLiteral( "Error decompressing COPC chunk: %1" ).arg( e.what() ) );
+    return nullptr;
+  }
+
+#ifdef QGISDEBUG
+  float t = common::since( start );
+  QgsDebugMsgLevel( QStringLiteral( "LAZ-PERF Read through the points in %1 seconds." ).arg( t ), 2 );
+#endif
+  return new QgsPointCloudBlock( pointCount, requestedAttributes, blockData, scale, offset );
+}
+
+#endif
+
 ///@endcond
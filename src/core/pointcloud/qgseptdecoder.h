@@ -21,6 +21,7 @@
 
 #include "qgis_core.h"
 #include "qgis_sip.h"
+#include "qgsconfig.h"
 #include "qgspointcloudblock.h"
 #include "qgspointcloudattribute.h"
 
@@ -37,6 +38,10 @@ namespace QgsEptDecoder
   QgsPointCloudBlock *decompressZStandard( const QByteArray &data, const QgsPointCloudAttributeCollection &attributes, const QgsPointCloudAttributeCollection &requestedAttributes, const QgsVector3D &scale, const QgsVector3D &offset );
   QgsPointCloudBlock *decompressLaz( const QString &filename, const QgsPointCloudAttributeCollection &attributes, const QgsPointCloudAttributeCollection &requestedAttributes, const QgsVector3D &scale, const QgsVector3D &offset );
   QgsPointCloudBlock *decompressLaz( const QByteArray &data, const QgsPointCloudAttributeCollection &attributes, const QgsPointCloudAttributeCollection &requestedAttributes, const QgsVector3D &scale, const QgsVector3D &offset );
+#ifdef HAVE_COPC
+  //! Decompresses the LAZ chunk of a COPC node, made of \a pointCount records of LAS 1.4 point format \a pointFormat (6, 7 or 8)
+  QgsPointCloudBlock *decompressCopc( const QByteArray &data, int pointFormat, int pointRecordLength, int pointCount, const QgsPointCloudAttributeCollection &requestedAttributes, const QgsVector3D &scale, const QgsVector3D &offset );
+#endif
 };
 
 ///@endcond
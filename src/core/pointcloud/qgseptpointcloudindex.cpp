@@ -55,6 +55,7 @@ void QgsEptPointCloudIndex::load( const QString &fileName )
 
   const QDir directory = QFileInfo( fileName ).absoluteDir();
   mDirectory = directory.absolutePath();
+  mUri = QFileInfo( fileName ).absoluteFilePath();
 
   const QByteArray dataJson = f.readAll();
   bool success = loadSchema( dataJson );
@@ -279,25 +280,32 @@ QgsPointCloudBlock *QgsEptPointCloudIndex::nodeData( const IndexedPointCloudNode
   if ( !found )
     return nullptr;
 
+  if ( QgsPointCloudBlock *cached = nodeDataFromCache( n, request ) )
+    return cached;
+
+  std::unique_ptr< QgsPointCloudBlock > block;
   if ( mDataType == QLatin1String( "binary" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.bin" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressBinary( filename, attributes(), request.attributes(), scale(), offset() );
+    block.reset( QgsEptDecoder::decompressBinary( filename, attributes(), request.attributes(), scale(), offset() ) );
   }
   else if ( mDataType == QLatin1String( "zstandard" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.zst" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset() );
+    block.reset( QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset() ) );
   }
   else if ( mDataType == QLatin1String( "laszip" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.laz" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressLaz( filename, attributes(), request.attributes(), scale(), offset() );
+    block.reset( QgsEptDecoder::decompressLaz( filename, attributes(), request.attributes(), scale(), offset() ) );
   }
   else
   {
     return nullptr;  // unsupported
   }
+
+  storeNodeDataToCache( block.get(), n, request );
+  return block.release();
 }
 
 QgsPointCloudBlockRequest *QgsEptPointCloudIndex::asyncNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
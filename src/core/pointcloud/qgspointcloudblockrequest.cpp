@@ -21,6 +21,8 @@
 #include "qgseptdecoder.h"
 #include "qgsapplication.h"
 
+#include <QTimer>
+
 //
 // QgsPointCloudBlockRequest
 //
@@ -41,6 +43,14 @@ QgsPointCloudBlockRequest::QgsPointCloudBlockRequest( const IndexedPointCloudNod
   connect( mTileDownloadManagetReply.get(), &QgsTileDownloadManagerReply::finished, this, &QgsPointCloudBlockRequest::blockFinishedLoading );
 }
 
+QgsPointCloudBlockRequest::QgsPointCloudBlockRequest( const IndexedPointCloudNode &node, QgsPointCloudBlock *block )
+  : mNode( node )
+  , mBlock( block )
+{
+  // callers connect to finished() after the request is created
+  QTimer::singleShot( 0, this, &QgsPointCloudBlockRequest::finished );
+}
+
 QgsPointCloudBlock *QgsPointCloudBlockRequest::block()
 {
   return mBlock;
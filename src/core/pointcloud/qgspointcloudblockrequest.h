@@ -50,6 +50,14 @@ class CORE_EXPORT QgsPointCloudBlockRequest : public QObject
                                const QgsPointCloudAttributeCollection &attributes, const QgsPointCloudAttributeCollection &requestedAttributes,
                                const QgsVector3D &scale, const QgsVector3D &offset );
 
+    /**
+     * QgsPointCloudBlockRequest constructor for a \a block of \a node which is already decoded,
+     * e.g. from the node data cache. The finished() signal is emitted once the event loop runs.
+     * Note: It is the responsablitiy of the caller to delete the block
+     * \since QGIS 3.22
+     */
+    QgsPointCloudBlockRequest( const IndexedPointCloudNode &node, QgsPointCloudBlock *block );
+
     /**
      * Returns the requested block. if the returned block is nullptr, that means the data request failed
      * Note: It is the responsablitiy of the caller to delete the block if it was loaded correctly
@@ -26,6 +26,7 @@
 #include <QtDebug>
 
 #include "qgstiledownloadmanager.h"
+#include "qgspointcloudrequest.h"
 
 IndexedPointCloudNode::IndexedPointCloudNode():
   mD( -1 ),
@@ -90,6 +91,32 @@ uint qHash( IndexedPointCloudNode id )
 // QgsPointCloudDataBounds
 //
 
+///////////////
+
+QgsPointCloudCacheKey::QgsPointCloudCacheKey( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request, const QString &uri )
+  : mNode( n )
+  , mUri( uri )
+{
+  const QgsPointCloudAttributeCollection attributes = request.attributes();
+  for ( int i = 0; i < attributes.count(); ++i )
+  {
+    const QgsPointCloudAttribute &attribute = attributes.at( i );
+    mAttributes += QStringLiteral( "%1:%2;" ).arg( attribute.name() ).arg( static_cast< int >( attribute.type() ) );
+  }
+}
+
+bool QgsPointCloudCacheKey::operator==( const QgsPointCloudCacheKey &other ) const
+{
+  return mNode == other.mNode && mUri == other.mUri && mAttributes == other.mAttributes;
+}
+
+uint qHash( const QgsPointCloudCacheKey &key )
+{
+  return qHash( key.node() ) ^ qHash( key.uri() ) ^ qHash( key.attributes() );
+}
+
+///////////////
+
 QgsPointCloudDataBounds::QgsPointCloudDataBounds() = default;
 
 QgsPointCloudDataBounds::QgsPointCloudDataBounds( qint32 xmin, qint32 ymin, qint32 zmin, qint32 xmax, qint32 ymax, qint32 zmax )
@@ -152,6 +179,9 @@ QgsDoubleRange QgsPointCloudDataBounds::zRange( const QgsVector3D &offset, const
 // QgsPointCloudIndex
 //
 
+QCache< QgsPointCloudCacheKey, QgsPointCloudBlock > QgsPointCloudIndex::sBlockCache( 256 * 1024 * 1024 );
+QMutex QgsPointCloudIndex::sBlockCacheMutex;
+
 QgsPointCloudIndex::QgsPointCloudIndex() = default;
 
 QgsPointCloudIndex::~QgsPointCloudIndex() = default;
@@ -250,7 +280,44 @@ int QgsPointCloudIndex::nodePointCount( const IndexedPointCloudNode &n )
   int count = -1;
   mHierarchyMutex.lock();
   if ( mHierarchy.contains( n ) )
-    count = mHierarchy.contains( n );
+    count = mHierarchy.value( n );
   mHierarchyMutex.unlock();
   return count;
 }
+
+void QgsPointCloudIndex::setNodeDataCacheSize( int size )
+{
+  QMutexLocker locker( &sBlockCacheMutex );
+  sBlockCache.setMaxCost( size );
+}
+
+int QgsPointCloudIndex::nodeDataCacheSize()
+{
+  QMutexLocker locker( &sBlockCacheMutex );
+  return sBlockCache.maxCost();
+}
+
+QgsPointCloudBlock *QgsPointCloudIndex::nodeDataFromCache( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const
+{
+  if ( mUri.isEmpty() )
+    return nullptr;
+
+  const QgsPointCloudCacheKey key( n, request, mUri );
+
+  QMutexLocker locker( &sBlockCacheMutex );
+  const QgsPointCloudBlock *cached = sBlockCache.object( key );
+  // the block data is implicitly shared, so the copy is cheap
+  return cached ? new QgsPointCloudBlock( *cached ) : nullptr;
+}
+
+void QgsPointCloudIndex::storeNodeDataToCache( const QgsPointCloudBlock *data, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const
+{
+  if ( !data || mUri.isEmpty() )
+    return;
+
+  const QgsPointCloudCacheKey key( n, request, mUri );
+  const int cost = data->pointCount() * data->attributes().pointRecordSize();
+
+  QMutexLocker locker( &sBlockCacheMutex );
+  sBlockCache.insert( key, new QgsPointCloudBlock( *data ), cost );
+}
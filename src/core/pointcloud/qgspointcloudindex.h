@@ -25,6 +25,7 @@
 #include <QVector>
 #include <QList>
 #include <QMutex>
+#include <QCache>
 
 #include "qgis_core.h"
 #include "qgsrectangle.h"
@@ -101,6 +102,45 @@ Q_DECLARE_TYPEINFO( IndexedPointCloudNode, Q_PRIMITIVE_TYPE );
 //! Hash function for indexed nodes
 CORE_EXPORT uint qHash( IndexedPointCloudNode id );
 
+/**
+ * \ingroup core
+ *
+ * \brief Key of a decoded node block in the cache shared by all point cloud indexes
+ *
+ * Blocks are identified by the URI of the index, the node and the attributes
+ * requested when decoding it.
+ *
+ * \note The API is considered EXPERIMENTAL and can be changed without a notice
+ *
+ * \since QGIS 3.22
+ */
+class CORE_EXPORT QgsPointCloudCacheKey
+{
+  public:
+    //! Constructs a key for the block of node \a n decoded with \a request from the index with \a uri
+    QgsPointCloudCacheKey( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request, const QString &uri );
+
+    //! Compares keys
+    bool operator==( const QgsPointCloudCacheKey &other ) const;
+
+    //! Returns the key's node
+    IndexedPointCloudNode node() const { return mNode; }
+
+    //! Returns the key's URI
+    QString uri() const { return mUri; }
+
+    //! Returns the names and types of the requested attributes, as a single string
+    QString attributes() const { return mAttributes; }
+
+  private:
+    IndexedPointCloudNode mNode;
+    QString mUri;
+    QString mAttributes;
+};
+
+//! Hash function for cache keys
+CORE_EXPORT uint qHash( const QgsPointCloudCacheKey &key );
+
 /**
  * \ingroup core
  *
@@ -277,10 +317,47 @@ class CORE_EXPORT QgsPointCloudIndex: public QObject
      */
     int nodePointCount( const IndexedPointCloudNode &n );
 
+    /**
+     * Sets the maximum size in bytes of the decoded node blocks kept in memory by all point cloud indexes.
+     *
+     * \see nodeDataCacheSize()
+     * \since QGIS 3.22
+     */
+    static void setNodeDataCacheSize( int size );
+
+    /**
+     * Returns the maximum size in bytes of the decoded node blocks kept in memory by all point cloud indexes.
+     *
+     * \see setNodeDataCacheSize()
+     * \since QGIS 3.22
+     */
+    static int nodeDataCacheSize();
+
   protected: //TODO private
     //! Sets native attributes of the data
     void setAttributes( const QgsPointCloudAttributeCollection &attributes );
 
+    /**
+     * Returns a copy of the cached block of node \a n decoded with the attributes of \a request,
+     * or NULLPTR if the block is not in the cache (or the index has no URI).
+     *
+     * It is caller responsibility to free the block.
+     *
+     * \see storeNodeDataToCache()
+     * \since QGIS 3.22
+     */
+    QgsPointCloudBlock *nodeDataFromCache( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const;
+
+    /**
+     * Stores a copy of the block \a data of node \a n decoded with the attributes of \a request in the cache.
+     *
+     * Least recently used blocks are evicted when the cache exceeds nodeDataCacheSize().
+     *
+     * \see nodeDataFromCache()
+     * \since QGIS 3.22
+     */
+    void storeNodeDataToCache( const QgsPointCloudBlock *data, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request ) const;
+
     QgsRectangle mExtent;  //!< 2D extent of data
     double mZMin = 0, mZMax = 0;   //!< Vertical extent of data
 
@@ -291,6 +368,13 @@ class CORE_EXPORT QgsPointCloudIndex: public QObject
     QgsPointCloudDataBounds mRootBounds;  //!< Bounds of the root node's cube (in int32 coordinates)
     QgsPointCloudAttributeCollection mAttributes; //! All native attributes stored in the file
     int mSpan;  //!< Number of points in one direction in a single node
+    QString mUri; //!< URI of the index, used to identify its blocks in the cache
+
+  private:
+    //! Decoded node blocks, shared by all indexes
+    static QCache< QgsPointCloudCacheKey, QgsPointCloudBlock > sBlockCache;
+    //! Mutex to protect the block cache
+    static QMutex sBlockCacheMutex;
 };
 
 #endif // QGSPOINTCLOUDINDEX_H
@@ -17,8 +17,13 @@
 
 #include <QElapsedTimer>
 #include <QPointer>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <queue>
 
 #include "qgspointcloudlayerrenderer.h"
+#include "qgspointcloudlayerrenderer_p.h"
 #include "qgspointcloudlayer.h"
 #include "qgsrendercontext.h"
 #include "qgspointcloudindex.h"
@@ -170,7 +175,11 @@ bool QgsPointCloudLayerRenderer::render()
     return false;
   }
   double rootErrorPixels = rootErrorInMapCoordinates / mapUnitsPerPixel; // in pixels
-  const QVector<IndexedPointCloudNode> nodes = traverseTree( pc, context.renderContext(), pc->root(), maximumError, rootErrorPixels );
+  const int pointBudget = mRenderer->pointBudget();
+  const QgsPointCloudNodeTraversal traversal( pc, context.renderContext(), mZOffset );
+  const QVector<IndexedPointCloudNode> nodes = pointBudget > 0
+      ? traversal.traverseTreeWithBudget( pc->root(), maximumError, rootErrorPixels, pointBudget )
+      : traversal.traverseTree( pc->root(), maximumError, rootErrorPixels );
 
   QgsPointCloudRequest request;
   request.setAttributes( mAttributes );
@@ -203,7 +212,25 @@ bool QgsPointCloudLayerRenderer::render()
 int QgsPointCloudLayerRenderer::renderNodesSync( const QVector<IndexedPointCloudNode> &nodes, QgsPointCloudIndex *pc, QgsPointCloudRenderContext &context, QgsPointCloudRequest &request, bool &canceled )
 {
   int nodesDrawn = 0;
-  for ( const IndexedPointCloudNode &n : nodes )
+
+  // The nodes are decoded in groups on the global thread pool (local indexes are safe to read
+  // concurrently), then the blocks of each group are rendered sequentially in the order of the nodes.
+  struct DecodedNode
+  {
+    IndexedPointCloudNode node;
+    std::unique_ptr<QgsPointCloudBlock> block;
+  };
+  const int groupSize = std::max( 1, QThread::idealThreadCount() );
+  const QgsRenderContext &renderContext = context.renderContext();
+  const auto decodeNode = [pc, &request, &renderContext]( DecodedNode & decoded )
+  {
+    // outstanding decoding is skipped as soon as the render is canceled, e.g. when the view changes
+    if ( renderContext.renderingStopped() )
+      return;
+    decoded.block.reset( pc->nodeData( decoded.node, request ) );
+  };
+
+  for ( int groupIndex = 0; groupIndex < nodes.size() && !canceled; groupIndex += groupSize )
   {
     if ( context.renderContext().renderingStopped() )
     {
@@ -211,32 +238,51 @@ int QgsPointCloudLayerRenderer::renderNodesSync( const QVector<IndexedPointCloud
       canceled = true;
       break;
     }
-    std::unique_ptr<QgsPointCloudBlock> block( pc->nodeData( n, request ) );
 
-    if ( !block )
-      continue;
+    std::vector<DecodedNode> group( std::min( nodes.size() - groupIndex, groupSize ) );
+    for ( std::size_t i = 0; i < group.size(); ++i )
+      group[ i ].node = nodes[ groupIndex + static_cast< int >( i ) ];
 
-    QgsVector3D contextScale = context.scale();
-    QgsVector3D contextOffset = context.offset();
+    if ( group.size() == 1 )
+      decodeNode( group.front() );
+    else
+      QtConcurrent::blockingMap( group, decodeNode );
 
-    context.setScale( block->scale() );
-    context.setOffset( block->offset() );
+    for ( const DecodedNode &decoded : group )
+    {
+      if ( context.renderContext().renderingStopped() )
+      {
+        QgsDebugMsgLevel( "canceled", 2 );
+        canceled = true;
+        break;
+      }
 
-    context.setAttributes( block->attributes() );
+      QgsPointCloudBlock *block = decoded.block.get();
+      if ( !block )
+        continue;
 
-    mRenderer->renderBlock( block.get(), context );
+      QgsVector3D contextScale = context.scale();
+      QgsVector3D contextOffset = context.offset();
 
-    context.setScale( contextScale );
-    context.setOffset( contextOffset );
+      context.setScale( block->scale() );
+      context.setOffset( block->offset() );
 
-    ++nodesDrawn;
+      context.setAttributes( block->attributes() );
 
-    // as soon as first block is rendered, we can start showing layer updates.
-    // but if we are blocking render updates (so that a previously cached image is being shown), we wait
-    // at most e.g. 3 seconds before we start forcing progressive updates.
-    if ( !mBlockRenderUpdates || mElapsedTimer.elapsed() > MAX_TIME_TO_USE_CACHED_PREVIEW_IMAGE )
-    {
-      mReadyToCompose = true;
+      mRenderer->renderBlock( block, context );
+
+      context.setScale( contextScale );
+      context.setOffset( contextOffset );
+
+      ++nodesDrawn;
+
+      // as soon as first block is rendered, we can start showing layer updates.
+      // but if we are blocking render updates (so that a previously cached image is being shown), we wait
+      // at most e.g. 3 seconds before we start forcing progressive updates.
+      if ( !mBlockRenderUpdates || mElapsedTimer.elapsed() > MAX_TIME_TO_USE_CACHED_PREVIEW_IMAGE )
+      {
+        mReadyToCompose = true;
+      }
     }
   }
   return nodesDrawn;
@@ -272,6 +318,12 @@ int QgsPointCloudLayerRenderer::renderNodesAsync( const QVector<IndexedPointClou
       const IndexedPointCloudNode &n = nodes[nodeIndex];
       const QString nStr = n.toString();
       QgsPointCloudBlockRequest *blockRequest = pc->asyncNodeData( n, request );
+      if ( !blockRequest )
+      {
+        QgsDebugMsg( QStringLiteral( "Unable to request node %1" ).arg( nStr ) );
+        finishedLoadingBlock[ i ] = true;
+        continue;
+      }
       blockRequests[ i ] = blockRequest;
       QObject::connect( blockRequest, &QgsPointCloudBlockRequest::finished, &loop, [ &, i, nStr, blockRequest ]()
       {
@@ -285,7 +337,8 @@ int QgsPointCloudLayerRenderer::renderNodesAsync( const QVector<IndexedPointClou
       } );
     }
     // Wait for all point cloud nodes to finish loading
-    loop.exec();
+    if ( finishedLoadingBlock.contains( false ) )
+      loop.exec();
 
     QgsDebugMsg( QStringLiteral( "Downloaded in : %1ms" ).arg( downloadTimer.elapsed() ) );
     if ( !context.feedback()->isCanceled() )
@@ -300,7 +353,7 @@ int QgsPointCloudLayerRenderer::renderNodesAsync( const QVector<IndexedPointClou
           break;
         }
 
-        if ( !blockRequests[ i ]->block() )
+        if ( !blockRequests[ i ] || !blockRequests[ i ]->block() )
           continue;
 
         QgsVector3D contextScale = context.scale();
@@ -354,26 +407,40 @@ void QgsPointCloudLayerRenderer::setLayerRenderingTimeHint( int time )
   mRenderTimeHint = time;
 }
 
-QVector<IndexedPointCloudNode> QgsPointCloudLayerRenderer::traverseTree( const QgsPointCloudIndex *pc,
-    const QgsRenderContext &context,
-    IndexedPointCloudNode n,
+QgsPointCloudLayerRenderer::~QgsPointCloudLayerRenderer() = default;
+
+///@cond PRIVATE
+
+QgsPointCloudNodeTraversal::QgsPointCloudNodeTraversal( QgsPointCloudIndex *index, const QgsRenderContext &context, double zOffset )
+  : mIndex( index )
+  , mContext( context )
+  , mZOffset( zOffset )
+{
+}
+
+bool QgsPointCloudNodeTraversal::isVisible( const IndexedPointCloudNode &n ) const
+{
+  if ( !mContext.extent().intersects( mIndex->nodeMapExtent( n ) ) )
+    return false;
+
+  const QgsDoubleRange nodeZRange = mIndex->nodeZRange( n );
+  const QgsDoubleRange adjustedNodeZRange = QgsDoubleRange( nodeZRange.lower() + mZOffset, nodeZRange.upper() + mZOffset );
+  return mContext.zRange().isInfinite() || mContext.zRange().overlaps( adjustedNodeZRange );
+}
+
+QVector<IndexedPointCloudNode> QgsPointCloudNodeTraversal::traverseTree( const IndexedPointCloudNode &n,
     double maxErrorPixels,
-    double nodeErrorPixels )
+    double nodeErrorPixels ) const
 {
   QVector<IndexedPointCloudNode> nodes;
 
-  if ( context.renderingStopped() )
+  if ( mContext.renderingStopped() )
   {
     QgsDebugMsgLevel( QStringLiteral( "canceled" ), 2 );
     return nodes;
   }
 
-  if ( !context.extent().intersects( pc->nodeMapExtent( n ) ) )
-    return nodes;
-
-  const QgsDoubleRange nodeZRange = pc->nodeZRange( n );
-  const QgsDoubleRange adjustedNodeZRange = QgsDoubleRange( nodeZRange.lower() + mZOffset, nodeZRange.upper() + mZOffset );
-  if ( !context.zRange().isInfinite() && !context.zRange().overlaps( adjustedNodeZRange ) )
+  if ( !isVisible( n ) )
     return nodes;
 
   nodes.append( n );
@@ -382,13 +449,83 @@ QVector<IndexedPointCloudNode> QgsPointCloudLayerRenderer::traverseTree( const Q
   if ( childrenErrorPixels < maxErrorPixels )
     return nodes;
 
-  const QList<IndexedPointCloudNode> children = pc->nodeChildren( n );
+  const QList<IndexedPointCloudNode> children = mIndex->nodeChildren( n );
   for ( const IndexedPointCloudNode &nn : children )
   {
-    nodes += traverseTree( pc, context, nn, maxErrorPixels, childrenErrorPixels );
+    nodes += traverseTree( nn, maxErrorPixels, childrenErrorPixels );
   }
 
   return nodes;
 }
 
-QgsPointCloudLayerRenderer::~QgsPointCloudLayerRenderer() = default;
+QVector<IndexedPointCloudNode> QgsPointCloudNodeTraversal::traverseTreeWithBudget( const IndexedPointCloudNode &n,
+    double maxErrorPixels,
+    double nodeErrorPixels,
+    int pointBudget ) const
+{
+  QVector<IndexedPointCloudNode> nodes;
+
+  // Nodes are visited by decreasing screen error, so that the coarse levels are selected (and drawn)
+  // first and the refinement can stop anywhere when the point budget is exhausted.
+  struct QueuedNode
+  {
+    IndexedPointCloudNode node;
+    double errorPixels;
+    double distanceToCenter;
+
+    // the queue pops the largest node first
+    bool operator<( const QueuedNode &other ) const
+    {
+      if ( errorPixels != other.errorPixels )
+        return errorPixels < other.errorPixels;
+      return distanceToCenter > other.distanceToCenter;
+    }
+  };
+
+  QgsPointCloudIndex *pc = mIndex;
+  const QgsPointXY viewCenter = mContext.extent().center();
+  const auto queuedNode = [pc, &viewCenter]( const IndexedPointCloudNode & node, double errorPixels )
+  {
+    return QueuedNode { node, errorPixels, pc->nodeMapExtent( node ).center().sqrDist( viewCenter ) };
+  };
+
+  std::priority_queue<QueuedNode> queue;
+  queue.push( queuedNode( n, nodeErrorPixels ) );
+  qint64 selectedPoints = 0;
+  while ( !queue.empty() )
+  {
+    if ( mContext.renderingStopped() )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "canceled" ), 2 );
+      break;
+    }
+
+    const QueuedNode current = queue.top();
+    queue.pop();
+
+    if ( !isVisible( current.node ) )
+      continue;
+
+    // the remaining nodes are at least as fine as this one
+    const int nodePoints = std::max( pc->nodePointCount( current.node ), 0 );
+    if ( !nodes.isEmpty() && selectedPoints + nodePoints > pointBudget )
+      break;
+    selectedPoints += nodePoints;
+
+    nodes.append( current.node );
+
+    double childrenErrorPixels = current.errorPixels / 2.0;
+    if ( childrenErrorPixels < maxErrorPixels )
+      continue;
+
+    const QList<IndexedPointCloudNode> children = pc->nodeChildren( current.node );
+    for ( const IndexedPointCloudNode &nn : children )
+    {
+      queue.push( queuedNode( nn, childrenErrorPixels ) );
+    }
+  }
+
+  return nodes;
+}
+
+///@endcond
@@ -0,0 +1,75 @@
+/***************************************************************************
+                         qgspointcloudlayerrenderer_p.h
+                         --------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPOINTCLOUDLAYERRENDERER_PRIVATE_H
+#define QGSPOINTCLOUDLAYERRENDERER_PRIVATE_H
+
+#define SIP_NO_FILE
+
+/// @cond PRIVATE
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QGIS API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+
+#include "qgis_core.h"
+#include "qgspointcloudindex.h"
+
+#include <QVector>
+
+class QgsRenderContext;
+
+/**
+ * Selects the nodes of a point cloud index drawn by QgsPointCloudLayerRenderer.
+ */
+class CORE_EXPORT QgsPointCloudNodeTraversal
+{
+  public:
+
+    /**
+     * Constructor for a traversal of the nodes of \a index which are visible in \a context.
+     * The z range of the nodes is shifted by \a zOffset.
+     */
+    QgsPointCloudNodeTraversal( QgsPointCloudIndex *index, const QgsRenderContext &context, double zOffset = 0 );
+
+    //! Returns the nodes to render, in depth-first order
+    QVector<IndexedPointCloudNode> traverseTree( const IndexedPointCloudNode &n, double maxErrorPixels, double nodeErrorPixels ) const;
+
+    /**
+     * Returns the nodes to render, by decreasing screen error: coarse levels first, then for a same level
+     * the nodes closest to the center of the view. The refinement stops when the selected nodes hold
+     * \a pointBudget points.
+     */
+    QVector<IndexedPointCloudNode> traverseTreeWithBudget( const IndexedPointCloudNode &n, double maxErrorPixels, double nodeErrorPixels, int pointBudget ) const;
+
+  private:
+
+    //! Returns TRUE if the node \a n is within the extent and the z range of the context
+    bool isVisible( const IndexedPointCloudNode &n ) const;
+
+    QgsPointCloudIndex *mIndex = nullptr;
+    const QgsRenderContext &mContext;
+    double mZOffset = 0;
+};
+
+/// @endcond
+
+#endif // QGSPOINTCLOUDLAYERRENDERER_PRIVATE_H
@@ -144,6 +144,16 @@ void QgsPointCloudRenderer::setMaximumScreenErrorUnit( QgsUnitTypes::RenderUnit
   mMaximumScreenErrorUnit = unit;
 }
 
+int QgsPointCloudRenderer::pointBudget() const
+{
+  return mPointBudget;
+}
+
+void QgsPointCloudRenderer::setPointBudget( int budget )
+{
+  mPointBudget = budget;
+}
+
 QList<QgsLayerTreeModelLegendNode *> QgsPointCloudRenderer::createLegendNodes( QgsLayerTreeLayer * )
 {
   return QList<QgsLayerTreeModelLegendNode *>();
@@ -161,6 +171,7 @@ void QgsPointCloudRenderer::copyCommonProperties( QgsPointCloudRenderer *destina
   destination->setPointSizeMapUnitScale( mPointSizeMapUnitScale );
   destination->setMaximumScreenError( mMaximumScreenError );
   destination->setMaximumScreenErrorUnit( mMaximumScreenErrorUnit );
+  destination->setPointBudget( mPointBudget );
   destination->setPointSymbol( mPointSymbol );
 }
 
@@ -172,6 +183,7 @@ void QgsPointCloudRenderer::restoreCommonProperties( const QDomElement &element,
 
   mMaximumScreenError = element.attribute( QStringLiteral( "maximumScreenError" ), QStringLiteral( "0.3" ) ).toDouble();
   mMaximumScreenErrorUnit = QgsUnitTypes::decodeRenderUnit( element.attribute( QStringLiteral( "maximumScreenErrorUnit" ), QStringLiteral( "MM" ) ) );
+  mPointBudget = element.attribute( QStringLiteral( "pointBudget" ), QStringLiteral( "0" ) ).toInt();
   mPointSymbol = static_cast< PointSymbol >( element.attribute( QStringLiteral( "pointSymbol" ), QStringLiteral( "0" ) ).toInt() );
 }
 
@@ -183,6 +195,7 @@ void QgsPointCloudRenderer::saveCommonProperties( QDomElement &element, const Qg
 
   element.setAttribute( QStringLiteral( "maximumScreenError" ), qgsDoubleToString( mMaximumScreenError ) );
   element.setAttribute( QStringLiteral( "maximumScreenErrorUnit" ), QgsUnitTypes::encodeUnit( mMaximumScreenErrorUnit ) );
+  element.setAttribute( QStringLiteral( "pointBudget" ), QString::number( mPointBudget ) );
   element.setAttribute( QStringLiteral( "pointSymbol" ), QString::number( mPointSymbol ) );
 }
 
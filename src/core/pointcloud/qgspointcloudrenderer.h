@@ -490,6 +490,28 @@ class CORE_EXPORT QgsPointCloudRenderer
      */
     void setMaximumScreenErrorUnit( QgsUnitTypes::RenderUnit unit );
 
+    /**
+     * Returns the maximum number of points rendered in a single render of the point cloud, or 0 if
+     * the number of points is only limited by the maximum screen error.
+     *
+     * When the budget is reached, the nodes with the largest screen error (i.e. the coarsest
+     * nodes, closest to the center of the view) are rendered first and the refinement stops.
+     *
+     * \see setPointBudget()
+     * \since QGIS 3.22
+     */
+    int pointBudget() const;
+
+    /**
+     * Sets the maximum number of points rendered in a single render of the point cloud.
+     *
+     * A \a budget of 0 means the number of points is only limited by the maximum screen error.
+     *
+     * \see pointBudget()
+     * \since QGIS 3.22
+     */
+    void setPointBudget( int budget );
+
     /**
      * Creates a set of legend nodes representing the renderer.
      */
@@ -585,6 +607,7 @@ class CORE_EXPORT QgsPointCloudRenderer
 
     double mMaximumScreenError = 0.3;
     QgsUnitTypes::RenderUnit mMaximumScreenErrorUnit = QgsUnitTypes::RenderMillimeters;
+    int mPointBudget = 0;
 
     double mPointSize = 1;
     QgsUnitTypes::RenderUnit mPointSizeUnit = QgsUnitTypes::RenderMillimeters;
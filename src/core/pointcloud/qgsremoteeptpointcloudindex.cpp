@@ -76,6 +76,7 @@ QList<IndexedPointCloudNode> QgsRemoteEptPointCloudIndex::nodeChildren( const In
 void QgsRemoteEptPointCloudIndex::load( const QString &url )
 {
   mUrl = QUrl( url );
+  mUri = url;
 
   QStringList splitUrl = url.split( '/' );
 
@@ -100,6 +101,9 @@ void QgsRemoteEptPointCloudIndex::load( const QString &url )
 
 QgsPointCloudBlock *QgsRemoteEptPointCloudIndex::nodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
 {
+  if ( QgsPointCloudBlock *cached = nodeDataFromCache( n, request ) )
+    return cached;
+
   std::unique_ptr<QgsPointCloudBlockRequest> blockRequest( asyncNodeData( n, request ) );
   if ( !blockRequest )
     return nullptr;
@@ -121,6 +125,9 @@ QgsPointCloudBlockRequest *QgsRemoteEptPointCloudIndex::asyncNodeData( const Ind
   if ( !loadNodeHierarchy( n ) )
     return nullptr;
 
+  if ( QgsPointCloudBlock *cached = nodeDataFromCache( n, request ) )
+    return new QgsPointCloudBlockRequest( n, cached );
+
   QString fileUrl;
   if ( mDataType == QLatin1String( "binary" ) )
   {
@@ -139,7 +146,15 @@ QgsPointCloudBlockRequest *QgsRemoteEptPointCloudIndex::asyncNodeData( const Ind
     return nullptr;
   }
 
-  return new QgsPointCloudBlockRequest( n, fileUrl, mDataType, attributes(), request.attributes(), scale(), offset() );
+  QgsPointCloudBlockRequest *blockRequest = new QgsPointCloudBlockRequest( n, fileUrl, mDataType, attributes(), request.attributes(), scale(), offset() );
+  // connected before the caller's slots, so the block is cached before it is handed over. The index is the
+  // context of the connection, which is removed if the index is deleted before the request finishes, and
+  // the connection is direct, as the index may live in another thread than the request.
+  connect( blockRequest, &QgsPointCloudBlockRequest::finished, this, [this, blockRequest, n, request]
+  {
+    storeNodeDataToCache( blockRequest->block(), n, request );
+  }, Qt::DirectConnection );
+  return blockRequest;
 }
 
 bool QgsRemoteEptPointCloudIndex::hasNode( const IndexedPointCloudNode &n ) const
@@ -1077,6 +1077,11 @@ void QgsProcessingFeatureBasedAlgorithm::prepareSource( const QVariantMap &param
   }
 }
 
+QgsProcessingFeatureSource *QgsProcessingFeatureBasedAlgorithm::source() const
+{
+  return mSource.get();
+}
+
 
 QgsProcessingAlgorithm::VectorProperties QgsProcessingFeatureBasedAlgorithm::sinkProperties( const QString &sink, const QVariantMap &parameters, QgsProcessingContext &context, const QMap<QString, QgsProcessingAlgorithm::VectorProperties> &sourceProperties ) const
 {
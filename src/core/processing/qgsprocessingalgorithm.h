@@ -1241,6 +1241,13 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      */
     void prepareSource( const QVariantMap &parameters, QgsProcessingContext &context );
 
+    /**
+     * Returns the source read by prepareSource(), or NULLPTR if the source has not been read.
+     *
+     * \since QGIS 3.22
+     */
+    QgsProcessingFeatureSource *source() const;
+
     QgsProcessingAlgorithm::VectorProperties sinkProperties( const QString &sink,
         const QVariantMap &parameters,
         QgsProcessingContext &context,
@@ -25,6 +25,7 @@
 #include "qgsproject.h"
 #include "qgsreadwritelocker.h"
 #include "qgsvector3d.h"
+#include "qgsgeometry.h"
 
 //qt includes
 #include <QDomNode>
@@ -33,6 +34,8 @@
 #include <QPolygonF>
 #include <QStringList>
 #include <QVector>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include <proj.h>
 #include "qgsprojutils.h"
@@ -45,6 +48,27 @@
 // if defined shows all information about transform to stdout
 // #define COORDINATE_TRANSFORM_VERBOSE
 
+///@cond PRIVATE
+namespace
+{
+  //! Minimum number of coordinates transformed by each thread in parallel transforms
+  constexpr int PARALLEL_TRANSFORM_MIN_BLOCK_SIZE = 16384;
+
+  //! Initial number of columns and rows of cells of approximation grids
+  constexpr int APPROXIMATION_INITIAL_CELLS = 4;
+
+  //! Maximum number of columns or rows of cells of approximation grids
+  constexpr int APPROXIMATION_MAX_CELLS = 512;
+
+  //! Returns the number of blocks to use for a parallel transform of \a numPoints coordinates
+  int parallelTransformBlockCount( long long numPoints )
+  {
+    const long long maxBlocks = numPoints / PARALLEL_TRANSFORM_MIN_BLOCK_SIZE;
+    return static_cast< int >( std::min< long long >( std::max( 1, QThread::idealThreadCount() ), maxBlocks ) );
+  }
+}
+///@endcond
+
 QReadWriteLock QgsCoordinateTransform::sCacheLock;
 QMultiHash< QPair< QString, QString >, QgsCoordinateTransform > QgsCoordinateTransform::sTransforms; //same auth_id pairs might have different datum transformations
 bool QgsCoordinateTransform::sDisableCache = false;
@@ -124,6 +148,7 @@ QgsCoordinateTransform::QgsCoordinateTransform( const QgsCoordinateTransform &o
   , mHasContext( o.mHasContext )
 #endif
   , mLastError()
+  , mApproximation( o.mApproximation )
 {
   d = o.d;
 }
@@ -136,6 +161,7 @@ QgsCoordinateTransform &QgsCoordinateTransform::operator=( const QgsCoordinateTr
 #endif
   mContext = o.mContext;
   mLastError = QString();
+  mApproximation = o.mApproximation;
   return *this;
 }
 
@@ -143,6 +169,7 @@ QgsCoordinateTransform::~QgsCoordinateTransform() {} //NOLINT
 
 void QgsCoordinateTransform::setSourceCrs( const QgsCoordinateReferenceSystem &crs )
 {
+  mApproximation.reset();
   d.detach();
   d->mSourceCRS = crs;
   if ( !d->checkValidity() )
@@ -159,6 +186,7 @@ void QgsCoordinateTransform::setSourceCrs( const QgsCoordinateReferenceSystem &c
 }
 void QgsCoordinateTransform::setDestinationCrs( const QgsCoordinateReferenceSystem &crs )
 {
+  mApproximation.reset();
   d.detach();
   d->mDestCRS = crs;
   if ( !d->checkValidity() )
@@ -176,6 +204,7 @@ void QgsCoordinateTransform::setDestinationCrs( const QgsCoordinateReferenceSyst
 
 void QgsCoordinateTransform::setContext( const QgsCoordinateTransformContext &context )
 {
+  mApproximation.reset();
   d.detach();
   mContext = context;
 #ifdef QGISDEBUG
@@ -387,7 +416,8 @@ void QgsCoordinateTransform::transformPolygon( QPolygonF &poly, TransformDirecti
   QString err;
   try
   {
-    transformCoords( nVertices, x.data(), y.data(), z.data(), direction );
+    // large polygons (e.g. detailed features while rendering) are split between threads
+    transformCoordsInParallel( nVertices, x.data(), y.data(), z.data(), direction );
   }
   catch ( const QgsCsException &e )
   {
@@ -622,6 +652,60 @@ void QgsCoordinateTransform::transformCoords( int numPoints, double *x, double *
 {
   if ( !d->mIsValid || d->mShortCircuit )
     return;
+
+  if ( !mApproximation || direction != ForwardTransform )
+  {
+    transformCoordsExact( numPoints, x, y, z, direction );
+    return;
+  }
+
+  // interpolate the coordinates covered by the approximation grid, and only transform the remaining ones with Proj
+  std::vector< int > exactPositions;
+  for ( int i = 0; i < numPoints; ++i )
+  {
+    if ( !mApproximation->transform( x[i], y[i] ) )
+      exactPositions.push_back( i );
+  }
+
+  mFallbackOperationOccurred = false;
+  if ( exactPositions.empty() )
+    return;
+
+  const std::size_t exactCount = exactPositions.size();
+  std::vector< double > exactX( exactCount );
+  std::vector< double > exactY( exactCount );
+  std::vector< double > exactZ( exactCount );
+  for ( std::size_t i = 0; i < exactCount; ++i )
+  {
+    exactX[i] = x[exactPositions[i]];
+    exactY[i] = y[exactPositions[i]];
+    exactZ[i] = z[exactPositions[i]];
+  }
+
+  QString err;
+  try
+  {
+    transformCoordsExact( static_cast< int >( exactCount ), exactX.data(), exactY.data(), exactZ.data(), direction );
+  }
+  catch ( const QgsCsException &e )
+  {
+    // record the exception, but don't rethrow it until we've recorded the coordinates we *could* transform
+    err = e.what();
+  }
+
+  for ( std::size_t i = 0; i < exactCount; ++i )
+  {
+    x[exactPositions[i]] = exactX[i];
+    y[exactPositions[i]] = exactY[i];
+    z[exactPositions[i]] = exactZ[i];
+  }
+
+  if ( !err.isEmpty() )
+    throw QgsCsException( err );
+}
+
+void QgsCoordinateTransform::transformCoordsExact( int numPoints, double *x, double *y, double *z, TransformDirection direction ) const
+{
   // Refuse to transform the points if the srs's are invalid
   if ( !d->mSourceCRS.isValid() )
   {
@@ -813,6 +897,303 @@ void QgsCoordinateTransform::transformCoords( int numPoints, double *x, double *
 #endif
 }
 
+void QgsCoordinateTransform::transformCoordsInParallel( int numPoints, double *x, double *y, double *z, TransformDirection direction ) const
+{
+  if ( !d->mIsValid || d->mShortCircuit )
+    return;
+
+  const int blockCount = parallelTransformBlockCount( numPoints );
+  if ( blockCount < 2 )
+  {
+    transformCoords( numPoints, x, y, z, direction );
+    return;
+  }
+
+  struct Block
+  {
+    int begin = 0;
+    int count = 0;
+    QString error;
+    bool fallbackOperationOccurred = false;
+  };
+
+  std::vector< Block > blocks( blockCount );
+  const int blockSize = numPoints / blockCount;
+  for ( int i = 0; i < blockCount; ++i )
+  {
+    blocks[i].begin = i * blockSize;
+    //make sure last block goes to end of arrays
+    blocks[i].count = i < blockCount - 1 ? blockSize : numPoints - blocks[i].begin;
+  }
+
+  QtConcurrent::blockingMap( blocks, [this, x, y, z, direction]( Block & block )
+  {
+    // each thread works on its own copy of the transform, so that the last error and fallback
+    // state are not shared between threads. The Proj objects are created per thread anyway.
+    QgsCoordinateTransform transform( *this );
+    transform.mBallparkTransformsAreAppropriate = mBallparkTransformsAreAppropriate;
+    transform.mDisableFallbackHandler = mDisableFallbackHandler;
+    try
+    {
+      transform.transformCoords( block.count, x + block.begin, y + block.begin, z + block.begin, direction );
+    }
+    catch ( QgsCsException &e )
+    {
+      block.error = e.what();
+    }
+    block.fallbackOperationOccurred = transform.mFallbackOperationOccurred;
+  } );
+
+  mFallbackOperationOccurred = std::any_of( blocks.begin(), blocks.end(), []( const Block & block ) { return block.fallbackOperationOccurred; } );
+
+  for ( const Block &block : blocks )
+  {
+    if ( !block.error.isEmpty() )
+    {
+      mLastError = block.error;
+      throw QgsCsException( block.error );
+    }
+  }
+}
+
+QList< int > QgsCoordinateTransform::transformGeometries( QVector< QgsGeometry > &geometries, TransformDirection direction, bool transformZ ) const
+{
+  QList< int > failed;
+  if ( !d->mIsValid || d->mShortCircuit || geometries.isEmpty() )
+    return failed;
+
+  // detach once, so that the worker threads can safely write to their own part of the vector
+  QgsGeometry *data = geometries.data();
+
+  const auto transformRange = [data, direction, transformZ]( const QgsCoordinateTransform & transform, int begin, int end, QList< int > &failedIndices, bool &fallbackOperationOccurred )
+  {
+    for ( int i = begin; i < end; ++i )
+    {
+      if ( data[i].isNull() )
+        continue;
+
+      // transform a copy, so that geometries which fail are left untouched
+      QgsGeometry geometry = data[i];
+      try
+      {
+        if ( geometry.transform( transform, direction, transformZ ) == QgsGeometry::Success )
+          data[i] = geometry;
+        else
+          failedIndices << i;
+      }
+      catch ( QgsCsException & )
+      {
+        failedIndices << i;
+      }
+      fallbackOperationOccurred = fallbackOperationOccurred || transform.mFallbackOperationOccurred;
+    }
+  };
+
+  std::vector< int > vertexCounts( geometries.size() );
+  long long totalVertices = 0;
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    const QgsAbstractGeometry *geometry = data[i].constGet();
+    vertexCounts[i] = geometry ? geometry->nCoordinates() : 0;
+    totalVertices += vertexCounts[i];
+  }
+
+  const int blockCount = std::min( parallelTransformBlockCount( totalVertices ), geometries.size() );
+  if ( blockCount < 2 )
+  {
+    bool fallbackOperationOccurred = false;
+    transformRange( *this, 0, geometries.size(), failed, fallbackOperationOccurred );
+    mFallbackOperationOccurred = fallbackOperationOccurred;
+    return failed;
+  }
+
+  struct Block
+  {
+    int begin = 0;
+    int end = 0;
+    QList< int > failed;
+    bool fallbackOperationOccurred = false;
+  };
+
+  // group consecutive geometries in blocks with a similar number of vertices
+  std::vector< Block > blocks;
+  blocks.reserve( blockCount );
+  const long long verticesPerBlock = totalVertices / blockCount;
+  long long blockVertices = 0;
+  Block currentBlock;
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    blockVertices += vertexCounts[i];
+    if ( blockVertices >= verticesPerBlock && static_cast< int >( blocks.size() ) < blockCount - 1 )
+    {
+      currentBlock.end = i + 1;
+      blocks.emplace_back( currentBlock );
+      currentBlock = Block();
+      currentBlock.begin = i + 1;
+      blockVertices = 0;
+    }
+  }
+  currentBlock.end = geometries.size();
+  if ( currentBlock.end > currentBlock.begin )
+    blocks.emplace_back( currentBlock );
+
+  QtConcurrent::blockingMap( blocks, [this, &transformRange]( Block & block )
+  {
+    // see transformCoordsInParallel()
+    QgsCoordinateTransform transform( *this );
+    transform.mBallparkTransformsAreAppropriate = mBallparkTransformsAreAppropriate;
+    transform.mDisableFallbackHandler = mDisableFallbackHandler;
+    transformRange( transform, block.begin, block.end, block.failed, block.fallbackOperationOccurred );
+  } );
+
+  mFallbackOperationOccurred = false;
+  for ( const Block &block : blocks )
+  {
+    failed.append( block.failed );
+    mFallbackOperationOccurred = mFallbackOperationOccurred || block.fallbackOperationOccurred;
+  }
+  return failed;
+}
+
+bool QgsCoordinateTransform::setApproximation( const QgsRectangle &sourceExtent, double tolerance )
+{
+  mApproximation.reset();
+  if ( !d->mIsValid || d->mShortCircuit || sourceExtent.isEmpty() || !sourceExtent.isFinite() || tolerance <= 0 )
+    return false;
+
+  const double xMin = sourceExtent.xMinimum();
+  const double yMin = sourceExtent.yMinimum();
+  const double width = sourceExtent.width();
+  const double height = sourceExtent.height();
+
+  // transforms the given points exactly, returns FALSE if any of them could not be transformed
+  const auto transformExact = [this]( std::vector< double > &x, std::vector< double > &y ) -> bool
+  {
+    std::vector< double > z( x.size(), 0 );
+    try
+    {
+      transformCoordsExact( static_cast< int >( x.size() ), x.data(), y.data(), z.data(), ForwardTransform );
+    }
+    catch ( QgsCsException & )
+    {
+      return false;
+    }
+    return std::all_of( x.begin(), x.end(), []( double v ) { return std::isfinite( v ); } )
+           && std::all_of( y.begin(), y.end(), []( double v ) { return std::isfinite( v ); } );
+  };
+
+  // start with a coarse grid, and refine the columns and rows independently until the interpolation
+  // error at the middle of the cell edges and at the cell centers is below the tolerance
+  int columns = APPROXIMATION_INITIAL_CELLS;
+  int rows = APPROXIMATION_INITIAL_CELLS;
+  while ( true )
+  {
+    std::vector< double > nodeX;
+    std::vector< double > nodeY;
+    nodeX.reserve( static_cast< std::size_t >( columns + 1 ) * ( rows + 1 ) );
+    nodeY.reserve( static_cast< std::size_t >( columns + 1 ) * ( rows + 1 ) );
+    for ( int r = 0; r <= rows; ++r )
+    {
+      for ( int c = 0; c <= columns; ++c )
+      {
+        nodeX.push_back( xMin + width * c / columns );
+        nodeY.push_back( yMin + height * r / rows );
+      }
+    }
+    if ( !transformExact( nodeX, nodeY ) )
+      return false;
+
+    auto approximation = std::make_shared< QgsCoordinateTransformApproximation >( xMin, yMin, xMin + width, yMin + height, columns, rows,
+                         std::move( nodeX ), std::move( nodeY ) );
+
+    // sample points: first the middles of horizontal edges, then the middles of vertical edges, then the cell centers
+    std::vector< double > sampleX;
+    std::vector< double > sampleY;
+    for ( int r = 0; r <= rows; ++r )
+    {
+      for ( int c = 0; c < columns; ++c )
+      {
+        sampleX.push_back( xMin + width * ( c + 0.5 ) / columns );
+        sampleY.push_back( yMin + height * r / rows );
+      }
+    }
+    const std::size_t verticalEdgesStart = sampleX.size();
+    for ( int r = 0; r < rows; ++r )
+    {
+      for ( int c = 0; c <= columns; ++c )
+      {
+        sampleX.push_back( xMin + width * c / columns );
+        sampleY.push_back( yMin + height * ( r + 0.5 ) / rows );
+      }
+    }
+    const std::size_t centersStart = sampleX.size();
+    for ( int r = 0; r < rows; ++r )
+    {
+      for ( int c = 0; c < columns; ++c )
+      {
+        sampleX.push_back( xMin + width * ( c + 0.5 ) / columns );
+        sampleY.push_back( yMin + height * ( r + 0.5 ) / rows );
+      }
+    }
+
+    std::vector< double > exactX = sampleX;
+    std::vector< double > exactY = sampleY;
+    if ( !transformExact( exactX, exactY ) )
+      return false;
+
+    bool refineColumns = false;
+    bool refineRows = false;
+    bool refineCenters = false;
+    for ( std::size_t i = 0; i < sampleX.size(); ++i )
+    {
+      double x = sampleX[i];
+      double y = sampleY[i];
+      approximation->transform( x, y );
+      if ( std::fabs( x - exactX[i] ) <= tolerance && std::fabs( y - exactY[i] ) <= tolerance )
+        continue;
+
+      if ( i < verticalEdgesStart )
+        refineColumns = true;
+      else if ( i < centersStart )
+        refineRows = true;
+      else
+        refineCenters = true;
+    }
+
+    if ( refineCenters && !refineColumns && !refineRows )
+    {
+      refineColumns = true;
+      refineRows = true;
+    }
+
+    if ( !refineColumns && !refineRows )
+    {
+      mApproximation = approximation;
+      return true;
+    }
+
+    if ( refineColumns )
+      columns *= 2;
+    if ( refineRows )
+      rows *= 2;
+    if ( columns > APPROXIMATION_MAX_CELLS || rows > APPROXIMATION_MAX_CELLS )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Could not build an approximation grid within %1 for %2" ).arg( tolerance ).arg( sourceExtent.toString() ), 2 );
+      return false;
+    }
+  }
+}
+
+void QgsCoordinateTransform::clearApproximation()
+{
+  mApproximation.reset();
+}
+
+bool QgsCoordinateTransform::hasApproximation() const
+{
+  return static_cast< bool >( mApproximation );
+}
+
 bool QgsCoordinateTransform::isValid() const
 {
   return d->mIsValid;
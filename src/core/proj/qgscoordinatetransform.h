@@ -18,6 +18,7 @@
 #define QGSCOORDINATETRANSFORM_H
 
 #include <QExplicitlySharedDataPointer>
+#include <memory>
 
 #include "qgsconfig.h"
 #include "qgis_core.h"
@@ -31,6 +32,8 @@ class QgsRectangle;
 class QPolygonF;
 class QgsProject;
 class QgsVector3D;
+class QgsGeometry;
+class QgsCoordinateTransformApproximation;
 
 /**
  * \ingroup core
@@ -351,6 +354,87 @@ class CORE_EXPORT QgsCoordinateTransform
      */
     void transformCoords( int numPoint, double *x, double *y, double *z, TransformDirection direction = ForwardTransform ) const SIP_THROW( QgsCsException );
 
+    /**
+     * Transforms an array of coordinates to the destination CRS, splitting large arrays into
+     * blocks which are transformed concurrently on the global thread pool.
+     *
+     * Each worker thread transforms its block with its own Proj context, so this is considerably
+     * faster than transformCoords() for large coordinate buffers. Small arrays are transformed
+     * on the calling thread.
+     *
+     * If a block cannot be transformed, the remaining blocks are still transformed and the
+     * QgsCsException is raised once all blocks have completed.
+     *
+     * \param numPoint number of coordinates in arrays
+     * \param x array of x coordinates to transform
+     * \param y array of y coordinates to transform
+     * \param z array of z coordinates to transform
+     * \param direction transform direction (defaults to ForwardTransform)
+     *
+     * \see transformCoords()
+     * \note not available in Python bindings
+     * \since QGIS 3.22
+     */
+    void transformCoordsInParallel( int numPoint, double *x, double *y, double *z, TransformDirection direction = ForwardTransform ) const SIP_SKIP;
+
+    /**
+     * Transforms a list of \a geometries in place, distributing them over the global thread pool.
+     *
+     * Geometries are grouped in blocks with a similar number of vertices, and each block is
+     * transformed on a separate thread with its own Proj context. Lists containing only a few
+     * vertices are transformed on the calling thread.
+     *
+     * Geometries which cannot be transformed are left untouched, and their indices are returned
+     * in ascending order.
+     *
+     * \param geometries geometries to transform
+     * \param direction transform direction (defaults to ForwardTransform)
+     * \param transformZ set to TRUE to also transform z coordinates
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.22
+     */
+    QList< int > transformGeometries( QVector< QgsGeometry > &geometries, TransformDirection direction = ForwardTransform, bool transformZ = false ) const SIP_SKIP;
+
+    /**
+     * Enables an approximate forward transform for coordinates located within \a sourceExtent.
+     *
+     * A grid of exactly transformed points is built over \a sourceExtent and refined until
+     * coordinates interpolated bilinearly from the grid differ by at most \a tolerance (in
+     * destination CRS units) from exactly transformed coordinates. Forward transforms of coordinates
+     * within the extent are then interpolated from the grid instead of being transformed by Proj,
+     * while coordinates outside the extent and reverse transforms remain exact.
+     *
+     * z values are left untouched by the approximation, so it is only suitable for 2D uses such as
+     * map rendering.
+     *
+     * Returns FALSE if no grid meeting the tolerance could be built, e.g. when the extent crosses a
+     * discontinuity of the destination CRS. The transform remains exact in this case.
+     *
+     * \note The approximation is discarded when the source CRS, destination CRS or context are changed.
+     *
+     * \see clearApproximation()
+     * \see hasApproximation()
+     * \since QGIS 3.22
+     */
+    bool setApproximation( const QgsRectangle &sourceExtent, double tolerance );
+
+    /**
+     * Disables the approximate transform, so that all coordinates are transformed exactly.
+     *
+     * \see setApproximation()
+     * \since QGIS 3.22
+     */
+    void clearApproximation();
+
+    /**
+     * Returns TRUE if forward transforms are approximated using an interpolation grid.
+     *
+     * \see setApproximation()
+     * \since QGIS 3.22
+     */
+    bool hasApproximation() const;
+
     /**
      * Returns TRUE if the transform short circuits because the source and destination are equivalent.
      */
@@ -713,6 +797,14 @@ class CORE_EXPORT QgsCoordinateTransform
     bool mDisableFallbackHandler = false;
     mutable bool mFallbackOperationOccurred = false;
 
+#ifndef SIP_RUN
+    //! Interpolation grid used for approximate forward transforms, if set
+    std::shared_ptr< const QgsCoordinateTransformApproximation > mApproximation;
+
+    //! Transforms coordinates with Proj, ignoring any approximation
+    void transformCoordsExact( int numPoint, double *x, double *y, double *z, TransformDirection direction ) const;
+#endif
+
     bool setFromCache( const QgsCoordinateReferenceSystem &src,
                        const QgsCoordinateReferenceSystem &dest,
                        const QString &coordinateOperationProj, bool allowFallback );
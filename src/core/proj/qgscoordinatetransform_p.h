@@ -32,6 +32,8 @@
 //
 
 #include <QSharedData>
+#include <algorithm>
+#include <vector>
 
 struct PJconsts;
 typedef struct PJconsts PJ;
@@ -201,6 +203,69 @@ class QgsCoordinateTransformPrivate : public QSharedData
     QgsCoordinateTransformPrivate &operator= ( const QgsCoordinateTransformPrivate & ) = delete;
 };
 
+/**
+ * Regular grid of exactly transformed points, used to approximate forward transforms
+ * by bilinear interpolation.
+ */
+class QgsCoordinateTransformApproximation
+{
+  public:
+
+    /**
+     * Constructor for a grid covering the source extent from \a xMin, \a yMin to \a xMax, \a yMax,
+     * with the specified number of \a columns and \a rows of cells.
+     *
+     * \a x and \a y contain the transformed coordinates of the (columns + 1) * (rows + 1) grid nodes,
+     * row by row from \a yMin.
+     */
+    QgsCoordinateTransformApproximation( double xMin, double yMin, double xMax, double yMax, int columns, int rows,
+                                         std::vector< double > x, std::vector< double > y )
+      : mXMin( xMin )
+      , mYMin( yMin )
+      , mCellWidth( ( xMax - xMin ) / columns )
+      , mCellHeight( ( yMax - yMin ) / rows )
+      , mColumns( columns )
+      , mRows( rows )
+      , mX( std::move( x ) )
+      , mY( std::move( y ) )
+    {}
+
+    /**
+     * Interpolates the transformed position of \a x, \a y in place.
+     * Returns FALSE if the point is not covered by the grid, in which case it is left untouched.
+     */
+    bool transform( double &x, double &y ) const
+    {
+      const double column = ( x - mXMin ) / mCellWidth;
+      const double row = ( y - mYMin ) / mCellHeight;
+      // also rejects NaN coordinates
+      if ( !( column >= 0 && column <= mColumns && row >= 0 && row <= mRows ) )
+        return false;
+
+      const int c = std::min( static_cast< int >( column ), mColumns - 1 );
+      const int r = std::min( static_cast< int >( row ), mRows - 1 );
+      const double fx = column - c;
+      const double fy = row - r;
+
+      const std::size_t node = static_cast< std::size_t >( r ) * ( mColumns + 1 ) + c;
+      const std::size_t nodeAbove = node + mColumns + 1;
+      x = ( 1 - fy ) * ( ( 1 - fx ) * mX[node] + fx * mX[node + 1] ) + fy * ( ( 1 - fx ) * mX[nodeAbove] + fx * mX[nodeAbove + 1] );
+      y = ( 1 - fy ) * ( ( 1 - fx ) * mY[node] + fx * mY[node + 1] ) + fy * ( ( 1 - fx ) * mY[nodeAbove] + fx * mY[nodeAbove + 1] );
+      return true;
+    }
+
+  private:
+
+    double mXMin = 0;
+    double mYMin = 0;
+    double mCellWidth = 0;
+    double mCellHeight = 0;
+    int mColumns = 0;
+    int mRows = 0;
+    std::vector< double > mX;
+    std::vector< double > mY;
+};
+
 /// @endcond
 
 #endif // QGSCOORDINATETRANSFORMPRIVATE_H
@@ -0,0 +1,84 @@
+/***************************************************************************
+                         qgscopcdataitems.cpp
+                         --------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgscopcdataitems.h"
+#include "qgslogger.h"
+#include "qgssettings.h"
+#include "qgsproviderregistry.h"
+#include "qgsprovidermetadata.h"
+#include "qgsfileutils.h"
+
+#include <QFileInfo>
+#include <mutex>
+
+///@cond PRIVATE
+
+QgsCopcLayerItem::QgsCopcLayerItem( QgsDataItem *parent,
+                                    const QString &name, const QString &path, const QString &uri )
+  : QgsLayerItem( parent, name, path, uri, Qgis::BrowserLayerType::PointCloud, QStringLiteral( "copc" ) )
+{
+  mToolTip = uri;
+  setState( Qgis::BrowserItemState::Populated );
+}
+
+QString QgsCopcLayerItem::layerName() const
+{
+  // strip the whole .copc.laz extension
+  const QString suffix = QStringLiteral( ".copc.laz" );
+  QString layerName = QFileInfo( name() ).fileName();
+  if ( layerName.endsWith( suffix, Qt::CaseInsensitive ) )
+    layerName.chop( suffix.length() );
+  return layerName;
+}
+
+// ---------------------------------------------------------------------------
+QgsCopcDataItemProvider::QgsCopcDataItemProvider()
+{
+  QgsProviderMetadata *metadata = QgsProviderRegistry::instance()->providerMetadata( QStringLiteral( "copc" ) );
+  mFileFilter = metadata->filters( QgsProviderMetadata::FilterType::FilterPointCloud );
+}
+
+QString QgsCopcDataItemProvider::name()
+{
+  return QStringLiteral( "copc" );
+}
+
+int QgsCopcDataItemProvider::capabilities() const
+{
+  return QgsDataProvider::File;
+}
+
+QgsDataItem *QgsCopcDataItemProvider::createDataItem( const QString &path, QgsDataItem *parentItem )
+{
+  if ( path.isEmpty() )
+    return nullptr;
+
+  QgsDebugMsgLevel( "thePath = " + path, 2 );
+
+  const QFileInfo info( path );
+
+  // allow only normal files
+  if ( !info.isFile() )
+    return nullptr;
+
+  // Filter files by extension
+  if ( !QgsFileUtils::fileMatchesFilter( path, mFileFilter ) )
+    return nullptr;
+
+  return new QgsCopcLayerItem( parentItem, info.fileName(), path, path );
+}
+
+///@endcond
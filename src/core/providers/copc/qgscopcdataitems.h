@@ -0,0 +1,57 @@
+/***************************************************************************
+                         qgscopcdataitems.h
+                         --------------------
+    begin                : October 2026
+    copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSCOPCDATAITEMS_H
+#define QGSCOPCDATAITEMS_H
+
+#include "qgslayeritem.h"
+#include "qgsdataitemprovider.h"
+
+///@cond PRIVATE
+#define SIP_NO_FILE
+
+class CORE_EXPORT QgsCopcLayerItem : public QgsLayerItem
+{
+    Q_OBJECT
+  public:
+    QgsCopcLayerItem( QgsDataItem *parent, const QString &name, const QString &path, const QString &uri );
+    QString layerName() const override;
+
+};
+
+//! Provider for COPC data items
+class QgsCopcDataItemProvider : public QgsDataItemProvider
+{
+  public:
+
+    QgsCopcDataItemProvider();
+
+    QString name() override;
+
+    int capabilities() const override;
+
+    QgsDataItem *createDataItem( const QString &pathIn, QgsDataItem *parentItem ) override;
+
+  private:
+
+    QString mFileFilter;
+};
+
+///@endcond
+#endif // QGSCOPCDATAITEMS_H
+
+
+
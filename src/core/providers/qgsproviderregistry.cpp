@@ -43,6 +43,10 @@
 #include "providers/ept/qgseptprovider.h"
 #endif
 
+#ifdef HAVE_COPC
+#include "providers/copc/qgscopcprovider.h"
+#endif
+
 #include "qgsruntimeprofiler.h"
 #include "qgsfileutils.h"
 
@@ -184,6 +188,13 @@ void QgsProviderRegistry::init()
     mProviders[ pc->key() ] = pc;
   }
 #endif
+#ifdef HAVE_COPC
+  {
+    QgsScopedRuntimeProfile profile( QObject::tr( "Create COPC point cloud provider" ) );
+    QgsProviderMetadata *pc = new QgsCopcProviderMetadata();
+    mProviders[ pc->key() ] = pc;
+  }
+#endif
 
   registerUnusableUriHandler( new PdalUnusableUriHandlerInterface() );
 
@@ -26,6 +26,11 @@
 #include <QNetworkProxy>
 #include <QString>
 #include <QImage>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <algorithm>
+#include <cmath>
 
 bool QgsGdalUtils::supportsRasterCreate( GDALDriverH driver )
 {
@@ -182,53 +187,106 @@ bool QgsGdalUtils::resampleSingleBandRaster( GDALDatasetH hSrcDS, GDALDatasetH h
   return retVal;
 }
 
-QImage QgsGdalUtils::resampleImage( const QImage &image, QSize outputSize, GDALRIOResampleAlg resampleAlg )
+///@cond PRIVATE
+
+//! Minimum number of output rows resampled by each thread in QgsGdalUtils::resampleImage()
+constexpr int RESAMPLE_IMAGE_MIN_ROWS_PER_BAND = 32;
+
+/**
+ * Resamples the rows from \a firstRow to \a firstRow + \a rowCount of the output image, whose bits start at
+ * \a outputBits. Each call uses its own memory dataset wrapping \a image, and reads the matching fractional
+ * window of the source so that the result is identical to resampling the whole image at once.
+ */
+static bool resampleImageRows( const QImage &image, QSize outputSize, GByte *outputBits, int bytesPerLine, int firstRow, int rowCount, GDALRIOResampleAlg resampleAlg )
 {
   gdal::dataset_unique_ptr srcDS = QgsGdalUtils::imageToMemoryDataset( image );
   if ( !srcDS )
-    return QImage();
+    return false;
+
+  const double yScale = static_cast< double >( image.height() ) / outputSize.height();
+  const double srcYOff = firstRow * yScale;
+  const double srcYSize = firstRow + rowCount == outputSize.height() ? image.height() - srcYOff : rowCount * yScale;
 
   GDALRasterIOExtraArg extra;
   INIT_RASTERIO_EXTRA_ARG( extra );
   extra.eResampleAlg = resampleAlg;
+  extra.bFloatingPointWindowValidity = TRUE;
+  extra.dfXOff = 0;
+  extra.dfYOff = srcYOff;
+  extra.dfXSize = image.width();
+  extra.dfYSize = srcYSize;
+
+  const int yOff = std::min( image.height() - 1, static_cast< int >( std::floor( srcYOff ) ) );
+  const int yEnd = std::min( image.height(), static_cast< int >( std::ceil( srcYOff + srcYSize - 1e-10 ) ) );
+  const int ySize = std::max( 1, yEnd - yOff );
+
+  GByte *rgb = outputBits + static_cast< qgssize >( firstRow ) * bytesPerLine;
+
+  // bands of the memory dataset are red, green, blue and alpha
+  const int offsets[] = { 2, 1, 0, 3 };
+  for ( int band = 0; band < 4; ++band )
+  {
+    const CPLErr err = GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), band + 1 ), GF_Read, 0, yOff, image.width(), ySize, rgb + offsets[band], outputSize.width(),
+                                       rowCount, GDT_Byte, sizeof( QRgb ), bytesPerLine, &extra );
+    if ( err != CE_None )
+    {
+      QgsDebugMsg( QStringLiteral( "failed to read band %1" ).arg( band + 1 ) );
+      return false;
+    }
+  }
+  return true;
+}
+
+///@endcond
+
+QImage QgsGdalUtils::resampleImage( const QImage &image, QSize outputSize, GDALRIOResampleAlg resampleAlg )
+{
+  const int bandCount = std::max( 1, std::min( QThread::idealThreadCount(), outputSize.height() / RESAMPLE_IMAGE_MIN_ROWS_PER_BAND ) );
+  return resampleImageInBands( image, outputSize, resampleAlg, bandCount );
+}
+
+QImage QgsGdalUtils::resampleImageInBands( const QImage &image, QSize outputSize, GDALRIOResampleAlg resampleAlg, int bandCount )
+{
+  if ( image.isNull() )
+    return QImage();
 
   QImage res( outputSize, image.format() );
   if ( res.isNull() )
     return QImage();
 
   GByte *rgb = reinterpret_cast<GByte *>( res.bits() );
+  const int bytesPerLine = res.bytesPerLine();
 
-  CPLErr err = GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), 1 ), GF_Read, 0, 0, image.width(), image.height(), rgb + 2, outputSize.width(),
-                               outputSize.height(), GDT_Byte, sizeof( QRgb ), res.bytesPerLine(), &extra );
-  if ( err != CE_None )
+  // the output rows are resampled in bands on the global thread pool
+  struct RowBand
   {
-    QgsDebugMsg( QStringLiteral( "failed to read red band" ) );
-    return QImage();
-  }
-
-  err = GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), 2 ), GF_Read, 0, 0, image.width(), image.height(), rgb + 1, outputSize.width(),
-                        outputSize.height(), GDT_Byte, sizeof( QRgb ), res.bytesPerLine(), &extra );
-  if ( err != CE_None )
+    int firstRow = 0;
+    int rowCount = 0;
+    bool ok = false;
+  };
+  std::vector< RowBand > bands;
+  bandCount = std::max( 1, std::min( bandCount, outputSize.height() ) );
+  const int rowsPerBand = outputSize.height() / bandCount;
+  for ( int i = 0; i < bandCount; ++i )
   {
-    QgsDebugMsg( QStringLiteral( "failed to read green band" ) );
-    return QImage();
+    RowBand band;
+    band.firstRow = i * rowsPerBand;
+    //make sure last band goes to end of image
+    band.rowCount = i < bandCount - 1 ? rowsPerBand : outputSize.height() - band.firstRow;
+    bands.emplace_back( band );
   }
 
-  err = GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), 3 ), GF_Read, 0, 0, image.width(), image.height(), rgb, outputSize.width(),
-                        outputSize.height(), GDT_Byte, sizeof( QRgb ), res.bytesPerLine(), &extra );
-  if ( err != CE_None )
+  const auto resampleBand = [&image, outputSize, rgb, bytesPerLine, resampleAlg]( RowBand & band )
   {
-    QgsDebugMsg( QStringLiteral( "failed to read blue band" ) );
-    return QImage();
-  }
+    band.ok = resampleImageRows( image, outputSize, rgb, bytesPerLine, band.firstRow, band.rowCount, resampleAlg );
+  };
+  if ( bands.size() == 1 )
+    resampleBand( bands.front() );
+  else
+    QtConcurrent::blockingMap( bands, resampleBand );
 
-  err = GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), 4 ), GF_Read, 0, 0, image.width(), image.height(), rgb + 3, outputSize.width(),
-                        outputSize.height(), GDT_Byte, sizeof( QRgb ), res.bytesPerLine(), &extra );
-  if ( err != CE_None )
-  {
-    QgsDebugMsg( QStringLiteral( "failed to read alpha band" ) );
+  if ( !std::all_of( bands.begin(), bands.end(), []( const RowBand & band ) { return band.ok; } ) )
     return QImage();
-  }
 
   return res;
 }
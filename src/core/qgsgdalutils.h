@@ -132,6 +132,11 @@ class CORE_EXPORT QgsGdalUtils
     static void setupProxy();
 #endif
 
+  private:
+
+    //! Resamples a QImage \a image, with the output rows split in \a bandCount bands resampled concurrently
+    static QImage resampleImageInBands( const QImage &image, QSize outputSize, GDALRIOResampleAlg resampleAlg, int bandCount );
+
     friend class TestQgsGdalUtils;
 };
 
@@ -21,6 +21,8 @@
 #include <QByteArray>
 #include <QTime>
 #include <QStringList>
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "qgslogger.h"
 #include "qgsrasterbandstats.h"
@@ -28,6 +30,181 @@
 #include "qgsrasterinterface.h"
 #include "qgsrectangle.h"
 
+///@cond PRIVATE
+
+//! Statistics of the values of one raster block, merged in block order into the band statistics
+struct QgsRasterBlockStatistics
+{
+  qgssize elementCount = 0; //!< Count of values which are not no data, including infinite values
+  double sum = 0; //!< Sum of the values which are not no data, including infinite values
+  qgssize finiteCount = 0; //!< Count of finite values
+  double minimum = std::numeric_limits<double>::max();
+  double maximum = std::numeric_limits<double>::lowest();
+  double mean = 0; //!< Mean of the finite values
+  double sumOfSquares = 0; //!< Sum of the squared deviations of the finite values from their mean
+};
+
+/**
+ * Computes the statistics of the \a count values of \a data.
+ *
+ * The sum of squares is computed in a second pass around the mean of the block, which is both more
+ * accurate than a running update and free of divisions in the loops.
+ */
+template <typename T, typename NoDataTest>
+static void blockStatistics( const T *data, qgssize count, const NoDataTest &isNoData, QgsRasterBlockStatistics &stats )
+{
+  double finiteSum = 0;
+  for ( qgssize i = 0; i < count; ++i )
+  {
+    const double value = static_cast< double >( data[i] );
+    if ( isNoData( i, value ) )
+      continue;
+
+    stats.sum += value;
+    stats.elementCount++;
+
+    if ( !std::isfinite( value ) )
+      continue;
+
+    stats.finiteCount++;
+    finiteSum += value;
+    stats.minimum = std::min( stats.minimum, value );
+    stats.maximum = std::max( stats.maximum, value );
+  }
+
+  if ( stats.finiteCount == 0 )
+    return;
+
+  stats.mean = finiteSum / stats.finiteCount;
+  for ( qgssize i = 0; i < count; ++i )
+  {
+    const double value = static_cast< double >( data[i] );
+    if ( isNoData( i, value ) || !std::isfinite( value ) )
+      continue;
+
+    const double delta = value - stats.mean;
+    stats.sumOfSquares += delta * delta;
+  }
+}
+
+/**
+ * Assigns to each of the \a count values of \a data its histogram bin in \a bins, or -1 if the value must not be counted.
+ */
+template <typename T, typename NoDataTest>
+static void blockHistogramBins( const T *data, qgssize count, const NoDataTest &isNoData, double minimum, double binSize, int binCount, bool includeOutOfRange, int *bins )
+{
+  for ( qgssize i = 0; i < count; ++i )
+  {
+    const double value = static_cast< double >( data[i] );
+    if ( isNoData( i, value ) )
+    {
+      bins[i] = -1;
+      continue;
+    }
+
+    // compare as double, so that values far outside of the range do not overflow the bin index
+    const double bin = std::floor( ( value - minimum ) / binSize );
+    if ( !( bin >= 0 ) )
+      bins[i] = includeOutOfRange ? 0 : -1;
+    else if ( bin > binCount - 1 )
+      bins[i] = includeOutOfRange ? binCount - 1 : -1;
+    else
+      bins[i] = static_cast< int >( bin );
+  }
+}
+
+/**
+ * Calls \a kernel with the typed data of \a block and the no data test matching the block, or
+ * with values converted to double for the data types without a typed kernel.
+ */
+template <typename Kernel>
+static void dispatchBlock( QgsRasterBlock *block, const Kernel &kernel )
+{
+  const qgssize count = static_cast< qgssize >( block->width() ) * block->height();
+
+  auto dispatchType = [block, count, &kernel]( const auto & isNoData )
+  {
+    const char *data = block->bits();
+    switch ( block->dataType() )
+    {
+      case Qgis::DataType::Byte:
+        kernel( reinterpret_cast< const quint8 * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::UInt16:
+        kernel( reinterpret_cast< const quint16 * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::Int16:
+        kernel( reinterpret_cast< const qint16 * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::UInt32:
+        kernel( reinterpret_cast< const quint32 * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::Int32:
+        kernel( reinterpret_cast< const qint32 * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::Float32:
+        kernel( reinterpret_cast< const float * >( data ), count, isNoData );
+        return true;
+      case Qgis::DataType::Float64:
+        kernel( reinterpret_cast< const double * >( data ), count, isNoData );
+        return true;
+      default:
+        return false;
+    }
+  };
+
+  bool done = false;
+  if ( block->bits() && block->hasNoDataValue() )
+  {
+    const double noDataValue = block->noDataValue();
+    done = dispatchType( [noDataValue]( qgssize, double value ) { return std::isnan( value ) || qgsDoubleNear( value, noDataValue ); } );
+  }
+  else if ( block->bits() && block->hasNoData() )
+  {
+    done = dispatchType( [block]( qgssize index, double ) { return block->isNoData( index ); } );
+  }
+  else if ( block->bits() )
+  {
+    done = dispatchType( []( qgssize, double ) { return false; } );
+  }
+
+  if ( !done )
+  {
+    // complex and ARGB types, or unallocated block
+    std::vector< double > values( count );
+    std::vector< char > noData( count );
+    for ( qgssize i = 0; i < count; ++i )
+    {
+      bool isNoData = false;
+      values[i] = block->valueAndNoData( i, isNoData );
+      noData[i] = isNoData;
+    }
+    kernel( values.data(), count, [&noData]( qgssize index, double ) { return noData[index] != 0; } );
+  }
+}
+
+//! Merges the statistics \a part of a block into the statistics \a total of the previous blocks
+static void mergeStatistics( QgsRasterBlockStatistics &total, const QgsRasterBlockStatistics &part )
+{
+  total.sum += part.sum;
+  total.elementCount += part.elementCount;
+
+  if ( part.finiteCount == 0 )
+    return;
+
+  total.minimum = std::min( total.minimum, part.minimum );
+  total.maximum = std::max( total.maximum, part.maximum );
+
+  // pairwise update of the mean and of the sum of squares (Chan et al.)
+  const double count = static_cast< double >( total.finiteCount + part.finiteCount );
+  const double delta = part.mean - total.mean;
+  total.mean += delta * static_cast< double >( part.finiteCount ) / count;
+  total.sumOfSquares += part.sumOfSquares + delta * delta * static_cast< double >( total.finiteCount ) * static_cast< double >( part.finiteCount ) / count;
+  total.finiteCount += part.finiteCount;
+}
+
+///@endcond
+
 QgsRasterInterface::QgsRasterInterface( QgsRasterInterface *input )
   : mInput( input )
 {
@@ -159,12 +336,39 @@ QgsRasterBandStats QgsRasterInterface::bandStatistics( int bandNo,
   double myYRes = myExtent.height() / myHeight;
   // TODO: progress signals
 
-  // used by single pass stdev
-  double myMean = 0;
-  double mySumOfSquares = 0;
+  // blocks are read on this thread, as interfaces are not required to be thread safe, and a batch of
+  // blocks is then reduced in parallel
+  struct BlockTask
+  {
+    std::unique_ptr< QgsRasterBlock > block;
+    QgsRasterBlockStatistics statistics;
+  };
+  const int batchSize = std::max( 1, QThread::idealThreadCount() );
+  std::vector< BlockTask > batch;
+  batch.reserve( batchSize );
+
+  QgsRasterBlockStatistics totalStatistics;
+  auto reduceBatch = [&batch, &totalStatistics]
+  {
+    auto reduceBlock = []( BlockTask & task )
+    {
+      QgsRasterBlockStatistics &statistics = task.statistics;
+      dispatchBlock( task.block.get(), [&statistics]( const auto * data, qgssize count, const auto & isNoData )
+      {
+        blockStatistics( data, count, isNoData, statistics );
+      } );
+    };
+
+    if ( batch.size() == 1 )
+      reduceBlock( batch.front() );
+    else
+      QtConcurrent::blockingMap( batch, reduceBlock );
+
+    for ( const BlockTask &task : batch )
+      mergeStatistics( totalStatistics, task.statistics );
+    batch.clear();
+  };
 
-  bool myFirstIterationFlag = true;
-  bool isNoData = false;
   for ( int myYBlock = 0; myYBlock < myNYBlocks; myYBlock++ )
   {
     for ( int myXBlock = 0; myXBlock < myNXBlocks; myXBlock++ )
@@ -183,45 +387,27 @@ QgsRasterBandStats QgsRasterInterface::bandStatistics( int bandNo,
 
       QgsRectangle myPartExtent( xmin, ymin, xmax, ymax );
 
-      std::unique_ptr< QgsRasterBlock > blk( block( bandNo, myPartExtent, myBlockWidth, myBlockHeight, feedback ) );
+      BlockTask task;
+      task.block.reset( block( bandNo, myPartExtent, myBlockWidth, myBlockHeight, feedback ) );
+      if ( !task.block )
+        continue;
 
-      // Collect the histogram counts.
-      for ( qgssize i = 0; i < ( static_cast< qgssize >( myBlockHeight ) ) * myBlockWidth; i++ )
-      {
-        double myValue = blk->valueAndNoData( i, isNoData );
-        if ( isNoData )
-          continue; // NULL
-
-        myRasterBandStats.sum += myValue;
-        myRasterBandStats.elementCount++;
-
-        if ( !std::isfinite( myValue ) ) continue; // inf
-
-        if ( myFirstIterationFlag )
-        {
-          myFirstIterationFlag = false;
-          myRasterBandStats.minimumValue = myValue;
-          myRasterBandStats.maximumValue = myValue;
-        }
-        else
-        {
-          if ( myValue < myRasterBandStats.minimumValue )
-          {
-            myRasterBandStats.minimumValue = myValue;
-          }
-          if ( myValue > myRasterBandStats.maximumValue )
-          {
-            myRasterBandStats.maximumValue = myValue;
-          }
-        }
-
-        // Single pass stdev
-        double myDelta = myValue - myMean;
-        myMean += myDelta / myRasterBandStats.elementCount;
-        mySumOfSquares += myDelta * ( myValue - myMean );
-      }
+      batch.emplace_back( std::move( task ) );
+      if ( static_cast< int >( batch.size() ) == batchSize )
+        reduceBatch();
     }
   }
+  if ( !batch.empty() )
+    reduceBatch();
+
+  myRasterBandStats.sum += totalStatistics.sum;
+  myRasterBandStats.elementCount += totalStatistics.elementCount;
+  if ( totalStatistics.finiteCount > 0 )
+  {
+    myRasterBandStats.minimumValue = totalStatistics.minimum;
+    myRasterBandStats.maximumValue = totalStatistics.maximum;
+  }
+  const double mySumOfSquares = totalStatistics.sumOfSquares;
 
   myRasterBandStats.range = myRasterBandStats.maximumValue - myRasterBandStats.minimumValue;
   myRasterBandStats.mean = myRasterBandStats.sum / myRasterBandStats.elementCount;
@@ -460,8 +646,49 @@ QgsRasterHistogram QgsRasterInterface::histogram( int bandNo,
 
   double myBinSize = ( myMaximum - myMinimum ) / myBinCount;
 
+  // blocks are read on this thread, as interfaces are not required to be thread safe, and the bins of
+  // a batch of blocks are then computed in parallel
+  struct BlockTask
+  {
+    std::unique_ptr< QgsRasterBlock > block;
+    std::vector< int > bins;
+  };
+  const int batchSize = std::max( 1, QThread::idealThreadCount() );
+  std::vector< BlockTask > batch;
+  batch.reserve( batchSize );
+
+  auto reduceBatch = [&batch, &myHistogram, myMinimum, myBinSize, myBinCount, includeOutOfRange]
+  {
+    auto binBlock = [myMinimum, myBinSize, myBinCount, includeOutOfRange]( BlockTask & task )
+    {
+      task.bins.resize( static_cast< qgssize >( task.block->width() ) * task.block->height() );
+      int *bins = task.bins.data();
+      dispatchBlock( task.block.get(), [ =, &bins ]( const auto * data, qgssize count, const auto & isNoData )
+      {
+        blockHistogramBins( data, count, isNoData, myMinimum, myBinSize, myBinCount, includeOutOfRange, bins );
+      } );
+    };
+
+    if ( batch.size() == 1 )
+      binBlock( batch.front() );
+    else
+      QtConcurrent::blockingMap( batch, binBlock );
+
+    for ( const BlockTask &task : batch )
+    {
+      for ( int bin : task.bins )
+      {
+        if ( bin < 0 )
+          continue;
+
+        myHistogram.histogramVector[bin] += 1;
+        myHistogram.nonNullCount++;
+      }
+    }
+    batch.clear();
+  };
+
   // TODO: progress signals
-  bool isNoData = false;
   for ( int myYBlock = 0; myYBlock < myNYBlocks; myYBlock++ )
   {
     for ( int myXBlock = 0; myXBlock < myNXBlocks; myXBlock++ )
@@ -479,31 +706,18 @@ QgsRasterHistogram QgsRasterInterface::histogram( int bandNo,
 
       QgsRectangle myPartExtent( xmin, ymin, xmax, ymax );
 
-      std::unique_ptr< QgsRasterBlock > blk( block( bandNo, myPartExtent, myBlockWidth, myBlockHeight, feedback ) );
-
-      // Collect the histogram counts.
-      for ( qgssize i = 0; i < ( static_cast< qgssize >( myBlockHeight ) ) * myBlockWidth; i++ )
-      {
-        double myValue = blk->valueAndNoData( i, isNoData );
-        if ( isNoData )
-        {
-          continue; // NULL
-        }
-
-        int myBinIndex = static_cast <int>( std::floor( ( myValue - myMinimum ) /  myBinSize ) );
-
-        if ( ( myBinIndex < 0 || myBinIndex > ( myBinCount - 1 ) ) && !includeOutOfRange )
-        {
-          continue;
-        }
-        if ( myBinIndex < 0 ) myBinIndex = 0;
-        if ( myBinIndex > ( myBinCount - 1 ) ) myBinIndex = myBinCount - 1;
+      BlockTask task;
+      task.block.reset( block( bandNo, myPartExtent, myBlockWidth, myBlockHeight, feedback ) );
+      if ( !task.block )
+        continue;
 
-        myHistogram.histogramVector[myBinIndex] += 1;
-        myHistogram.nonNullCount++;
-      }
+      batch.emplace_back( std::move( task ) );
+      if ( static_cast< int >( batch.size() ) == batchSize )
+        reduceBatch();
     }
   }
+  if ( !batch.empty() )
+    reduceBatch();
 
   myHistogram.valid = true;
   mHistograms.append( myHistogram );
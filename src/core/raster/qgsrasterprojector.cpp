@@ -22,6 +22,29 @@
 #include "qgscoordinatetransform.h"
 #include "qgsexception.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
+///@cond PRIVATE
+
+//! Minimum number of destination rows projected by each thread
+constexpr int MIN_ROWS_PER_BAND = 32;
+
+//! Copies the source pixels at \a indexes to a destination row of \a count pixels, skipping negative indexes
+template< typename T >
+static void copyPixels( const qint64 *indexes, int count, const char *srcData, char *destRow )
+{
+  const T *src = reinterpret_cast< const T * >( srcData );
+  T *dest = reinterpret_cast< T * >( destRow );
+  for ( int j = 0; j < count; ++j )
+  {
+    if ( indexes[j] >= 0 )
+      dest[j] = src[indexes[j]];
+  }
+}
+
+///@endcond
+
 Q_NOWARN_DEPRECATED_PUSH // because of deprecated members
 QgsRasterProjector::QgsRasterProjector()
   : QgsRasterInterface( nullptr )
@@ -402,22 +425,22 @@ void ProjectorData::calcSrcRowsCols()
 }
 
 
-inline void ProjectorData::destPointOnCPMatrix( int row, int col, double *theX, double *theY )
+inline void ProjectorData::destPointOnCPMatrix( int row, int col, double *theX, double *theY ) const
 {
   *theX = mDestExtent.xMinimum() + col * mDestExtent.width() / ( mCPCols - 1 );
   *theY = mDestExtent.yMaximum() - row * mDestExtent.height() / ( mCPRows - 1 );
 }
 
-inline int ProjectorData::matrixRow( int destRow )
+inline int ProjectorData::matrixRow( int destRow ) const
 {
   return static_cast< int >( std::floor( ( destRow + 0.5 ) / mDestRowsPerMatrixRow ) );
 }
-inline int ProjectorData::matrixCol( int destCol )
+inline int ProjectorData::matrixCol( int destCol ) const
 {
   return static_cast< int >( std::floor( ( destCol + 0.5 ) / mDestColsPerMatrixCol ) );
 }
 
-void ProjectorData::calcHelper( int matrixRow, QgsPointXY *points )
+void ProjectorData::calcHelper( int matrixRow, QgsPointXY *points ) const
 {
   // TODO?: should we also precalc dest cell center coordinates for x and y?
   for ( int myDestCol = 0; myDestCol < mDestCols; myDestCol++ )
@@ -433,8 +456,8 @@ void ProjectorData::calcHelper( int matrixRow, QgsPointXY *points )
 
     double xfrac = ( myDestX - myDestXMin ) / ( myDestXMax - myDestXMin );
 
-    QgsPointXY &mySrcPoint0 = mCPMatrix[matrixRow][myMatrixCol];
-    QgsPointXY &mySrcPoint1 = mCPMatrix[matrixRow][myMatrixCol + 1];
+    const QgsPointXY &mySrcPoint0 = mCPMatrix.at( matrixRow ).at( myMatrixCol );
+    const QgsPointXY &mySrcPoint1 = mCPMatrix.at( matrixRow ).at( myMatrixCol + 1 );
     double s = mySrcPoint0.x() + ( mySrcPoint1.x() - mySrcPoint0.x() ) * xfrac;
     double t = mySrcPoint0.y() + ( mySrcPoint1.y() - mySrcPoint0.y() ) * xfrac;
 
@@ -498,6 +521,11 @@ bool ProjectorData::preciseSrcRowCol( int destRow, int destCol, int *srcRow, int
   QgsDebugMsgLevel( QStringLiteral( "x = %1 y = %2" ).arg( x ).arg( y ), 5 );
 #endif
 
+  return srcRowColForPoint( x, y, srcRow, srcCol );
+}
+
+bool ProjectorData::srcRowColForPoint( double x, double y, int *srcRow, int *srcCol ) const
+{
   if ( !mExtent.contains( x, y ) )
   {
     return false;
@@ -505,10 +533,6 @@ bool ProjectorData::preciseSrcRowCol( int destRow, int destCol, int *srcRow, int
   // Get source row col
   *srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - y ) / mSrcYRes ) );
   *srcCol = static_cast< int >( std::floor( ( x - mSrcExtent.xMinimum() ) / mSrcXRes ) );
-#if 0
-  QgsDebugMsgLevel( QStringLiteral( "mSrcExtent.yMinimum() = %1 mSrcExtent.yMaximum() = %2 mSrcYRes = %3" ).arg( mSrcExtent.yMinimum() ).arg( mSrcExtent.yMaximum() ).arg( mSrcYRes ), 5 );
-  QgsDebugMsgLevel( QStringLiteral( "theSrcRow = %1 srcCol = %2" ).arg( *srcRow ).arg( *srcCol ), 5 );
-#endif
 
   // With epsg 32661 (Polar Stereographic) it was happening that *srcCol == mSrcCols
   // For now silently correct limits to avoid crashes
@@ -525,7 +549,6 @@ bool ProjectorData::preciseSrcRowCol( int destRow, int destCol, int *srcRow, int
 bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol )
 {
   int myMatrixRow = matrixRow( destRow );
-  int myMatrixCol = matrixCol( destCol );
 
   if ( myMatrixRow > mHelperTopRow )
   {
@@ -533,6 +556,14 @@ bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow,
     nextHelper();
   }
 
+  return interpolatedSrcRowCol( destRow, destCol, pHelperTop, pHelperBottom, srcRow, srcCol );
+}
+
+bool ProjectorData::interpolatedSrcRowCol( int destRow, int destCol, const QgsPointXY *top, const QgsPointXY *bottom, int *srcRow, int *srcCol ) const
+{
+  int myMatrixRow = matrixRow( destRow );
+  int myMatrixCol = matrixCol( destCol );
+
   double myDestY = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
 
   // See the schema in javax.media.jai.WarpGrid doc (but up side down)
@@ -544,8 +575,8 @@ bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow,
 
   double yfrac = ( myDestY - myDestYMin ) / ( myDestYMax - myDestYMin );
 
-  QgsPointXY &myTop = pHelperTop[destCol];
-  QgsPointXY &myBot = pHelperBottom[destCol];
+  const QgsPointXY &myTop = top[destCol];
+  const QgsPointXY &myBot = bottom[destCol];
 
   // Warning: this is very SLOW compared to the following code!:
   //double mySrcX = myBot.x() + (myTop.x() - myBot.x()) * yfrac;
@@ -558,25 +589,95 @@ bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow,
   double mySrcX = bx + ( tx - bx ) * yfrac;
   double mySrcY = by + ( ty - by ) * yfrac;
 
-  if ( !mExtent.contains( mySrcX, mySrcY ) )
+  // TODO: check again cell selection (coor is in the middle)
+  return srcRowColForPoint( mySrcX, mySrcY, srcRow, srcCol );
+}
+
+void ProjectorData::srcIndexes( int startRow, int endRow, qint64 *indexes ) const
+{
+  int srcRow = 0;
+  int srcCol = 0;
+  if ( mApproximate )
   {
-    return false;
+    // each caller interpolates with its own helper rows, the shared ones are only used by srcRowCol()
+    std::vector< QgsPointXY > top( mDestCols );
+    std::vector< QgsPointXY > bottom( mDestCols );
+    int helperRow = -1;
+    for ( int destRow = startRow; destRow < endRow; ++destRow )
+    {
+      const int myMatrixRow = matrixRow( destRow );
+      if ( myMatrixRow != helperRow )
+      {
+        calcHelper( myMatrixRow, top.data() );
+        calcHelper( myMatrixRow + 1, bottom.data() );
+        helperRow = myMatrixRow;
+      }
+      for ( int destCol = 0; destCol < mDestCols; ++destCol )
+      {
+        *indexes++ = interpolatedSrcRowCol( destRow, destCol, top.data(), bottom.data(), &srcRow, &srcCol )
+                     ? static_cast< qint64 >( srcRow ) * mSrcCols + srcCol : -1;
+      }
+    }
+    return;
   }
 
-  // TODO: check again cell selection (coor is in the middle)
-
-  *srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - mySrcY ) / mSrcYRes ) );
-  *srcCol = static_cast< int >( std::floor( ( mySrcX - mSrcExtent.xMinimum() ) / mSrcXRes ) );
+  // precise: transform the centers of a whole destination row at once
+  std::vector< double > x( mDestCols );
+  std::vector< double > y( mDestCols );
+  std::vector< double > z( mDestCols );
+  for ( int destRow = startRow; destRow < endRow; ++destRow )
+  {
+    const double destY = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
+    for ( int destCol = 0; destCol < mDestCols; ++destCol )
+    {
+      x[destCol] = mDestExtent.xMinimum() + ( destCol + 0.5 ) * mDestXRes;
+      y[destCol] = destY;
+      z[destCol] = 0;
+    }
 
-  // For now silently correct limits to avoid crashes
-  // TODO: review
-  // should not happen
-  if ( *srcRow >= mSrcRows ) return false;
-  if ( *srcRow < 0 ) return false;
-  if ( *srcCol >= mSrcCols ) return false;
-  if ( *srcCol < 0 ) return false;
+    // a copy of the transform per row, so that its fallback state is neither shared between callers nor between rows
+    const QgsCoordinateTransform ct = mInverseCt;
+    bool transformed = true;
+    if ( ct.isValid() )
+    {
+      try
+      {
+        ct.transformCoords( mDestCols, x.data(), y.data(), z.data() );
+        // a fallback operation is applied to the whole row when some of its points fail, while
+        // srcRowCol() only uses it for these points
+        transformed = !ct.fallbackOperationOccurred();
+      }
+      catch ( QgsCsException & )
+      {
+        transformed = false;
+      }
+    }
 
-  return true;
+    for ( int destCol = 0; destCol < mDestCols; ++destCol )
+    {
+      bool inside = false;
+      if ( transformed )
+      {
+        inside = srcRowColForPoint( x[destCol], y[destCol], &srcRow, &srcCol );
+      }
+      else
+      {
+        // transform the points of the row one by one
+        double px = mDestExtent.xMinimum() + ( destCol + 0.5 ) * mDestXRes;
+        double py = destY;
+        double pz = 0;
+        try
+        {
+          ct.transformInPlace( px, py, pz );
+          inside = srcRowColForPoint( px, py, &srcRow, &srcCol );
+        }
+        catch ( QgsCsException & )
+        {
+        }
+      }
+      *indexes++ = inside ? static_cast< qint64 >( srcRow ) * mSrcCols + srcCol : -1;
+    }
+  }
 }
 
 void ProjectorData::insertRows( const QgsCoordinateTransform &ct )
@@ -849,42 +950,97 @@ QgsRasterBlock *QgsRasterProjector::block( int bandNo, QgsRectangle  const &exte
 
   outputBlock->setIsNoData();
 
-  int srcRow, srcCol;
-  for ( int i = 0; i < height; ++i )
+  // The destination rows are processed in bands on the global thread pool. For each band, the index
+  // of the source pixel of every destination pixel is calculated first, then the values are copied
+  // with a loop specialized for the pixel size. The no data bitmap of a block is padded per row,
+  // so bands never write to the same bitmap bytes.
+  const char *srcData = inputBlock->bits();
+  char *destData = outputBlock->bits();
+  if ( !srcData || !destData )
   {
-    if ( feedback && feedback->isCanceled() )
-      break;
-    for ( int j = 0; j < width; ++j )
+    QgsDebugMsg( QStringLiteral( "Cannot get block data" ) );
+    return outputBlock.release();
+  }
+
+  struct RowBand
+  {
+    int startRow = 0;
+    int endRow = 0;
+  };
+  std::vector< RowBand > bands;
+  const int bandCount = std::max( 1, std::min( QThread::idealThreadCount(), height / MIN_ROWS_PER_BAND ) );
+  const int rowsPerBand = height / bandCount;
+  for ( int band = 0; band < bandCount; ++band )
+  {
+    RowBand rowBand;
+    rowBand.startRow = band * rowsPerBand;
+    //make sure last band goes to end of block
+    rowBand.endRow = band < bandCount - 1 ? rowBand.startRow + rowsPerBand : height;
+    bands.emplace_back( rowBand );
+  }
+
+  const bool useBitmap = !outputBlock->hasNoDataValue();
+  const QgsRasterBlock *constInputBlock = inputBlock.get();
+  QgsRasterBlock *destBlock = outputBlock.get();
+  const auto projectBand = [ =, &pd ]( const RowBand & band )
+  {
+    std::vector< qint64 > indexes( static_cast< std::size_t >( width ) );
+    for ( int i = band.startRow; i < band.endRow; ++i )
     {
-      bool inside = pd.srcRowCol( i, j, &srcRow, &srcCol );
-      if ( !inside ) continue; // we have everything set to no data
+      if ( feedback && feedback->isCanceled() )
+        break;
 
-      qgssize srcIndex = static_cast< qgssize >( srcRow * pd.srcCols() + srcCol );
+      pd.srcIndexes( i, i + 1, indexes.data() );
 
-      // isNoData() may be slow so we check doNoData first
-      if ( doNoData && inputBlock->isNoData( srcRow, srcCol ) )
+      if ( doNoData )
       {
-        outputBlock->setIsNoData( i, j );
-        continue;
+        // isNoData() may be slow so this is only done when required
+        for ( int j = 0; j < width; ++j )
+        {
+          if ( indexes[j] >= 0 && constInputBlock->isNoData( static_cast< qgssize >( indexes[j] ) ) )
+            indexes[j] = -1;
+        }
       }
 
-      qgssize destIndex = static_cast< qgssize >( i * width + j );
-      char *srcBits = inputBlock->bits( srcIndex );
-      char *destBits = outputBlock->bits( destIndex );
-      if ( !srcBits )
+      char *destRow = destData + static_cast< qgssize >( i ) * width * pixelSize;
+      switch ( pixelSize )
       {
-        // QgsDebugMsg( QStringLiteral( "Cannot get input block data: row = %1 col = %2" ).arg( i ).arg( j ) );
-        continue;
+        case 1:
+          copyPixels< quint8 >( indexes.data(), width, srcData, destRow );
+          break;
+        case 2:
+          copyPixels< quint16 >( indexes.data(), width, srcData, destRow );
+          break;
+        case 4:
+          copyPixels< quint32 >( indexes.data(), width, srcData, destRow );
+          break;
+        case 8:
+          copyPixels< quint64 >( indexes.data(), width, srcData, destRow );
+          break;
+        default:
+          for ( int j = 0; j < width; ++j )
+          {
+            if ( indexes[j] >= 0 )
+              memcpy( destRow + j * pixelSize, srcData + indexes[j] * pixelSize, pixelSize );
+          }
+          break;
       }
-      if ( !destBits )
+
+      if ( useBitmap )
       {
-        // QgsDebugMsg( QStringLiteral( "Cannot set output block data: srcRow = %1 srcCol = %2" ).arg( srcRow ).arg( srcCol ) );
-        continue;
+        for ( int j = 0; j < width; ++j )
+        {
+          if ( indexes[j] >= 0 )
+            destBlock->setIsData( i, j );
+        }
       }
-      memcpy( destBits, srcBits, pixelSize );
-      outputBlock->setIsData( i, j );
     }
-  }
+  };
+
+  if ( bands.size() == 1 )
+    projectBand( bands.front() );
+  else
+    QtConcurrent::blockingMap( bands, projectBand );
 
   return outputBlock.release();
 }
@@ -152,6 +152,16 @@ class ProjectorData
      */
     bool srcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
 
+    /**
+     * Calculates the index in the source block (srcRow * srcCols() + srcCol) of each pixel of the
+     * destination rows from \a startRow to \a endRow (excluded), or -1 for pixels outside of the source.
+     * \a indexes must have room for ( endRow - startRow ) * destination width values.
+     *
+     * Unlike srcRowCol(), this does not modify the projector data, so it can be called concurrently
+     * for distinct rows.
+     */
+    void srcIndexes( int startRow, int endRow, qint64 *indexes ) const;
+
     QgsRectangle srcExtent() const { return mSrcExtent; }
     int srcRows() const { return mSrcRows; }
     int srcCols() const { return mSrcCols; }
@@ -159,13 +169,19 @@ class ProjectorData
   private:
 
     //! Returns the destination point for _current_ destination position.
-    void destPointOnCPMatrix( int row, int col, double *theX, double *theY );
+    void destPointOnCPMatrix( int row, int col, double *theX, double *theY ) const;
 
     //! Returns the matrix upper left row index for destination row.
-    int matrixRow( int destRow );
+    int matrixRow( int destRow ) const;
 
     //! Returns the matrix upper left col index for destination col.
-    int matrixCol( int destCol );
+    int matrixCol( int destCol ) const;
+
+    //! Returns source row and column indexes of the source point \a x, \a y.
+    inline bool srcRowColForPoint( double x, double y, int *srcRow, int *srcCol ) const;
+
+    //! Returns source row and column indexes interpolated between the \a top and \a bottom helper points of the matrix row of \a destRow.
+    inline bool interpolatedSrcRowCol( int destRow, int destCol, const QgsPointXY *top, const QgsPointXY *bottom, int *srcRow, int *srcCol ) const;
 
     //! Returns precise source row and column indexes for current source extent and resolution.
     inline bool preciseSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
@@ -207,7 +223,7 @@ class ProjectorData
     bool checkRows( const QgsCoordinateTransform &ct );
 
     //! Calculate array of src helper points
-    void calcHelper( int matrixRow, QgsPointXY *points );
+    void calcHelper( int matrixRow, QgsPointXY *points ) const;
 
     //! Calc / switch helper
     void nextHelper();
@@ -392,6 +392,21 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
     context.setVectorSimplifyMethod( vectorMethod );
   }
 
+  // replace the exact reprojection of every vertex with an interpolation in a grid of exactly transformed
+  // points covering the clipping extent used by the symbols, with an error below half a pixel
+  if ( context.testFlag( QgsRenderContext::ApproximateTransforms ) && !( context.flags() & QgsRenderContext::ApplyClipAfterReprojection )
+       && context.coordinateTransform().isValid() && !context.coordinateTransform().isShortCircuited() && !context.coordinateTransform().hasApproximation() )
+  {
+    const QgsRectangle e = context.extent();
+    const double cw = e.width() / 10;
+    const double ch = e.height() / 10;
+    const QgsRectangle gridExtent( e.xMinimum() - cw, e.yMinimum() - ch, e.xMaximum() + cw, e.yMaximum() + ch );
+
+    QgsCoordinateTransform ct = context.coordinateTransform();
+    if ( ct.setApproximation( gridExtent, context.mapToPixel().mapUnitsPerPixel() / 2 ) )
+      context.setCoordinateTransform( ct );
+  }
+
   featureRequest.setFeedback( mInterruptionChecker.get() );
   // also set the interruption checker for the expression context, in case the renderer uses some complex expression
   // which could benefit from early exit paths...
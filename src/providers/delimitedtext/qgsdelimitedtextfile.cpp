@@ -30,6 +30,44 @@
 #include <QUrl>
 #include <QUrlQuery>
 
+#include <algorithm>
+#include <cstring>
+
+// Interval between the line offsets recorded for memory mapped files
+static const long LINE_OFFSET_STEP = 64;
+
+void QgsDelimitedTextLineIndex::setFile( qint64 size, const QDateTime &lastModified )
+{
+  QMutexLocker locker( &mMutex );
+  if ( size == mFileSize && lastModified == mLastModified )
+    return;
+
+  mFileSize = size;
+  mLastModified = lastModified;
+  mOffsets.clear();
+}
+
+void QgsDelimitedTextLineIndex::addLineOffset( long lineNumber, qint64 offset, long step )
+{
+  if ( lineNumber % step != 0 )
+    return;
+
+  QMutexLocker locker( &mMutex );
+  if ( lineNumber / step == mOffsets.size() )
+    mOffsets.append( offset );
+}
+
+long QgsDelimitedTextLineIndex::closestLine( long lineNumber, qint64 &offset, long step ) const
+{
+  QMutexLocker locker( &mMutex );
+  if ( mOffsets.isEmpty() || lineNumber < 0 )
+    return -1;
+
+  const long checkpoint = std::min<long>( lineNumber / step, mOffsets.size() - 1 );
+  offset = mOffsets.at( checkpoint );
+  return checkpoint * step;
+}
+
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
   , mEncoding( QStringLiteral( "UTF-8" ) )
@@ -39,6 +77,7 @@ QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   mDefaultFieldRegexp.setPatternOptions( QRegularExpression::CaseInsensitiveOption );
   // The default type is CSV
   setTypeCSV();
+  mLineIndex = std::make_shared< QgsDelimitedTextLineIndex >();
   if ( ! url.isNull() ) setFromUrl( url );
 
   // For tests
@@ -59,6 +98,11 @@ void QgsDelimitedTextFile::close()
     delete mStream;
     mStream = nullptr;
   }
+  // deleting the file unmaps it
+  mMappedData = nullptr;
+  mMappedSize = 0;
+  mMappedStart = 0;
+  mMappedPos = 0;
   if ( mFile )
   {
     delete mFile;
@@ -96,6 +140,7 @@ bool QgsDelimitedTextFile::open()
         QTextCodec *codec = QTextCodec::codecForName( mEncoding.toLatin1() );
         mStream->setCodec( codec );
       }
+      mapFile();
       if ( mUseWatcher )
       {
         mWatcher = new QFileSystemWatcher();
@@ -107,6 +152,54 @@ bool QgsDelimitedTextFile::open()
   return nullptr != mFile;
 }
 
+void QgsDelimitedTextFile::mapFile()
+{
+  // A watched file is expected to change. The size of other files is checked
+  // again before each line is read from the map, see nextMappedLine()
+  if ( mUseWatcher )
+    return;
+
+  const QTextCodec *codec = QTextCodec::codecForName( mEncoding.toLatin1() );
+  if ( !codec || ( codec->mibEnum() != 106 && codec->mibEnum() != 4 ) ) // UTF-8 or ISO-8859-1
+    return;
+
+  const qint64 size = mFile->size();
+  if ( size <= 0 )
+    return;
+
+  const char *data = reinterpret_cast< const char * >( mFile->map( 0, size ) );
+  if ( !data )
+    return;
+
+  // Like the text stream, follow a byte order mark: UTF-8 is decoded
+  // directly, other unicode encodings are left to the stream
+  mMappedStart = 0;
+  mMappedLatin1 = codec->mibEnum() == 4;
+  if ( size >= 3 && std::memcmp( data, "\xEF\xBB\xBF", 3 ) == 0 )
+  {
+    mMappedStart = 3;
+    mMappedLatin1 = false;
+  }
+  else if ( size >= 2 && ( std::memcmp( data, "\xFF\xFE", 2 ) == 0 || std::memcmp( data, "\xFE\xFF", 2 ) == 0 ) )
+  {
+    mFile->unmap( reinterpret_cast< uchar * >( const_cast< char * >( data ) ) );
+    return;
+  }
+
+  mMappedData = data;
+  mMappedSize = size;
+  mMappedPos = mMappedStart;
+  // the offsets recorded by other readers are only valid for the same file contents
+  mLineIndex->setFile( size, QFileInfo( *mFile ).lastModified() );
+}
+
+void QgsDelimitedTextFile::setLineIndex( const std::shared_ptr< QgsDelimitedTextLineIndex > &index )
+{
+  mLineIndex = index;
+  if ( mMappedData )
+    mLineIndex->setFile( mMappedSize, QFileInfo( *mFile ).lastModified() );
+}
+
 void QgsDelimitedTextFile::updateFile()
 {
   close();
@@ -544,7 +637,10 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
   if ( ! isValid() || ! open() ) return InvalidDefinition;
 
   // Reset the file pointer
-  mStream->seek( 0 );
+  if ( mMappedData )
+    mMappedPos = mMappedStart;
+  else
+    mStream->seek( 0 );
   mLineNumber = 0;
   mRecordNumber = -1;
   mRecordLineNumber = -1;
@@ -576,6 +672,9 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
     Status status = reset();
     if ( status != RecordOk ) return status;
   }
+  if ( mMappedData )
+    return nextMappedLine( buffer, skipBlank );
+
   if ( mLineNumber == 0 )
   {
     mPosInBuffer = 0;
@@ -673,13 +772,91 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
   return RecordEOF;
 }
 
+QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextMappedLine( QString &buffer, bool skipBlank )
+{
+  while ( mMappedPos < mMappedSize )
+  {
+    // Reading past the end of a file which has been truncated while mapped
+    // raises SIGBUS. Give up on the map instead, later reads of the file go
+    // through the text stream.
+    if ( mFile->size() < mMappedSize )
+    {
+      QgsDebugMsgLevel( "Data file " + mFileName + " was truncated while it was read", 2 );
+      mFile->unmap( reinterpret_cast< uchar * >( const_cast< char * >( mMappedData ) ) );
+      mMappedData = nullptr;
+      mMappedSize = 0;
+      mMappedStart = 0;
+      mMappedPos = 0;
+      return RecordEOF;
+    }
+
+    const char *start = mMappedData + mMappedPos;
+
+    // As with the text stream, a line longer than the working buffer is
+    // truncated and ends the file
+    const size_t window = static_cast< size_t >( std::min<qint64>( mMappedSize - mMappedPos, mMaxBufferSize ) );
+
+    // memchr is vectorized by the C library
+    const char *eol = nullptr;
+    if ( mLineNumber == 0 || mFirstEOLChar.isNull() )
+    {
+      // For the first line we don't know yet the end of line character. Neither do we
+      // after jumping to a line recorded by another reader of the file.
+      const char *cr = static_cast< const char * >( std::memchr( start, '\r', window ) );
+      const char *lf = static_cast< const char * >( std::memchr( start, '\n', window ) );
+      eol = !cr ? lf : ( !lf ? cr : std::min( cr, lf ) );
+      if ( eol )
+        mFirstEOLChar = QChar( *eol );
+    }
+    else
+    {
+      eol = static_cast< const char * >( std::memchr( start, mFirstEOLChar.toLatin1(), window ) );
+    }
+
+    mLineIndex->addLineOffset( mLineNumber, mMappedPos, LINE_OFFSET_STEP );
+
+    qint64 length = static_cast< qint64 >( window );
+    qint64 nextPos = mMappedSize;
+    if ( eol )
+    {
+      length = eol - start;
+      nextPos = mMappedPos + length + 1;
+      // \r\n end of line
+      if ( *eol == '\r' && nextPos < mMappedSize && mMappedData[nextPos] == '\n' )
+        nextPos++;
+    }
+
+    buffer = mMappedLatin1 ? QString::fromLatin1( start, static_cast< int >( length ) ) : QString::fromUtf8( start, static_cast< int >( length ) );
+    mMappedPos = nextPos;
+
+    mLineNumber++;
+    if ( skipBlank && buffer.isEmpty() ) continue;
+    return RecordOk;
+  }
+
+  return RecordEOF;
+}
+
 bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 {
   if ( ! mStream ) return false;
+  qint64 offset = 0;
+  const long checkpointLine = mMappedData ? mLineIndex->closestLine( nextLineNumber - 1, offset, LINE_OFFSET_STEP ) : -1;
+  if ( checkpointLine >= 0 && ( mLineNumber > nextLineNumber - 1 || checkpointLine > mLineNumber ) )
+  {
+    // Jump to the closest known line before the requested one
+    if ( mLineNumber > nextLineNumber - 1 )
+      mRecordNumber = -1;
+    mMappedPos = offset;
+    mLineNumber = checkpointLine;
+  }
   if ( mLineNumber > nextLineNumber - 1 )
   {
     mRecordNumber = -1;
-    mStream->seek( 0 );
+    if ( mMappedData )
+      mMappedPos = mMappedStart;
+    else
+      mStream->seek( 0 );
     mLineNumber = 0;
   }
   QString buffer;
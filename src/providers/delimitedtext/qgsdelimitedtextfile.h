@@ -22,6 +22,11 @@
 #include <QRegularExpression>
 #include <QUrl>
 #include <QObject>
+#include <QVector>
+#include <QDateTime>
+#include <QMutex>
+
+#include <memory>
 
 class QgsFeature;
 class QgsField;
@@ -29,6 +34,44 @@ class QFile;
 class QFileSystemWatcher;
 class QTextStream;
 
+/**
+ * \class QgsDelimitedTextLineIndex
+ * \brief Byte offsets of lines of a memory mapped delimited text file.
+ *
+ * The index is shared by the QgsDelimitedTextFile objects reading the same file, so that the
+ * offsets recorded while the provider scans the file are used by the feature iterators.
+ * It is only used while the size and modification time of the file are the ones it was built for.
+ * Access is serialized, as iterators may run in other threads.
+ */
+class QgsDelimitedTextLineIndex
+{
+  public:
+
+    /**
+     * Sets the \a size and \a lastModified time of the file the offsets are read from.
+     * The recorded offsets are discarded if the file has changed.
+     */
+    void setFile( qint64 size, const QDateTime &lastModified );
+
+    /**
+     * Records the byte \a offset of the line \a lineNumber, if it is the next line expected
+     * by the index (one line out of \a step).
+     */
+    void addLineOffset( long lineNumber, qint64 offset, long step );
+
+    /**
+     * Returns the last recorded line number not after \a lineNumber, and sets its byte \a offset.
+     * Returns -1 if no line is recorded.
+     */
+    long closestLine( long lineNumber, qint64 &offset, long step ) const;
+
+  private:
+    mutable QMutex mMutex;
+    qint64 mFileSize = -1;
+    QDateTime mLastModified;
+    QVector<qint64> mOffsets;
+};
+
 
 /**
 * \class QgsDelimitedTextFile
@@ -292,6 +335,16 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextRecordId( long nextRecordId );
 
+    /**
+     * Returns the line offset index of the file, to be shared with other readers of the same file.
+     */
+    std::shared_ptr< QgsDelimitedTextLineIndex > lineIndex() const { return mLineIndex; }
+
+    /**
+     * Sets the line offset \a index, shared with other readers of the same file.
+     */
+    void setLineIndex( const std::shared_ptr< QgsDelimitedTextLineIndex > &index );
+
     /**
      * Number record number of records visited. After scanning the file
      *  serves as a record count.
@@ -386,6 +439,17 @@ class QgsDelimitedTextFile : public QObject
      */
     Status nextLine( QString &buffer, bool skipBlank = false );
 
+    /**
+     * Returns the next line from the memory mapped data file.
+     */
+    Status nextMappedLine( QString &buffer, bool skipBlank );
+
+    /**
+     * Maps the opened file in memory if its encoding can be decoded
+     * directly from the file contents.
+     */
+    void mapFile();
+
     /**
      * Set the next line to read from the file.
      */
@@ -404,6 +468,16 @@ class QgsDelimitedTextFile : public QObject
     QString mEncoding;
     QFile *mFile = nullptr;
     QTextStream *mStream = nullptr;
+
+    // Memory mapped file contents, read instead of the text stream when available
+    const char *mMappedData = nullptr;
+    qint64 mMappedSize = 0;
+    qint64 mMappedStart = 0;
+    qint64 mMappedPos = 0;
+    bool mMappedLatin1 = false;
+    // Byte offset of every LINE_OFFSET_STEP line read from the mapped file, shared with the
+    // other readers of the file
+    std::shared_ptr< QgsDelimitedTextLineIndex > mLineIndex;
     bool mUseWatcher = false;
     QFileSystemWatcher *mWatcher = nullptr;
 
@@ -1275,7 +1275,7 @@ PGresult *QgsPostgresConn::PQexec( const QString &query, bool logError, bool ret
   if ( res && PQstatus() == CONNECTION_OK )
   {
     int errorStatus = PQresultStatus( res );
-    if ( errorStatus != PGRES_COMMAND_OK && errorStatus != PGRES_TUPLES_OK )
+    if ( errorStatus != PGRES_COMMAND_OK && errorStatus != PGRES_TUPLES_OK && errorStatus != PGRES_COPY_IN )
     {
       if ( logError )
       {
@@ -1442,6 +1442,16 @@ PGresult *QgsPostgresConn::PQgetResult()
   return ::PQgetResult( mConn );
 }
 
+int QgsPostgresConn::PQputCopyData( const QByteArray &data )
+{
+  return ::PQputCopyData( mConn, data.constData(), data.size() );
+}
+
+int QgsPostgresConn::PQputCopyEnd( const QString &errorMessage )
+{
+  return ::PQputCopyEnd( mConn, errorMessage.isEmpty() ? nullptr : errorMessage.toUtf8().constData() );
+}
+
 PGresult *QgsPostgresConn::PQprepare( const QString &stmtName, const QString &query, int nParams, const Oid *paramTypes )
 {
   QMutexLocker locker( &mLock );
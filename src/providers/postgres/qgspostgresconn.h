@@ -280,6 +280,22 @@ class QgsPostgresConn : public QObject
      */
     PGresult *PQgetResult();
 
+    /**
+     * Sends \a data to the server during a COPY FROM STDIN operation
+     * \returns 1 on success, 0 if the data could not be queued and -1 on error
+     * Thread safety must be ensured by the caller by calling QgsPostgresConn::lock() and QgsPostgresConn::unlock()
+     * \since QGIS 3.22
+     */
+    int PQputCopyData( const QByteArray &data );
+
+    /**
+     * Ends a COPY FROM STDIN operation, the operation fails with \a errorMessage if it is not empty.
+     * The result of the operation must then be fetched with PQgetResult().
+     * Thread safety must be ensured by the caller by calling QgsPostgresConn::lock() and QgsPostgresConn::unlock()
+     * \since QGIS 3.22
+     */
+    int PQputCopyEnd( const QString &errorMessage = QString() );
+
     bool begin();
     bool commit();
     bool rollback();
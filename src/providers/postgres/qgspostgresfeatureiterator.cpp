@@ -25,6 +25,14 @@
 
 #include <QElapsedTimer>
 #include <QObject>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
+
+// bounds of the adaptive number of features fetched at once
+static const int MIN_FEATURE_QUEUE_SIZE = 100;
+static const int MAX_FEATURE_QUEUE_SIZE = 20000;
 
 QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
   : QgsAbstractFeatureIteratorFromSource<QgsPostgresFeatureSource>( source, ownSource, request )
@@ -248,57 +256,29 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
 
   if ( mFeatureQueue.empty() && !mLastFetch )
   {
-#if 0 //disabled dynamic queue size
     QElapsedTimer timer;
     timer.start();
-#endif
-
-    QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
-    QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
 
     lock();
-    if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
-    {
-      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-    }
+    if ( !mFetchPending )
+      sendFetch();
+    receiveFetch();
 
-    QgsPostgresResult queryResult;
-    for ( ;; )
-    {
-      queryResult = mConn->PQgetResult();
-      if ( !queryResult.result() )
-        break;
-
-      if ( queryResult.PQresultStatus() != PGRES_TUPLES_OK )
-      {
-        QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-        break;
-      }
-
-      int rows = queryResult.PQntuples();
-      if ( rows == 0 )
-        continue;
-
-      mLastFetch = rows < mFeatureQueueSize;
-
-      for ( int row = 0; row < rows; row++ )
-      {
-        mFeatureQueue.enqueue( QgsFeature() );
-        getFeature( queryResult, row, mFeatureQueue.back() );
-      } // for each row in queue
-    }
-    unlock();
-
-#if 0 //disabled dynamic queue size
-    if ( timer.elapsed() > 500 && mFeatureQueueSize > 1 )
+    // adapt the batch size to the time spent waiting for the server
+    if ( timer.elapsed() > 500 && mFeatureQueueSize > MIN_FEATURE_QUEUE_SIZE )
     {
       mFeatureQueueSize /= 2;
     }
-    else if ( timer.elapsed() < 50 && mFeatureQueueSize < 10000 )
+    else if ( timer.elapsed() < 50 && mFeatureQueueSize < MAX_FEATURE_QUEUE_SIZE )
     {
       mFeatureQueueSize *= 2;
     }
-#endif
+
+    // prefetch the next batch while the current one is consumed. A transaction
+    // connection is shared with the provider, so it must not be left busy
+    if ( !mLastFetch && !mIsTransactionConnection )
+      sendFetch();
+    unlock();
   }
 
   if ( mFeatureQueue.empty() )
@@ -321,6 +301,70 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
   return true;
 }
 
+void QgsPostgresFeatureIterator::sendFetch()
+{
+  QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
+  QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
+
+  if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+    mFetchPending = false;
+    return;
+  }
+
+  mPendingFetchSize = mFeatureQueueSize;
+  mFetchPending = true;
+}
+
+void QgsPostgresFeatureIterator::receiveFetch()
+{
+  if ( !mFetchPending )
+  {
+    mLastFetch = true;
+    return;
+  }
+  mFetchPending = false;
+  // stop fetching if no result is returned
+  mLastFetch = true;
+
+  QgsPostgresResult queryResult;
+  for ( ;; )
+  {
+    queryResult = mConn->PQgetResult();
+    if ( !queryResult.result() )
+      break;
+
+    if ( queryResult.PQresultStatus() != PGRES_TUPLES_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+      continue;
+    }
+
+    int rows = queryResult.PQntuples();
+    mLastFetch = rows < mPendingFetchSize;
+
+    for ( int row = 0; row < rows; row++ )
+    {
+      mFeatureQueue.enqueue( QgsFeature() );
+      getFeature( queryResult, row, mFeatureQueue.back() );
+    } // for each row in queue
+  }
+}
+
+void QgsPostgresFeatureIterator::discardFetch()
+{
+  if ( !mFetchPending )
+    return;
+
+  lock();
+  while ( PGresult *result = mConn->PQgetResult() )
+    ::PQclear( result );
+  unlock();
+
+  mFetchPending = false;
+}
+
 bool QgsPostgresFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   if ( !mExpressionCompiled )
@@ -379,6 +423,8 @@ bool QgsPostgresFeatureIterator::rewind()
   if ( mClosed )
     return false;
 
+  discardFetch();
+
   // move cursor to first record
 
   mConn->PQexecNR( QStringLiteral( "move absolute 0 in %1" ).arg( mCursorName ) );
@@ -394,6 +440,8 @@ bool QgsPostgresFeatureIterator::close()
   if ( !mConn )
     return false;
 
+  discardFetch();
+
   mConn->closeCursor( mCursorName );
 
   if ( !mIsTransactionConnection )
@@ -697,6 +745,8 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
       return false;
   }
 
+  mBinaryTypes.fill( BinaryType::Text, mSource->mFields.count() );
+
   bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
   const auto constAllAttributesList = subsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList();
   for ( int idx : constAllAttributesList )
@@ -704,7 +754,14 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
     if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
       continue;
 
-    query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+    const QgsField fld = mSource->mFields.at( idx );
+
+    // common types are decoded from the binary cursor instead of being cast to text and parsed
+    const BinaryType type = binaryType( fld, mConn->pgVersion() );
+    if ( idx < mBinaryTypes.size() )
+      mBinaryTypes[idx] = type;
+
+    query += delim + ( type == BinaryType::Text ? mConn->fieldExpression( fld ) : QgsPostgresConn::quotedIdentifier( fld.name() ) );
   }
 
   query += " FROM " + mSource->mQuery;
@@ -904,6 +961,14 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
 
   const QgsField fld = mSource->mFields.at( idx );
 
+  const BinaryType type = mBinaryTypes.value( idx, BinaryType::Text );
+  if ( type != BinaryType::Text )
+  {
+    feature.setAttribute( idx, binaryValue( type, fld.type(), queryResult, row, col ) );
+    col++;
+    return;
+  }
+
   QVariant v;
 
   switch ( fld.type() )
@@ -955,6 +1020,99 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
   col++;
 }
 
+QgsPostgresFeatureIterator::BinaryType QgsPostgresFeatureIterator::binaryType( const QgsField &field, int pgVersion )
+{
+  const QString &typeName = field.typeName();
+  switch ( field.type() )
+  {
+    case QVariant::Int:
+      if ( typeName == QLatin1String( "int4" ) )
+        return BinaryType::Int4;
+      if ( typeName == QLatin1String( "int2" ) )
+        return BinaryType::Int2;
+      break;
+
+    case QVariant::Double:
+      // single precision values keep their shortest text representation
+      if ( typeName == QLatin1String( "float8" ) )
+        return BinaryType::Float8;
+      break;
+
+    case QVariant::Bool:
+      if ( typeName == QLatin1String( "bool" ) )
+        return BinaryType::Bool;
+      break;
+
+    case QVariant::Date:
+      if ( typeName == QLatin1String( "date" ) )
+        return BinaryType::Date;
+      break;
+
+    case QVariant::DateTime:
+      // timestamps are sent as 64 bits integers since PostgreSQL 10, time zone
+      // aware timestamps keep the text representation with its UTC offset
+      if ( typeName == QLatin1String( "timestamp" ) && pgVersion >= 100000 )
+        return BinaryType::Timestamp;
+      break;
+
+    default:
+      break;
+  }
+  return BinaryType::Text;
+}
+
+QVariant QgsPostgresFeatureIterator::binaryValue( BinaryType binaryType, QVariant::Type type, QgsPostgresResult &queryResult, int row, int col )
+{
+  if ( ::PQgetisnull( queryResult.result(), row, col ) )
+    return QVariant( type );
+
+  // values of a binary cursor are in network byte order
+  const char *value = ::PQgetvalue( queryResult.result(), row, col );
+  switch ( binaryType )
+  {
+    case BinaryType::Int2:
+      return static_cast< int >( qFromBigEndian<qint16>( value ) );
+
+    case BinaryType::Int4:
+      return static_cast< int >( qFromBigEndian<qint32>( value ) );
+
+    case BinaryType::Float8:
+    {
+      const quint64 bits = qFromBigEndian<quint64>( value );
+      double v;
+      std::memcpy( &v, &bits, sizeof( v ) );
+      return v;
+    }
+
+    case BinaryType::Bool:
+      return *value != 0;
+
+    case BinaryType::Date:
+    {
+      const qint32 days = qFromBigEndian<qint32>( value );
+      // infinite dates
+      if ( days == std::numeric_limits<qint32>::max() || days == std::numeric_limits<qint32>::min() )
+        return QVariant( type );
+      return QDate( 2000, 1, 1 ).addDays( days );
+    }
+
+    case BinaryType::Timestamp:
+    {
+      const qint64 usecs = qFromBigEndian<qint64>( value );
+      // infinite timestamps
+      if ( usecs == std::numeric_limits<qint64>::max() || usecs == std::numeric_limits<qint64>::min() )
+        return QVariant( type );
+      const qint64 msecs = usecs >= 0 ? usecs / 1000 : -( ( -usecs + 999 ) / 1000 );
+      // timestamps without time zone hold the wall clock time
+      const QDateTime utc = QDateTime( QDate( 2000, 1, 1 ), QTime( 0, 0 ), Qt::UTC ).addMSecs( msecs );
+      return QDateTime( utc.date(), utc.time() );
+    }
+
+    case BinaryType::Text:
+      break;
+  }
+  return QVariant( type );
+}
 
 //  ------------------
 
@@ -88,12 +88,33 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
 
     QgsPostgresConn *mConn = nullptr;
 
+    //! Field values decoded from their binary representation, other fields are fetched as text
+    enum class BinaryType
+    {
+      Text,
+      Int2,
+      Int4,
+      Float8,
+      Bool,
+      Date,
+      Timestamp,
+    };
+
+    static BinaryType binaryType( const QgsField &field, int pgVersion );
+    static QVariant binaryValue( BinaryType binaryType, QVariant::Type type, QgsPostgresResult &queryResult, int row, int col );
 
     QString whereClauseRect();
     bool getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature );
     void getFeatureAttribute( int idx, QgsPostgresResult &queryResult, int row, int &col, QgsFeature &feature );
     bool declareCursor( const QString &whereClause, long limit = -1, bool closeOnFail = true, const QString &orderBy = QString() );
 
+    //! Sends a FETCH of the next mFeatureQueueSize features
+    void sendFetch();
+    //! Reads the result of the pending FETCH into the feature queue
+    void receiveFetch();
+    //! Discards the result of a pending FETCH
+    void discardFetch();
+
     QString mCursorName;
 
     /**
@@ -105,6 +126,15 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
     //! Maximal size of the feature queue
     int mFeatureQueueSize = 2000;
 
+    //! Number of features requested by the pending FETCH
+    int mPendingFetchSize = 0;
+
+    //! Sets to true if a FETCH has been sent and its result has not been read yet
+    bool mFetchPending = false;
+
+    //! Binary representation of each field, indexed by field index
+    QVector<BinaryType> mBinaryTypes;
+
     //! Number of retrieved features
     int mFetched = 0;
 
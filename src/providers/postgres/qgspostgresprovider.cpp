@@ -29,6 +29,10 @@
 
 #include <QMessageBox>
 #include <QRegularExpression>
+#include <QtEndian>
+
+#include <cstring>
+#include <limits>
 
 #include "qgsvectorlayerexporter.h"
 #include "qgspostgresprovider.h"
@@ -2295,6 +2299,410 @@ QString QgsPostgresProvider::geomParam( int offset ) const
   return geometry;
 }
 
+// minimum number of features for which a binary COPY is used to insert features
+static const int COPY_MIN_FEATURES = 100;
+
+// size of the buffers sent to the server during a COPY
+static const int COPY_BUFFER_SIZE = 1024 * 1024;
+
+namespace
+{
+  //! Column types which can be encoded in the binary COPY format
+  enum class CopyType
+  {
+    Bool,
+    Int2,
+    Int4,
+    Int8,
+    Float4,
+    Float8,
+    Text,
+    Bytea,
+    Json,
+    Jsonb,
+    Date,
+    Timestamp,
+    Timestamptz,
+  };
+
+  bool copyTypeFromName( const QString &typeName, int pgVersion, CopyType &type )
+  {
+    static const QHash<QString, CopyType> sTypes
+    {
+      { QStringLiteral( "bool" ), CopyType::Bool },
+      { QStringLiteral( "int2" ), CopyType::Int2 },
+      { QStringLiteral( "int4" ), CopyType::Int4 },
+      { QStringLiteral( "int8" ), CopyType::Int8 },
+      { QStringLiteral( "float4" ), CopyType::Float4 },
+      { QStringLiteral( "float8" ), CopyType::Float8 },
+      { QStringLiteral( "text" ), CopyType::Text },
+      { QStringLiteral( "varchar" ), CopyType::Text },
+      { QStringLiteral( "bpchar" ), CopyType::Text },
+      { QStringLiteral( "bytea" ), CopyType::Bytea },
+      { QStringLiteral( "json" ), CopyType::Json },
+      { QStringLiteral( "jsonb" ), CopyType::Jsonb },
+      { QStringLiteral( "date" ), CopyType::Date },
+      { QStringLiteral( "timestamp" ), CopyType::Timestamp },
+      { QStringLiteral( "timestamptz" ), CopyType::Timestamptz },
+    };
+
+    const auto it = sTypes.constFind( typeName );
+    if ( it == sTypes.constEnd() )
+      return false;
+
+    // timestamps are only encoded as 64 bits integers, which is mandatory since PostgreSQL 10
+    if ( ( *it == CopyType::Timestamp || *it == CopyType::Timestamptz ) && pgVersion < 100000 )
+      return false;
+
+    type = *it;
+    return true;
+  }
+
+  template<typename T>
+  void copyAppend( QByteArray &buffer, T value )
+  {
+    char data[sizeof( T )];
+    qToBigEndian( value, data );
+    buffer.append( data, sizeof( T ) );
+  }
+
+  void copyAppendField( QByteArray &buffer, const QByteArray &data )
+  {
+    copyAppend<qint32>( buffer, data.size() );
+    buffer.append( data );
+  }
+
+  // microseconds between the Unix and the PostgreSQL (2000-01-01) epochs
+  const qint64 POSTGRES_EPOCH_USECS = 946684800000000LL;
+
+  /**
+   * Appends \a value to \a buffer in the binary COPY format of the \a type column.
+   * Returns FALSE if the value cannot be converted.
+   */
+  bool copyAppendValue( QByteArray &buffer, CopyType type, const QVariant &value )
+  {
+    bool ok = true;
+    switch ( type )
+    {
+      case CopyType::Bool:
+      {
+        bool v = value.toBool();
+        if ( value.type() == QVariant::String )
+        {
+          // PostgreSQL boolean literals
+          const QString str = value.toString().trimmed().toLower();
+          if ( str == QLatin1String( "t" ) || str == QLatin1String( "true" ) || str == QLatin1String( "1" ) || str == QLatin1String( "yes" ) || str == QLatin1String( "on" ) )
+            v = true;
+          else if ( str == QLatin1String( "f" ) || str == QLatin1String( "false" ) || str == QLatin1String( "0" ) || str == QLatin1String( "no" ) || str == QLatin1String( "off" ) )
+            v = false;
+          else
+            return false;
+        }
+        copyAppend<qint32>( buffer, 1 );
+        buffer.append( v ? '\1' : '\0' );
+        return true;
+      }
+
+      case CopyType::Int2:
+      {
+        const qlonglong v = value.toLongLong( &ok );
+        if ( !ok || v < std::numeric_limits<qint16>::min() || v > std::numeric_limits<qint16>::max() )
+          return false;
+        copyAppend<qint32>( buffer, 2 );
+        copyAppend<qint16>( buffer, static_cast< qint16 >( v ) );
+        return true;
+      }
+
+      case CopyType::Int4:
+      {
+        const qlonglong v = value.toLongLong( &ok );
+        if ( !ok || v < std::numeric_limits<qint32>::min() || v > std::numeric_limits<qint32>::max() )
+          return false;
+        copyAppend<qint32>( buffer, 4 );
+        copyAppend<qint32>( buffer, static_cast< qint32 >( v ) );
+        return true;
+      }
+
+      case CopyType::Int8:
+      {
+        const qlonglong v = value.toLongLong( &ok );
+        if ( !ok )
+          return false;
+        copyAppend<qint32>( buffer, 8 );
+        copyAppend<qint64>( buffer, v );
+        return true;
+      }
+
+      case CopyType::Float4:
+      {
+        const float v = value.toFloat( &ok );
+        if ( !ok )
+          return false;
+        quint32 bits;
+        std::memcpy( &bits, &v, sizeof( bits ) );
+        copyAppend<qint32>( buffer, 4 );
+        copyAppend<quint32>( buffer, bits );
+        return true;
+      }
+
+      case CopyType::Float8:
+      {
+        const double v = value.toDouble( &ok );
+        if ( !ok )
+          return false;
+        quint64 bits;
+        std::memcpy( &bits, &v, sizeof( bits ) );
+        copyAppend<qint32>( buffer, 8 );
+        copyAppend<quint64>( buffer, bits );
+        return true;
+      }
+
+      case CopyType::Text:
+        copyAppendField( buffer, value.toString().toUtf8() );
+        return true;
+
+      case CopyType::Bytea:
+        copyAppendField( buffer, value.toByteArray() );
+        return true;
+
+      case CopyType::Json:
+      case CopyType::Jsonb:
+      {
+        // strings are expected to hold the json document, like with the INSERT parameters
+        const QByteArray json = value.type() == QVariant::String
+                                ? value.toString().toUtf8()
+                                : QByteArray::fromStdString( QgsJsonUtils::jsonFromVariant( value ).dump() );
+        if ( type == CopyType::Jsonb )
+        {
+          // jsonb binary format version
+          copyAppend<qint32>( buffer, json.size() + 1 );
+          buffer.append( '\1' );
+          buffer.append( json );
+        }
+        else
+        {
+          copyAppendField( buffer, json );
+        }
+        return true;
+      }
+
+      case CopyType::Date:
+      {
+        const QDate date = value.toDate();
+        if ( !date.isValid() )
+          return false;
+        copyAppend<qint32>( buffer, 4 );
+        copyAppend<qint32>( buffer, static_cast< qint32 >( QDate( 2000, 1, 1 ).daysTo( date ) ) );
+        return true;
+      }
+
+      case CopyType::Timestamp:
+      case CopyType::Timestamptz:
+      {
+        QDateTime dateTime = value.toDateTime();
+        if ( !dateTime.isValid() )
+          return false;
+        // timestamps without time zone store the wall clock time
+        if ( type == CopyType::Timestamp )
+          dateTime = QDateTime( dateTime.date(), dateTime.time(), Qt::UTC );
+        copyAppend<qint32>( buffer, 8 );
+        copyAppend<qint64>( buffer, dateTime.toMSecsSinceEpoch() * 1000 - POSTGRES_EPOCH_USECS );
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Converts the WKB \a wkb to EWKB embedding the \a srid.
+   */
+  QByteArray wkbToEwkb( const QByteArray &wkb, int srid )
+  {
+    if ( wkb.size() < 5 || srid <= 0 )
+      return wkb;
+
+    const bool littleEndian = wkb.at( 0 ) == 1;
+    quint32 wkbType = littleEndian ? qFromLittleEndian<quint32>( wkb.constData() + 1 ) : qFromBigEndian<quint32>( wkb.constData() + 1 );
+    // SRID flag
+    wkbType |= 0x20000000;
+
+    QByteArray ewkb;
+    ewkb.reserve( wkb.size() + 4 );
+    ewkb.append( wkb.at( 0 ) );
+    char data[4];
+    if ( littleEndian )
+      qToLittleEndian<quint32>( wkbType, data );
+    else
+      qToBigEndian<quint32>( wkbType, data );
+    ewkb.append( data, 4 );
+    if ( littleEndian )
+      qToLittleEndian<qint32>( srid, data );
+    else
+      qToBigEndian<qint32>( srid, data );
+    ewkb.append( data, 4 );
+    ewkb.append( wkb.constData() + 5, wkb.size() - 5 );
+    return ewkb;
+  }
+}
+
+bool QgsPostgresProvider::copyFeatures( QgsPostgresConn *conn, const QgsFeatureList &features )
+{
+  // COPY FROM is rejected by views, even with INSTEAD OF triggers or rules
+  switch ( relkind() )
+  {
+    case Relkind::OrdinaryTable:
+    case Relkind::PartitionedTable:
+      break;
+
+    case Relkind::NotSet:
+    case Relkind::Unknown:
+    case Relkind::Index:
+    case Relkind::Sequence:
+    case Relkind::View:
+    case Relkind::MaterializedView:
+    case Relkind::CompositeType:
+    case Relkind::ToastTable:
+    case Relkind::ForeignTable:
+      return false;
+  }
+
+  // topogeometries and geographies need server side conversions
+  if ( !mGeometryColumn.isNull() && mSpatialColType != SctGeometry )
+    return false;
+
+  struct CopyColumn
+  {
+    int index;
+    CopyType type;
+  };
+  QList<CopyColumn> columns;
+  QStringList columnNames;
+
+  for ( int idx = 0; idx < mAttributeFields.count(); ++idx )
+  {
+    const QgsField fld = mAttributeFields.at( idx );
+    if ( !mGeneratedValues.value( idx, QString() ).isEmpty() || fld.name().isEmpty() || fld.name() == mGeometryColumn )
+      continue;
+
+    // COPY cannot evaluate default values per row: columns left to their
+    // default value are omitted, and mixed columns need INSERT statements
+    const QString defVal = defaultValueClause( idx );
+    int defaulted = 0;
+    for ( const QgsFeature &feature : features )
+    {
+      const QVariant v = feature.attributes().value( idx, QVariant( QVariant::Int ) );
+      if ( v.isNull() || ( !defVal.isEmpty() && v.toString() == defVal ) )
+        defaulted++;
+    }
+
+    if ( defaulted == features.size() )
+      continue;
+
+    if ( defaulted > 0 && !defVal.isEmpty() )
+      return false;
+
+    // COPY does not support OVERRIDING SYSTEM VALUE
+    if ( mIdentityFields.value( idx ) == 'a' )
+      return false;
+
+    CopyType type;
+    if ( !copyTypeFromName( fld.typeName(), conn->pgVersion(), type ) )
+      return false;
+
+    columns << CopyColumn { idx, type };
+    columnNames << quotedIdentifier( fld.name() );
+  }
+
+  const bool hasGeometry = !mGeometryColumn.isNull();
+  if ( hasGeometry )
+    columnNames.prepend( quotedIdentifier( mGeometryColumn ) );
+
+  if ( columnNames.isEmpty() )
+    return false;
+
+  const bool forceMulti = QgsWkbTypes::isMultiType( wkbType() );
+  const int srid = ( mRequestedSrid.isEmpty() ? mDetectedSrid : mRequestedSrid ).toInt();
+
+  // encode everything before starting the COPY, so that unsupported values
+  // can still fall back to INSERT statements
+  QList<QByteArray> buffers;
+  QByteArray buffer;
+  buffer.reserve( COPY_BUFFER_SIZE );
+  buffer.append( "PGCOPY\n\377\r\n\0", 11 );
+  copyAppend<qint32>( buffer, 0 ); // flags
+  copyAppend<qint32>( buffer, 0 ); // header extension length
+
+  for ( const QgsFeature &feature : features )
+  {
+    copyAppend<qint16>( buffer, static_cast< qint16 >( columnNames.size() ) );
+
+    if ( hasGeometry )
+    {
+      const QgsGeometry geom = feature.geometry();
+      if ( geom.isNull() )
+      {
+        copyAppend<qint32>( buffer, -1 );
+      }
+      else
+      {
+        QgsGeometry convertedGeom( convertToProviderType( geom ) );
+        if ( convertedGeom.isNull() )
+          convertedGeom = geom;
+        if ( forceMulti && !convertedGeom.isMultipart() )
+          convertedGeom.convertToMultiType();
+        copyAppendField( buffer, wkbToEwkb( convertedGeom.asWkb(), srid ) );
+      }
+    }
+
+    const QgsAttributes attrs = feature.attributes();
+    for ( const CopyColumn &column : std::as_const( columns ) )
+    {
+      const QVariant value = attrs.value( column.index, QVariant( QVariant::Int ) );
+      if ( value.isNull() )
+        copyAppend<qint32>( buffer, -1 );
+      else if ( !copyAppendValue( buffer, column.type, value ) )
+        return false;
+    }
+
+    if ( buffer.size() >= COPY_BUFFER_SIZE )
+    {
+      buffers << buffer;
+      buffer.clear();
+      buffer.reserve( COPY_BUFFER_SIZE );
+    }
+  }
+
+  // trailer
+  copyAppend<qint16>( buffer, -1 );
+  buffers << buffer;
+
+  const QString copy = QStringLiteral( "COPY %1(%2) FROM STDIN (FORMAT binary)" ).arg( mQuery, columnNames.join( ',' ) );
+  QgsDebugMsgLevel( QStringLiteral( "copy addfeatures: %1" ).arg( copy ), 2 );
+
+  QgsPostgresResult result( conn->PQexec( copy ) );
+  if ( result.PQresultStatus() != PGRES_COPY_IN )
+    throw PGException( result );
+
+  for ( const QByteArray &data : std::as_const( buffers ) )
+  {
+    if ( conn->PQputCopyData( data ) != 1 )
+      break;
+  }
+  conn->PQputCopyEnd();
+
+  // the COPY status, errors included, is reported by the last result
+  bool success = false;
+  while ( PGresult *res = conn->PQgetResult() )
+  {
+    result = res;
+    success = result.PQresultStatus() == PGRES_COMMAND_OK;
+  }
+  if ( !success )
+    throw PGException( result );
+
+  return true;
+}
+
 bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
 {
   if ( flist.isEmpty() )
@@ -2316,6 +2724,18 @@ bool QgsPostgresProvider::addFeatures( QgsFeatureList &flist, Flags flags )
   {
     conn->begin();
 
+    // Bulk insertion with a binary COPY when the generated keys don't have to be returned
+    if ( ( flags & QgsFeatureSink::FastInsert ) && flist.size() >= COPY_MIN_FEATURES && copyFeatures( conn, flist ) )
+    {
+      returnvalue &= conn->commit();
+      if ( mTransaction )
+        mTransaction->dirtyLastSavePoint();
+
+      mShared->addFeaturesCounted( flist.size() );
+      conn->unlock();
+      return returnvalue;
+    }
+
     // Prepare the INSERT statement
     QString insert = QStringLiteral( "INSERT INTO %1(" ).arg( mQuery );
     QString values;
@@ -464,6 +464,16 @@ class QgsPostgresProvider final: public QgsVectorDataProvider
     QgsVectorDataProvider::Capabilities mEnabledCapabilities = QgsVectorDataProvider::Capabilities();
 
     void appendGeomParam( const QgsGeometry &geom, QStringList &param ) const;
+
+    /**
+     * Inserts \a features with a binary COPY, which is much faster than
+     * executing an INSERT statement per feature. Returns FALSE, before
+     * anything is sent, if a column or a value cannot be encoded in the
+     * binary format, or if the relation is not a table (COPY is rejected by views):
+     * the features must then be inserted with INSERT statements.
+     * Throws a PGException if the server rejects the data.
+     */
+    bool copyFeatures( QgsPostgresConn *conn, const QgsFeatureList &features );
     void appendPkParams( QgsFeatureId fid, QStringList &param ) const;
 
     QString paramValue( const QString &fieldvalue, const QString &defaultValue ) const;
@@ -0,0 +1,252 @@
+/***************************************************************************
+                              qgis_wmts_seed.cpp
+
+A command line tool to seed the built-in WMTS tile cache of QGIS Server.
+
+Tiles are requested through the WMTS service of an embedded QgsServer, so
+that they are rendered by metatiles and stored exactly as they would be
+by the running server. The cache directory and the metatile size are read
+from the QGIS_SERVER_WMTS_CACHE_DIRECTORY and QGIS_SERVER_WMTS_METATILE_SIZE
+environment variables, or from the command line options.
+
+                              -------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+
+//for CMAKE_INSTALL_PREFIX
+#include "qgsconfig.h"
+#include "qgsserver.h"
+#include "qgsserversettings.h"
+#include "qgsbufferserverrequest.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsapplication.h"
+#include "qgsproject.h"
+#include "qgsserverprojectutils.h"
+
+#include <QCommandLineParser>
+#include <QDomDocument>
+#include <QString>
+#include <QUrlQuery>
+
+///@cond PRIVATE
+
+struct TileMatrixLimits
+{
+  int tileMatrix = 0;
+  int minCol = 0;
+  int maxCol = -1;
+  int minRow = 0;
+  int maxRow = -1;
+};
+
+static QByteArray executeRequest( QgsServer &server, const QgsProject *project, const QUrlQuery &query, int &statusCode )
+{
+  QgsBufferServerRequest request( QStringLiteral( "http://localhost/?" ) + query.toString( QUrl::FullyEncoded ) );
+  QgsBufferServerResponse response;
+  server.handleRequest( request, response, project );
+  statusCode = response.statusCode();
+  return response.body();
+}
+
+//! Returns the number of tiles of a metatile along an axis, reduced as by the server to fit in the WMS size limits
+static int metatileStep( int metatileSize, int projectMaxSize, int settingsMaxSize )
+{
+  const int maxSize = projectMaxSize != -1 && settingsMaxSize != -1 ? std::min( projectMaxSize, settingsMaxSize ) : std::max( projectMaxSize, settingsMaxSize );
+  const int size = std::max( 1, metatileSize );
+  return maxSize > 0 ? std::max( 1, std::min( size, maxSize / 256 ) ) : size;
+}
+
+static QList<TileMatrixLimits> tileMatrixLimits( const QDomDocument &capabilities, const QString &layer, const QString &tileMatrixSet )
+{
+  QList<TileMatrixLimits> limits;
+
+  const QDomNodeList layerNodes = capabilities.elementsByTagName( QStringLiteral( "Layer" ) );
+  for ( int i = 0; i < layerNodes.count(); ++i )
+  {
+    const QDomElement layerElem = layerNodes.at( i ).toElement();
+    if ( layerElem.firstChildElement( QStringLiteral( "ows:Identifier" ) ).text() != layer )
+      continue;
+
+    for ( QDomElement linkElem = layerElem.firstChildElement( QStringLiteral( "TileMatrixSetLink" ) );
+          !linkElem.isNull();
+          linkElem = linkElem.nextSiblingElement( QStringLiteral( "TileMatrixSetLink" ) ) )
+    {
+      if ( linkElem.firstChildElement( QStringLiteral( "TileMatrixSet" ) ).text() != tileMatrixSet )
+        continue;
+
+      const QDomElement setLimitsElem = linkElem.firstChildElement( QStringLiteral( "TileMatrixSetLimits" ) );
+      for ( QDomElement limitsElem = setLimitsElem.firstChildElement( QStringLiteral( "TileMatrixLimits" ) );
+            !limitsElem.isNull();
+            limitsElem = limitsElem.nextSiblingElement( QStringLiteral( "TileMatrixLimits" ) ) )
+      {
+        TileMatrixLimits l;
+        l.tileMatrix = limitsElem.firstChildElement( QStringLiteral( "TileMatrix" ) ).text().toInt();
+        l.minCol = limitsElem.firstChildElement( QStringLiteral( "MinTileCol" ) ).text().toInt();
+        l.maxCol = limitsElem.firstChildElement( QStringLiteral( "MaxTileCol" ) ).text().toInt();
+        l.minRow = limitsElem.firstChildElement( QStringLiteral( "MinTileRow" ) ).text().toInt();
+        l.maxRow = limitsElem.firstChildElement( QStringLiteral( "MaxTileRow" ) ).text().toInt();
+        limits << l;
+      }
+      return limits;
+    }
+  }
+
+  return limits;
+}
+
+int main( int argc, char *argv[] )
+{
+  // The seeder never needs a display
+  if ( qgetenv( "DISPLAY" ).isEmpty() )
+  {
+    qputenv( "QT_QPA_PLATFORM", "offscreen" );
+  }
+
+  QgsApplication app( argc, argv, false, QString(), QStringLiteral( "QGIS WMTS Seeder" ) );
+
+  QCoreApplication::setOrganizationName( QgsApplication::QGIS_ORGANIZATION_NAME );
+  QCoreApplication::setOrganizationDomain( QgsApplication::QGIS_ORGANIZATION_DOMAIN );
+  QCoreApplication::setApplicationName( "QGIS WMTS Seeder" );
+  QCoreApplication::setApplicationVersion( VERSION );
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription( QObject::tr( "QGIS Server WMTS tile cache seeder %1" ).arg( VERSION ) );
+  parser.addHelpOption();
+  parser.addVersionOption();
+
+  QCommandLineOption projectOption( "p", QObject::tr( "Path to a QGIS project file (*.qgs or *.qgz)." ), "projectPath" );
+  parser.addOption( projectOption );
+  QCommandLineOption layerOption( "layer", QObject::tr( "WMTS layer identifier to seed." ), "layer" );
+  parser.addOption( layerOption );
+  QCommandLineOption styleOption( "style", QObject::tr( "WMTS style to seed (default: default)." ), "style", QStringLiteral( "default" ) );
+  parser.addOption( styleOption );
+  QCommandLineOption tileMatrixSetOption( "tilematrixset", QObject::tr( "Tile matrix set to seed (default: EPSG:3857)." ), "tileMatrixSet", QStringLiteral( "EPSG:3857" ) );
+  parser.addOption( tileMatrixSetOption );
+  QCommandLineOption formatOption( "format", QObject::tr( "Tile format (default: image/png)." ), "format", QStringLiteral( "image/png" ) );
+  parser.addOption( formatOption );
+  QCommandLineOption minZoomOption( "min-zoom", QObject::tr( "First tile matrix to seed (default: 0)." ), "tileMatrix", QStringLiteral( "0" ) );
+  parser.addOption( minZoomOption );
+  QCommandLineOption maxZoomOption( "max-zoom", QObject::tr( "Last tile matrix to seed (default: last tile matrix of the set)." ), "tileMatrix", QStringLiteral( "-1" ) );
+  parser.addOption( maxZoomOption );
+  QCommandLineOption cacheDirectoryOption( "c", QObject::tr( "Cache directory, overrides QGIS_SERVER_WMTS_CACHE_DIRECTORY." ), "cacheDirectory" );
+  parser.addOption( cacheDirectoryOption );
+  QCommandLineOption metatileSizeOption( "m", QObject::tr( "Metatile size, overrides QGIS_SERVER_WMTS_METATILE_SIZE." ), "metatileSize" );
+  parser.addOption( metatileSizeOption );
+
+  parser.process( app );
+
+  if ( parser.value( projectOption ).isEmpty() || parser.value( layerOption ).isEmpty() )
+  {
+    std::cerr << QObject::tr( "A project (-p) and a layer (--layer) are required." ).toStdString() << std::endl;
+    parser.showHelp( 1 );
+  }
+
+  if ( parser.isSet( cacheDirectoryOption ) )
+  {
+    qputenv( "QGIS_SERVER_WMTS_CACHE_DIRECTORY", parser.value( cacheDirectoryOption ).toUtf8() );
+  }
+  if ( parser.isSet( metatileSizeOption ) )
+  {
+    qputenv( "QGIS_SERVER_WMTS_METATILE_SIZE", parser.value( metatileSizeOption ).toUtf8() );
+  }
+  qputenv( "QGIS_SERVER_LOG_STDERR", "1" );
+
+  QgsServer server;
+
+  const QgsServerSettings settings;
+  if ( settings.wmtsCacheDirectory().isEmpty() )
+  {
+    std::cerr << QObject::tr( "The WMTS cache directory is not set, use -c or QGIS_SERVER_WMTS_CACHE_DIRECTORY." ).toStdString() << std::endl;
+    return 1;
+  }
+
+  QgsProject project;
+  if ( !project.read( parser.value( projectOption ), QgsProject::ReadFlag::FlagDontLoadLayouts ) )
+  {
+    std::cerr << QObject::tr( "Unable to read project %1." ).arg( parser.value( projectOption ) ).toStdString() << std::endl;
+    return 1;
+  }
+
+  const int rowStep = metatileStep( settings.wmtsMetatileSize(), QgsServerProjectUtils::wmsMaxHeight( project ), settings.wmsMaxHeight() );
+  const int colStep = metatileStep( settings.wmtsMetatileSize(), QgsServerProjectUtils::wmsMaxWidth( project ), settings.wmsMaxWidth() );
+
+  const QString layer = parser.value( layerOption );
+  const QString tileMatrixSet = parser.value( tileMatrixSetOption );
+
+  QUrlQuery capabilitiesQuery;
+  capabilitiesQuery.addQueryItem( QStringLiteral( "SERVICE" ), QStringLiteral( "WMTS" ) );
+  capabilitiesQuery.addQueryItem( QStringLiteral( "VERSION" ), QStringLiteral( "1.0.0" ) );
+  capabilitiesQuery.addQueryItem( QStringLiteral( "REQUEST" ), QStringLiteral( "GetCapabilities" ) );
+
+  int statusCode = 0;
+  QDomDocument capabilities;
+  if ( !capabilities.setContent( executeRequest( server, &project, capabilitiesQuery, statusCode ) ) || statusCode != 200 )
+  {
+    std::cerr << QObject::tr( "Unable to get the WMTS capabilities of the project." ).toStdString() << std::endl;
+    return 1;
+  }
+
+  const QList<TileMatrixLimits> limits = tileMatrixLimits( capabilities, layer, tileMatrixSet );
+  if ( limits.isEmpty() )
+  {
+    std::cerr << QObject::tr( "Layer %1 is not available for tile matrix set %2." ).arg( layer, tileMatrixSet ).toStdString() << std::endl;
+    return 1;
+  }
+
+  const int minZoom = parser.value( minZoomOption ).toInt();
+  const int maxZoom = parser.value( maxZoomOption ).toInt();
+
+  int errors = 0;
+  for ( const TileMatrixLimits &l : limits )
+  {
+    if ( l.tileMatrix < minZoom || ( maxZoom >= 0 && l.tileMatrix > maxZoom ) )
+      continue;
+
+    std::cout << QObject::tr( "Seeding tile matrix %1: rows %2-%3, columns %4-%5" )
+              .arg( l.tileMatrix ).arg( l.minRow ).arg( l.maxRow ).arg( l.minCol ).arg( l.maxCol ).toStdString() << std::endl;
+
+    // One request per metatile: the server renders and stores all of its tiles
+    for ( int row = ( l.minRow / rowStep ) * rowStep; row <= l.maxRow; row += rowStep )
+    {
+      for ( int col = ( l.minCol / colStep ) * colStep; col <= l.maxCol; col += colStep )
+      {
+        QUrlQuery tileQuery;
+        tileQuery.addQueryItem( QStringLiteral( "SERVICE" ), QStringLiteral( "WMTS" ) );
+        tileQuery.addQueryItem( QStringLiteral( "VERSION" ), QStringLiteral( "1.0.0" ) );
+        tileQuery.addQueryItem( QStringLiteral( "REQUEST" ), QStringLiteral( "GetTile" ) );
+        tileQuery.addQueryItem( QStringLiteral( "LAYER" ), layer );
+        tileQuery.addQueryItem( QStringLiteral( "STYLE" ), parser.value( styleOption ) );
+        tileQuery.addQueryItem( QStringLiteral( "TILEMATRIXSET" ), tileMatrixSet );
+        tileQuery.addQueryItem( QStringLiteral( "TILEMATRIX" ), QString::number( l.tileMatrix ) );
+        tileQuery.addQueryItem( QStringLiteral( "TILEROW" ), QString::number( std::max( row, l.minRow ) ) );
+        tileQuery.addQueryItem( QStringLiteral( "TILECOL" ), QString::number( std::max( col, l.minCol ) ) );
+        tileQuery.addQueryItem( QStringLiteral( "FORMAT" ), parser.value( formatOption ) );
+
+        executeRequest( server, &project, tileQuery, statusCode );
+        if ( statusCode != 200 )
+        {
+          std::cerr << QObject::tr( "Failed to seed metatile %1/%2/%3 (HTTP %4)." )
+                    .arg( l.tileMatrix ).arg( row ).arg( col ).arg( statusCode ).toStdString() << std::endl;
+          ++errors;
+        }
+      }
+    }
+  }
+
+  return errors > 0 ? 1 : 0;
+}
+
+///@endcond
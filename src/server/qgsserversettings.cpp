@@ -22,6 +22,8 @@
 #include <QSettings>
 #include <QDir>
 
+#include <algorithm>
+
 QgsServerSettings::QgsServerSettings()
 {
   load();
@@ -333,6 +335,61 @@ void QgsServerSettings::initSettings()
                                     QVariant()
                                   };
   mSettings[ sServiceUrl.envVar ] = sWmtsServiceUrl;
+
+  // the built-in WMTS tile cache directory
+  const Setting sWmtsCacheDirectory = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_DIRECTORY,
+                                        QgsServerSettingsEnv::DEFAULT_VALUE,
+                                        QStringLiteral( "Directory of the built-in WMTS tile cache, the cache is disabled when empty" ),
+                                        QStringLiteral( "/qgis/server_wmts_cache_directory" ),
+                                        QVariant::String,
+                                        QVariant( "" ),
+                                        QVariant()
+                                      };
+  mSettings[ sWmtsCacheDirectory.envVar ] = sWmtsCacheDirectory;
+
+  // the built-in WMTS tile cache metatile size
+  const Setting sWmtsMetatileSize = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE,
+                                      QgsServerSettingsEnv::DEFAULT_VALUE,
+                                      QStringLiteral( "Number of tiles per side of the metatiles rendered by the built-in WMTS tile cache" ),
+                                      QStringLiteral( "/qgis/server_wmts_metatile_size" ),
+                                      QVariant::Int,
+                                      QVariant( 4 ),
+                                      QVariant()
+                                    };
+  mSettings[ sWmtsMetatileSize.envVar ] = sWmtsMetatileSize;
+
+  // the zlib compression level of WMS PNG images
+  const Setting sWmsPngCompressionLevel = { QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL,
+                                            QgsServerSettingsEnv::DEFAULT_VALUE,
+                                            QStringLiteral( "Zlib compression level of PNG images returned by WMS" ),
+                                            QStringLiteral( "/qgis/server_wms_png_compression_level" ),
+                                            QVariant::Int,
+                                            QVariant( -1 ),
+                                            QVariant()
+                                          };
+  mSettings[ sWmsPngCompressionLevel.envVar ] = sWmsPngCompressionLevel;
+
+  // the row filter of WMS PNG images
+  const Setting sWmsPngFilter = { QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_FILTER,
+                                  QgsServerSettingsEnv::DEFAULT_VALUE,
+                                  QStringLiteral( "Row filter of PNG images returned by WMS" ),
+                                  QStringLiteral( "/qgis/server_wms_png_filter" ),
+                                  QVariant::String,
+                                  QVariant( "" ),
+                                  QVariant()
+                                };
+  mSettings[ sWmsPngFilter.envVar ] = sWmsPngFilter;
+
+  // dithering of WMS 8 bits PNG images
+  const Setting sWmsPng8Dithering = { QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG8_DITHERING,
+                                      QgsServerSettingsEnv::DEFAULT_VALUE,
+                                      QStringLiteral( "Enables dithering of 8 bits PNG images returned by WMS" ),
+                                      QStringLiteral( "/qgis/server_wms_png8_dithering" ),
+                                      QVariant::Bool,
+                                      QVariant( false ),
+                                      QVariant()
+                                    };
+  mSettings[ sWmsPng8Dithering.envVar ] = sWmsPng8Dithering;
 }
 
 void QgsServerSettings::load()
@@ -615,3 +672,28 @@ QString QgsServerSettings::serviceUrl( const QString &service ) const
 
   return result;
 }
+
+QString QgsServerSettings::wmtsCacheDirectory() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_DIRECTORY ).toString();
+}
+
+int QgsServerSettings::wmtsMetatileSize() const
+{
+  return std::max( 1, value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE ).toInt() );
+}
+
+int QgsServerSettings::wmsPngCompressionLevel() const
+{
+  return std::clamp( value( QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL ).toInt(), -1, 9 );
+}
+
+QString QgsServerSettings::wmsPngFilter() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG_FILTER ).toString();
+}
+
+bool QgsServerSettings::wmsPng8Dithering() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMS_PNG8_DITHERING ).toBool();
+}
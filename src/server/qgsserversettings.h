@@ -77,6 +77,11 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_SERVER_WCS_SERVICE_URL, //!< To set the WCS service URL if it's not present in the project. (since QGIS 3.20).
       QGIS_SERVER_WMTS_SERVICE_URL, //!< To set the WMTS service URL if it's not present in the project. (since QGIS 3.20).
       QGIS_SERVER_LANDING_PAGE_PREFIX, //! Prefix of the path component of the landing page base URL, default is empty (since QGIS 3.20).
+      QGIS_SERVER_WMTS_CACHE_DIRECTORY, //!< Directory of the built-in WMTS tile cache, the cache is disabled when empty (since QGIS 3.22).
+      QGIS_SERVER_WMTS_METATILE_SIZE, //!< Number of tiles per side of the metatiles rendered by the built-in WMTS tile cache, defaults to 4 (since QGIS 3.22).
+      QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL, //!< Zlib compression level (0 to 9, -1 for the zlib default) of PNG images returned by WMS (since QGIS 3.22).
+      QGIS_SERVER_WMS_PNG_FILTER, //!< Row filter (none, sub, up, average, paeth or adaptive) of PNG images returned by WMS (since QGIS 3.22).
+      QGIS_SERVER_WMS_PNG8_DITHERING, //!< Enables dithering of 8 bits PNG images returned by WMS (since QGIS 3.22).
     };
     Q_ENUM( EnvVar )
 };
@@ -294,6 +299,61 @@ class SERVER_EXPORT QgsServerSettings
      */
     QString serviceUrl( const QString &service ) const;
 
+    /**
+     * Returns the directory of the built-in WMTS tile cache.
+     *
+     * The built-in tile cache is disabled when the directory is empty, which
+     * is the default value. This value can be changed by setting the environment
+     * variable QGIS_SERVER_WMTS_CACHE_DIRECTORY.
+     *
+     * \since QGIS 3.22
+     */
+    QString wmtsCacheDirectory() const;
+
+    /**
+     * Returns the number of tiles per side of the metatiles rendered by the
+     * built-in WMTS tile cache.
+     *
+     * A metatile is rendered with a single WMS GetMap request and then sliced
+     * into tiles, so that labels are placed consistently across tile edges.
+     * The default value is 4, a value of 1 disables metatiling. This value can
+     * be changed by setting the environment variable QGIS_SERVER_WMTS_METATILE_SIZE.
+     *
+     * \since QGIS 3.22
+     */
+    int wmtsMetatileSize() const;
+
+    /**
+     * Returns the zlib compression level of PNG images returned by WMS,
+     * from 0 (no compression) to 9 (best compression). The default value
+     * is -1, meaning that the zlib default level is used. This value can be
+     * changed by setting the environment variable QGIS_SERVER_WMS_PNG_COMPRESSION_LEVEL.
+     *
+     * \since QGIS 3.22
+     */
+    int wmsPngCompressionLevel() const;
+
+    /**
+     * Returns the row filter of PNG images returned by WMS. Supported values
+     * are none, sub, up, average, paeth and adaptive. By default, no filter
+     * is used for 8 bits images and the adaptive filter for other images.
+     * This value can be changed by setting the environment variable
+     * QGIS_SERVER_WMS_PNG_FILTER.
+     *
+     * \since QGIS 3.22
+     */
+    QString wmsPngFilter() const;
+
+    /**
+     * Returns TRUE if a Floyd-Steinberg dithering is applied when reducing
+     * the colors of 8 bits PNG images returned by WMS. The default value is
+     * FALSE. This value can be changed by setting the environment variable
+     * QGIS_SERVER_WMS_PNG8_DITHERING.
+     *
+     * \since QGIS 3.22
+     */
+    bool wmsPng8Dithering() const;
+
     /**
      * Returns the string representation of a setting.
      * \since QGIS 3.16
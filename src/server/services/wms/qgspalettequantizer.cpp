@@ -0,0 +1,407 @@
+/***************************************************************************
+                              qgspalettequantizer.cpp
+                              -------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspalettequantizer.h"
+
+#include <QHash>
+#include <QVector>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace QgsWms
+{
+  namespace
+  {
+    // 4 bits for alpha and 5 bits for each color channel
+    constexpr int HISTOGRAM_SIZE = 1 << 19;
+
+    inline int histogramKey( int a, int r, int g, int b )
+    {
+      // all the almost transparent pixels share the same bin whatever their color
+      if ( a < 16 )
+        return 0;
+      return ( ( a >> 4 ) << 15 ) | ( ( r >> 3 ) << 10 ) | ( ( g >> 3 ) << 5 ) | ( b >> 3 );
+    }
+
+    inline int histogramKey( QRgb c )
+    {
+      return histogramKey( qAlpha( c ), qRed( c ), qGreen( c ), qBlue( c ) );
+    }
+
+    struct HistogramBin
+    {
+      // alpha, red, green, blue
+      int channels[4];
+      quint32 count;
+    };
+
+    struct ColorBox
+    {
+      int begin = 0;
+      int end = 0;
+      quint64 count = 0;
+      int channel = 0;
+      int range = 0;
+    };
+
+    HistogramBin histogramBin( int key, quint32 count )
+    {
+      // expand the reduced channels back to the full [0, 255] range
+      const int a = ( key >> 15 ) & 0x0f;
+      const int r = ( key >> 10 ) & 0x1f;
+      const int g = ( key >> 5 ) & 0x1f;
+      const int b = key & 0x1f;
+
+      HistogramBin bin;
+      bin.channels[0] = a * 17;
+      bin.channels[1] = ( r << 3 ) | ( r >> 2 );
+      bin.channels[2] = ( g << 3 ) | ( g >> 2 );
+      bin.channels[3] = ( b << 3 ) | ( b >> 2 );
+      bin.count = count;
+      return bin;
+    }
+
+    void updateBox( const std::vector<HistogramBin> &bins, ColorBox &box )
+    {
+      int minValues[4] = { 255, 255, 255, 255 };
+      int maxValues[4] = { 0, 0, 0, 0 };
+      box.count = 0;
+      for ( int i = box.begin; i < box.end; ++i )
+      {
+        const HistogramBin &bin = bins[i];
+        for ( int c = 0; c < 4; ++c )
+        {
+          minValues[c] = std::min( minValues[c], bin.channels[c] );
+          maxValues[c] = std::max( maxValues[c], bin.channels[c] );
+        }
+        box.count += bin.count;
+      }
+
+      box.range = -1;
+      for ( int c = 0; c < 4; ++c )
+      {
+        if ( maxValues[c] - minValues[c] > box.range )
+        {
+          box.range = maxValues[c] - minValues[c];
+          box.channel = c;
+        }
+      }
+    }
+
+    QRgb boxColor( const std::vector<HistogramBin> &bins, const ColorBox &box )
+    {
+      quint64 sums[4] = { 0, 0, 0, 0 };
+      for ( int i = box.begin; i < box.end; ++i )
+      {
+        for ( int c = 0; c < 4; ++c )
+          sums[c] += static_cast< quint64 >( bins[i].channels[c] ) * bins[i].count;
+      }
+
+      const quint64 half = box.count / 2;
+      return qRgba( static_cast< int >( ( sums[1] + half ) / box.count ),
+                    static_cast< int >( ( sums[2] + half ) / box.count ),
+                    static_cast< int >( ( sums[3] + half ) / box.count ),
+                    static_cast< int >( ( sums[0] + half ) / box.count ) );
+    }
+
+    QVector<QRgb> histogramPalette( const std::vector<quint32> &histogram, int nColors )
+    {
+      std::vector<HistogramBin> bins;
+      for ( int key = 0; key < HISTOGRAM_SIZE; ++key )
+      {
+        if ( histogram[key] > 0 )
+          bins.push_back( histogramBin( key, histogram[key] ) );
+      }
+
+      std::vector<ColorBox> boxes;
+      ColorBox firstBox;
+      firstBox.end = static_cast< int >( bins.size() );
+      updateBox( bins, firstBox );
+      boxes.push_back( firstBox );
+
+      while ( static_cast< int >( boxes.size() ) < nColors )
+      {
+        // split the box with the largest spread of pixels
+        int boxIndex = -1;
+        quint64 bestScore = 0;
+        for ( int i = 0; i < static_cast< int >( boxes.size() ); ++i )
+        {
+          const ColorBox &box = boxes[i];
+          if ( box.end - box.begin < 2 || box.range <= 0 )
+            continue;
+
+          const quint64 score = box.count * static_cast< quint64 >( box.range );
+          if ( score > bestScore )
+          {
+            bestScore = score;
+            boxIndex = i;
+          }
+        }
+
+        if ( boxIndex < 0 )
+          break; // every box contains a single color
+
+        ColorBox box = boxes[boxIndex];
+        const int channel = box.channel;
+        std::sort( bins.begin() + box.begin, bins.begin() + box.end, [channel]( const HistogramBin & b1, const HistogramBin & b2 )
+        {
+          return b1.channels[channel] < b2.channels[channel];
+        } );
+
+        // find the weighted median, keeping at least one bin on each side
+        const quint64 half = box.count / 2;
+        quint64 sum = 0;
+        int split = box.begin;
+        for ( ; split < box.end - 1; ++split )
+        {
+          sum += bins[split].count;
+          if ( sum >= half )
+            break;
+        }
+        ++split;
+
+        ColorBox lower;
+        lower.begin = box.begin;
+        lower.end = split;
+        updateBox( bins, lower );
+
+        ColorBox upper;
+        upper.begin = split;
+        upper.end = box.end;
+        updateBox( bins, upper );
+
+        boxes[boxIndex] = lower;
+        boxes.push_back( upper );
+      }
+
+      QVector<QRgb> palette;
+      palette.reserve( static_cast< int >( boxes.size() ) );
+      for ( const ColorBox &box : boxes )
+      {
+        if ( box.count > 0 )
+          palette << boxColor( bins, box );
+      }
+      return palette;
+    }
+
+    int nearestColor( const QVector<QRgb> &palette, int a, int r, int g, int b )
+    {
+      int index = 0;
+      int bestDistance = std::numeric_limits<int>::max();
+      for ( int i = 0; i < palette.size(); ++i )
+      {
+        const QRgb c = palette.at( i );
+        const int da = qAlpha( c ) - a;
+        const int dr = qRed( c ) - r;
+        const int dg = qGreen( c ) - g;
+        const int db = qBlue( c ) - b;
+        // alpha differences are more visible than color differences
+        const int distance = 2 * da * da + dr * dr + dg * dg + db * db;
+        if ( distance < bestDistance )
+        {
+          bestDistance = distance;
+          index = i;
+          if ( distance == 0 )
+            break;
+        }
+      }
+      return index;
+    }
+
+    class PaletteLookup
+    {
+      public:
+        explicit PaletteLookup( const QVector<QRgb> &palette )
+          : mPalette( palette )
+          , mLookup( HISTOGRAM_SIZE, -1 )
+        {}
+
+        int index( int a, int r, int g, int b )
+        {
+          const int key = histogramKey( a, r, g, b );
+          qint16 &index = mLookup[key];
+          if ( index < 0 )
+          {
+            const HistogramBin bin = histogramBin( key, 0 );
+            index = static_cast< qint16 >( nearestColor( mPalette, bin.channels[0], bin.channels[1], bin.channels[2], bin.channels[3] ) );
+          }
+          return index;
+        }
+
+        QRgb color( int index ) const { return mPalette.at( index ); }
+
+      private:
+        const QVector<QRgb> &mPalette;
+        std::vector<qint16> mLookup;
+    };
+
+    void mapPixels( const QImage &image, QImage &result, PaletteLookup &lookup )
+    {
+      const int width = image.width();
+      const int height = image.height();
+      for ( int y = 0; y < height; ++y )
+      {
+        const QRgb *src = reinterpret_cast< const QRgb * >( image.constScanLine( y ) );
+        uchar *dst = result.scanLine( y );
+
+        QRgb previous = src[0];
+        uchar previousIndex = static_cast< uchar >( lookup.index( qAlpha( previous ), qRed( previous ), qGreen( previous ), qBlue( previous ) ) );
+        for ( int x = 0; x < width; ++x )
+        {
+          const QRgb c = src[x];
+          if ( c != previous )
+          {
+            previous = c;
+            previousIndex = static_cast< uchar >( lookup.index( qAlpha( c ), qRed( c ), qGreen( c ), qBlue( c ) ) );
+          }
+          dst[x] = previousIndex;
+        }
+      }
+    }
+
+    void mapPixelsDithered( const QImage &image, QImage &result, PaletteLookup &lookup )
+    {
+      const int width = image.width();
+      const int height = image.height();
+
+      // errors are stored multiplied by 16, with one guard pixel on each side
+      std::vector<int> currentErrors( ( width + 2 ) * 4, 0 );
+      std::vector<int> nextErrors( ( width + 2 ) * 4, 0 );
+
+      for ( int y = 0; y < height; ++y )
+      {
+        const QRgb *src = reinterpret_cast< const QRgb * >( image.constScanLine( y ) );
+        uchar *dst = result.scanLine( y );
+        std::fill( nextErrors.begin(), nextErrors.end(), 0 );
+
+        for ( int x = 0; x < width; ++x )
+        {
+          const QRgb c = src[x];
+          if ( qAlpha( c ) == 0 )
+          {
+            // do not spread noise over transparent areas
+            dst[x] = static_cast< uchar >( lookup.index( 0, 0, 0, 0 ) );
+            continue;
+          }
+
+          int *error = &currentErrors[( x + 1 ) * 4];
+          const int values[4] =
+          {
+            std::clamp( qAlpha( c ) + error[0] / 16, 0, 255 ),
+            std::clamp( qRed( c ) + error[1] / 16, 0, 255 ),
+            std::clamp( qGreen( c ) + error[2] / 16, 0, 255 ),
+            std::clamp( qBlue( c ) + error[3] / 16, 0, 255 )
+          };
+
+          const int index = lookup.index( values[0], values[1], values[2], values[3] );
+          dst[x] = static_cast< uchar >( index );
+
+          const QRgb p = lookup.color( index );
+          const int paletteValues[4] = { qAlpha( p ), qRed( p ), qGreen( p ), qBlue( p ) };
+          for ( int ch = 0; ch < 4; ++ch )
+          {
+            const int e = values[ch] - paletteValues[ch];
+            currentErrors[( x + 2 ) * 4 + ch] += e * 7;
+            nextErrors[x * 4 + ch] += e * 3;
+            nextErrors[( x + 1 ) * 4 + ch] += e * 5;
+            nextErrors[( x + 2 ) * 4 + ch] += e;
+          }
+        }
+        std::swap( currentErrors, nextErrors );
+      }
+    }
+
+  } // namespace
+
+  QImage quantizeImage( const QImage &inputImage, int nColors, bool dither )
+  {
+    if ( inputImage.isNull() || nColors <= 0 )
+      return QImage();
+
+    const QImage image = inputImage.format() == QImage::Format_ARGB32 ? inputImage : inputImage.convertToFormat( QImage::Format_ARGB32 );
+    const int width = image.width();
+    const int height = image.height();
+
+    // single pass over the pixels to collect both the reduced histogram and,
+    // as long as there are few of them, the exact colors
+    std::vector<quint32> histogram( HISTOGRAM_SIZE, 0 );
+    QHash<QRgb, int> exactColors;
+    bool exact = true;
+    for ( int y = 0; y < height; ++y )
+    {
+      const QRgb *line = reinterpret_cast< const QRgb * >( image.constScanLine( y ) );
+      QRgb previous = line[0];
+      if ( exact )
+      {
+        exactColors.insert( previous, 0 );
+        exact = exactColors.size() <= nColors;
+      }
+      for ( int x = 0; x < width; ++x )
+      {
+        const QRgb c = line[x];
+        histogram[histogramKey( c )]++;
+        if ( exact && c != previous )
+        {
+          previous = c;
+          exactColors.insert( c, 0 );
+          exact = exactColors.size() <= nColors;
+        }
+      }
+    }
+
+    QImage result( width, height, QImage::Format_Indexed8 );
+    if ( exact )
+    {
+      // all the colors of the image fit in the palette
+      QVector<QRgb> palette = exactColors.keys().toVector();
+      std::sort( palette.begin(), palette.end() );
+      for ( int i = 0; i < palette.size(); ++i )
+        exactColors[palette.at( i )] = i;
+
+      for ( int y = 0; y < height; ++y )
+      {
+        const QRgb *src = reinterpret_cast< const QRgb * >( image.constScanLine( y ) );
+        uchar *dst = result.scanLine( y );
+        QRgb previous = src[0];
+        uchar previousIndex = static_cast< uchar >( exactColors.value( previous ) );
+        for ( int x = 0; x < width; ++x )
+        {
+          if ( src[x] != previous )
+          {
+            previous = src[x];
+            previousIndex = static_cast< uchar >( exactColors.value( previous ) );
+          }
+          dst[x] = previousIndex;
+        }
+      }
+      result.setColorTable( palette );
+      return result;
+    }
+
+    const QVector<QRgb> palette = histogramPalette( histogram, nColors );
+    PaletteLookup lookup( palette );
+    if ( dither )
+      mapPixelsDithered( image, result, lookup );
+    else
+      mapPixels( image, result, lookup );
+
+    result.setColorTable( palette );
+    return result;
+  }
+
+} // namespace QgsWms
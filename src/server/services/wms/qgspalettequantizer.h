@@ -0,0 +1,47 @@
+/***************************************************************************
+                              qgspalettequantizer.h
+                              -------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSPALETTEQUANTIZER_H
+#define QGSPALETTEQUANTIZER_H
+
+#include <QImage>
+
+/**
+ * \ingroup server
+ * \brief Palette quantization used for 8 bits images
+ */
+
+namespace QgsWms
+{
+
+  /**
+   * Reduces \a image to an indexed image of at most \a nColors colors.
+   *
+   * If the image contains at most \a nColors distinct colors, they are used
+   * as is. Otherwise, colors are first accumulated in a reduced precision
+   * histogram (5 bits per color channel and 4 bits for alpha) and the palette
+   * is computed with a median cut over the histogram bins, so that the cost
+   * depends on the number of pixels and not on the number of distinct colors.
+   *
+   * When \a dither is TRUE, a Floyd-Steinberg error diffusion is applied
+   * while mapping pixels to the palette.
+   *
+   * \returns an image in the QImage::Format_Indexed8 format
+   */
+  QImage quantizeImage( const QImage &image, int nColors, bool dither = false );
+
+} // namespace QgsWms
+
+#endif
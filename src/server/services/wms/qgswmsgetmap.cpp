@@ -57,7 +57,7 @@ namespace QgsWms
     if ( result )
     {
       const QString format = request.parameters().value( QStringLiteral( "FORMAT" ), QStringLiteral( "PNG" ) );
-      writeImage( response, *result, format, context.imageQuality() );
+      writeImage( response, *result, format, context.imageQuality(), &context.settings() );
     }
     else
     {
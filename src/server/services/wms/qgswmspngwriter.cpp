@@ -0,0 +1,358 @@
+/***************************************************************************
+                              qgswmspngwriter.cpp
+                              -------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgswmspngwriter.h"
+
+#include <QIODevice>
+#include <QVector>
+
+#include <cstdlib>
+#include <vector>
+
+#include <zlib.h>
+
+namespace QgsWms
+{
+  namespace
+  {
+    // size of the compressed data stored in each IDAT chunk
+    constexpr int IDAT_CHUNK_SIZE = 64 * 1024;
+
+    enum RowFilterType
+    {
+      FilterNone = 0,
+      FilterSub = 1,
+      FilterUp = 2,
+      FilterAverage = 3,
+      FilterPaeth = 4
+    };
+
+    void appendUInt32( QByteArray &data, quint32 value )
+    {
+      data.append( static_cast< char >( ( value >> 24 ) & 0xff ) );
+      data.append( static_cast< char >( ( value >> 16 ) & 0xff ) );
+      data.append( static_cast< char >( ( value >> 8 ) & 0xff ) );
+      data.append( static_cast< char >( value & 0xff ) );
+    }
+
+    bool writeChunk( QIODevice *device, const char *type, const QByteArray &data )
+    {
+      QByteArray chunk;
+      chunk.reserve( data.size() + 12 );
+      appendUInt32( chunk, static_cast< quint32 >( data.size() ) );
+      chunk.append( type, 4 );
+      chunk.append( data );
+
+      // the CRC covers the chunk type and data
+      const uLong crc = crc32( crc32( 0L, Z_NULL, 0 ), reinterpret_cast< const Bytef * >( chunk.constData() + 4 ), static_cast< uInt >( data.size() + 4 ) );
+      appendUInt32( chunk, static_cast< quint32 >( crc ) );
+
+      return device->write( chunk ) == chunk.size();
+    }
+
+    inline uchar paethPredictor( int a, int b, int c )
+    {
+      const int p = a + b - c;
+      const int pa = std::abs( p - a );
+      const int pb = std::abs( p - b );
+      const int pc = std::abs( p - c );
+      if ( pa <= pb && pa <= pc )
+        return static_cast< uchar >( a );
+      if ( pb <= pc )
+        return static_cast< uchar >( b );
+      return static_cast< uchar >( c );
+    }
+
+    /**
+     * Filters the \a row with the \a type filter into \a out, \a previous is
+     * the unfiltered previous row (zeros for the first row).
+     */
+    void filterRow( RowFilterType type, const uchar *row, const uchar *previous, int length, int bpp, uchar *out )
+    {
+      out[0] = static_cast< uchar >( type );
+      uchar *dst = out + 1;
+      switch ( type )
+      {
+        case FilterNone:
+          std::copy( row, row + length, dst );
+          break;
+
+        case FilterSub:
+          for ( int i = 0; i < length; ++i )
+            dst[i] = static_cast< uchar >( row[i] - ( i >= bpp ? row[i - bpp] : 0 ) );
+          break;
+
+        case FilterUp:
+          for ( int i = 0; i < length; ++i )
+            dst[i] = static_cast< uchar >( row[i] - previous[i] );
+          break;
+
+        case FilterAverage:
+          for ( int i = 0; i < length; ++i )
+            dst[i] = static_cast< uchar >( row[i] - ( ( i >= bpp ? row[i - bpp] : 0 ) + previous[i] ) / 2 );
+          break;
+
+        case FilterPaeth:
+          for ( int i = 0; i < length; ++i )
+          {
+            const int a = i >= bpp ? row[i - bpp] : 0;
+            const int c = i >= bpp ? previous[i - bpp] : 0;
+            dst[i] = static_cast< uchar >( row[i] - paethPredictor( a, previous[i], c ) );
+          }
+          break;
+      }
+    }
+
+    quint64 filteredRowCost( const uchar *filtered, int length )
+    {
+      // minimum sum of absolute differences heuristic, bytes are interpreted as signed
+      quint64 cost = 0;
+      for ( int i = 1; i <= length; ++i )
+        cost += std::abs( static_cast< int >( static_cast< signed char >( filtered[i] ) ) );
+      return cost;
+    }
+
+    class IdatWriter
+    {
+      public:
+        IdatWriter( QIODevice *device, int compressionLevel, int strategy )
+          : mDevice( device )
+          , mBuffer( IDAT_CHUNK_SIZE, 0 )
+        {
+          mValid = deflateInit2( &mStream, compressionLevel, Z_DEFLATED, 15, 8, strategy ) == Z_OK;
+        }
+
+        ~IdatWriter()
+        {
+          if ( mValid )
+            deflateEnd( &mStream );
+        }
+
+        bool write( const uchar *data, int length, bool finish )
+        {
+          if ( !mValid )
+            return false;
+
+          mStream.next_in = const_cast< Bytef * >( data );
+          mStream.avail_in = static_cast< uInt >( length );
+          int result = Z_OK;
+          do
+          {
+            mStream.next_out = reinterpret_cast< Bytef * >( mBuffer.data() );
+            mStream.avail_out = static_cast< uInt >( mBuffer.size() );
+            result = deflate( &mStream, finish ? Z_FINISH : Z_NO_FLUSH );
+            if ( result == Z_STREAM_ERROR )
+              return false;
+
+            const int produced = mBuffer.size() - static_cast< int >( mStream.avail_out );
+            if ( produced > 0 && !writeChunk( mDevice, "IDAT", QByteArray::fromRawData( mBuffer.constData(), produced ) ) )
+              return false;
+          }
+          while ( mStream.avail_out == 0 || ( finish && result != Z_STREAM_END ) );
+
+          return true;
+        }
+
+      private:
+        QIODevice *mDevice = nullptr;
+        z_stream mStream = {};
+        QByteArray mBuffer;
+        bool mValid = false;
+    };
+
+  } // namespace
+
+  PngFilter parsePngFilter( const QString &filter )
+  {
+    const QString f = filter.trimmed().toLower();
+    if ( f == QLatin1String( "none" ) )
+      return PngFilter::None;
+    if ( f == QLatin1String( "sub" ) )
+      return PngFilter::Sub;
+    if ( f == QLatin1String( "up" ) )
+      return PngFilter::Up;
+    if ( f == QLatin1String( "average" ) )
+      return PngFilter::Average;
+    if ( f == QLatin1String( "paeth" ) )
+      return PngFilter::Paeth;
+    if ( f == QLatin1String( "adaptive" ) )
+      return PngFilter::Adaptive;
+    return PngFilter::Automatic;
+  }
+
+  bool writePng( QIODevice *device, const QImage &inputImage, int compressionLevel, PngFilter filter )
+  {
+    if ( !device || inputImage.isNull() )
+      return false;
+
+    QImage image;
+    int colorType = 0;
+    int bpp = 0;
+    if ( inputImage.format() == QImage::Format_Indexed8 )
+    {
+      image = inputImage;
+      colorType = 3;
+      bpp = 1;
+    }
+    else if ( inputImage.hasAlphaChannel() )
+    {
+      image = inputImage.convertToFormat( QImage::Format_ARGB32 );
+      colorType = 6;
+      bpp = 4;
+    }
+    else
+    {
+      image = inputImage.convertToFormat( QImage::Format_RGB32 );
+      colorType = 2;
+      bpp = 3;
+    }
+
+    if ( filter == PngFilter::Automatic )
+      filter = colorType == 3 ? PngFilter::None : PngFilter::Adaptive;
+
+    if ( compressionLevel < -1 || compressionLevel > 9 )
+      compressionLevel = Z_DEFAULT_COMPRESSION;
+
+    const int width = image.width();
+    const int height = image.height();
+
+    // signature
+    static const char signature[] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+    if ( device->write( signature, 8 ) != 8 )
+      return false;
+
+    QByteArray header;
+    appendUInt32( header, static_cast< quint32 >( width ) );
+    appendUInt32( header, static_cast< quint32 >( height ) );
+    header.append( static_cast< char >( 8 ) ); // bit depth
+    header.append( static_cast< char >( colorType ) );
+    header.append( static_cast< char >( 0 ) ); // deflate compression
+    header.append( static_cast< char >( 0 ) ); // adaptive filtering
+    header.append( static_cast< char >( 0 ) ); // no interlace
+    if ( !writeChunk( device, "IHDR", header ) )
+      return false;
+
+    if ( colorType == 3 )
+    {
+      const QVector<QRgb> colorTable = image.colorTable();
+      QByteArray palette;
+      QByteArray transparency;
+      int lastTransparent = -1;
+      for ( int i = 0; i < colorTable.size(); ++i )
+      {
+        const QRgb c = colorTable.at( i );
+        palette.append( static_cast< char >( qRed( c ) ) );
+        palette.append( static_cast< char >( qGreen( c ) ) );
+        palette.append( static_cast< char >( qBlue( c ) ) );
+        transparency.append( static_cast< char >( qAlpha( c ) ) );
+        if ( qAlpha( c ) != 255 )
+          lastTransparent = i;
+      }
+      if ( !writeChunk( device, "PLTE", palette ) )
+        return false;
+
+      // trailing opaque entries can be omitted
+      if ( lastTransparent >= 0 && !writeChunk( device, "tRNS", transparency.left( lastTransparent + 1 ) ) )
+        return false;
+    }
+
+    if ( image.dotsPerMeterX() > 0 && image.dotsPerMeterY() > 0 )
+    {
+      QByteArray physical;
+      appendUInt32( physical, static_cast< quint32 >( image.dotsPerMeterX() ) );
+      appendUInt32( physical, static_cast< quint32 >( image.dotsPerMeterY() ) );
+      physical.append( static_cast< char >( 1 ) ); // meter unit
+      if ( !writeChunk( device, "pHYs", physical ) )
+        return false;
+    }
+
+    // zlib performs better on filtered data with a strategy that favors huffman coding
+    IdatWriter idat( device, compressionLevel, filter == PngFilter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED );
+
+    const int rowLength = width * bpp;
+    std::vector<uchar> row( rowLength, 0 );
+    std::vector<uchar> previous( rowLength, 0 );
+    std::vector<uchar> filtered( rowLength + 1, 0 );
+    std::vector<uchar> candidate( filter == PngFilter::Adaptive ? rowLength + 1 : 0, 0 );
+
+    for ( int y = 0; y < height; ++y )
+    {
+      const uchar *line = image.constScanLine( y );
+      if ( colorType == 3 )
+      {
+        std::copy( line, line + rowLength, row.begin() );
+      }
+      else
+      {
+        const QRgb *pixels = reinterpret_cast< const QRgb * >( line );
+        uchar *dst = row.data();
+        for ( int x = 0; x < width; ++x )
+        {
+          const QRgb p = pixels[x];
+          *dst++ = static_cast< uchar >( qRed( p ) );
+          *dst++ = static_cast< uchar >( qGreen( p ) );
+          *dst++ = static_cast< uchar >( qBlue( p ) );
+          if ( colorType == 6 )
+            *dst++ = static_cast< uchar >( qAlpha( p ) );
+        }
+      }
+
+      switch ( filter )
+      {
+        case PngFilter::Automatic:
+        case PngFilter::None:
+          filterRow( FilterNone, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          break;
+        case PngFilter::Sub:
+          filterRow( FilterSub, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          break;
+        case PngFilter::Up:
+          filterRow( FilterUp, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          break;
+        case PngFilter::Average:
+          filterRow( FilterAverage, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          break;
+        case PngFilter::Paeth:
+          filterRow( FilterPaeth, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          break;
+        case PngFilter::Adaptive:
+        {
+          filterRow( FilterNone, row.data(), previous.data(), rowLength, bpp, filtered.data() );
+          quint64 bestCost = filteredRowCost( filtered.data(), rowLength );
+          for ( RowFilterType type : { FilterSub, FilterUp, FilterAverage, FilterPaeth } )
+          {
+            filterRow( type, row.data(), previous.data(), rowLength, bpp, candidate.data() );
+            const quint64 cost = filteredRowCost( candidate.data(), rowLength );
+            if ( cost < bestCost )
+            {
+              bestCost = cost;
+              std::swap( filtered, candidate );
+            }
+          }
+          break;
+        }
+      }
+
+      if ( !idat.write( filtered.data(), rowLength + 1, y == height - 1 ) )
+        return false;
+
+      std::swap( row, previous );
+    }
+
+    return writeChunk( device, "IEND", QByteArray() );
+  }
+
+} // namespace QgsWms
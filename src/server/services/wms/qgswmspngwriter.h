@@ -0,0 +1,64 @@
+/***************************************************************************
+                              qgswmspngwriter.h
+                              -------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSWMSPNGWRITER_H
+#define QGSWMSPNGWRITER_H
+
+#include <QImage>
+#include <QString>
+
+class QIODevice;
+
+/**
+ * \ingroup server
+ * \brief PNG encoder with tunable compression
+ */
+
+namespace QgsWms
+{
+
+  //! PNG row filter strategy
+  enum class PngFilter
+  {
+    Automatic, //!< No filter for indexed images, adaptive filter otherwise
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth,
+    Adaptive //!< Per row choice of the filter minimizing the sum of absolute differences
+  };
+
+  /**
+   * Parses a PNG filter strategy name (none, sub, up, average, paeth or adaptive).
+   * Returns PngFilter::Automatic for an empty or unknown name.
+   */
+  PngFilter parsePngFilter( const QString &filter );
+
+  /**
+   * Writes \a image to \a device as a PNG file.
+   *
+   * Unlike QImageWriter, the zlib \a compressionLevel (from 0 to 9, -1 for
+   * the zlib default) and the row \a filter strategy can be tuned. Indexed
+   * images are written with a palette, images with an alpha channel as RGBA
+   * and other images as RGB. The image resolution is preserved.
+   *
+   * \returns TRUE if the image has been written
+   */
+  bool writePng( QIODevice *device, const QImage &image, int compressionLevel = -1, PngFilter filter = PngFilter::Automatic );
+
+} // namespace QgsWms
+
+#endif
@@ -23,7 +23,8 @@
 
 #include "qgsmodule.h"
 #include "qgswmsutils.h"
-#include "qgsmediancut.h"
+#include "qgspalettequantizer.h"
+#include "qgswmspngwriter.h"
 #include "qgsserverprojectutils.h"
 #include "qgswmsserviceexception.h"
 #include "qgsproject.h"
@@ -103,7 +104,7 @@ namespace QgsWms
 
   // Write image response
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
-                   int imageQuality )
+                   int imageQuality, const QgsServerSettings *settings )
   {
     ImageOutputFormat outputFormat = parseImageFormat( formatStr );
     QImage  result;
@@ -117,21 +118,10 @@ namespace QgsWms
         saveFormat = "PNG";
         break;
       case PNG8:
-      {
-        QVector<QRgb> colorTable;
-
-        // Rendering is made with the format QImage::Format_ARGB32_Premultiplied
-        // So we need to convert it in QImage::Format_ARGB32 in order to properly build
-        // the color table.
-        QImage img256 = img.convertToFormat( QImage::Format_ARGB32 );
-        medianCut( colorTable, 256, img256 );
-        result = img256.convertToFormat( QImage::Format_Indexed8, colorTable,
-                                         Qt::ColorOnly | Qt::ThresholdDither |
-                                         Qt::ThresholdAlphaDither | Qt::NoOpaqueDetection );
-      }
-      contentType = "image/png";
-      saveFormat = "PNG";
-      break;
+        result = quantizeImage( img, 256, settings && settings->wmsPng8Dithering() );
+        contentType = "image/png";
+        saveFormat = "PNG";
+        break;
       case PNG16:
         result = img.convertToFormat( QImage::Format_ARGB4444_Premultiplied );
         contentType = "image/png";
@@ -171,6 +161,14 @@ namespace QgsWms
       {
         result.save( response.io(), qPrintable( saveFormat ), imageQuality );
       }
+      else if ( outputFormat == PNG || outputFormat == PNG8 )
+      {
+        // the built-in encoder allows to tune the compression level and the row filter
+        const int compressionLevel = settings ? settings->wmsPngCompressionLevel() : -1;
+        const PngFilter filter = settings ? parsePngFilter( settings->wmsPngFilter() ) : PngFilter::Automatic;
+        if ( !writePng( response.io(), result, compressionLevel, filter ) )
+          throw QgsServerException( QStringLiteral( "Failed to write the PNG image" ) );
+      }
       else
       {
         result.save( response.io(), qPrintable( saveFormat ) );
@@ -61,9 +61,11 @@ namespace QgsWms
 
   /**
    * Write image response
+   *
+   * The PNG encoding options are read from \a settings when available.
    */
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
-                   int imageQuality = -1 );
+                   int imageQuality = -1, const QgsServerSettings *settings = nullptr );
 } // namespace QgsWms
 
 #endif
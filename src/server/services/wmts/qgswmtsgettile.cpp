@@ -17,11 +17,24 @@
 #include "qgswmtsutils.h"
 #include "qgswmtsparameters.h"
 #include "qgswmtsgettile.h"
+#include "qgswmtstilecache.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsserverprojectutils.h"
 
 #include <QImage>
 
 namespace QgsWmts
 {
+  namespace
+  {
+    // same rule as the WMS GetMap size check: the more conservative limit when both are set
+    int wmsMaxSize( int projectMaxSize, int settingsMaxSize )
+    {
+      if ( projectMaxSize != -1 && settingsMaxSize != -1 )
+        return std::min( projectMaxSize, settingsMaxSize );
+      return std::max( projectMaxSize, settingsMaxSize );
+    }
+  }
 
   void writeGetTile( QgsServerInterface *serverIface, const QgsProject *project,
                      const QString &version, const QgsServerRequest &request,
@@ -30,12 +43,16 @@ namespace QgsWmts
     Q_UNUSED( version )
     const QgsWmtsParameters params( QUrlQuery( request.url() ) );
 
-    // WMS query
-    QUrlQuery query = translateWmtsParamToWmsQueryItem( QStringLiteral( "GetMap" ), params, project, serverIface );
+    // Check the requested tile
+    const tileRequestDef tile = checkTileRequest( params, project, serverIface );
+
+    QgsAccessControl *accessControl = nullptr;
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+    accessControl = serverIface->accessControls();
+#endif
 
     // Get cached image
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
-    QgsAccessControl *accessControl = serverIface->accessControls();
     QgsServerCacheManager *cacheManager = serverIface->cacheManager();
     if ( cacheManager )
     {
@@ -66,10 +83,54 @@ namespace QgsWmts
     }
 #endif
 
-    QgsServerParameters wmsParams( query );
-    QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
-    QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
-    service->executeRequest( wmsRequest, response, project );
+    const QgsServerSettings *settings = serverIface->serverSettings();
+    const TileCache tileCache( *settings, project, tile, accessControl );
+    if ( tileCache.isEnabled() )
+    {
+      QByteArray content = tileCache.tile( tile.row, tile.col );
+      if ( content.isEmpty() )
+      {
+        // Render the whole metatile once and store all its tiles
+        const metatileDef metatile = calculateMetatile( tile, settings->wmtsMetatileSize(),
+                                     wmsMaxSize( QgsServerProjectUtils::wmsMaxWidth( *project ), settings->wmsMaxWidth() ),
+                                     wmsMaxSize( QgsServerProjectUtils::wmsMaxHeight( *project ), settings->wmsMaxHeight() ) );
+        QUrlQuery query = translateTileRequestToWmsQueryItem( QStringLiteral( "GetMap" ), params, tile, metatile );
+
+        QgsServerParameters wmsParams( query );
+        QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
+        QgsBufferServerResponse wmsResponse;
+        QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
+        service->executeRequest( wmsRequest, wmsResponse, project );
+
+        QImage image;
+        if ( !image.loadFromData( wmsResponse.data() ) )
+        {
+          // Not an image, e.g. a WMS service exception: send it as is and store nothing
+          const QMap<QString, QString> headers = wmsResponse.headers();
+          for ( auto it = headers.constBegin(); it != headers.constEnd(); ++it )
+            response.setHeader( it.key(), it.value() );
+          response.setStatusCode( wmsResponse.statusCode() );
+          response.write( wmsResponse.data() );
+          return;
+        }
+
+        const QList< QList< QByteArray > > tiles = tileCache.storeMetatile( image, metatile );
+        content = tiles.value( tile.row - metatile.minRow ).value( tile.col - metatile.minCol );
+      }
+
+      response.setHeader( QStringLiteral( "Content-Type" ), tileCache.contentType() );
+      response.write( content );
+    }
+    else
+    {
+      // WMS query
+      QUrlQuery query = translateTileRequestToWmsQueryItem( QStringLiteral( "GetMap" ), params, tile, calculateMetatile( tile, 1 ) );
+
+      QgsServerParameters wmsParams( query );
+      QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
+      QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
+      service->executeRequest( wmsRequest, response, project );
+    }
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
     if ( cacheManager )
     {
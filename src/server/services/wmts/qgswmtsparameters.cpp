@@ -89,6 +89,9 @@ namespace QgsWmts
     const QgsWmtsParameter pLayer = QgsWmtsParameter( QgsWmtsParameter::LAYER );
     save( pLayer );
 
+    const QgsWmtsParameter pStyle = QgsWmtsParameter( QgsWmtsParameter::STYLE );
+    save( pStyle );
+
     const QgsWmtsParameter pFormat = QgsWmtsParameter( QgsWmtsParameter::FORMAT );
     save( pFormat );
 
@@ -174,6 +177,11 @@ namespace QgsWmts
     return mWmtsParameters[ QgsWmtsParameter::LAYER ].toString();
   }
 
+  QString QgsWmtsParameters::style() const
+  {
+    return mWmtsParameters[ QgsWmtsParameter::STYLE ].toString();
+  }
+
   QString QgsWmtsParameters::formatAsString() const
   {
     return mWmtsParameters[ QgsWmtsParameter::FORMAT ].toString();
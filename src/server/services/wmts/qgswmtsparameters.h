@@ -88,6 +88,7 @@ namespace QgsWmts
       {
         UNKNOWN,
         LAYER,
+        STYLE,
         FORMAT,
         TILEMATRIXSET,
         TILEMATRIX,
@@ -199,6 +200,13 @@ namespace QgsWmts
        */
       QString layer() const;
 
+      /**
+       * Returns STYLE parameter as a string.
+       * \returns style parameter as string
+       * \since QGIS 3.22
+       */
+      QString style() const;
+
       /**
        * Returns FORMAT parameter as a string.
        * \returns Format parameter as string
@@ -0,0 +1,154 @@
+/***************************************************************************
+                              qgswmtstilecache.cpp
+                              -------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgswmtstilecache.h"
+#include "qgsaccesscontrol.h"
+#include "qgsserverprojectutils.h"
+#include "qgsproject.h"
+#include "qgsmessagelog.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QUrl>
+
+namespace QgsWmts
+{
+  namespace
+  {
+    QString pathComponent( const QString &value )
+    {
+      if ( value.isEmpty() )
+        return QStringLiteral( "default" );
+
+      // percent encode everything that could not be safely used as a directory name
+      return QString::fromLatin1( QUrl::toPercentEncoding( value, QByteArray( " " ) ) );
+    }
+  }
+
+  TileCache::TileCache( const QgsServerSettings &settings, const QgsProject *project, const tileRequestDef &tile,
+                        QgsAccessControl *accessControl )
+  {
+    const QString cacheDirectory = settings.wmtsCacheDirectory();
+    if ( cacheDirectory.isEmpty() || !project )
+      return;
+
+    QStringList projectKey;
+    projectKey << project->absoluteFilePath()
+               << project->lastModified().toString( Qt::ISODateWithMs );
+    if ( accessControl && !accessControl->fillCacheKey( projectKey ) )
+    {
+      // access control does not allow caching
+      return;
+    }
+
+    const QByteArray projectHash = QCryptographicHash::hash( projectKey.join( '-' ).toUtf8(), QCryptographicHash::Sha1 ).toHex();
+
+    mDirectory = QDir( cacheDirectory ).filePath( QStringLiteral( "%1/%2/%3/%4/%5" ).arg(
+                   QString::fromLatin1( projectHash ),
+                   pathComponent( tile.layer ),
+                   pathComponent( tile.style ),
+                   pathComponent( tile.tms.ref ),
+                   QString::number( tile.tileMatrix ) ) );
+
+    if ( tile.imageFormat == QgsWmtsParameters::Format::JPG )
+    {
+      mExtension = QStringLiteral( "jpg" );
+      mSaveFormat = QByteArrayLiteral( "JPEG" );
+      mImageQuality = QgsServerProjectUtils::wmsImageQuality( *project );
+    }
+    else
+    {
+      mExtension = QStringLiteral( "png" );
+      mSaveFormat = QByteArrayLiteral( "PNG" );
+    }
+
+    mEnabled = true;
+  }
+
+  QString TileCache::tilePath( int row, int col ) const
+  {
+    return QStringLiteral( "%1/%2/%3.%4" ).arg( mDirectory, QString::number( row ), QString::number( col ), mExtension );
+  }
+
+  QString TileCache::contentType() const
+  {
+    return mExtension == QLatin1String( "jpg" ) ? QStringLiteral( "image/jpeg" ) : QStringLiteral( "image/png" );
+  }
+
+  QByteArray TileCache::tile( int row, int col ) const
+  {
+    if ( !mEnabled )
+      return QByteArray();
+
+    QFile file( tilePath( row, col ) );
+    if ( !file.open( QIODevice::ReadOnly ) )
+      return QByteArray();
+
+    return file.readAll();
+  }
+
+  QList< QList< QByteArray > > TileCache::storeMetatile( const QImage &image, const metatileDef &metatile ) const
+  {
+    QList< QList< QByteArray > > tiles;
+    if ( image.isNull() || metatile.rowCount <= 0 || metatile.colCount <= 0 )
+      return tiles;
+
+    const int tileWidth = image.width() / metatile.colCount;
+    const int tileHeight = image.height() / metatile.rowCount;
+
+    for ( int r = 0; r < metatile.rowCount; ++r )
+    {
+      QList< QByteArray > rowTiles;
+      const QString rowDirectory = QStringLiteral( "%1/%2" ).arg( mDirectory, QString::number( metatile.minRow + r ) );
+      if ( mEnabled && !QDir().mkpath( rowDirectory ) )
+      {
+        QgsMessageLog::logMessage( QStringLiteral( "Unable to create WMTS cache directory %1" ).arg( rowDirectory ), QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+      }
+
+      for ( int c = 0; c < metatile.colCount; ++c )
+      {
+        const QImage tileImage = image.copy( c * tileWidth, r * tileHeight, tileWidth, tileHeight );
+
+        QByteArray content;
+        QBuffer buffer( &content );
+        buffer.open( QIODevice::WriteOnly );
+        QImageWriter writer( &buffer, mSaveFormat );
+        writer.setQuality( mImageQuality );
+        writer.write( tileImage );
+        rowTiles << content;
+
+        if ( !mEnabled || content.isEmpty() )
+          continue;
+
+        // QSaveFile renames on commit, so that concurrent readers never get a partially written tile
+        QSaveFile file( tilePath( metatile.minRow + r, metatile.minCol + c ) );
+        if ( !file.open( QIODevice::WriteOnly ) || file.write( content ) != content.size() || !file.commit() )
+        {
+          QgsMessageLog::logMessage( QStringLiteral( "Unable to write WMTS cache tile %1" ).arg( file.fileName() ), QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+        }
+      }
+      tiles << rowTiles;
+    }
+
+    return tiles;
+  }
+
+} // namespace QgsWmts
@@ -0,0 +1,98 @@
+/***************************************************************************
+                              qgswmtstilecache.h
+
+  Built-in disk cache for WMTS tiles rendered by metatiles
+  --------------------------------------------------------
+  begin                : October 2026
+  copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSWMTSTILECACHE_H
+#define QGSWMTSTILECACHE_H
+
+#include "qgswmtsutils.h"
+
+#include <QByteArray>
+#include <QImage>
+
+class QgsAccessControl;
+
+namespace QgsWmts
+{
+
+  /**
+   * \ingroup server
+   * \class QgsWmts::TileCache
+   * \brief Built-in disk cache for WMTS tiles.
+   *
+   * Tiles are stored in the directory defined by QgsServerSettings::wmtsCacheDirectory()
+   * following the layout:
+   *
+   *   <cache directory>/<project key>/<layer>/<style>/<tile matrix set>/<tile matrix>/<row>/<col>.<png|jpg>
+   *
+   * The project key is built from the project path, its last modification time
+   * and the access control cache keys, so that tiles are invalidated when the
+   * project is saved again.
+   *
+   * Tiles are rendered by metatiles: a block of tiles is rendered with a single
+   * WMS GetMap request, then sliced and stored by storeMetatile().
+   *
+   * \since QGIS 3.22
+   */
+  class TileCache
+  {
+    public:
+
+      /**
+       * Constructor for the tile cache of the \a tile layer, style, tile matrix set and tile matrix.
+       */
+      TileCache( const QgsServerSettings &settings, const QgsProject *project, const tileRequestDef &tile,
+                 QgsAccessControl *accessControl );
+
+      /**
+       * Returns TRUE if the built-in tile cache is enabled and the tile
+       * can be cached according to access control.
+       */
+      bool isEnabled() const { return mEnabled; }
+
+      /**
+       * Returns the path of the cached tile at \a row and \a col.
+       */
+      QString tilePath( int row, int col ) const;
+
+      /**
+       * Returns the content of the cached tile at \a row and \a col or an
+       * empty array if the tile is not cached.
+       */
+      QByteArray tile( int row, int col ) const;
+
+      /**
+       * Slices the rendered \a image of the \a metatile into tiles and stores them.
+       * Returns the encoded tiles, indexed by row and column offsets in the metatile.
+       */
+      QList< QList< QByteArray > > storeMetatile( const QImage &image, const metatileDef &metatile ) const;
+
+      /**
+       * Returns the content type of the cached tiles.
+       */
+      QString contentType() const;
+
+    private:
+      bool mEnabled = false;
+      QString mDirectory;
+      QString mExtension;
+      QByteArray mSaveFormat;
+      int mImageQuality = -1;
+  };
+
+} // namespace QgsWmts
+
+#endif
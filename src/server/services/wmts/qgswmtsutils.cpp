@@ -622,8 +622,7 @@ namespace QgsWmts
     return tmsl;
   }
 
-  QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
-      const QgsProject *project, QgsServerInterface *serverIface )
+  tileRequestDef checkTileRequest( const QgsWmtsParameters &params, const QgsProject *project, QgsServerInterface *serverIface )
   {
 #ifndef HAVE_SERVER_PYTHON_PLUGINS
     ( void )serverIface;
@@ -757,11 +756,60 @@ namespace QgsWmts
       throw QgsRequestNotWellFormedException( QStringLiteral( "TileCol is unknown" ) );
     }
 
+    tileRequestDef tile;
+    tile.layer = layer;
+    // "default" is the only style advertised in the capabilities, it renders the current style of the layers
+    tile.style = params.style();
+    if ( tile.style.compare( QLatin1String( "default" ), Qt::CaseInsensitive ) == 0 )
+      tile.style.clear();
+    tile.format = format;
+    tile.imageFormat = params.format();
+    tile.tms = tms;
+    tile.tileMatrix = tm_idx;
+    tile.row = tr;
+    tile.col = tc;
+    return tile;
+  }
+
+  metatileDef calculateMetatile( const tileRequestDef &tile, int metatileSize, int maxWidth, int maxHeight )
+  {
+    const tileMatrixDef tm = tile.tms.tileMatrixList.at( tile.tileMatrix );
+    const int size = std::max( 1, metatileSize );
+    // the metatile is rendered by a single GetMap request, which must fit in the WMS size limits
+    const int rowSize = maxHeight > 0 ? std::max( 1, std::min( size, maxHeight / tileSize ) ) : size;
+    const int colSize = maxWidth > 0 ? std::max( 1, std::min( size, maxWidth / tileSize ) ) : size;
+
+    metatileDef metatile;
+    metatile.minRow = ( tile.row / rowSize ) * rowSize;
+    metatile.minCol = ( tile.col / colSize ) * colSize;
+    // metatiles are clipped to the tile matrix
+    metatile.rowCount = std::min( rowSize, tm.row - metatile.minRow );
+    metatile.colCount = std::min( colSize, tm.col - metatile.minCol );
+    return metatile;
+  }
+
+  QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
+      const QgsProject *project, QgsServerInterface *serverIface )
+  {
+    const tileRequestDef tile = checkTileRequest( params, project, serverIface );
+
+    metatileDef metatile;
+    metatile.minRow = tile.row;
+    metatile.minCol = tile.col;
+    return translateTileRequestToWmsQueryItem( request, params, tile, metatile );
+  }
+
+  QUrlQuery translateTileRequestToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
+      const tileRequestDef &tile, const metatileDef &metatile )
+  {
+    const tileMatrixSetDef &tms = tile.tms;
+    const tileMatrixDef tm = tms.tileMatrixList.at( tile.tileMatrix );
+
     double res = tm.resolution;
-    double minx = tm.left + tc * ( tileSize * res );
-    double miny = tm.top - ( tr + 1 ) * ( tileSize * res );
-    double maxx = tm.left + ( tc + 1 ) * ( tileSize * res );
-    double maxy = tm.top - tr * ( tileSize * res );
+    double minx = tm.left + metatile.minCol * ( tileSize * res );
+    double miny = tm.top - ( metatile.minRow + metatile.rowCount ) * ( tileSize * res );
+    double maxx = tm.left + ( metatile.minCol + metatile.colCount ) * ( tileSize * res );
+    double maxy = tm.top - metatile.minRow * ( tileSize * res );
     QString bbox;
     if ( tms.hasAxisInverted )
     {
@@ -786,13 +834,13 @@ namespace QgsWmts
     query.addQueryItem( QgsServerParameter::name( QgsServerParameter::SERVICE ), QStringLiteral( "WMS" ) );
     query.addQueryItem( QgsServerParameter::name( QgsServerParameter::VERSION_SERVICE ), QStringLiteral( "1.3.0" ) );
     query.addQueryItem( QgsServerParameter::name( QgsServerParameter::REQUEST ), request );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::LAYERS ), layer );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::STYLES ), QString() );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::LAYERS ), tile.layer );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::STYLES ), tile.style );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::CRS ), tms.ref );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::BBOX ), bbox );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QStringLiteral( "256" ) );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QStringLiteral( "256" ) );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT ), format );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QString::number( metatile.colCount * tileSize ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QString::number( metatile.rowCount * tileSize ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT ), tile.format );
     if ( params.format() == QgsWmtsParameters::Format::PNG )
     {
       query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::TRANSPARENT ), QStringLiteral( "true" ) );
@@ -118,6 +118,36 @@ namespace QgsWmts
     double minScale = 0.0;
   };
 
+  struct tileRequestDef
+  {
+    QString layer;
+
+    QString style;
+
+    QString format;
+
+    QgsWmtsParameters::Format imageFormat = QgsWmtsParameters::Format::PNG;
+
+    tileMatrixSetDef tms;
+
+    int tileMatrix = 0;
+
+    int row = 0;
+
+    int col = 0;
+  };
+
+  struct metatileDef
+  {
+    int minRow = 0;
+
+    int minCol = 0;
+
+    int rowCount = 1;
+
+    int colCount = 1;
+  };
+
   /**
    * Returns the highest version supported by this implementation
    */
@@ -141,12 +171,33 @@ namespace QgsWmts
   QList< layerDef > getWmtsLayerList( QgsServerInterface *serverIface, const QgsProject *project );
   tileMatrixSetLinkDef getLayerTileMatrixSetLink( const layerDef layer, const tileMatrixSetDef tms, const QgsProject *project );
 
+  /**
+   * Checks the WMTS tile parameters and returns the requested tile
+   * \throws QgsRequestNotWellFormedException
+   * \throws QgsBadRequestException
+   */
+  tileRequestDef checkTileRequest( const QgsWmtsParameters &params, const QgsProject *project, QgsServerInterface *serverIface );
+
+  /**
+   * Returns the metatile of \a metatileSize x \a metatileSize tiles containing
+   * the requested tile, clipped to the tile matrix. Fewer rows and columns are
+   * used so that the metatile image fits in \a maxWidth x \a maxHeight pixels
+   * (-1 for no limit), down to the single requested tile.
+   */
+  metatileDef calculateMetatile( const tileRequestDef &tile, int metatileSize, int maxWidth = -1, int maxHeight = -1 );
+
   /**
    * Translate WMTS parameters to WMS query item
    */
   QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
       const QgsProject *project, QgsServerInterface *serverIface );
 
+  /**
+   * Translate a checked tile request to WMS query item covering the \a metatile
+   */
+  QUrlQuery translateTileRequestToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
+      const tileRequestDef &tile, const metatileDef &metatile );
+
 } // namespace QgsWmts
 
 #endif
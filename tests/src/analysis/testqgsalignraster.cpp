@@ -235,6 +235,65 @@ class TestAlignRaster : public QObject
       QCOMPARE( out.identify( 1308405, -746611 ), 10. );
     }
 
+    void testConcurrentRasters()
+    {
+      QString tmpFile1( _tempFile( QStringLiteral( "concurrent-1" ) ) );
+      QString tmpFile2( _tempFile( QStringLiteral( "concurrent-2" ) ) );
+
+      QgsAlignRaster align;
+      QgsAlignRaster::List rasters;
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile1 );
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile2 );
+      rasters[1].resampleMethod = QgsAlignRaster::RA_Bilinear;
+      align.setRasters( rasters );
+      align.setParametersFromRaster( SRC_FILE );
+      align.setCellSize( 0.1, 0.1 );
+      QCOMPARE( align.maximumConcurrentRasters(), 1 );
+      align.setMaximumConcurrentRasters( 2 );
+      QCOMPARE( align.maximumConcurrentRasters(), 2 );
+      bool res = align.run();
+      QVERIFY( res );
+
+      QgsAlignRaster::RasterInfo out1( tmpFile1 );
+      QVERIFY( out1.isValid() );
+      QCOMPARE( out1.rasterSize(), QSize( 8, 8 ) );
+      QCOMPARE( out1.cellSize(), QSizeF( 0.1, 0.1 ) );
+      QCOMPARE( out1.identify( 106.05, -6.95 ), 13. );
+      QCOMPARE( out1.identify( 106.15, -6.95 ), 13. );
+
+      QgsAlignRaster::RasterInfo out2( tmpFile2 );
+      QVERIFY( out2.isValid() );
+      QCOMPARE( out2.rasterSize(), QSize( 8, 8 ) );
+      QCOMPARE( out2.cellSize(), QSizeF( 0.1, 0.1 ) );
+      QCOMPARE( out2.identify( 106.15, -6.35 ), 2.25 );
+    }
+
+    void testVrtOutput()
+    {
+      QString tmpFile( QStringLiteral( "%1/aligntest-vrt.vrt" ).arg( QDir::tempPath() ) );
+
+      QgsAlignRaster align;
+      QgsAlignRaster::List rasters;
+      rasters << QgsAlignRaster::Item( SRC_FILE, tmpFile );
+      align.setRasters( rasters );
+      align.setParametersFromRaster( SRC_FILE );
+      align.setCellSize( 0.1, 0.1 );
+      bool res = align.run();
+      QVERIFY( res );
+
+      QgsAlignRaster::RasterInfo out( tmpFile );
+      QVERIFY( out.isValid() );
+      QCOMPARE( out.rasterSize(), QSize( 8, 8 ) );
+      QCOMPARE( out.cellSize(), QSizeF( 0.1, 0.1 ) );
+      QCOMPARE( out.identify( 106.05, -6.95 ), 13. );
+      QCOMPARE( out.identify( 106.15, -6.95 ), 13. );
+
+      // rescaling is only done when the values are written
+      rasters[0].rescaleValues = true;
+      align.setRasters( rasters );
+      QVERIFY( !align.run() );
+    }
+
     void testSuggestedReferenceLayer()
     {
       QgsAlignRaster align;
@@ -16,12 +16,14 @@ Email                : nyall dot dawson at gmail dot com
 
 //header for class being tested
 #include "qgsgeometrysnapper.h"
+#include "qgsgeometrysnapper_p.h"
 #include "qgsgeometry.h"
 #include <qgsapplication.h>
 #include "qgsvectordataprovider.h"
 #include "qgsvectorlayer.h"
 #include "qgsgeos.h"
 #include <geos_c.h>
+#include <random>
 
 
 class TestQgsGeometrySnapper : public QObject
@@ -53,6 +55,7 @@ class TestQgsGeometrySnapper : public QObject
     void insertExtra();
     void duplicateNodes();
     void snapMultiPolygonToPolygon();
+    void referenceIndex();
 
 };
 
@@ -632,6 +635,82 @@ void TestQgsGeometrySnapper::snapMultiPolygonToPolygon()
 
 }
 
+void TestQgsGeometrySnapper::referenceIndex()
+{
+  QgsVectorLayer rl( QStringLiteral( "LineString" ), QStringLiteral( "x" ), QStringLiteral( "memory" ) );
+  QgsFeatureList flist;
+  auto addLine = [&flist]( double x1, double y1, double x2, double y2 )
+  {
+    QgsFeature ff;
+    ff.setGeometry( QgsGeometry::fromPolyline( QgsPolyline() << QgsPoint( x1, y1 ) << QgsPoint( x2, y2 ) ) );
+    flist << ff;
+  };
+
+  // enough lines for several levels in the index, with degenerate boxes at the origin among them
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > coordinate( -100, 100 );
+  std::uniform_real_distribution< double > length( 0, 5 );
+  for ( int i = 0; i < 2000; ++i )
+  {
+    const double x = coordinate( generator );
+    const double y = coordinate( generator );
+    addLine( x, y, x + length( generator ), y + length( generator ) );
+    if ( i % 100 == 0 )
+    {
+      addLine( 0, 0, 0, 0 );
+      addLine( 0, 0, 3, 0 );
+      addLine( 0, -3, 0, 0 );
+    }
+  }
+  rl.dataProvider()->addFeatures( flist );
+  // the reference geometries are stored by feature id, which may have gaps
+  rl.dataProvider()->deleteFeatures( QgsFeatureIds() << 5 << 6 << 300 );
+
+  QMap< QgsFeatureId, QgsGeometry > geometries;
+  QgsFeature f;
+  QgsFeatureIterator it = rl.getFeatures();
+  while ( it.nextFeature( f ) )
+    geometries.insert( f.id(), f.geometry() );
+  const QgsSpatialIndex index( rl.getFeatures() );
+
+  const QgsSnapperReferenceIndex snapperIndex( geometries.values().toVector() );
+
+  QList< QgsRectangle > searchBounds
+  {
+    QgsRectangle( 0, 0, 0, 0 ),
+    QgsRectangle( -1, -1, 1, 1 ),
+    QgsRectangle( 0, -1, 0, 1 ),
+    QgsRectangle( -1, 0, 1, 0 ),
+    QgsRectangle( 1, 1, 2, 2 ),
+    QgsRectangle( -200, -200, 200, 200 ),
+    QgsRectangle( 300, 300, 400, 400 ),
+  };
+  std::uniform_real_distribution< double > size( 0, 20 );
+  for ( int i = 0; i < 200; ++i )
+  {
+    const double x = coordinate( generator );
+    const double y = coordinate( generator );
+    searchBounds << QgsRectangle( x, y, x + size( generator ), y + size( generator ) );
+  }
+
+  for ( const QgsRectangle &bounds : std::as_const( searchBounds ) )
+  {
+    QList< QgsFeatureId > ids = index.intersects( bounds );
+    std::sort( ids.begin(), ids.end() );
+    QStringList expected;
+    for ( QgsFeatureId id : std::as_const( ids ) )
+      expected << geometries.value( id ).asWkt();
+
+    QStringList found;
+    const QList< QgsGeometry > referenceGeometries = snapperIndex.intersects( bounds );
+    for ( const QgsGeometry &geometry : referenceGeometries )
+      found << geometry.asWkt();
+
+    QCOMPARE( found, expected );
+  }
+  QVERIFY( snapperIndex.intersects( QgsRectangle( 0, 0, 0, 0 ) ).size() >= 60 );
+}
+
 
 QGSTEST_MAIN( TestQgsGeometrySnapper )
 #include "testqgsgeometrysnapper.moc"
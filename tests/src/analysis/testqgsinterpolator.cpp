@@ -20,6 +20,8 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgsidwinterpolator.h"
 #include "qgsvectorlayer.h"
 
+#include <limits>
+
 class TestQgsInterpolator : public QObject
 {
     Q_OBJECT
@@ -35,8 +37,15 @@ class TestQgsInterpolator : public QObject
 
     void TIN_IDW_Interpolator_with_attribute();
     void TIN_IDW_Interpolator_with_Z();
+    void IDW_Interpolator_neighbors();
+    void TIN_Interpolator_rows();
+    void TIN_Interpolator_break_lines();
+    void TIN_Interpolator_cocircular();
 
   private:
+
+    //! Returns a memory layer with a feature for each of the PointZ \a wkts
+    std::unique_ptr< QgsVectorLayer > createPointZLayer( const QStringList &wkts ) const;
 };
 
 void  TestQgsInterpolator::initTestCase()
@@ -57,6 +66,23 @@ void TestQgsInterpolator::cleanupTestCase()
 void TestQgsInterpolator::init()
 {}
 
+std::unique_ptr< QgsVectorLayer > TestQgsInterpolator::createPointZLayer( const QStringList &wkts ) const
+{
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "PointZ" ),
+      QStringLiteral( "point" ),
+      QStringLiteral( "memory" ) );
+
+  QgsFeatureList flist;
+  for ( const QString &wkt : wkts )
+  {
+    QgsFeature f;
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+    flist << f;
+  }
+  layer->dataProvider()->addFeatures( flist );
+  return layer;
+}
+
 void TestQgsInterpolator::cleanup()
 {}
 
@@ -441,5 +467,225 @@ void TestQgsInterpolator::TIN_IDW_Interpolator_with_attribute()
   QVERIFY( qgsDoubleNear( resutlIDW, 3.5108401084, 0.00000001 ) );
 }
 
+void TestQgsInterpolator::IDW_Interpolator_neighbors()
+{
+  std::unique_ptr<QgsVectorLayer> mLayerPoint = createPointZLayer( { QStringLiteral( "PointZ (0.0 0.0 1.0)" ), QStringLiteral( "PointZ (2.0 0.0 2.0)" ),
+                                                                     QStringLiteral( "PointZ (0.0 2.0 3.0)" ), QStringLiteral( "PointZ (2.0 2.0 4.0)" ) } );
+
+  QgsInterpolator::LayerData layerdata;
+  layerdata.source = mLayerPoint.get();
+  layerdata.valueSource = QgsInterpolator::ValueZ;
+  QList<QgsInterpolator::LayerData> layerDataList;
+  layerDataList.append( layerdata );
+
+  QgsIDWInterpolator idw( layerDataList );
+  QCOMPARE( idw.maximumNeighbors(), 0 );
+  QCOMPARE( idw.searchRadius(), 0.0 );
+  QVERIFY( idw.isThreadSafe() );
+
+  // all the points are neighbors, same result as without the spatial index
+  idw.setMaximumNeighbors( 4 );
+  QCOMPARE( idw.maximumNeighbors(), 4 );
+  double result = -1;
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 1.6176470588, 0.00000001 );
+  QCOMPARE( idw.interpolatePoint( 1, 1.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 2.94444444444, 0.00000001 );
+
+  // only the nearest point
+  idw.setMaximumNeighbors( 1 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 1.0, 0.00000001 );
+  QCOMPARE( idw.interpolatePoint( 1.6, 1.9, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 4.0, 0.00000001 );
+  // far outside of the points
+  QCOMPARE( idw.interpolatePoint( 100, -100, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 2.0, 0.00000001 );
+
+  // two nearest points, at the same distance
+  idw.setMaximumNeighbors( 2 );
+  QCOMPARE( idw.interpolatePoint( 1, 0, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 1.5, 0.00000001 );
+
+  // more neighbors than points
+  idw.setMaximumNeighbors( 10 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 1.6176470588, 0.00000001 );
+
+  // the search for neighbors ends for coordinates which are not numbers
+  QVERIFY( idw.interpolatePoint( std::numeric_limits< double >::quiet_NaN(), 0.5, result, nullptr ) != 0 );
+  QVERIFY( idw.interpolatePoint( 0.5, std::numeric_limits< double >::infinity(), result, nullptr ) != 0 );
+
+  // only the points within the search radius
+  idw.setMaximumNeighbors( 0 );
+  idw.setSearchRadius( 1.0 );
+  QCOMPARE( idw.searchRadius(), 1.0 );
+  QCOMPARE( idw.interpolatePoint( 0.5, 0.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 1.0, 0.00000001 );
+  QVERIFY( idw.interpolatePoint( 1, 1, result, nullptr ) != 0 );
+}
+
+void TestQgsInterpolator::TIN_Interpolator_rows()
+{
+  std::unique_ptr<QgsVectorLayer> mLayerPoint = createPointZLayer( { QStringLiteral( "PointZ (0.0 0.0 1.0)" ), QStringLiteral( "PointZ (2.0 0.0 2.0)" ),
+                                                                     QStringLiteral( "PointZ (0.0 2.0 3.0)" ), QStringLiteral( "PointZ (2.0 2.0 4.0)" ),
+                                                                     QStringLiteral( "PointZ (0.7 0.4 5.0)" ), QStringLiteral( "PointZ (1.3 1.1 0.0)" ),
+                                                                     QStringLiteral( "PointZ (0.4 1.6 2.5)" ), QStringLiteral( "PointZ (1.8 0.9 3.5)" ) } );
+
+  QgsInterpolator::LayerData layerdata;
+  layerdata.source = mLayerPoint.get();
+  layerdata.valueSource = QgsInterpolator::ValueZ;
+  QList<QgsInterpolator::LayerData> layerDataList;
+  layerDataList.append( layerdata );
+
+  QgsTinInterpolator tin( layerDataList );
+
+  // the rasterized rows must match the values interpolated at the cell centers
+  const int columns = 12;
+  const int rows = 12;
+  QVector< double > xCenters;
+  for ( int column = 0; column < columns; ++column )
+    xCenters << -0.5 + ( column + 0.5 ) * 0.25;
+  QVector< double > yCenters;
+  for ( int row = 0; row < rows; ++row )
+    yCenters << 2.5 - ( row + 0.5 ) * 0.25;
+  std::vector< double > values( columns * rows );
+  QVERIFY( tin.interpolateRows( xCenters, yCenters, values.data() ) );
+
+  for ( int row = 0; row < rows; ++row )
+  {
+    for ( int column = 0; column < columns; ++column )
+    {
+      double result = -1;
+      const double value = values[row * columns + column];
+      if ( tin.interpolatePoint( xCenters.at( column ), yCenters.at( row ), result, nullptr ) == 0 )
+      {
+        QGSCOMPARENEAR( value, result, 0.00000001 );
+      }
+      else
+      {
+        QVERIFY( std::isnan( value ) );
+      }
+    }
+  }
+
+  // a subset of the rows
+  std::vector< double > subsetValues( columns * 3 );
+  QVERIFY( tin.interpolateRows( xCenters, yCenters.mid( 5, 3 ), subsetValues.data() ) );
+  for ( int i = 0; i < columns * 3; ++i )
+  {
+    const double value = values[5 * columns + i];
+    if ( std::isnan( value ) )
+      QVERIFY( std::isnan( subsetValues[i] ) );
+    else
+      QGSCOMPARENEAR( subsetValues[i], value, 0.00000001 );
+  }
+}
+
+void TestQgsInterpolator::TIN_Interpolator_break_lines()
+{
+  std::unique_ptr<QgsVectorLayer> mLayerPoint = createPointZLayer( { QStringLiteral( "PointZ (0.0 0.0 0.0)" ), QStringLiteral( "PointZ (2.0 0.0 0.0)" ),
+                                                                     QStringLiteral( "PointZ (0.0 2.0 0.0)" ), QStringLiteral( "PointZ (2.0 2.0 0.0)" ) } );
+  std::unique_ptr<QgsVectorLayer>mLayerLine = std::make_unique<QgsVectorLayer>( QStringLiteral( "LineStringZ" ),
+      QStringLiteral( "line" ),
+      QStringLiteral( "memory" ) );
+
+  QgsFeature line;
+  line.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineStringZ (0.0 1.0 10.0, 2.0 1.0 10.0)" ) ) );
+  mLayerLine->dataProvider()->addFeature( line );
+
+  // the points are read before the break line, which must be inserted after them
+  QgsInterpolator::LayerData pointData;
+  pointData.source = mLayerPoint.get();
+  pointData.valueSource = QgsInterpolator::ValueZ;
+  pointData.sourceType = QgsInterpolator::SourcePoints;
+  QgsInterpolator::LayerData lineData;
+  lineData.source = mLayerLine.get();
+  lineData.valueSource = QgsInterpolator::ValueZ;
+  lineData.sourceType = QgsInterpolator::SourceBreakLines;
+  QList<QgsInterpolator::LayerData> layerDataList;
+  layerDataList << pointData << lineData;
+
+  QgsTinInterpolator tin( layerDataList );
+
+  double result = -1;
+  QCOMPARE( tin.interpolatePoint( 1, 1, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 10.0, 0.00000001 );
+  QCOMPARE( tin.interpolatePoint( 0.5, 1, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 10.0, 0.00000001 );
+  QCOMPARE( tin.interpolatePoint( 1, 0.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 5.0, 0.00000001 );
+  QCOMPARE( tin.interpolatePoint( 1.5, 1.5, result, nullptr ), 0 );
+  QGSCOMPARENEAR( result, 5.0, 0.00000001 );
+}
+
+void TestQgsInterpolator::TIN_Interpolator_cocircular()
+{
+  // The points are inserted along a Hilbert curve rather than in the order they are read. The corners of the
+  // cells of a regular grid are cocircular, so each cell may be split along either of its diagonals depending
+  // on the insertion order. The points are read in an order far from the Hilbert curve.
+  const int size = 8;
+  QStringList planeWkts;
+  QStringList saddleWkts;
+  for ( int i = 0; i < size * size; ++i )
+  {
+    const int index = ( i * 37 ) % ( size * size );
+    const int x = index % size;
+    const int y = index / size;
+    planeWkts << QStringLiteral( "PointZ (%1 %2 %3)" ).arg( x ).arg( y ).arg( 2 * x + 3 * y + 1 );
+    saddleWkts << QStringLiteral( "PointZ (%1 %2 %3)" ).arg( x ).arg( y ).arg( x * y );
+  }
+  // cocircular points on a circle of radius 3 around (3.5, 3.5), also on the plane
+  for ( int i = 0; i < 12; ++i )
+  {
+    const double x = 3.5 + 3 * std::cos( i * M_PI / 6 );
+    const double y = 3.5 + 3 * std::sin( i * M_PI / 6 );
+    planeWkts << QStringLiteral( "PointZ (%1 %2 %3)" ).arg( qgsDoubleToString( x, 12 ), qgsDoubleToString( y, 12 ), qgsDoubleToString( 2 * x + 3 * y + 1, 12 ) );
+  }
+
+  std::unique_ptr<QgsVectorLayer> planeLayer = createPointZLayer( planeWkts );
+  std::unique_ptr<QgsVectorLayer> saddleLayer = createPointZLayer( saddleWkts );
+  QCOMPARE( planeLayer->featureCount(), static_cast< long >( size * size + 12 ) );
+
+  QgsInterpolator::LayerData layerdata;
+  layerdata.source = planeLayer.get();
+  layerdata.valueSource = QgsInterpolator::ValueZ;
+  QgsTinInterpolator planeTin( QList<QgsInterpolator::LayerData>() << layerdata );
+  layerdata.source = saddleLayer.get();
+  QgsTinInterpolator saddleTin( QList<QgsInterpolator::LayerData>() << layerdata );
+
+  // whatever the triangulation, the whole hull is covered and a plane is interpolated exactly
+  for ( int i = 0; i <= 4 * ( size - 1 ); ++i )
+  {
+    for ( int j = 0; j <= 4 * ( size - 1 ); ++j )
+    {
+      const double x = i * 0.25;
+      const double y = j * 0.25;
+      double result = -1;
+      QCOMPARE( planeTin.interpolatePoint( x, y, result, nullptr ), 0 );
+      QGSCOMPARENEAR( result, 2 * x + 3 * y + 1, 0.00000001 );
+    }
+  }
+
+  // at the center of a cell, the saddle is interpolated along one of the diagonals of the cell
+  for ( int x = 0; x < size - 1; ++x )
+  {
+    for ( int y = 0; y < size - 1; ++y )
+    {
+      double result = -1;
+      QCOMPARE( saddleTin.interpolatePoint( x + 0.5, y + 0.5, result, nullptr ), 0 );
+      const double diagonal = ( x * y + ( x + 1 ) * ( y + 1 ) ) / 2.0;
+      const double antiDiagonal = ( ( x + 1 ) * y + x * ( y + 1 ) ) / 2.0;
+      QVERIFY2( qgsDoubleNear( result, diagonal, 0.00000001 ) || qgsDoubleNear( result, antiDiagonal, 0.00000001 ),
+                QStringLiteral( "%1 at %2 %3" ).arg( result ).arg( x + 0.5 ).arg( y + 0.5 ).toLocal8Bit().constData() );
+
+      // the rasterized value is the same as the interpolated one
+      std::vector< double > value( 1 );
+      QVERIFY( saddleTin.interpolateRows( QVector< double >() << x + 0.5, QVector< double >() << y + 0.5, value.data() ) );
+      QGSCOMPARENEAR( value.front(), result, 0.00000001 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsInterpolator )
 #include "testqgsinterpolator.moc"
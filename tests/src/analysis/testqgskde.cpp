@@ -0,0 +1,164 @@
+/***************************************************************************
+     testqgskde.cpp
+     --------------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+
+#include "qgsapplication.h"
+#include "qgsfeature.h"
+#include "qgsgeometry.h"
+#include "qgsvectorlayer.h"
+#include "qgskde.h"
+
+#include <QTemporaryDir>
+
+#include <random>
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the kernel density estimation class
+ */
+class TestQgsKde : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testTiledSurface();
+};
+
+void TestQgsKde::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsKde::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsKde::testTiledSurface()
+{
+  // The surface is drawn by tiles once a million points are pending. Checks a surface spanning
+  // several tiles, with more points than that, against the same points drawn one after the other.
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "MultiPoint?crs=epsg:3857&field=radius:integer&field=weight:double" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > xDistribution( 0, 1400 );
+  std::uniform_real_distribution< double > yDistribution( 0, 1100 );
+  std::uniform_int_distribution< int > radiusDistribution( 2, 6 );
+  std::uniform_real_distribution< double > weightDistribution( 0.5, 2 );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 1100; ++i )
+  {
+    QgsMultiPointXY points;
+    for ( int j = 0; j < 1000; ++j )
+      points << QgsPointXY( xDistribution( generator ), yDistribution( generator ) );
+
+    QgsFeature f( layer->fields() );
+    f.setGeometry( QgsGeometry::fromMultiPointXY( points ) );
+    f.setAttributes( QgsAttributes() << radiusDistribution( generator ) << weightDistribution( generator ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  const QTemporaryDir dir;
+  const QString outputFile = dir.filePath( QStringLiteral( "kde.tif" ) );
+
+  QgsKernelDensityEstimation::Parameters parameters;
+  parameters.source = layer.get();
+  parameters.radius = 0;
+  parameters.radiusField = QStringLiteral( "radius" );
+  parameters.weightField = QStringLiteral( "weight" );
+  parameters.pixelSize = 1;
+  parameters.shape = QgsKernelDensityEstimation::KernelQuartic;
+  parameters.decayRatio = 0;
+  parameters.outputValues = QgsKernelDensityEstimation::OutputRaw;
+
+  QgsKernelDensityEstimation kde( parameters, outputFile, QStringLiteral( "GTiff" ) );
+  QCOMPARE( kde.prepare(), QgsKernelDensityEstimation::Success );
+  for ( const QgsFeature &f : std::as_const( features ) )
+    QCOMPARE( kde.addFeature( f ), QgsKernelDensityEstimation::Success );
+  QCOMPARE( kde.finalise(), QgsKernelDensityEstimation::Success );
+
+  // the bounds are the extent of the points, grown by the largest radius
+  QgsRectangle bounds = layer->sourceExtent();
+  bounds.grow( layer->maximumValue( 0 ).toInt() );
+  const int rows = static_cast< int >( std::ceil( bounds.height() ) ) + 1;
+  const int columns = static_cast< int >( std::ceil( bounds.width() ) ) + 1;
+  QVERIFY( rows > 1024 );
+  QVERIFY( columns > 1024 );
+
+  gdal::dataset_unique_ptr dataset( GDALOpen( outputFile.toUtf8().constData(), GA_ReadOnly ) );
+  QVERIFY( dataset );
+  QCOMPARE( GDALGetRasterXSize( dataset.get() ), columns );
+  QCOMPARE( GDALGetRasterYSize( dataset.get() ), rows );
+  std::vector< float > values( static_cast< std::size_t >( rows ) * columns );
+  QCOMPARE( GDALRasterIO( GDALGetRasterBand( dataset.get(), 1 ), GF_Read, 0, 0, columns, rows,
+                          values.data(), columns, rows, GDT_Float32, 0, 0 ), CE_None );
+
+  // draw the points one after the other, with the pixel placement and accumulation of the raster
+  std::vector< float > expected( values.size(), -9999 );
+  for ( const QgsFeature &f : std::as_const( features ) )
+  {
+    const int radius = f.attribute( 0 ).toInt();
+    const double weight = f.attribute( 1 ).toDouble();
+    const int blockSize = 2 * radius + 1;
+    const QgsMultiPointXY points = f.geometry().asMultiPoint();
+    for ( const QgsPointXY &point : points )
+    {
+      const int xPosition = static_cast< int >( ( point.x() - bounds.xMinimum() ) - radius );
+      const int yPosition = static_cast< int >( ( point.y() - bounds.yMinimum() ) - radius );
+      const int yPositionIO = static_cast< int >( ( bounds.yMaximum() - point.y() ) - radius );
+      for ( int xp = 0; xp < blockSize; ++xp )
+      {
+        for ( int yp = 0; yp < blockSize; ++yp )
+        {
+          if ( xPosition + xp >= columns || yPositionIO + yp >= rows )
+            continue;
+
+          const double pixelCentroidX = ( xPosition + xp + 0.5 ) + bounds.xMinimum();
+          const double pixelCentroidY = ( yPosition + yp + 0.5 ) + bounds.yMinimum();
+          const double distance = std::sqrt( std::pow( pixelCentroidX - point.x(), 2.0 ) + std::pow( pixelCentroidY - point.y(), 2.0 ) );
+          if ( distance > radius )
+            continue;
+
+          float &pixel = expected[ static_cast< std::size_t >( yPositionIO + yp ) * columns + xPosition + xp ];
+          if ( pixel == -9999 )
+            pixel = 0;
+          pixel += weight * std::pow( 1. - std::pow( distance / radius, 2 ), 2 );
+        }
+      }
+    }
+  }
+
+  int differences = 0;
+  for ( std::size_t i = 0; i < values.size(); ++i )
+  {
+    if ( !qgsDoubleNear( values[i], expected[i], 1e-4 ) )
+    {
+      if ( differences++ < 10 )
+        qDebug() << "pixel" << i % columns << i / columns << values[i] << "expected" << expected[i];
+    }
+  }
+  QCOMPARE( differences, 0 );
+}
+
+QGSTEST_MAIN( TestQgsKde )
+#include "testqgskde.moc"
@@ -29,6 +29,8 @@
 #include "qgsalgorithmimportphotos.h"
 #include "qgsalgorithmtransform.h"
 #include "qgsalgorithmkmeansclustering.h"
+#include "qgsalgorithmdbscanclustering.h"
+#include "qgsalgorithmjoinbylocation.h"
 #include "qgsvectorlayer.h"
 #include "qgscategorizedsymbolrenderer.h"
 #include "qgssinglesymbolrenderer.h"
@@ -61,6 +63,10 @@
 #include "qgsmarkersymbol.h"
 #include "qgsfillsymbol.h"
 
+#include <QThreadPool>
+
+#include <random>
+
 class TestQgsProcessingAlgs: public QObject
 {
     Q_OBJECT
@@ -91,11 +97,19 @@ class TestQgsProcessingAlgs: public QObject
     void featureFilterAlg();
     void transformAlg();
     void kmeansCluster();
+    void kmeansClusterChunks();
+    void dbscanCluster();
     void categorizeByStyle();
     void extractBinary();
     void exportLayersInformationAlg();
     void createDirectory();
     void flattenRelations();
+    void dissolveSortedInput();
+    void dissolveAllBlocks();
+    void overlayBatches();
+    void countPointsInPolygon();
+    void joinByLocation();
+    void joinByLocationPoints();
 
     void polygonsToLines_data();
     void polygonsToLines();
@@ -1078,6 +1092,207 @@ void TestQgsProcessingAlgs::kmeansCluster()
   QCOMPARE( features[ 2 ].cluster, -1 );
 }
 
+void TestQgsProcessingAlgs::kmeansClusterChunks()
+{
+  // more points than the 2^16 points of a chunk, in blobs and uniformly spread, with coincident points
+  std::vector< QgsKMeansClusteringAlgorithm::Feature > features;
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > coordinate( 0, 1000 );
+  std::normal_distribution< double > spread( 0, 20 );
+  for ( int blob = 0; blob < 12; ++blob )
+  {
+    const double x = coordinate( generator );
+    const double y = coordinate( generator );
+    for ( int i = 0; i < 10000; ++i )
+      features.emplace_back( QgsKMeansClusteringAlgorithm::Feature( QgsPointXY( x + spread( generator ), y + spread( generator ) ) ) );
+  }
+  for ( int i = 0; i < 60000; ++i )
+    features.emplace_back( QgsKMeansClusteringAlgorithm::Feature( QgsPointXY( coordinate( generator ), coordinate( generator ) ) ) );
+  for ( int i = 0; i < 3000; ++i )
+  {
+    const QgsPointXY point = features.at( static_cast< std::size_t >( i ) * 61 ).point;
+    features.emplace_back( QgsKMeansClusteringAlgorithm::Feature( point ) );
+  }
+  QVERIFY( features.size() > 2 * ( 1 << 16 ) );
+
+  const int k = 9;
+  std::vector< QgsPointXY > centers( k );
+  QgsKMeansClusteringAlgorithm::initClusters( features, centers, k, nullptr );
+
+  // each iteration assigns the points to the same centers as a full scan of the centers,
+  // and moves the centers to the means of their points
+  std::vector< uint > weights( k );
+  bool changed = true;
+  for ( int iteration = 0; iteration < 50 && changed; ++iteration )
+  {
+    std::vector< int > expectedClusters( features.size() );
+    bool expectedChanged = false;
+    for ( std::size_t i = 0; i < features.size(); ++i )
+    {
+      int nearest = 0;
+      double nearestDistance = features[i].point.sqrDist( centers[0] );
+      for ( int cluster = 1; cluster < k; ++cluster )
+      {
+        const double distance = features[i].point.sqrDist( centers[cluster] );
+        if ( distance < nearestDistance )
+        {
+          nearest = cluster;
+          nearestDistance = distance;
+        }
+      }
+      expectedClusters[i] = nearest;
+      expectedChanged |= features[i].cluster != nearest;
+    }
+
+    QgsKMeansClusteringAlgorithm::findNearest( features, centers, k, changed );
+    QCOMPARE( changed, expectedChanged );
+    for ( std::size_t i = 0; i < features.size(); ++i )
+    {
+      if ( features[i].cluster != expectedClusters[i] )
+        QFAIL( QStringLiteral( "point %1 assigned to %2 instead of %3 at iteration %4" ).arg( i ).arg( features[i].cluster ).arg( expectedClusters[i] ).arg( iteration ).toLocal8Bit().constData() );
+    }
+
+    // the chunks are summed separately, so the means may only differ from a sequential sum by rounding
+    std::vector< QgsVector > sums( k );
+    std::vector< uint > counts( k, 0 );
+    for ( const QgsKMeansClusteringAlgorithm::Feature &feature : features )
+    {
+      sums[feature.cluster] += QgsVector( feature.point.x(), feature.point.y() );
+      counts[feature.cluster]++;
+    }
+    QgsKMeansClusteringAlgorithm::updateMeans( features, centers, weights, k );
+    for ( int cluster = 0; cluster < k; ++cluster )
+    {
+      QCOMPARE( weights[cluster], counts[cluster] );
+      QGSCOMPARENEAR( centers[cluster].x(), sums[cluster].x() / counts[cluster], 1e-6 );
+      QGSCOMPARENEAR( centers[cluster].y(), sums[cluster].y() / counts[cluster], 1e-6 );
+    }
+  }
+}
+
+void TestQgsProcessingAlgs::dbscanCluster()
+{
+  // sequential DBSCAN, expanding the clusters one at a time in the order of the points
+  auto sequentialDbscan = []( std::size_t minSize, double eps, bool borderPointsAreNoise, const std::vector< QgsDbscanClusteringAlgorithm::Point > &points )
+  {
+    auto neighbors = [&points, eps]( std::size_t point )
+    {
+      std::vector< std::size_t > result;
+      for ( std::size_t i = 0; i < points.size(); ++i )
+      {
+        const double dx = points[i].x - points[point].x;
+        const double dy = points[i].y - points[point].y;
+        if ( dx * dx + dy * dy <= eps * eps )
+          result.push_back( i );
+      }
+      return result;
+    };
+
+    std::unordered_map< QgsFeatureId, int > idToCluster;
+    std::vector< bool > visited( points.size(), false );
+    int clusterCount = 0;
+    for ( std::size_t i = 0; i < points.size(); ++i )
+    {
+      if ( visited[i] )
+        continue;
+
+      std::vector< std::size_t > within = neighbors( i );
+      if ( within.size() < minSize )
+        continue;
+
+      clusterCount++;
+      while ( !within.empty() )
+      {
+        const std::size_t j = within.back();
+        within.pop_back();
+        if ( visited[j] )
+          continue;
+        visited[j] = true;
+
+        const std::vector< std::size_t > within2 = neighbors( j );
+        if ( within2.size() >= minSize )
+        {
+          for ( std::size_t k : within2 )
+          {
+            if ( !visited[k] )
+              within.push_back( k );
+          }
+        }
+        if ( !borderPointsAreNoise || within2.size() >= minSize )
+          idToCluster[ points[j].id ] = clusterCount;
+      }
+    }
+    return idToCluster;
+  };
+
+  // dense blobs, sparse points and coincident points, over many more cells than threads
+  std::vector< QgsDbscanClusteringAlgorithm::Point > points;
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution< double > coordinate( 0, 100 );
+  std::normal_distribution< double > spread( 0, 1.5 );
+  for ( int blob = 0; blob < 30; ++blob )
+  {
+    const double x = coordinate( generator );
+    const double y = coordinate( generator );
+    for ( int i = 0; i < 60; ++i )
+      points.push_back( { static_cast< QgsFeatureId >( points.size() ), x + spread( generator ), y + spread( generator ) } );
+  }
+  for ( int i = 0; i < 1000; ++i )
+    points.push_back( { static_cast< QgsFeatureId >( points.size() ), coordinate( generator ), coordinate( generator ) } );
+  for ( int i = 0; i < 300; ++i )
+  {
+    const QgsDbscanClusteringAlgorithm::Point &point = points.at( static_cast< std::size_t >( i ) * 7 );
+    points.push_back( { static_cast< QgsFeatureId >( points.size() ), point.x, point.y } );
+  }
+
+  QgsProcessingFeedback feedback;
+  const QList< std::tuple< std::size_t, double, bool > > settings
+  {
+    std::make_tuple( 5, 1.0, false ),
+    std::make_tuple( 5, 1.0, true ),
+    std::make_tuple( 12, 0.8, false ),
+    std::make_tuple( 1, 0.5, false ),
+    std::make_tuple( 3, 2.5, false ),
+    std::make_tuple( 2, 0.0, false ),
+    std::make_tuple( 2, 0.0, true ),
+  };
+  for ( const std::tuple< std::size_t, double, bool > &setting : settings )
+  {
+    const std::size_t minSize = std::get< 0 >( setting );
+    const double eps = std::get< 1 >( setting );
+    const bool borderPointsAreNoise = std::get< 2 >( setting );
+
+    const std::unordered_map< QgsFeatureId, int > expected = sequentialDbscan( minSize, eps, borderPointsAreNoise, points );
+    std::unordered_map< QgsFeatureId, int > idToCluster;
+    QgsDbscanClusteringAlgorithm::dbscan( minSize, eps, borderPointsAreNoise, points, idToCluster, &feedback );
+
+    QCOMPARE( idToCluster.size(), expected.size() );
+    for ( const QgsDbscanClusteringAlgorithm::Point &point : points )
+    {
+      const auto expectedCluster = expected.find( point.id );
+      const auto cluster = idToCluster.find( point.id );
+      QCOMPARE( cluster == idToCluster.end(), expectedCluster == expected.end() );
+      if ( cluster != idToCluster.end() )
+        QCOMPARE( cluster->second, expectedCluster->second );
+    }
+  }
+
+  // groups of points 2^32 cells away from each other are not in the same cell
+  const double farX = 4294967296.0 / M_SQRT2;
+  points.clear();
+  for ( int i = 0; i < 3; ++i )
+  {
+    points.push_back( { static_cast< QgsFeatureId >( points.size() ), 0.1 * i, 0 } );
+    points.push_back( { static_cast< QgsFeatureId >( points.size() ), farX + 0.1 * ( i + 1 ), 0 } );
+  }
+  std::unordered_map< QgsFeatureId, int > idToCluster;
+  QgsDbscanClusteringAlgorithm::dbscan( 4, 1, false, points, idToCluster, &feedback );
+  QVERIFY( idToCluster.empty() );
+  QgsDbscanClusteringAlgorithm::dbscan( 3, 1, false, points, idToCluster, &feedback );
+  QCOMPARE( idToCluster.size(), static_cast< std::size_t >( 6 ) );
+  QCOMPARE( idToCluster[0], 1 );
+  QCOMPARE( idToCluster[1], 2 );
+}
 void TestQgsProcessingAlgs::categorizeByStyle()
 {
   std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:categorizeusingstyle" ) ) );
@@ -1389,6 +1604,559 @@ void TestQgsProcessingAlgs::flattenRelations()
 }
 
 
+void TestQgsProcessingAlgs::dissolveSortedInput()
+{
+  QgsProject p;
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:4326&field=grp:string" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  p.addMapLayer( layer );
+
+  // enough adjacent squares in the first group for a cascaded union with several levels
+  QgsFeatureList features;
+  auto addSquare = [&features]( const QString & group, int x )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << group );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, 0, x + 1, 1 ) ) );
+    features << f;
+  };
+  for ( int x = 0; x < 600; ++x )
+    addSquare( QStringLiteral( "a" ), x );
+  for ( int x = 0; x < 10; ++x )
+    addSquare( QStringLiteral( "b" ), x );
+  addSquare( QStringLiteral( "a" ), 1000 );
+  layer->dataProvider()->addFeatures( features );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer ) );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "grp" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  bool ok = false;
+  QgsProcessingFeedback feedback;
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 2L );
+  QMap< QString, double > areas;
+  QgsFeature f;
+  QgsFeatureIterator it = outputLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+    areas.insert( f.attribute( 0 ).toString(), f.geometry().area() );
+  QGSCOMPARENEAR( areas.value( QStringLiteral( "a" ) ), 601, 0.000001 );
+  QGSCOMPARENEAR( areas.value( QStringLiteral( "b" ) ), 10, 0.000001 );
+
+  // with sorted input, the last feature starts a new group
+  parameters.insert( QStringLiteral( "SORTED_INPUT" ), true );
+  results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 3L );
+  QList< double > sortedAreas;
+  QStringList groups;
+  it = outputLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    groups << f.attribute( 0 ).toString();
+    sortedAreas << f.geometry().area();
+  }
+  QCOMPARE( groups, QStringList() << QStringLiteral( "a" ) << QStringLiteral( "b" ) << QStringLiteral( "a" ) );
+  QGSCOMPARENEAR( sortedAreas.at( 0 ), 600, 0.000001 );
+  QGSCOMPARENEAR( sortedAreas.at( 1 ), 10, 0.000001 );
+  QGSCOMPARENEAR( sortedAreas.at( 2 ), 1, 0.000001 );
+  // adjacent squares are dissolved into a single polygon
+  QCOMPARE( outputLayer->getFeature( 1 ).geometry().constGet()->partCount(), 1 );
+}
+
+void TestQgsProcessingAlgs::countPointsInPolygon()
+{
+  QgsProject p;
+  QgsVectorLayer *polygons = new QgsVectorLayer( QStringLiteral( "MultiPolygon?crs=epsg:3857" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( polygons->isValid() );
+  p.addMapLayer( polygons );
+
+  const QStringList polygonWkts
+  {
+    // a square with a hole
+    QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0),(4 4, 6 4, 6 6, 4 6, 4 4))" ),
+    // sloped edges
+    QStringLiteral( "Polygon((20 0, 30 0, 25 10, 20 0))" ),
+    QStringLiteral( "MultiPolygon(((40 0, 42 0, 42 2, 40 2, 40 0)),((44 0, 46 0, 46 2, 44 2, 44 0)))" ),
+    // bounds far larger than the grid of the points, and far away from it
+    QStringLiteral( "Polygon((-1e20 -1e20, 1e20 -1e20, 1e20 1e20, -1e20 1e20, -1e20 -1e20))" ),
+    QStringLiteral( "Polygon((1e20 1e20, 2e20 1e20, 2e20 2e20, 1e20 2e20, 1e20 1e20))" ),
+  };
+  QgsFeatureList polygonFeatures;
+  for ( const QString &wkt : polygonWkts )
+  {
+    QgsFeature f;
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+    polygonFeatures << f;
+  }
+  polygons->dataProvider()->addFeatures( polygonFeatures );
+
+  // the same polygons with curved rings, which are only tested by the geometry engine
+  QgsVectorLayer *curvedPolygons = new QgsVectorLayer( QStringLiteral( "MultiSurface?crs=epsg:3857" ), QStringLiteral( "curved" ), QStringLiteral( "memory" ) );
+  QVERIFY( curvedPolygons->isValid() );
+  p.addMapLayer( curvedPolygons );
+  for ( QgsFeature &f : polygonFeatures )
+    f.setGeometry( QgsGeometry( f.geometry().constGet()->toCurveType() ) );
+  curvedPolygons->dataProvider()->addFeatures( polygonFeatures );
+
+  const QList< QgsPointXY > pointCoordinates
+  {
+    // interior of the square
+    QgsPointXY( 2, 2 ), QgsPointXY( 3, 5 ), QgsPointXY( 7, 8 ), QgsPointXY( 2, 2 ),
+    // on vertices
+    QgsPointXY( 0, 0 ), QgsPointXY( 10, 10 ), QgsPointXY( 4, 4 ), QgsPointXY( 25, 10 ),
+    // on horizontal edges, of the exterior ring and of the hole
+    QgsPointXY( 5, 0 ), QgsPointXY( 5, 10 ), QgsPointXY( 5, 4 ), QgsPointXY( 4.5, 6 ), QgsPointXY( 25, 0 ),
+    // on vertical and sloped edges
+    QgsPointXY( 0, 5 ), QgsPointXY( 6, 5 ), QgsPointXY( 22.5, 5 ),
+    // in the hole
+    QgsPointXY( 5, 5 ), QgsPointXY( 4.5, 5.5 ),
+    // interior of the triangle and of the parts
+    QgsPointXY( 25, 5 ), QgsPointXY( 25, 0.5 ), QgsPointXY( 41, 1 ), QgsPointXY( 45, 1 ),
+    // between the parts
+    QgsPointXY( 43, 1 ),
+  };
+
+  auto createPointLayer = [&p, &pointCoordinates]( bool multipoint )
+  {
+    QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "%1?crs=epsg:3857&field=weight:double&field=class:string" ).arg( multipoint ? QStringLiteral( "MultiPoint" ) : QStringLiteral( "Point" ) ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+    p.addMapLayer( layer );
+    QgsFeatureList features;
+    for ( int i = 0; i < pointCoordinates.size(); ++i )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << i + 1 << ( i % 3 == 0 ? QStringLiteral( "a" ) : QStringLiteral( "b" ) ) );
+      const QgsGeometry point = QgsGeometry::fromPointXY( pointCoordinates.at( i ) );
+      f.setGeometry( multipoint ? QgsGeometry::fromMultiPointXY( QgsMultiPointXY() << pointCoordinates.at( i ) ) : point );
+      features << f;
+    }
+    layer->dataProvider()->addFeatures( features );
+    return layer;
+  };
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:countpointsinpolygon" ) ) );
+  QVERIFY( alg != nullptr );
+
+  auto countPoints = [&alg]( QgsVectorLayer * polygonLayer, QgsVectorLayer * pointLayer, const QString & weightField, const QString & classField )
+  {
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "POLYGONS" ), QVariant::fromValue( polygonLayer ) );
+    parameters.insert( QStringLiteral( "POINTS" ), QVariant::fromValue( pointLayer ) );
+    parameters.insert( QStringLiteral( "WEIGHT" ), weightField );
+    parameters.insert( QStringLiteral( "CLASSFIELD" ), classField );
+    parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "NUMPOINTS" ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    bool ok = false;
+    QgsProcessingFeedback feedback;
+    QgsProcessingContext context;
+    const QVariantMap results = alg->run( parameters, context, &feedback, &ok );
+    QList< double > counts;
+    if ( !ok )
+      return counts;
+
+    QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+    QgsFeature f;
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    while ( it.nextFeature( f ) )
+      counts << f.attribute( QStringLiteral( "NUMPOINTS" ) ).toDouble();
+    return counts;
+  };
+
+  // multipoints are requested for each polygon and tested by the geometry engine
+  QgsVectorLayer *multipoints = createPointLayer( true );
+  const QList< double > expected { 4, 2, 2, static_cast< double >( pointCoordinates.size() ), 0 };
+  QCOMPARE( countPoints( polygons, multipoints, QString(), QString() ), expected );
+  const QList< double > expectedWeights = countPoints( polygons, multipoints, QStringLiteral( "weight" ), QString() );
+  QCOMPARE( expectedWeights.at( 0 ), 1.0 + 2 + 3 + 4 );
+  const QList< double > expectedClasses = countPoints( polygons, multipoints, QString(), QStringLiteral( "class" ) );
+  QCOMPARE( expectedClasses.at( 0 ), 2.0 );
+
+  // single points without spatial index are loaded before the first polygon, with one the requests
+  // for each polygon are used until they have returned as many points as the layer holds
+  QgsVectorLayer *points = createPointLayer( false );
+  QgsVectorLayer *indexedPoints = createPointLayer( false );
+  QVERIFY( indexedPoints->dataProvider()->createSpatialIndex() );
+  for ( QgsVectorLayer *pointLayer : { points, indexedPoints } )
+  {
+    for ( QgsVectorLayer *polygonLayer : { polygons, curvedPolygons } )
+    {
+      QCOMPARE( countPoints( polygonLayer, pointLayer, QString(), QString() ), expected );
+      QCOMPARE( countPoints( polygonLayer, pointLayer, QStringLiteral( "weight" ), QString() ), expectedWeights );
+      QCOMPARE( countPoints( polygonLayer, pointLayer, QString(), QStringLiteral( "class" ) ), expectedClasses );
+    }
+  }
+}
+
+void TestQgsProcessingAlgs::joinByLocation()
+{
+  QgsProject p;
+  QgsVectorLayer *input = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:3857&field=id:integer" ), QStringLiteral( "input" ), QStringLiteral( "memory" ) );
+  QVERIFY( input->isValid() );
+  p.addMapLayer( input );
+  QgsVectorLayer *join = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:3857&field=jid:integer" ), QStringLiteral( "join" ), QStringLiteral( "memory" ) );
+  QVERIFY( join->isValid() );
+  p.addMapLayer( join );
+
+  // a row of squares, the last ones beyond the join polygons, features without geometry and a feature far away
+  QgsFeatureList features;
+  auto addFeature = [&features]( int id, const QgsGeometry & geometry )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << id );
+    f.setGeometry( geometry );
+    features << f;
+  };
+  for ( int i = 0; i < 35; ++i )
+  {
+    addFeature( features.size(), QgsGeometry::fromRect( QgsRectangle( i, 0, i + 0.8, 0.8 ) ) );
+    if ( i == 10 || i == 20 )
+      addFeature( features.size(), QgsGeometry() );
+  }
+  addFeature( features.size(), QgsGeometry::fromRect( QgsRectangle( 100, 100, 101, 101 ) ) );
+  input->dataProvider()->addFeatures( features );
+
+  // overlapping join polygons, so that some input features match several of them with different overlaps
+  features.clear();
+  for ( int j = 0; j < 8; ++j )
+    addFeature( j, QgsGeometry::fromRect( QgsRectangle( 4 * j - 0.5, -1, 4 * j + 4.5, 1 ) ) );
+  addFeature( 8, QgsGeometry::fromRect( QgsRectangle( 2.1, 0.1, 2.3, 0.3 ) ) );
+  join->dataProvider()->addFeatures( features );
+  QVERIFY( join->featureCount() <= input->featureCount() );
+
+  // returns the id and joined id of the output features, the non-matching ids and the joined count
+  auto runJoin = [input, join]( int method, bool discardNonMatching, bool useJoinIndex, QVector< std::pair< int, int > > &joined, QVector< int > &nonMatching ) -> long long
+  {
+    std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:joinattributesbylocation" ) ) );
+    if ( !useJoinIndex )
+      static_cast< QgsJoinByLocationAlgorithm * >( alg.get() )->mMaxIndexedJoinFeatures = 0;
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( input ) );
+    parameters.insert( QStringLiteral( "JOIN" ), QVariant::fromValue( join ) );
+    parameters.insert( QStringLiteral( "PREDICATE" ), QVariantList() << 0 );
+    parameters.insert( QStringLiteral( "METHOD" ), method );
+    parameters.insert( QStringLiteral( "DISCARD_NONMATCHING" ), discardNonMatching );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+    parameters.insert( QStringLiteral( "NON_MATCHING" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    QgsProcessingFeedback feedback;
+    QgsProcessingContext context;
+    joined.clear();
+    nonMatching.clear();
+    if ( !alg->prepare( parameters, context, &feedback ) )
+      return -1;
+    const QVariantMap results = alg->runPrepared( parameters, context, &feedback );
+
+    QgsFeature f;
+    QgsFeatureIterator it = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) )->getFeatures();
+    while ( it.nextFeature( f ) )
+      joined.append( std::make_pair( f.attribute( QStringLiteral( "id" ) ).toInt(), f.attribute( QStringLiteral( "jid" ) ).isNull() ? -1 : f.attribute( QStringLiteral( "jid" ) ).toInt() ) );
+    it = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "NON_MATCHING" ) ).toString() ) )->getFeatures();
+    while ( it.nextFeature( f ) )
+      nonMatching.append( f.attribute( QStringLiteral( "id" ) ).toInt() );
+    return results.value( QStringLiteral( "JOINED_COUNT" ) ).toLongLong();
+  };
+
+  for ( int method = 0; method < 3; ++method )
+  {
+    for ( bool discardNonMatching : { false, true } )
+    {
+      QVector< std::pair< int, int > > joined;
+      QVector< int > nonMatching;
+      const long long joinedCount = runJoin( method, discardNonMatching, true, joined, nonMatching );
+      QVector< std::pair< int, int > > previousJoined;
+      QVector< int > previousNonMatching;
+      const long long previousJoinedCount = runJoin( method, discardNonMatching, false, previousJoined, previousNonMatching );
+      QVERIFY( joinedCount > 0 );
+
+      // the previous path iterating over the join features writes the matches grouped by join feature
+      // and the non-matching features last, in no specific order: the indexed path writes the same features
+      // in the order of the input, with the matches of each input feature in the order of the join layer
+      std::stable_sort( previousJoined.begin(), previousJoined.end(), []( const std::pair< int, int > &a, const std::pair< int, int > &b )
+      {
+        return a.first < b.first;
+      } );
+      std::sort( previousNonMatching.begin(), previousNonMatching.end() );
+
+      QCOMPARE( joined, previousJoined );
+      QCOMPARE( nonMatching, previousNonMatching );
+      QCOMPARE( joinedCount, previousJoinedCount );
+      QCOMPARE( nonMatching, QVector< int >() << 11 << 22 << 35 << 36 << 37 );
+    }
+  }
+
+  // input feature 3 overlaps the join polygons 0 and 1, 2 contains the join polygon 8
+  QVector< std::pair< int, int > > joined;
+  QVector< int > nonMatching;
+  QCOMPARE( runJoin( 0, true, true, joined, nonMatching ), 48LL );
+  QCOMPARE( joined.mid( 2, 3 ), QVector< std::pair< int, int > >() << std::make_pair( 2, 0 ) << std::make_pair( 2, 8 ) << std::make_pair( 3, 0 ) );
+  QCOMPARE( joined.at( 5 ), std::make_pair( 3, 1 ) );
+  QCOMPARE( runJoin( 1, true, true, joined, nonMatching ), 33LL );
+  QCOMPARE( joined.at( 3 ), std::make_pair( 3, 0 ) );
+  QCOMPARE( runJoin( 2, true, true, joined, nonMatching ), 33LL );
+  QCOMPARE( joined.at( 2 ), std::make_pair( 2, 0 ) );
+  QCOMPARE( joined.at( 3 ), std::make_pair( 3, 0 ) );
+  QCOMPARE( joined.at( 4 ), std::make_pair( 4, 1 ) );
+}
+
+void TestQgsProcessingAlgs::joinByLocationPoints()
+{
+  QgsProject p;
+  QgsVectorLayer *input = new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "input" ), QStringLiteral( "memory" ) );
+  QVERIFY( input->isValid() );
+  p.addMapLayer( input );
+  QgsVectorLayer *join = new QgsVectorLayer( QStringLiteral( "MultiPolygon?crs=epsg:3857&field=jid:integer" ), QStringLiteral( "join" ), QStringLiteral( "memory" ) );
+  QVERIFY( join->isValid() );
+  p.addMapLayer( join );
+
+  // a grid of points, some of them on the vertices and segments of the join polygons
+  QgsFeatureList features;
+  for ( int y = -4; y <= 44; ++y )
+  {
+    for ( int x = -4; x <= 44; ++x )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << features.size() );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( x * 0.25, y * 0.25 ) ) );
+      features << f;
+    }
+  }
+  input->dataProvider()->addFeatures( features );
+
+  // a polygon with a hole, a slanted multipolygon and a circle with too many vertices to be walked
+  features.clear();
+  const QStringList wkts
+  {
+    QStringLiteral( "MultiPolygon(((0 0, 4 0, 4 4, 0 4, 0 0),(1 1, 1 2, 2 2, 2 1, 1 1)))" ),
+    QStringLiteral( "MultiPolygon(((3 3, 7 4, 6 8, 3 3)),((8 0, 10 0, 10 1.5, 8 0)))" ),
+    QStringLiteral( "MultiPolygon(((2 6, 5.25 9.5, 2 9.5, 2 6)))" ),
+  };
+  for ( const QString &wkt : wkts )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << features.size() );
+    f.setGeometry( QgsGeometry::fromWkt( wkt ) );
+    features << f;
+  }
+  QgsFeature circle;
+  circle.setAttributes( QgsAttributes() << features.size() );
+  circle.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 7, 7 ) ).buffer( 3, 100 ) );
+  QVERIFY( circle.geometry().constGet()->nCoordinates() > 256 );
+  features << circle;
+  join->dataProvider()->addFeatures( features );
+
+  // returns the id and joined id of the output features, ordered by id
+  auto runJoin = [input, join]( int predicate, bool useJoinIndex )
+  {
+    std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:joinattributesbylocation" ) ) );
+    if ( !useJoinIndex )
+      static_cast< QgsJoinByLocationAlgorithm * >( alg.get() )->mMaxIndexedJoinFeatures = 0;
+
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( input ) );
+    parameters.insert( QStringLiteral( "JOIN" ), QVariant::fromValue( join ) );
+    parameters.insert( QStringLiteral( "PREDICATE" ), QVariantList() << predicate );
+    parameters.insert( QStringLiteral( "METHOD" ), 0 );
+    parameters.insert( QStringLiteral( "DISCARD_NONMATCHING" ), true );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    QgsProcessingFeedback feedback;
+    QgsProcessingContext context;
+    bool ok = false;
+    const QVariantMap results = alg->run( parameters, context, &feedback, &ok );
+
+    QVector< std::pair< int, int > > joined;
+    QgsFeature f;
+    QgsFeatureIterator it = qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) )->getFeatures();
+    while ( it.nextFeature( f ) )
+      joined.append( std::make_pair( f.attribute( QStringLiteral( "id" ) ).toInt(), f.attribute( QStringLiteral( "jid" ) ).toInt() ) );
+    std::sort( joined.begin(), joined.end() );
+    return joined;
+  };
+
+  // the points located in the polygons, or left to GEOS on their boundaries, match as with the prepared engines
+  for ( int predicate = 0; predicate < 7; ++predicate )
+  {
+    const QVector< std::pair< int, int > > joined = runJoin( predicate, true );
+    QCOMPARE( joined, runJoin( predicate, false ) );
+    if ( predicate == 0 || predicate == 3 || predicate == 5 )
+      QVERIFY( !joined.isEmpty() );
+  }
+
+  // the point ( 1.5, 1.5 ) is in the hole of the first polygon, ( 1, 1 ) on its boundary and ( 0.5, 0.5 ) inside
+  auto pointId = []( int x, int y )
+  {
+    return ( y + 4 ) * 49 + x + 4;
+  };
+  const QVector< std::pair< int, int > > within = runJoin( 5, true );
+  QVERIFY( !within.contains( std::make_pair( pointId( 6, 6 ), 0 ) ) );
+  QVERIFY( !within.contains( std::make_pair( pointId( 4, 4 ), 0 ) ) );
+  QVERIFY( within.contains( std::make_pair( pointId( 2, 2 ), 0 ) ) );
+  QVERIFY( runJoin( 3, true ).contains( std::make_pair( pointId( 4, 4 ), 0 ) ) );
+}
+
+void TestQgsProcessingAlgs::dissolveAllBlocks()
+{
+  QgsProject p;
+  QgsVectorLayer *layer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:4326&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  p.addMapLayer( layer );
+
+  // a grid of adjacent squares, dissolved by several blocks of 10000 geometries whose results are merged
+  QgsFeatureList features;
+  for ( int y = 0; y < 100; ++y )
+  {
+    for ( int x = 0; x < 250; ++x )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << features.size() );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      features << f;
+    }
+  }
+  layer->dataProvider()->addFeatures( features );
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  bool ok = false;
+  QgsProcessingFeedback feedback;
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+
+  const QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 1L );
+  const QgsFeature f = outputLayer->getFeature( 1 );
+  QCOMPARE( f.attribute( 0 ).toInt(), 0 );
+  QGSCOMPARENEAR( f.geometry().area(), 25000, 0.000001 );
+  QCOMPARE( f.geometry().constGet()->partCount(), 1 );
+  QCOMPARE( f.geometry().boundingBox(), QgsRectangle( 0, 0, 250, 100 ) );
+}
+
+void TestQgsProcessingAlgs::overlayBatches()
+{
+  // the features of the input are overlaid in parallel batches, whose size depends on the thread count
+  QgsProject p;
+  QgsVectorLayer *inputLayer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:4326&field=a:integer" ), QStringLiteral( "input" ), QStringLiteral( "memory" ) );
+  QgsVectorLayer *overlayLayer = new QgsVectorLayer( QStringLiteral( "Polygon?crs=epsg:4326&field=b:integer" ), QStringLiteral( "overlay" ), QStringLiteral( "memory" ) );
+  QVERIFY( inputLayer->isValid() );
+  QVERIFY( overlayLayer->isValid() );
+  p.addMapLayers( QList< QgsMapLayer * >() << inputLayer << overlayLayer );
+
+  std::mt19937 generator( 7 );
+  std::uniform_real_distribution< double > position( 0, 100 );
+  std::uniform_real_distribution< double > size( 1, 15 );
+  QgsFeatureList features;
+  for ( int i = 0; i < 1000; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    const double x = position( generator );
+    const double y = position( generator );
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + size( generator ), y + size( generator ) ) ) );
+    features << f;
+  }
+  // a feature without geometry is kept by the difference
+  QgsFeature noGeometry;
+  noGeometry.setAttributes( QgsAttributes() << 1000 );
+  features << noGeometry;
+  inputLayer->dataProvider()->addFeatures( features );
+
+  features.clear();
+  for ( int i = 0; i < 100; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    const QgsPointXY center( position( generator ), position( generator ) );
+    f.setGeometry( QgsGeometry::fromPointXY( center ).buffer( size( generator ), 8 ) );
+    features << f;
+  }
+  overlayLayer->dataProvider()->addFeatures( features );
+
+  auto runOverlay = [inputLayer, overlayLayer]( const QString & algorithm )
+  {
+    std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( algorithm ) );
+    QVariantMap parameters;
+    parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( inputLayer ) );
+    parameters.insert( QStringLiteral( "OVERLAY" ), QVariant::fromValue( overlayLayer ) );
+    parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+    bool ok = false;
+    QgsProcessingFeedback feedback;
+    QgsProcessingContext context;
+    const QVariantMap results = alg->run( parameters, context, &feedback, &ok );
+    QStringList output;
+    QgsVectorLayer *outputLayer = ok ? qobject_cast< QgsVectorLayer * >( context.getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) ) : nullptr;
+    if ( !outputLayer )
+      return output;
+
+    QgsFeature f;
+    QgsFeatureIterator it = outputLayer->getFeatures();
+    while ( it.nextFeature( f ) )
+    {
+      QStringList attributes;
+      for ( const QVariant &attribute : f.attributes() )
+        attributes << attribute.toString();
+      output << QStringLiteral( "%1 %2" ).arg( attributes.join( ',' ), f.geometry().asWkt( 6 ) );
+    }
+    return output;
+  };
+
+  const int maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 1 );
+  const QStringList intersection = runOverlay( QStringLiteral( "native:intersection" ) );
+  const QStringList difference = runOverlay( QStringLiteral( "native:difference" ) );
+
+  QVERIFY( intersection.size() > 1000 );
+  QVERIFY( difference.size() > 100 );
+  QCOMPARE( difference.last(), QStringLiteral( "1000 " ) );
+
+  // the intersections of each input feature are ordered by overlay feature id, which is the overlay attribute + 1
+  int previousA = -1;
+  int previousB = -1;
+  for ( const QString &feature : intersection )
+  {
+    const QStringList attributes = feature.section( ' ', 0, 0 ).split( ',' );
+    const int a = attributes.at( 0 ).toInt();
+    const int b = attributes.at( 1 ).toInt();
+    QVERIFY( a >= previousA );
+    if ( a == previousA )
+      QVERIFY( b > previousB );
+    previousA = a;
+    previousB = b;
+  }
+
+  // the same output for any thread count, and so for any batch size
+  for ( int threadCount : { 2, 3, 8 } )
+  {
+    QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+    QCOMPARE( runOverlay( QStringLiteral( "native:intersection" ) ), intersection );
+    QCOMPARE( runOverlay( QStringLiteral( "native:difference" ) ), difference );
+  }
+  QThreadPool::globalInstance()->setMaxThreadCount( maxThreadCount );
+}
+
 void TestQgsProcessingAlgs::polygonsToLines_data()
 {
   QTest::addColumn<QgsGeometry>( "sourceGeometry" );
@@ -23,6 +23,7 @@
 #include "qgstest.h"
 #include "qgsexception.h"
 #include "qgslogger.h"
+#include "qgsgeometry.h"
 
 class TestQgsCoordinateTransform: public QObject
 {
@@ -53,6 +54,9 @@ class TestQgsCoordinateTransform: public QObject
     void transformErrorOnePoint();
     void testDeprecated4240to4326();
     void testCustomProjTransform();
+    void transformCoordsInParallel();
+    void transformGeometries();
+    void approximation();
 };
 
 
@@ -760,6 +764,147 @@ void TestQgsCoordinateTransform::testCustomProjTransform()
                             "+step +proj=unitconvert +xy_in=rad +xy_out=deg" ) );
 }
 
+void TestQgsCoordinateTransform::transformCoordsInParallel()
+{
+  QgsCoordinateTransform ct( QgsCoordinateReferenceSystem::fromEpsgId( 4326 ), QgsCoordinateReferenceSystem::fromEpsgId( 3857 ), QgsCoordinateTransformContext() );
+  QVERIFY( ct.isValid() );
+
+  // large enough to be split between threads
+  const int count = 200000;
+  QVector< double > x( count );
+  QVector< double > y( count );
+  QVector< double > z( count, 0 );
+  for ( int i = 0; i < count; ++i )
+  {
+    x[i] = -180 + 360.0 * i / count;
+    y[i] = -80 + 160.0 * i / count;
+  }
+  QVector< double > expectedX = x;
+  QVector< double > expectedY = y;
+  QVector< double > expectedZ = z;
+  ct.transformCoords( count, expectedX.data(), expectedY.data(), expectedZ.data() );
+
+  ct.transformCoordsInParallel( count, x.data(), y.data(), z.data() );
+  QCOMPARE( x, expectedX );
+  QCOMPARE( y, expectedY );
+
+  // and back
+  ct.transformCoordsInParallel( count, x.data(), y.data(), z.data(), QgsCoordinateTransform::ReverseTransform );
+  QGSCOMPARENEAR( x.at( 0 ), -180, 0.000001 );
+  QGSCOMPARENEAR( y.at( count - 1 ), 80 - 160.0 / count, 0.000001 );
+
+  // small arrays are transformed directly
+  double sx[] = { 0 };
+  double sy[] = { 0 };
+  double sz[] = { 0 };
+  ct.transformCoordsInParallel( 1, sx, sy, sz );
+  QGSCOMPARENEAR( sx[0], 0, 0.01 );
+  QGSCOMPARENEAR( sy[0], 0, 0.01 );
+}
+
+void TestQgsCoordinateTransform::transformGeometries()
+{
+  QgsCoordinateTransform ct( QgsCoordinateReferenceSystem::fromEpsgId( 4326 ), QgsCoordinateReferenceSystem::fromEpsgId( 3857 ), QgsCoordinateTransformContext() );
+  QVERIFY( ct.isValid() );
+
+  QVector< QgsGeometry > geometries;
+  QVector< QgsGeometry > expected;
+  for ( int i = 0; i < 20000; ++i )
+  {
+    const double x = -170 + i * 0.01;
+    QgsGeometry g = QgsGeometry::fromWkt( QStringLiteral( "LineString(%1 10, %2 20, %3 30)" ).arg( x ).arg( x + 1 ).arg( x + 2 ) );
+    geometries << g;
+    g.transform( ct );
+    expected << g;
+  }
+  // null geometries are skipped
+  geometries << QgsGeometry();
+  expected << QgsGeometry();
+  // geometries which cannot be transformed are reported and left untouched
+  const QgsGeometry invalid = QgsGeometry::fromWkt( QStringLiteral( "Point(-1000 0)" ) );
+  geometries << invalid;
+  expected << invalid;
+
+  const QList< int > failed = ct.transformGeometries( geometries );
+  QCOMPARE( failed, QList< int >() << 20001 );
+  QCOMPARE( geometries.size(), expected.size() );
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    QCOMPARE( geometries.at( i ).asWkt( 3 ), expected.at( i ).asWkt( 3 ) );
+  }
+
+  // short circuited transform leaves the geometries untouched
+  QgsCoordinateTransform shortCircuited( QgsCoordinateReferenceSystem::fromEpsgId( 4326 ), QgsCoordinateReferenceSystem::fromEpsgId( 4326 ), QgsCoordinateTransformContext() );
+  QVector< QgsGeometry > unchanged = QVector< QgsGeometry >() << QgsGeometry::fromWkt( QStringLiteral( "Point(1 2)" ) );
+  QVERIFY( shortCircuited.transformGeometries( unchanged ).isEmpty() );
+  QCOMPARE( unchanged.at( 0 ).asWkt(), QStringLiteral( "Point (1 2)" ) );
+}
+
+void TestQgsCoordinateTransform::approximation()
+{
+  // British National Grid to Web Mercator
+  QgsCoordinateTransform ct( QgsCoordinateReferenceSystem::fromEpsgId( 27700 ), QgsCoordinateReferenceSystem::fromEpsgId( 3857 ), QgsCoordinateTransformContext() );
+  QVERIFY( ct.isValid() );
+  QVERIFY( !ct.hasApproximation() );
+
+  const QgsCoordinateTransform exact = ct;
+  const QgsRectangle extent( 400000, 200000, 500000, 300000 );
+  QVERIFY( ct.setApproximation( extent, 0.5 ) );
+  QVERIFY( ct.hasApproximation() );
+  QVERIFY( !exact.hasApproximation() );
+
+  // copies share the approximation
+  const QgsCoordinateTransform copy = ct;
+  QVERIFY( copy.hasApproximation() );
+
+  const int count = 1000;
+  QVector< double > x( count );
+  QVector< double > y( count );
+  QVector< double > z( count, 0 );
+  for ( int i = 0; i < count; ++i )
+  {
+    x[i] = 400000 + 100000.0 * ( i % 37 ) / 36;
+    y[i] = 200000 + 100000.0 * i / count;
+  }
+  // a point outside of the grid is transformed exactly
+  x[0] = 300000;
+  y[0] = 100000;
+
+  QVector< double > expectedX = x;
+  QVector< double > expectedY = y;
+  QVector< double > expectedZ = z;
+  exact.transformCoords( count, expectedX.data(), expectedY.data(), expectedZ.data() );
+  ct.transformCoords( count, x.data(), y.data(), z.data() );
+  for ( int i = 0; i < count; ++i )
+  {
+    QGSCOMPARENEAR( x.at( i ), expectedX.at( i ), 1 );
+    QGSCOMPARENEAR( y.at( i ), expectedY.at( i ), 1 );
+  }
+  QCOMPARE( x.at( 0 ), expectedX.at( 0 ) );
+  QCOMPARE( y.at( 0 ), expectedY.at( 0 ) );
+
+  // reverse transforms are always exact
+  const QgsPointXY reversed = ct.transform( QgsPointXY( expectedX.at( 1 ), expectedY.at( 1 ) ), QgsCoordinateTransform::ReverseTransform );
+  const QgsPointXY exactReversed = exact.transform( QgsPointXY( expectedX.at( 1 ), expectedY.at( 1 ) ), QgsCoordinateTransform::ReverseTransform );
+  QCOMPARE( reversed.x(), exactReversed.x() );
+  QCOMPARE( reversed.y(), exactReversed.y() );
+
+  ct.clearApproximation();
+  QVERIFY( !ct.hasApproximation() );
+
+  // changing the CRS discards the approximation
+  QVERIFY( ct.setApproximation( extent, 0.5 ) );
+  ct.setDestinationCrs( QgsCoordinateReferenceSystem::fromEpsgId( 4326 ) );
+  QVERIFY( !ct.hasApproximation() );
+
+  // no approximation for short circuited transforms, or an invalid tolerance
+  QgsCoordinateTransform shortCircuited( QgsCoordinateReferenceSystem::fromEpsgId( 27700 ), QgsCoordinateReferenceSystem::fromEpsgId( 27700 ), QgsCoordinateTransformContext() );
+  QVERIFY( !shortCircuited.setApproximation( extent, 0.5 ) );
+  QVERIFY( !exact.hasApproximation() );
+  QgsCoordinateTransform noTolerance = exact;
+  QVERIFY( !noTolerance.setApproximation( extent, 0 ) );
+}
+
 
 QGSTEST_MAIN( TestQgsCoordinateTransform )
 #include "testqgscoordinatetransform.moc"
@@ -20,6 +20,9 @@
 
 #include <gdal.h>
 
+#include <cstring>
+#include <random>
+
 #include "qgsgdalutils.h"
 #include "qgsapplication.h"
 #include "qgsrasterlayer.h"
@@ -41,6 +44,7 @@ class TestQgsGdalUtils: public QObject
     void testResampleSingleBandRaster();
     void testImageToDataset();
     void testResampleImageToImage();
+    void testResampleImageInBands();
 
   private:
 
@@ -268,6 +272,47 @@ void TestQgsGdalUtils::testResampleImageToImage()
   QCOMPARE( qAlpha( res.pixel( 40, 40 ) ), 255 );
 }
 
+void TestQgsGdalUtils::testResampleImageInBands()
+{
+  // noisy rows, so that a band missing the source rows needed by the cubic kernel around its edges differs
+  QImage src( 120, 90, QImage::Format_ARGB32 );
+  std::mt19937 generator( 42 );
+  std::uniform_int_distribution< int > value( 0, 255 );
+  for ( int y = 0; y < src.height(); ++y )
+    for ( int x = 0; x < src.width(); ++x )
+      src.setPixel( x, y, qRgba( value( generator ), value( generator ), value( generator ), 255 ) );
+
+  const QList< QSize > sizes { QSize( 250, 200 ), QSize( 250, 37 ), QSize( 60, 90 ) };
+  for ( const QSize &size : sizes )
+  {
+    // the whole image read at once by GDAL
+    gdal::dataset_unique_ptr srcDS = QgsGdalUtils::imageToMemoryDataset( src );
+    QVERIFY( srcDS );
+    QImage expected( size, src.format() );
+    GDALRasterIOExtraArg extra;
+    INIT_RASTERIO_EXTRA_ARG( extra );
+    extra.eResampleAlg = GRIORA_Cubic;
+    const int offsets[] = { 2, 1, 0, 3 };
+    for ( int band = 0; band < 4; ++band )
+    {
+      QCOMPARE( GDALRasterIOEx( GDALGetRasterBand( srcDS.get(), band + 1 ), GF_Read, 0, 0, src.width(), src.height(), expected.bits() + offsets[band],
+                                size.width(), size.height(), GDT_Byte, sizeof( QRgb ), expected.bytesPerLine(), &extra ), CE_None );
+    }
+
+    // whatever the count of bands, including bands of a single row
+    for ( int bandCount : { 1, 2, 3, 7, size.height() } )
+    {
+      const QImage res = QgsGdalUtils::resampleImageInBands( src, size, GRIORA_Cubic, bandCount );
+      QCOMPARE( res.size(), size );
+      for ( int y = 0; y < size.height(); ++y )
+      {
+        QVERIFY2( std::memcmp( res.constScanLine( y ), expected.constScanLine( y ), static_cast< std::size_t >( size.width() ) * sizeof( QRgb ) ) == 0,
+                  QStringLiteral( "row %1 differs with %2 bands for %3x%4" ).arg( y ).arg( bandCount ).arg( size.width() ).arg( size.height() ).toLocal8Bit().constData() );
+      }
+    }
+  }
+}
+
 double TestQgsGdalUtils::identify( GDALDatasetH dataset, int band, int px, int py )
 {
   GDALRasterBandH hBand = GDALGetRasterBand( dataset, band );
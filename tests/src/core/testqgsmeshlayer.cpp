@@ -28,6 +28,7 @@
 #include "qgstriangularmesh.h"
 #include "qgsmeshlayerutils.h"
 #include "qgsmeshlayertemporalproperties.h"
+#include "qgsmeshdatasetgroupstore.h"
 
 #include "qgsmeshdataprovidertemporalcapabilities.h"
 #include "qgsprovidermetadata.h"
@@ -87,6 +88,8 @@ class TestQgsMeshLayer : public QObject
 
     void test_snap_on_mesh();
     void test_dataset_value_from_layer();
+    void test_dataset_cache();
+    void test_dataset_cache_prefetch();
 
     void test_dataset_group_item_tree_item();
 
@@ -1710,5 +1713,146 @@ void TestQgsMeshLayer::test_temporal()
   mMdal3DLayer->temporalProperties();
 }
 
+void TestQgsMeshLayer::test_dataset_cache()
+{
+  QgsMeshLayer layer( mDataDir + "/quad_and_triangle.2dm", "Triangle and Quad MDAL", "mdal" );
+  QVERIFY( layer.isValid() );
+  QVERIFY( layer.addDatasets( mDataDir + "/quad_and_triangle_vertex_scalar.dat" ) );
+  QCOMPARE( layer.datasetGroupCount(), 2 );
+
+  const int groupIndex = 1;
+  const int datasetCount = layer.datasetCount( QgsMeshDatasetIndex( groupIndex ) );
+  QVERIFY( datasetCount > 1 );
+  const int vertexCount = layer.dataProvider()->vertexCount();
+  const int faceCount = layer.dataProvider()->faceCount();
+
+  QVector<QVector<double>> expectedValues;
+  for ( int i = 0; i < datasetCount; ++i )
+  {
+    const QgsMeshDataBlock block = layer.datasetValues( QgsMeshDatasetIndex( groupIndex, i ), 0, vertexCount );
+    QVector<double> values;
+    for ( int v = 0; v < vertexCount; ++v )
+      values << block.value( v ).scalar();
+    expectedValues << values;
+  }
+
+  QCOMPARE( layer.datasetCacheSize(), 0 );
+  QCOMPARE( layer.datasetPrefetchCount(), 0 );
+  layer.setDatasetCacheSize( 1024 * 1024 );
+  layer.setDatasetPrefetchCount( 2 );
+  QCOMPARE( layer.datasetCacheSize(), 1024 * 1024 );
+  QCOMPARE( layer.datasetPrefetchCount(), 2 );
+
+  // same values read twice, from the provider then from the cache, with following datasets read in advance
+  for ( int pass = 0; pass < 2; ++pass )
+  {
+    for ( int i = 0; i < datasetCount; ++i )
+    {
+      const QgsMeshDatasetIndex index( groupIndex, i );
+      const QgsMeshDataBlock block = layer.datasetValues( index, 0, vertexCount );
+      QVERIFY( block.isValid() );
+      QCOMPARE( block.count(), vertexCount );
+      for ( int v = 0; v < vertexCount; ++v )
+        QCOMPARE( block.value( v ).scalar(), expectedValues.at( i ).at( v ) );
+
+      const QgsMeshDataBlock active = layer.areFacesActive( index, 0, faceCount );
+      QCOMPARE( active.count(), faceCount );
+    }
+  }
+
+  // a range of values is cached separately from the whole dataset
+  const QgsMeshDataBlock range = layer.datasetValues( QgsMeshDatasetIndex( groupIndex, 1 ), 2, 2 );
+  QCOMPARE( range.count(), 2 );
+  QCOMPARE( range.value( 0 ).scalar(), expectedValues.at( 1 ).at( 2 ) );
+  QCOMPARE( range.value( 1 ).scalar(), expectedValues.at( 1 ).at( 3 ) );
+
+  // the settings are kept by clones and saved with the layer, sizes above 2 GB included
+  layer.setDatasetCacheSize( 3LL * 1024 * 1024 * 1024 );
+  std::unique_ptr< QgsMeshLayer > clonedLayer( layer.clone() );
+  QCOMPARE( clonedLayer->datasetCacheSize(), 3LL * 1024 * 1024 * 1024 );
+  QCOMPARE( clonedLayer->datasetPrefetchCount(), 2 );
+
+  QgsReadWriteContext readWriteContext;
+  QDomDocument doc( "savedLayer" );
+  QDomElement layerElement = doc.createElement( "maplayer" );
+  layer.writeLayerXml( layerElement, doc, readWriteContext );
+  QgsMeshLayer readLayer;
+  QVERIFY( readLayer.readLayerXml( layerElement, readWriteContext ) );
+  QCOMPARE( readLayer.datasetCacheSize(), 3LL * 1024 * 1024 * 1024 );
+  QCOMPARE( readLayer.datasetPrefetchCount(), 2 );
+
+  // disabling the cache still returns the values
+  layer.setDatasetCacheSize( 0 );
+  const QgsMeshDataBlock block = layer.datasetValues( QgsMeshDatasetIndex( groupIndex, 0 ), 0, vertexCount );
+  QCOMPARE( block.value( 0 ).scalar(), expectedValues.at( 0 ).at( 0 ) );
+}
+
+void TestQgsMeshLayer::test_dataset_cache_prefetch()
+{
+  std::unique_ptr< QgsMeshDataProvider > provider( qobject_cast< QgsMeshDataProvider * >(
+        QgsProviderRegistry::instance()->createProvider( QStringLiteral( "mdal" ), mDataDir + "/quad_and_triangle.2dm", QgsDataProvider::ProviderOptions() ) ) );
+  QVERIFY( provider );
+  QVERIFY( provider->isValid() );
+
+  QgsMeshDatasetGroupStore store( nullptr );
+  store.setPersistentProvider( provider.get(), QStringList() << mDataDir + "/quad_and_triangle_vertex_scalar.dat" );
+  QCOMPARE( store.datasetGroupCount(), 2 );
+
+  const int vertexCount = provider->vertexCount();
+  const QgsMeshDatasetIndex firstIndex( 1, 0 );
+  const QgsMeshDatasetIndex secondIndex( 1, 1 );
+  QCOMPARE( store.datasetCount( 1 ), 2 );
+
+  // without the cache, nothing is kept
+  QgsMeshDataBlock block = store.datasetValues( firstIndex, 0, vertexCount );
+  QVERIFY( block.isValid() );
+  QVERIFY( !store.datasetValuesCached( firstIndex, 0, vertexCount ) );
+
+  // the cache without prefetching only keeps the values read
+  store.setDatasetCache( 1024 * 1024, 0 );
+  block = store.datasetValues( firstIndex, 0, vertexCount );
+  store.waitForDatasetPrefetching();
+  QVERIFY( store.datasetValuesCached( firstIndex, 0, vertexCount ) );
+  QVERIFY( !store.datasetValuesCached( secondIndex, 0, vertexCount ) );
+
+  // values read again come from the cache
+  const QgsMeshDataBlock cachedBlock = store.datasetValues( firstIndex, 0, vertexCount );
+  QCOMPARE( cachedBlock.count(), vertexCount );
+  for ( int i = 0; i < vertexCount; ++i )
+    QCOMPARE( cachedBlock.value( i ).scalar(), block.value( i ).scalar() );
+
+  // the following dataset is read in advance, with the values of the provider
+  store.setDatasetCache( 1024 * 1024, 1 );
+  store.datasetValues( firstIndex, 0, vertexCount );
+  store.waitForDatasetPrefetching();
+  QVERIFY( store.datasetValuesCached( secondIndex, 0, vertexCount ) );
+  const QgsMeshDataBlock prefetchedBlock = store.datasetValues( secondIndex, 0, vertexCount );
+  const QgsMeshDataBlock providerBlock = provider->datasetValues( QgsMeshDatasetIndex( 1, 1 ), 0, vertexCount );
+  QCOMPARE( prefetchedBlock.count(), vertexCount );
+  for ( int i = 0; i < vertexCount; ++i )
+    QCOMPARE( prefetchedBlock.value( i ).scalar(), providerBlock.value( i ).scalar() );
+
+  // clearing the cache removes the values read in advance
+  store.clearDatasetCache();
+  QVERIFY( !store.datasetValuesCached( firstIndex, 0, vertexCount ) );
+  QVERIFY( !store.datasetValuesCached( secondIndex, 0, vertexCount ) );
+
+  // the blocks are accounted in kilobytes: a cache of a kilobyte keeps the small blocks of this mesh
+  store.clearDatasetCache();
+  store.setDatasetCache( 1024, 0 );
+  store.datasetValues( firstIndex, 0, vertexCount );
+  QVERIFY( store.datasetValuesCached( firstIndex, 0, vertexCount ) );
+
+  // a cache smaller than a kilobyte is disabled, nothing is kept nor read in advance
+  store.clearDatasetCache();
+  store.setDatasetCache( 1023, 1 );
+  store.datasetValues( firstIndex, 0, vertexCount );
+  store.waitForDatasetPrefetching();
+  QVERIFY( !store.datasetValuesCached( firstIndex, 0, vertexCount ) );
+  QVERIFY( !store.datasetValuesCached( secondIndex, 0, vertexCount ) );
+
+  store.setPersistentProvider( nullptr, QStringList() );
+}
+
 QGSTEST_MAIN( TestQgsMeshLayer )
 #include "testqgsmeshlayer.moc"
@@ -24,6 +24,9 @@
 #include <qgsapplication.h>
 #include <qgscoordinatereferencesystem.h>
 #include <qgsproject.h>
+#include <qgsmeshlayerutils.h>
+#include <qgstriangularmesh.h>
+#include <qgsmaptopixel.h>
 
 /**
  * \ingroup UnitTests
@@ -39,6 +42,7 @@ class TestQgsMeshLayerInterpolator: public QObject
     void cleanup() {} // will be called after every testfunction.
 
     void testExportRasterBand();
+    void testExportRasterBandLarge();
   private:
     QString mTestDataDir;
 };
@@ -89,5 +93,60 @@ void TestQgsMeshLayerInterpolator::testExportRasterBand()
   QVERIFY( block->isNoData( 10, 10 ) );
 }
 
+void TestQgsMeshLayerInterpolator::testExportRasterBandLarge()
+{
+  // block large enough to be rasterized in several bands of rows
+  QgsMeshLayer memoryLayer( mTestDataDir + "/mesh/quad_and_triangle.2dm",
+                            "Triangle and Quad Mdal",
+                            "mdal" );
+  QVERIFY( memoryLayer.isValid() );
+  const QgsMeshDatasetIndex index( 0, 0 ); // bed elevation, on vertices
+
+  QgsMesh nativeMesh;
+  memoryLayer.dataProvider()->populateMesh( &nativeMesh );
+  QgsTriangularMesh triangularMesh;
+  triangularMesh.update( &nativeMesh, QgsCoordinateTransform() );
+
+  const QgsMeshDataBlock values = memoryLayer.dataProvider()->datasetValues( index, 0, nativeMesh.vertexCount() );
+  const QgsMeshDataBlock activeFaces = memoryLayer.dataProvider()->areFacesActive( index, 0, nativeMesh.faceCount() );
+  const QVector<double> magnitudes = QgsMeshLayerUtils::calculateMagnitudes( values );
+
+  const QgsRectangle extent = memoryLayer.extent();
+  const double mapUnitsPerPixel = 1;
+  std::unique_ptr< QgsRasterBlock > block( QgsMeshUtils::exportRasterBlock( triangularMesh,
+      values,
+      activeFaces,
+      QgsMeshDatasetGroupMetadata::DataOnVertices,
+      QgsCoordinateTransform(),
+      mapUnitsPerPixel,
+      extent ) );
+
+  QCOMPARE( block->width(), 2000 );
+  QCOMPARE( block->height(), 1000 );
+
+  const QgsMapToPixel mapToPixel( mapUnitsPerPixel, extent.center().x(), extent.center().y(), block->width(), block->height(), 0 );
+  const QVector<QgsMeshVertex> &vertices = triangularMesh.vertices();
+  for ( int row = 0; row < block->height(); row += 37 )
+  {
+    for ( int column = 0; column < block->width(); column += 41 )
+    {
+      const QgsPointXY point = mapToPixel.toMapCoordinates( column, row );
+      double expected = std::numeric_limits<double>::quiet_NaN();
+      for ( const QgsMeshFace &face : triangularMesh.triangles() )
+      {
+        const double value = QgsMeshLayerUtils::interpolateFromVerticesData( vertices[face[0]], vertices[face[1]], vertices[face[2]],
+                             magnitudes[face[0]], magnitudes[face[1]], magnitudes[face[2]], point );
+        if ( !std::isnan( value ) )
+          expected = value;
+      }
+
+      if ( std::isnan( expected ) )
+        QVERIFY( block->isNoData( row, column ) );
+      else
+        QGSCOMPARENEAR( block->value( row, column ), expected, 1e-6 );
+    }
+  }
+}
+
 QGSTEST_MAIN( TestQgsMeshLayerInterpolator )
 #include "testqgsmeshlayerinterpolator.moc"
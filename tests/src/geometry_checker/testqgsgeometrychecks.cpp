@@ -47,6 +47,9 @@
 #include "qgsfeedback.h"
 
 #include "qgsgeometrytypecheck.h"
+#include "qgsgeometrychecker.h"
+
+#include <QThread>
 
 class TestQgsGeometryChecks: public QObject
 {
@@ -101,6 +104,9 @@ class TestQgsGeometryChecks: public QObject
     void testSliverPolygonCheck();
     void testGapCheckPointInPoly();
     void testOverlapCheckToleranceBug();
+    void testCheckerSingleGeometryCheckOrder();
+    void testCheckerTopologyCheckOrder();
+    void testCheckerFixErrorUpdates();
 };
 
 void TestQgsGeometryChecks::initTestCase()
@@ -1292,6 +1298,242 @@ void TestQgsGeometryChecks::testOverlapCheckToleranceBug()
   cleanupTestContext( testContext );
 }
 
+void TestQgsGeometryChecks::testCheckerSingleGeometryCheckOrder()
+{
+  // The checker runs the checks on worker threads, where single geometry checks process
+  // their features by parallel batches. The errors must still be reported in feature order.
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:4326" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+
+  // enough features for several batches, every third one is self-intersecting
+  const int featureCount = QThread::idealThreadCount() * 64 * 3 + 17;
+  QgsFeatureList features;
+  for ( int i = 0; i < featureCount; ++i )
+  {
+    const double x = i * 2;
+    QgsFeature f;
+    if ( i % 3 == 0 )
+      f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((%1 0, %2 1, %2 0, %1 1, %1 0))" ).arg( x ).arg( x + 1 ) ) );
+    else
+      f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((%1 0, %2 0, %2 1, %1 1, %1 0))" ).arg( x ).arg( x + 1 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  auto errorSummary = []( const QList<QgsGeometryCheckError *> &errors )
+  {
+    QStringList summary;
+    for ( const QgsGeometryCheckError *error : errors )
+      summary << QStringLiteral( "%1 %2" ).arg( error->featureId() ).arg( error->location().asWkt() );
+    return summary;
+  };
+
+  // Reference: collected on the main thread, where the features are checked sequentially
+  QStringList expected;
+  {
+    QgsGeometryCheckContext context( 8, QgsCoordinateReferenceSystem( "EPSG:4326" ), QgsProject::instance()->transformContext(), QgsProject::instance() );
+    QMap<QString, QgsFeaturePool *> featurePools;
+    featurePools.insert( layer->id(), createFeaturePool( layer.get() ) );
+
+    QList<QgsGeometryCheckError *> checkErrors;
+    QStringList messages;
+    QgsFeedback feedback;
+    QgsGeometrySelfIntersectionCheck check( &context, QVariantMap() );
+    check.collectErrors( featurePools, checkErrors, messages, &feedback );
+    QCOMPARE( checkErrors.size(), ( featureCount + 2 ) / 3 );
+    for ( const QgsGeometryCheckError *error : std::as_const( checkErrors ) )
+      QCOMPARE( error->featureId() % 3, 1LL );
+
+    expected = errorSummary( checkErrors );
+    qDeleteAll( checkErrors );
+    qDeleteAll( featurePools );
+  }
+
+  // Through the checker, which takes ownership of the check, the context and the feature pools
+  QgsGeometryCheckContext *context = new QgsGeometryCheckContext( 8, QgsCoordinateReferenceSystem( "EPSG:4326" ), QgsProject::instance()->transformContext(), QgsProject::instance() );
+  QMap<QString, QgsFeaturePool *> featurePools;
+  featurePools.insert( layer->id(), createFeaturePool( layer.get() ) );
+  QgsGeometryChecker checker( QList<QgsGeometryCheck *>() << new QgsGeometrySelfIntersectionCheck( context, QVariantMap() ), context, featurePools );
+
+  // the errors are added from the thread running the check
+  QList<QgsGeometryCheckError *> checkErrors;
+  connect( &checker, &QgsGeometryChecker::errorAdded, &checker, [&checkErrors]( QgsGeometryCheckError * error ) { checkErrors << error; }, Qt::DirectConnection );
+
+  checker.execute().waitForFinished();
+  QCoreApplication::processEvents();
+
+  QCOMPARE( errorSummary( checkErrors ), expected );
+}
+
+void TestQgsGeometryChecks::testCheckerTopologyCheckOrder()
+{
+  // The overlap and duplicate checks compare their features with their neighbors by parallel batches,
+  // and the gap check searches the neighbors of its gaps in parallel, when they are run by the checker.
+  // The errors must still be the same, in the same order, as when checking sequentially.
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:4326" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+
+  // three rows of squares: the squares of the first row overlap their neighbors and every fifth
+  // is duplicated, every fourth square of the second row is shrunk and leaves a gap around it
+  const int columns = QThread::idealThreadCount() * 16 * 3 + 5;
+  QgsFeatureList features;
+  QgsFeatureList duplicates;
+  for ( int i = 0; i < columns; ++i )
+  {
+    QgsFeature f;
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 0, i + 1.2, 1 ) ) );
+    features << f;
+    if ( i % 5 == 0 )
+      duplicates << f;
+    f.setGeometry( QgsGeometry::fromRect( i % 4 == 2 ? QgsRectangle( i + 0.1, 1.1, i + 0.9, 2 ) : QgsRectangle( i, 1, i + 1, 2 ) ) );
+    features << f;
+    f.setGeometry( QgsGeometry::fromRect( QgsRectangle( i, 2, i + 1, 3 ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features << duplicates ) );
+
+  auto errorSummary = []( const QList<QgsGeometryCheckError *> &errors )
+  {
+    QStringList summary;
+    for ( const QgsGeometryCheckError *error : errors )
+      summary << QStringLiteral( "%1 %2 %3" ).arg( error->featureId() ).arg( error->location().asWkt( 6 ), error->value().toString() );
+    return summary;
+  };
+
+  auto createCheck = []( int checkIndex, const QgsGeometryCheckContext * context ) -> QgsGeometryCheck *
+  {
+    switch ( checkIndex )
+    {
+      case 0:
+        return new QgsGeometryOverlapCheck( context, QVariantMap( { { QStringLiteral( "maxOverlapArea" ), 0.0 } } ) );
+      case 1:
+        return new QgsGeometryDuplicateCheck( context, QVariantMap() );
+      default:
+        return new QgsGeometryGapCheck( context, QVariantMap() );
+    }
+  };
+
+  // the duplicates also overlap the neighbors of their square, and the gaps are enclosed except on the last column
+  int overlaps = columns - 1;
+  for ( int i = 0; i < columns; i += 5 )
+    overlaps += ( i > 0 ? 1 : 0 ) + ( i < columns - 1 ? 1 : 0 );
+  const int gaps = ( columns + 1 ) / 4 - ( ( columns - 1 ) % 4 == 2 ? 1 : 0 );
+  const QList<int> expectedErrorCounts { overlaps, ( columns + 4 ) / 5, gaps };
+  for ( int checkIndex = 0; checkIndex < 3; ++checkIndex )
+  {
+    // Reference: collected on the main thread, where the features are checked sequentially
+    QStringList expected;
+    {
+      QgsGeometryCheckContext context( 8, QgsCoordinateReferenceSystem( "EPSG:4326" ), QgsProject::instance()->transformContext(), QgsProject::instance() );
+      QMap<QString, QgsFeaturePool *> featurePools;
+      featurePools.insert( layer->id(), createFeaturePool( layer.get() ) );
+
+      QList<QgsGeometryCheckError *> checkErrors;
+      QStringList messages;
+      QgsFeedback feedback;
+      std::unique_ptr< QgsGeometryCheck > check( createCheck( checkIndex, &context ) );
+      check->collectErrors( featurePools, checkErrors, messages, &feedback );
+      QCOMPARE( checkErrors.size(), expectedErrorCounts.at( checkIndex ) );
+
+      expected = errorSummary( checkErrors );
+      qDeleteAll( checkErrors );
+      qDeleteAll( featurePools );
+    }
+
+    // Through the checker, which takes ownership of the check, the context and the feature pools
+    QgsGeometryCheckContext *context = new QgsGeometryCheckContext( 8, QgsCoordinateReferenceSystem( "EPSG:4326" ), QgsProject::instance()->transformContext(), QgsProject::instance() );
+    QMap<QString, QgsFeaturePool *> featurePools;
+    featurePools.insert( layer->id(), createFeaturePool( layer.get() ) );
+    QgsGeometryChecker checker( QList<QgsGeometryCheck *>() << createCheck( checkIndex, context ), context, featurePools );
+
+    QList<QgsGeometryCheckError *> checkErrors;
+    connect( &checker, &QgsGeometryChecker::errorAdded, &checker, [&checkErrors]( QgsGeometryCheckError * error ) { checkErrors << error; }, Qt::DirectConnection );
+
+    checker.execute().waitForFinished();
+    QCoreApplication::processEvents();
+
+    QCOMPARE( errorSummary( checkErrors ), expected );
+  }
+}
+
+void TestQgsGeometryChecks::testCheckerFixErrorUpdates()
+{
+  // After a fix, the checker only updates the feature errors of the changed or rechecked features.
+  // The errors of the other features must keep their status.
+
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=epsg:4326" ), QStringLiteral( "polygons" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+
+  // the first polygon has two duplicate nodes, the next ones one each, and the last two are duplicates
+  QgsFeatureList features;
+  QgsFeature f;
+  f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((0 0, 1 0, 1 0, 1 1, 0 1, 0 1, 0 0))" ) ) );
+  features << f;
+  for ( int i = 1; i < 5; ++i )
+  {
+    f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "Polygon ((%1 0, %2 0, %2 0, %2 1, %1 1, %1 0))" ).arg( i * 2 ).arg( i * 2 + 1 ) ) );
+    features << f;
+  }
+  f.setGeometry( QgsGeometry::fromRect( QgsRectangle( 20, 0, 21, 1 ) ) );
+  features << f << f;
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+  const QgsFeatureId firstId = features.at( 0 ).id();
+  const QgsFeatureId duplicateId = features.at( 6 ).id();
+
+  QgsGeometryCheckContext *context = new QgsGeometryCheckContext( 8, QgsCoordinateReferenceSystem( "EPSG:4326" ), QgsProject::instance()->transformContext(), QgsProject::instance() );
+  QMap<QString, QgsFeaturePool *> featurePools;
+  featurePools.insert( layer->id(), createFeaturePool( layer.get() ) );
+  QgsGeometryChecker checker( QList<QgsGeometryCheck *>()
+                              << new QgsGeometryDuplicateNodesCheck( context, QVariantMap() )
+                              << new QgsGeometryDuplicateCheck( context, QVariantMap() ), context, featurePools );
+
+  QList<QgsGeometryCheckError *> addedErrors;
+  QList<QgsGeometryCheckError *> updatedErrors;
+  connect( &checker, &QgsGeometryChecker::errorAdded, &checker, [&addedErrors]( QgsGeometryCheckError * error ) { addedErrors << error; }, Qt::DirectConnection );
+  connect( &checker, &QgsGeometryChecker::errorUpdated, &checker, [&updatedErrors]( QgsGeometryCheckError * error, bool ) { updatedErrors << error; }, Qt::DirectConnection );
+
+  checker.execute().waitForFinished();
+  QCoreApplication::processEvents();
+  const QList<QgsGeometryCheckError *> errors = addedErrors;
+  QCOMPARE( errors.size(), 7 );
+
+  QgsGeometryCheckError *fixedError = nullptr;
+  QgsGeometryCheckError *otherFirstError = nullptr;
+  QgsGeometryCheckError *duplicateError = nullptr;
+  for ( QgsGeometryCheckError *error : errors )
+  {
+    if ( dynamic_cast<QgsGeometryDuplicateCheckError *>( error ) )
+      duplicateError = error;
+    else if ( error->featureId() == firstId && !fixedError )
+      fixedError = error;
+    else if ( error->featureId() == firstId )
+      otherFirstError = error;
+  }
+  QVERIFY( fixedError );
+  QVERIFY( otherFirstError );
+  QVERIFY( duplicateError );
+  QCOMPARE( duplicateError->featureId(), duplicateId );
+
+  addedErrors.clear();
+  QVERIFY( checker.fixError( fixedError, QgsGeometryDuplicateNodesCheck::RemoveDuplicates ) );
+  QCOMPARE( fixedError->status(), QgsGeometryCheckError::StatusFixed );
+
+  // the other error of the fixed feature is matched with the error found when rechecking it
+  QCOMPARE( updatedErrors, QList<QgsGeometryCheckError *>() << fixedError << otherFirstError );
+  QCOMPARE( otherFirstError->status(), QgsGeometryCheckError::StatusPending );
+  QCOMPARE( otherFirstError->vidx().vertex, 4 );
+  QVERIFY( addedErrors.isEmpty() );
+
+  // the errors of the other features are untouched
+  for ( QgsGeometryCheckError *error : errors )
+  {
+    if ( error != fixedError )
+      QCOMPARE( error->status(), QgsGeometryCheckError::StatusPending );
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 double TestQgsGeometryChecks::layerToMapUnits( const QgsMapLayer *layer, const QgsCoordinateReferenceSystem &mapCrs ) const
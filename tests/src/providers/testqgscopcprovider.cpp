@@ -0,0 +1,371 @@
+/***************************************************************************
+     testqgscopcprovider.cpp
+     --------------------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include <limits>
+
+#include "qgstest.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QApplication>
+#include <QFileInfo>
+#include <QDir>
+
+//qgis includes...
+#include "qgis.h"
+#include "qgsapplication.h"
+#include "qgsproviderregistry.h"
+#include "qgscopcprovider.h"
+#include "qgspointcloudlayer.h"
+#include "qgspointcloudindex.h"
+#include "qgspointcloudlayerelevationproperties.h"
+#include "qgspointcloudrequest.h"
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the COPC provider
+ *
+ * The test file holds four points, one in each node of a small octree, the
+ * deepest node being listed in a child hierarchy page.
+ */
+class TestQgsCopcProvider : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+    void init() {}// will be called before each testfunction is executed.
+    void cleanup() {}// will be called after every testfunction.
+
+    void filters();
+    void preferredUri();
+    void layerTypesForUri();
+    void brokenPath();
+    void validLayer();
+    void hierarchy();
+    void attributes();
+    void calculateZRange();
+    void nodeData();
+    void testIdentify();
+
+  private:
+    QString mTestDataDir;
+    QString mReport;
+};
+
+//runs before all tests
+void TestQgsCopcProvider::initTestCase()
+{
+  // init QGIS's paths - true means that all path will be inited from prefix
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
+  mTestDataDir = QStringLiteral( TEST_DATA_DIR ) + '/'; //defined in CmakeLists.txt
+  mReport = QStringLiteral( "<h1>COPC Provider Tests</h1>\n" );
+}
+
+//runs after all tests
+void TestQgsCopcProvider::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+  QString myReportFile = QDir::tempPath() + "/qgistest.html";
+  QFile myFile( myReportFile );
+  if ( myFile.open( QIODevice::WriteOnly | QIODevice::Append ) )
+  {
+    QTextStream myQTextStream( &myFile );
+    myQTextStream << mReport;
+    myFile.close();
+  }
+}
+
+void TestQgsCopcProvider::filters()
+{
+  QgsProviderMetadata *metadata = QgsProviderRegistry::instance()->providerMetadata( QStringLiteral( "copc" ) );
+  QVERIFY( metadata );
+
+  QCOMPARE( metadata->filters( QgsProviderMetadata::FilterType::FilterPointCloud ), QStringLiteral( "COPC Point Clouds (*.copc.laz *.COPC.LAZ)" ) );
+  QCOMPARE( metadata->filters( QgsProviderMetadata::FilterType::FilterVector ), QString() );
+}
+
+void TestQgsCopcProvider::preferredUri()
+{
+  QgsProviderMetadata *copcMetadata = QgsProviderRegistry::instance()->providerMetadata( QStringLiteral( "copc" ) );
+  QVERIFY( copcMetadata->capabilities() & QgsProviderMetadata::PriorityForUri );
+
+  // test that COPC is the preferred provider for copc.laz uris, even when PDAL can read them too
+  const QList<QgsProviderRegistry::ProviderCandidateDetails> candidates = QgsProviderRegistry::instance()->preferredProvidersForUri( QStringLiteral( "/home/test/cloud.copc.laz" ) );
+  QCOMPARE( candidates.size(), 1 );
+  QCOMPARE( candidates.at( 0 ).metadata()->key(), QStringLiteral( "copc" ) );
+  QCOMPARE( candidates.at( 0 ).layerTypes(), QList< QgsMapLayerType >() << QgsMapLayerType::PointCloudLayer );
+
+  QVERIFY( !QgsProviderRegistry::instance()->shouldDeferUriForOtherProviders( QStringLiteral( "/home/test/cloud.copc.laz" ), QStringLiteral( "copc" ) ) );
+}
+
+void TestQgsCopcProvider::layerTypesForUri()
+{
+  QgsProviderMetadata *copcMetadata = QgsProviderRegistry::instance()->providerMetadata( QStringLiteral( "copc" ) );
+  QVERIFY( copcMetadata->capabilities() & QgsProviderMetadata::LayerTypesForUri );
+
+  QCOMPARE( copcMetadata->validLayerTypesForUri( QStringLiteral( "/home/test/cloud.copc.laz" ) ), QList< QgsMapLayerType >() << QgsMapLayerType::PointCloudLayer );
+  QCOMPARE( copcMetadata->validLayerTypesForUri( QStringLiteral( "/home/test/cloud.laz" ) ), QList< QgsMapLayerType >() );
+}
+
+void TestQgsCopcProvider::brokenPath()
+{
+  // test loading a bad layer URI
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( QStringLiteral( "not valid" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( !layer->isValid() );
+
+  // a LAS file without COPC info
+  layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/las/cloud.las" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( !layer->isValid() );
+}
+
+void TestQgsCopcProvider::validLayer()
+{
+  // octree.copc.laz holds one point per node, so each LAZ chunk stores its point raw and
+  // empty layers. It was written by a script, not by a COPC writer: its chunk table and
+  // layers match the output of the laz-perf arithmetic encoder, but it should be replaced
+  // by a file written with PDAL's writers.copc or untwine.
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  QCOMPARE( layer->crs().authid(), QStringLiteral( "EPSG:32633" ) );
+  QGSCOMPARENEAR( layer->extent().xMinimum(), 93.0, 0.001 );
+  QGSCOMPARENEAR( layer->extent().yMinimum(), 193.0, 0.001 );
+  QGSCOMPARENEAR( layer->extent().xMaximum(), 107.0, 0.001 );
+  QGSCOMPARENEAR( layer->extent().yMaximum(), 207.5, 0.001 );
+  QCOMPARE( layer->dataProvider()->pointCount(), 4 );
+  QCOMPARE( layer->pointCount(), 4 );
+
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+  QVERIFY( index );
+  QCOMPARE( index->scale(), QgsVector3D( 0.01, 0.01, 0.01 ) );
+  QCOMPARE( index->offset(), QgsVector3D( 100, 200, 50 ) );
+  // the octree is a cube of 16 units around the center of the COPC info
+  QGSCOMPARENEAR( index->nodeMapExtent( index->root() ).xMinimum(), 92.0, 0.001 );
+  QGSCOMPARENEAR( index->nodeMapExtent( index->root() ).xMaximum(), 108.0, 0.001 );
+  QGSCOMPARENEAR( index->nodeZRange( index->root() ).lower(), 42.0, 0.001 );
+  QGSCOMPARENEAR( index->nodeZRange( index->root() ).upper(), 58.0, 0.001 );
+  QCOMPARE( index->span(), 128 );
+
+  QCOMPARE( layer->dataProvider()->originalMetadata().value( QStringLiteral( "minor_version" ) ).toInt(), 4 );
+  QCOMPARE( layer->dataProvider()->originalMetadata().value( QStringLiteral( "dataformat_id" ) ).toInt(), 7 );
+}
+
+void TestQgsCopcProvider::hierarchy()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+
+  QVERIFY( index->hasNode( IndexedPointCloudNode::fromString( "0-0-0-0" ) ) );
+  QVERIFY( index->hasNode( IndexedPointCloudNode::fromString( "1-0-0-0" ) ) );
+  QVERIFY( index->hasNode( IndexedPointCloudNode::fromString( "1-1-1-1" ) ) );
+  // a node without points
+  QVERIFY( index->hasNode( IndexedPointCloudNode::fromString( "1-1-0-0" ) ) );
+  // listed in a child hierarchy page
+  QVERIFY( index->hasNode( IndexedPointCloudNode::fromString( "2-3-3-3" ) ) );
+  QVERIFY( !index->hasNode( IndexedPointCloudNode::fromString( "1-0-0-1" ) ) );
+  QVERIFY( !index->hasNode( IndexedPointCloudNode::fromString( "2-0-0-0" ) ) );
+
+  QCOMPARE( index->nodePointCount( IndexedPointCloudNode::fromString( "0-0-0-0" ) ), 1 );
+  QCOMPARE( index->nodePointCount( IndexedPointCloudNode::fromString( "1-1-0-0" ) ), 0 );
+  QCOMPARE( index->nodePointCount( IndexedPointCloudNode::fromString( "2-3-3-3" ) ), 1 );
+
+  QList<IndexedPointCloudNode> children = index->nodeChildren( index->root() );
+  std::sort( children.begin(), children.end(), []( const IndexedPointCloudNode & a, const IndexedPointCloudNode & b ) { return a.toString() < b.toString(); } );
+  QCOMPARE( children.size(), 3 );
+  QCOMPARE( children.at( 0 ).toString(), QStringLiteral( "1-0-0-0" ) );
+  QCOMPARE( children.at( 1 ).toString(), QStringLiteral( "1-1-0-0" ) );
+  QCOMPARE( children.at( 2 ).toString(), QStringLiteral( "1-1-1-1" ) );
+  children = index->nodeChildren( IndexedPointCloudNode::fromString( "1-1-1-1" ) );
+  QCOMPARE( children.size(), 1 );
+  QCOMPARE( children.at( 0 ).toString(), QStringLiteral( "2-3-3-3" ) );
+}
+
+void TestQgsCopcProvider::attributes()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  const QgsPointCloudAttributeCollection attributes = layer->attributes();
+  QCOMPARE( attributes.count(), 21 );
+  QCOMPARE( attributes.at( 0 ).name(), QStringLiteral( "X" ) );
+  QCOMPARE( attributes.at( 0 ).type(), QgsPointCloudAttribute::Int32 );
+  QCOMPARE( attributes.at( 1 ).name(), QStringLiteral( "Y" ) );
+  QCOMPARE( attributes.at( 1 ).type(), QgsPointCloudAttribute::Int32 );
+  QCOMPARE( attributes.at( 2 ).name(), QStringLiteral( "Z" ) );
+  QCOMPARE( attributes.at( 2 ).type(), QgsPointCloudAttribute::Int32 );
+  QCOMPARE( attributes.at( 3 ).name(), QStringLiteral( "Intensity" ) );
+  QCOMPARE( attributes.at( 3 ).type(), QgsPointCloudAttribute::UShort );
+  QCOMPARE( attributes.at( 4 ).name(), QStringLiteral( "ReturnNumber" ) );
+  QCOMPARE( attributes.at( 4 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 5 ).name(), QStringLiteral( "NumberOfReturns" ) );
+  QCOMPARE( attributes.at( 5 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 6 ).name(), QStringLiteral( "ScanDirectionFlag" ) );
+  QCOMPARE( attributes.at( 6 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 7 ).name(), QStringLiteral( "EdgeOfFlightLine" ) );
+  QCOMPARE( attributes.at( 7 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 8 ).name(), QStringLiteral( "Classification" ) );
+  QCOMPARE( attributes.at( 8 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 9 ).name(), QStringLiteral( "ScanAngleRank" ) );
+  QCOMPARE( attributes.at( 9 ).type(), QgsPointCloudAttribute::Short );
+  QCOMPARE( attributes.at( 10 ).name(), QStringLiteral( "UserData" ) );
+  QCOMPARE( attributes.at( 10 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 11 ).name(), QStringLiteral( "PointSourceId" ) );
+  QCOMPARE( attributes.at( 11 ).type(), QgsPointCloudAttribute::UShort );
+  QCOMPARE( attributes.at( 12 ).name(), QStringLiteral( "Synthetic" ) );
+  QCOMPARE( attributes.at( 12 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 13 ).name(), QStringLiteral( "KeyPoint" ) );
+  QCOMPARE( attributes.at( 13 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 14 ).name(), QStringLiteral( "Withheld" ) );
+  QCOMPARE( attributes.at( 14 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 15 ).name(), QStringLiteral( "Overlap" ) );
+  QCOMPARE( attributes.at( 15 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 16 ).name(), QStringLiteral( "ScannerChannel" ) );
+  QCOMPARE( attributes.at( 16 ).type(), QgsPointCloudAttribute::Char );
+  QCOMPARE( attributes.at( 17 ).name(), QStringLiteral( "GpsTime" ) );
+  QCOMPARE( attributes.at( 17 ).type(), QgsPointCloudAttribute::Double );
+  QCOMPARE( attributes.at( 18 ).name(), QStringLiteral( "Red" ) );
+  QCOMPARE( attributes.at( 18 ).type(), QgsPointCloudAttribute::UShort );
+  QCOMPARE( attributes.at( 19 ).name(), QStringLiteral( "Green" ) );
+  QCOMPARE( attributes.at( 19 ).type(), QgsPointCloudAttribute::UShort );
+  QCOMPARE( attributes.at( 20 ).name(), QStringLiteral( "Blue" ) );
+  QCOMPARE( attributes.at( 20 ).type(), QgsPointCloudAttribute::UShort );
+}
+
+void TestQgsCopcProvider::calculateZRange()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  QgsDoubleRange range = layer->elevationProperties()->calculateZRange( layer.get() );
+  QGSCOMPARENEAR( range.lower(), 43.0, 0.01 );
+  QGSCOMPARENEAR( range.upper(), 57.5, 0.01 );
+
+  static_cast< QgsPointCloudLayerElevationProperties * >( layer->elevationProperties() )->setZScale( 2 );
+  static_cast< QgsPointCloudLayerElevationProperties * >( layer->elevationProperties() )->setZOffset( 0.5 );
+
+  range = layer->elevationProperties()->calculateZRange( layer.get() );
+  QGSCOMPARENEAR( range.lower(), 86.5, 0.01 );
+  QGSCOMPARENEAR( range.upper(), 115.5, 0.01 );
+}
+
+void TestQgsCopcProvider::nodeData()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+
+  QgsPointCloudAttributeCollection attributes;
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "X" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Y" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Z" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Classification" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Synthetic" ), QgsPointCloudAttribute::Char ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "GpsTime" ), QgsPointCloudAttribute::Double ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Red" ), QgsPointCloudAttribute::UShort ) );
+  // not stored in point format 7
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Infrared" ), QgsPointCloudAttribute::UShort ) );
+  QgsPointCloudRequest request;
+  request.setAttributes( attributes );
+
+  // the deepest node, listed in a child hierarchy page
+  std::unique_ptr< QgsPointCloudBlock > block( index->nodeData( IndexedPointCloudNode::fromString( "2-3-3-3" ), request ) );
+  QVERIFY( block );
+  QCOMPARE( block->pointCount(), 1 );
+  QCOMPARE( block->attributes().pointRecordSize(), 26 );
+  QCOMPARE( block->scale(), QgsVector3D( 0.01, 0.01, 0.01 ) );
+  QCOMPARE( block->offset(), QgsVector3D( 100, 200, 50 ) );
+
+  const QVariantMap values = QgsPointCloudAttribute::getAttributeMap( block->data(), 0, block->attributes() );
+  QCOMPARE( values.value( QStringLiteral( "X" ) ).toInt(), 700 );
+  QCOMPARE( values.value( QStringLiteral( "Y" ) ).toInt(), 750 );
+  QCOMPARE( values.value( QStringLiteral( "Z" ) ).toInt(), 750 );
+  QCOMPARE( values.value( QStringLiteral( "Classification" ) ).toInt(), 6 );
+  QCOMPARE( values.value( QStringLiteral( "Synthetic" ) ).toInt(), 1 );
+  QCOMPARE( values.value( QStringLiteral( "GpsTime" ) ).toDouble(), 4.75 );
+  QCOMPARE( values.value( QStringLiteral( "Red" ) ).toInt(), 65535 );
+  QCOMPARE( values.value( QStringLiteral( "Infrared" ) ).toInt(), 0 );
+
+  // the second request is served from the cache, with the same content
+  std::unique_ptr< QgsPointCloudBlock > cached( index->nodeData( IndexedPointCloudNode::fromString( "2-3-3-3" ), request ) );
+  QVERIFY( cached );
+  QCOMPARE( cached->pointCount(), 1 );
+  QCOMPARE( QByteArray( cached->data(), 26 ), QByteArray( block->data(), 26 ) );
+
+  // a node without points
+  block.reset( index->nodeData( IndexedPointCloudNode::fromString( "1-1-0-0" ), request ) );
+  QVERIFY( block );
+  QCOMPARE( block->pointCount(), 0 );
+
+  // a node which is not in the hierarchy
+  block.reset( index->nodeData( IndexedPointCloudNode::fromString( "2-0-0-0" ), request ) );
+  QVERIFY( !block );
+}
+
+void TestQgsCopcProvider::testIdentify()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/copc/octree.copc.laz" ), QStringLiteral( "layer" ), QStringLiteral( "copc" ) );
+  QVERIFY( layer->isValid() );
+
+  // the point of the root node
+  {
+    const QgsGeometry extent = QgsGeometry::fromRect( QgsRectangle( 100.45, 200.2, 100.55, 200.3 ) );
+    const QVector<QMap<QString, QVariant>> points = layer->dataProvider()->identify( 0.01, extent );
+    QCOMPARE( points.size(), 1 );
+    QMap<QString, QVariant> expected;
+    expected[ QStringLiteral( "Blue" ) ] = 3000;
+    expected[ QStringLiteral( "Classification" ) ] = 2;
+    expected[ QStringLiteral( "EdgeOfFlightLine" ) ] = 0;
+    expected[ QStringLiteral( "GpsTime" ) ] = 1.5;
+    expected[ QStringLiteral( "Green" ) ] = 2000;
+    expected[ QStringLiteral( "Intensity" ) ] = 100;
+    expected[ QStringLiteral( "KeyPoint" ) ] = 0;
+    expected[ QStringLiteral( "NumberOfReturns" ) ] = 1;
+    expected[ QStringLiteral( "Overlap" ) ] = 0;
+    expected[ QStringLiteral( "PointSourceId" ) ] = 11;
+    expected[ QStringLiteral( "Red" ) ] = 1000;
+    expected[ QStringLiteral( "ReturnNumber" ) ] = 1;
+    expected[ QStringLiteral( "ScanAngleRank" ) ] = -15;
+    expected[ QStringLiteral( "ScanDirectionFlag" ) ] = 1;
+    expected[ QStringLiteral( "ScannerChannel" ) ] = 0;
+    expected[ QStringLiteral( "Synthetic" ) ] = 0;
+    expected[ QStringLiteral( "UserData" ) ] = 7;
+    expected[ QStringLiteral( "Withheld" ) ] = 0;
+    expected[ QStringLiteral( "X" ) ] = 100.5;
+    expected[ QStringLiteral( "Y" ) ] = 200.25;
+    expected[ QStringLiteral( "Z" ) ] = 50.75;
+    QVERIFY( points.at( 0 ) == expected );
+  }
+
+  // points of the first level, one of them in the empty z range
+  {
+    const QgsGeometry extent = QgsGeometry::fromRect( QgsRectangle( 92, 192, 108, 208 ) );
+    QVector<QMap<QString, QVariant>> points = layer->dataProvider()->identify( 0.01, extent, QgsDoubleRange( 42, 56 ) );
+    QCOMPARE( points.size(), 3 );
+    std::sort( points.begin(), points.end(), []( const QMap<QString, QVariant> &a, const QMap<QString, QVariant> &b ) { return a.value( QStringLiteral( "GpsTime" ) ).toDouble() < b.value( QStringLiteral( "GpsTime" ) ).toDouble(); } );
+    QCOMPARE( points.at( 0 ).value( QStringLiteral( "Classification" ) ).toInt(), 2 );
+    QCOMPARE( points.at( 1 ).value( QStringLiteral( "Classification" ) ).toInt(), 3 );
+    QCOMPARE( points.at( 1 ).value( QStringLiteral( "NumberOfReturns" ) ).toInt(), 2 );
+    QCOMPARE( points.at( 2 ).value( QStringLiteral( "Classification" ) ).toInt(), 5 );
+    QCOMPARE( points.at( 2 ).value( QStringLiteral( "EdgeOfFlightLine" ) ).toInt(), 1 );
+    QCOMPARE( points.at( 2 ).value( QStringLiteral( "ScanAngleRank" ) ).toInt(), 30 );
+  }
+}
+
+QGSTEST_MAIN( TestQgsCopcProvider )
+#include "testqgscopcprovider.moc"
@@ -13,6 +13,7 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <functional>
 #include <limits>
 
 #include "qgstest.h"
@@ -22,6 +23,7 @@
 #include <QApplication>
 #include <QFileInfo>
 #include <QDir>
+#include <QSignalSpy>
 
 //qgis includes...
 #include "qgis.h"
@@ -31,6 +33,10 @@
 #include "qgspointcloudlayer.h"
 #include "qgspointcloudindex.h"
 #include "qgspointcloudlayerelevationproperties.h"
+#include "qgspointcloudrequest.h"
+#include "qgspointcloudblockrequest.h"
+#include "qgspointcloudlayerrenderer_p.h"
+#include "qgsrendercontext.h"
 
 /**
  * \ingroup UnitTests
@@ -57,6 +63,8 @@ class TestQgsEptProvider : public QObject
     void validLayerWithEptHierarchy();
     void attributes();
     void calculateZRange();
+    void nodeDataCache();
+    void traverseTree();
     void testIdentify();
 
   private:
@@ -196,6 +204,12 @@ void TestQgsEptProvider::validLayerWithEptHierarchy()
   // all hierarchy is stored in multiple nodes
   QVERIFY( layer->dataProvider()->index()->hasNode( IndexedPointCloudNode::fromString( "1-1-1-1" ) ) );
   QVERIFY( layer->dataProvider()->index()->hasNode( IndexedPointCloudNode::fromString( "2-3-3-1" ) ) );
+
+  QCOMPARE( layer->dataProvider()->index()->nodePointCount( IndexedPointCloudNode::fromString( "0-0-0-0" ) ), 41998 );
+  QCOMPARE( layer->dataProvider()->index()->nodePointCount( IndexedPointCloudNode::fromString( "1-1-1-1" ) ), 48879 );
+  QCOMPARE( layer->dataProvider()->index()->nodePointCount( IndexedPointCloudNode::fromString( "2-2-2-1" ) ), 85048 );
+  QCOMPARE( layer->dataProvider()->index()->nodePointCount( IndexedPointCloudNode::fromString( "3-5-4-4" ) ), 21327 );
+  QCOMPARE( layer->dataProvider()->index()->nodePointCount( IndexedPointCloudNode::fromString( "1-0-0-1" ) ), -1 );
 }
 
 void TestQgsEptProvider::attributes()
@@ -256,6 +270,120 @@ void TestQgsEptProvider::calculateZRange()
   QGSCOMPARENEAR( range.upper(), 160.54, 0.01 );
 }
 
+void TestQgsEptProvider::nodeDataCache()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/sunshine-coast/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
+  QVERIFY( layer->isValid() );
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+
+  QgsPointCloudAttributeCollection attributes;
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "X" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Classification" ), QgsPointCloudAttribute::Char ) );
+  QgsPointCloudRequest request;
+  request.setAttributes( attributes );
+
+  std::unique_ptr< QgsPointCloudBlock > decoded( index->nodeData( index->root(), request ) );
+  QVERIFY( decoded );
+  QVERIFY( decoded->pointCount() > 0 );
+
+  // the second request is served from the cache, with the same content
+  std::unique_ptr< QgsPointCloudBlock > cached( index->nodeData( index->root(), request ) );
+  QVERIFY( cached );
+  QVERIFY( cached.get() != decoded.get() );
+  QCOMPARE( cached->pointCount(), decoded->pointCount() );
+  QCOMPARE( cached->attributes().pointRecordSize(), 5 );
+  const int size = decoded->pointCount() * decoded->attributes().pointRecordSize();
+  QCOMPARE( QByteArray( cached->data(), size ), QByteArray( decoded->data(), size ) );
+
+  // other attributes must not be served the cached block
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Intensity" ), QgsPointCloudAttribute::UShort ) );
+  request.setAttributes( attributes );
+  std::unique_ptr< QgsPointCloudBlock > otherAttributes( index->nodeData( index->root(), request ) );
+  QVERIFY( otherAttributes );
+  QCOMPARE( otherAttributes->pointCount(), decoded->pointCount() );
+  QCOMPARE( otherAttributes->attributes().pointRecordSize(), 7 );
+
+  // another layer reading the same index shares the cache
+  std::unique_ptr< QgsPointCloudLayer > layer2 = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/sunshine-coast/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
+  std::unique_ptr< QgsPointCloudBlock > shared( layer2->dataProvider()->index()->nodeData( index->root(), request ) );
+  QVERIFY( shared );
+  QCOMPARE( shared->pointCount(), decoded->pointCount() );
+
+  // remote indexes hand cached blocks over through an already finished request
+  QgsPointCloudBlock *cachedBlock = shared.release();
+  QgsPointCloudBlockRequest blockRequest( index->root(), cachedBlock );
+  QSignalSpy spyFinished( &blockRequest, &QgsPointCloudBlockRequest::finished );
+  QCOMPARE( spyFinished.count(), 0 );
+  QVERIFY( spyFinished.wait() );
+  QCOMPARE( blockRequest.block(), cachedBlock );
+  delete blockRequest.block();
+}
+
+void TestQgsEptProvider::traverseTree()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/lone-star-laszip/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
+  QVERIFY( layer->isValid() );
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+
+  QgsRenderContext context;
+  context.setExtent( layer->extent() );
+  const QgsPointCloudNodeTraversal traversal( index, context );
+
+  // without budget, the whole hierarchy is returned in depth-first order
+  QVector<IndexedPointCloudNode> expected;
+  std::function< void( const IndexedPointCloudNode & ) > visit = [&expected, &visit, index]( const IndexedPointCloudNode & node )
+  {
+    expected << node;
+    for ( const IndexedPointCloudNode &child : index->nodeChildren( node ) )
+      visit( child );
+  };
+  visit( index->root() );
+  QCOMPARE( expected.size(), 13 );
+  QCOMPARE( traversal.traverseTree( index->root(), 0, 1 ), expected );
+
+  const auto pointCount = [index]( const QVector<IndexedPointCloudNode> &nodes )
+  {
+    qint64 count = 0;
+    for ( const IndexedPointCloudNode &node : nodes )
+      count += index->nodePointCount( node );
+    return count;
+  };
+
+  // with a budget, coarse levels are selected first and are never partially dropped for a finer one
+  const int levelsPoints = 41998 + 22108 + 25867 + 37195 + 32867 + 48879;
+  QVector<IndexedPointCloudNode> nodes = traversal.traverseTreeWithBudget( index->root(), 0, 1, levelsPoints );
+  QCOMPARE( nodes.size(), 6 );
+  QCOMPARE( nodes.at( 0 ), index->root() );
+  for ( int i = 1; i < nodes.size(); ++i )
+    QCOMPARE( nodes.at( i ).d(), 1 );
+  QCOMPARE( pointCount( nodes ), levelsPoints );
+
+  nodes = traversal.traverseTreeWithBudget( index->root(), 0, 1, levelsPoints + 100000 );
+  QVERIFY( nodes.size() > 6 );
+  QVERIFY( nodes.size() < expected.size() );
+  QVERIFY( pointCount( nodes ) <= levelsPoints + 100000 );
+  for ( int i = 1; i < nodes.size(); ++i )
+  {
+    QVERIFY( nodes.at( i ).d() >= nodes.at( i - 1 ).d() );
+    QVERIFY( nodes.mid( 0, i ).contains( nodes.at( i ).parentNode() ) );
+  }
+
+  // the root is always selected, even when it alone exceeds the budget
+  nodes = traversal.traverseTreeWithBudget( index->root(), 0, 1, 1 );
+  QCOMPARE( nodes, QVector<IndexedPointCloudNode>() << index->root() );
+
+  // a large budget selects the same nodes as the depth-first traversal
+  nodes = traversal.traverseTreeWithBudget( index->root(), 0, 1, std::numeric_limits<int>::max() );
+  QCOMPARE( nodes.size(), expected.size() );
+  for ( const IndexedPointCloudNode &node : std::as_const( expected ) )
+    QVERIFY( nodes.contains( node ) );
+
+  // the error threshold still limits the refinement
+  nodes = traversal.traverseTreeWithBudget( index->root(), 1, 2, std::numeric_limits<int>::max() );
+  QCOMPARE( nodes.size(), 6 );
+  QCOMPARE( traversal.traverseTree( index->root(), 1, 2 ).size(), 6 );
+}
+
 void TestQgsEptProvider::testIdentify()
 {
   std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/sunshine-coast/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
@@ -50,6 +50,7 @@ from qgis.core import (
     QgsVectorDataProvider,
     QgsDataSourceUri,
     QgsProviderConnectionException,
+    QgsFeatureSink,
 )
 from qgis.gui import QgsGui, QgsAttributeForm
 from qgis.PyQt.QtCore import QDate, QTime, QDateTime, QVariant, QDir, QObject, QByteArray, QTemporaryDir
@@ -2262,6 +2263,118 @@ class TestPyQgsPostgresProvider(unittest.TestCase, ProviderTestCase):
         self.assertEqual(vl.featureCount(), 4000)
         print("--- %s seconds ---" % (time.time() - start_time))
 
+    def testAddFeaturesCopy(self):
+        """Test that large batches of features are inserted with a binary COPY"""
+
+        self.execSQLCommand('DROP TABLE IF EXISTS qgis_test.add_features_copy')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test.add_features_copy(pk SERIAL NOT NULL PRIMARY KEY, '
+            'name TEXT, num INTEGER, big BIGINT, val DOUBLE PRECISION, flag BOOLEAN, '
+            'day DATE, ts TIMESTAMP, created TEXT DEFAULT \'auto\', geom public.geometry(MultiPoint, 4326))')
+
+        vl = QgsVectorLayer(
+            self.dbconn +
+            ' sslmode=disable key=\'pk\' srid=4326 type=MULTIPOINT table="qgis_test"."add_features_copy" (geom) sql=',
+            'test_add_features_copy', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        features = []
+        for i in range(1000):
+            f = QgsFeature(vl.fields())
+            f.setAttributes([None, 'name %d' % i, i, i * 10000000000, i / 4, i % 2 == 0,
+                             QDate(2021, 1, 1).addDays(i), QDateTime(QDate(2021, 10, 18), QTime(12, 30, i % 60)), None])
+            # single points are promoted to the layer multi type
+            f.setGeometry(QgsGeometry.fromWkt('Point (%d %d)' % (i % 180, i % 90)) if i % 10 else QgsGeometry())
+            features.append(f)
+
+        self.assertTrue(vl.dataProvider().addFeatures(features, QgsFeatureSink.FastInsert))
+        self.assertEqual(vl.dataProvider().featureCount(), 1000)
+
+        cur = self.con.cursor()
+        cur.execute('SELECT COUNT(DISTINCT pk), COUNT(*) FILTER (WHERE created = \'auto\'), COUNT(geom) '
+                    'FROM qgis_test.add_features_copy')
+        self.assertEqual(cur.fetchone(), (1000, 1000, 900))
+        cur.execute('SELECT name, num, big, val, flag, day::text, ts::text, ST_AsText(geom), ST_SRID(geom) '
+                    'FROM qgis_test.add_features_copy WHERE num = 123')
+        self.assertEqual(cur.fetchone(), ('name 123', 123, 1230000000000, 30.75, False, '2021-05-04',
+                                          '2021-10-18 12:30:03', 'MULTIPOINT(123 33)', 4326))
+        cur.close()
+
+    def testFetchBinaryValues(self):
+        """Test values decoded from the binary cursor over several prefetched batches"""
+
+        self.execSQLCommand('DROP TABLE IF EXISTS qgis_test.fetch_binary_values')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test.fetch_binary_values AS SELECT i AS pk, i::int2 AS small, i * 3 AS num, '
+            'i / 8.0::float8 AS val, i % 3 = 0 AS flag, DATE \'2021-01-01\' + i AS day, '
+            'TIMESTAMP \'2021-10-18 12:30:00\' + i * INTERVAL \'1 second\' AS ts FROM generate_series(1, 25000) AS i')
+        self.execSQLCommand('UPDATE qgis_test.fetch_binary_values SET small = NULL, day = NULL, ts = \'infinity\' WHERE pk = 7')
+        self.execSQLCommand('ALTER TABLE qgis_test.fetch_binary_values ADD PRIMARY KEY (pk)')
+
+        vl = QgsVectorLayer(self.dbconn + ' sslmode=disable key=\'pk\' table="qgis_test"."fetch_binary_values" sql=',
+                            'test_fetch_binary_values', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        count = 0
+        for f in vl.getFeatures(QgsFeatureRequest().addOrderBy('pk')):
+            count += 1
+            i = f['pk']
+            self.assertEqual(i, count)
+            if i == 7:
+                self.assertEqual(f['small'], NULL)
+                self.assertEqual(f['day'], NULL)
+                self.assertEqual(f['ts'], NULL)
+                continue
+            self.assertEqual(f['small'], i)
+            self.assertEqual(f['num'], i * 3)
+            self.assertEqual(f['val'], i / 8.0)
+            self.assertEqual(f['flag'], i % 3 == 0)
+            self.assertEqual(f['day'], QDate(2021, 1, 1).addDays(i))
+            self.assertEqual(f['ts'], QDateTime(QDate(2021, 10, 18), QTime(12, 30, 0)).addSecs(i))
+        self.assertEqual(count, 25000)
+
+        # stopping the iteration while the next batch is prefetched leaves the connection usable
+        self.assertEqual(len([f for f in vl.getFeatures(QgsFeatureRequest().setLimit(10))]), 10)
+        it = vl.getFeatures()
+        f = QgsFeature()
+        self.assertTrue(it.nextFeature(f))
+        self.assertTrue(it.rewind())
+        self.assertEqual(len([f for f in it]), 25000)
+
+    def testAddFeaturesCopyView(self):
+        """Test that large batches of features inserted in an editable view do not use COPY"""
+
+        self.execSQLCommand('DROP VIEW IF EXISTS qgis_test.add_features_copy_view')
+        self.execSQLCommand('DROP TABLE IF EXISTS qgis_test.add_features_copy_view_table')
+        self.execSQLCommand(
+            'CREATE TABLE qgis_test.add_features_copy_view_table(pk SERIAL NOT NULL PRIMARY KEY, '
+            'name TEXT, geom public.geometry(Point, 4326))')
+        self.execSQLCommand(
+            'CREATE VIEW qgis_test.add_features_copy_view AS SELECT * FROM qgis_test.add_features_copy_view_table')
+        self.execSQLCommand(
+            'CREATE RULE add_features_copy_view_insert AS ON INSERT TO qgis_test.add_features_copy_view '
+            'DO INSTEAD INSERT INTO qgis_test.add_features_copy_view_table(name, geom) VALUES (NEW.name, NEW.geom)')
+
+        vl = QgsVectorLayer(
+            self.dbconn +
+            ' sslmode=disable key=\'pk\' srid=4326 type=POINT table="qgis_test"."add_features_copy_view" (geom) sql=',
+            'test_add_features_copy_view', 'postgres')
+        self.assertTrue(vl.isValid())
+
+        features = []
+        for i in range(200):
+            f = QgsFeature(vl.fields())
+            f.setAttributes([None, 'name %d' % i])
+            f.setGeometry(QgsGeometry.fromWkt('Point (%d %d)' % (i % 180, i % 90)))
+            features.append(f)
+
+        self.assertTrue(vl.dataProvider().addFeatures(features, QgsFeatureSink.FastInsert))
+
+        cur = self.con.cursor()
+        cur.execute('SELECT COUNT(*) FROM qgis_test.add_features_copy_view_table')
+        self.assertEqual(cur.fetchone(), (200, ))
+        cur.close()
+
     def testFilterOnCustomBbox(self):
         extent = QgsRectangle(-68, 70, -67, 80)
         request = QgsFeatureRequest().setFilterRect(extent)
@@ -1025,5 +1025,113 @@ class TestQgsDelimitedTextProviderOther(unittest.TestCase):
             del os.environ['QGIS_DELIMITED_TEXT_FILE_BUFFER_SIZE']
 
 
+    def testRandomAccessMappedFile(self):
+        # Features requested by id jump through the line offsets of the memory mapped file
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        with os.fdopen(filehandle, 'wb') as f:
+            # byte order mark, multi line quoted records, blank and non ascii lines
+            f.write(b'\xef\xbb\xbfid,name,x\r\n')
+            for i in range(1000):
+                if i % 100 == 0:
+                    f.write('{},"line\r\nbreak {}",{}\r\n'.format(i, i, i / 2).encode('utf-8'))
+                else:
+                    f.write('{},\u00e9t\u00e9 {},{}\r\n'.format(i, i, i / 2).encode('utf-8'))
+                if i % 7 == 0:
+                    f.write(b'\r\n')
+
+        try:
+            url = MyUrl.fromLocalFile(filename)
+            url.addQueryItem('type', 'csv')
+            url.addQueryItem('geomType', 'none')
+            vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+            self.assertTrue(vl.isValid())
+            self.assertEqual(vl.fields().names(), ['id', 'name', 'x'])
+            self.assertEqual(vl.featureCount(), 1000)
+
+            features = {f['id']: f for f in vl.getFeatures()}
+            self.assertEqual(len(features), 1000)
+            self.assertEqual(features[100]['name'], 'line\nbreak 100')
+            self.assertEqual(features[101]['name'], '\u00e9t\u00e9 101')
+
+            # request features backwards, then forwards across the offsets
+            for i in list(range(999, -1, -37)) + list(range(3, 1000, 53)):
+                f = next(vl.getFeatures(QgsFeatureRequest(features[i].id())))
+                self.assertEqual(f.attributes(), features[i].attributes())
+        finally:
+            del vl
+            os.remove(filename)
+
+    def testRandomAccessUsesProviderLineOffsets(self):
+        # The line offsets recorded while the provider scans the file are used by the
+        # feature iterators, which jump to the requested line instead of reading from the start
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        with os.fdopen(filehandle, 'wb') as f:
+            f.write(b'id,name\n')
+            for i in range(1000):
+                f.write('{},name {}\n'.format(i, i).encode('utf-8'))
+
+        try:
+            url = MyUrl.fromLocalFile(filename)
+            url.addQueryItem('type', 'csv')
+            url.addQueryItem('geomType', 'none')
+            vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+            self.assertTrue(vl.isValid())
+            self.assertEqual(vl.featureCount(), 1000)
+            fids = {f['id']: f.id() for f in vl.getFeatures()}
+
+            # Join the lines of records 10 and 11, without changing the size nor the
+            # modification time of the file. Reading from the start of the file now
+            # shifts all the following lines, jumping to a recorded line offset does not.
+            stat = os.stat(filename)
+            with open(filename, 'r+b') as f:
+                content = f.read()
+                pos = content.index(b'10,name 10\n') + len(b'10,name 10')
+                f.seek(pos)
+                f.write(b' ')
+            os.utime(filename, ns=(stat.st_atime_ns, stat.st_mtime_ns))
+
+            for i in (500, 999, 700):
+                f = next(vl.getFeatures(QgsFeatureRequest(fids[i])))
+                self.assertEqual(f.attributes(), [i, 'name {}'.format(i)])
+        finally:
+            del vl
+            os.remove(filename)
+
+    def testFileTruncatedWhileRead(self):
+        # Files which are not watched are read through a memory map. Truncating the
+        # file while it is read ends the iteration instead of crashing
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        with os.fdopen(filehandle, 'wb') as f:
+            f.write(b'id,name\n')
+            for i in range(1000):
+                f.write('{},name {}\n'.format(i, i).encode('utf-8'))
+
+        try:
+            url = MyUrl.fromLocalFile(filename)
+            url.addQueryItem('type', 'csv')
+            url.addQueryItem('geomType', 'none')
+            url.addQueryItem('watchFile', 'no')
+            vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+            self.assertTrue(vl.isValid())
+            self.assertEqual(vl.featureCount(), 1000)
+
+            it = vl.getFeatures()
+            f = QgsFeature()
+            self.assertTrue(it.nextFeature(f))
+            self.assertEqual(f['id'], 0)
+
+            with open(filename, 'r+b') as f:
+                f.truncate(100)
+
+            count = 1
+            f = QgsFeature()
+            while it.nextFeature(f):
+                count += 1
+            self.assertLess(count, 1000)
+        finally:
+            del vl
+            os.remove(filename)
+
+
 if __name__ == '__main__':
     unittest.main()
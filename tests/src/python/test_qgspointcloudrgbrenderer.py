@@ -116,6 +116,7 @@ class TestQgsPointCloudRgbRenderer(unittest.TestCase):
         renderer.setBlueContrastEnhancement(bluece)
 
         renderer.setMaximumScreenError(18)
+        renderer.setPointBudget(5000)
         renderer.setMaximumScreenErrorUnit(QgsUnitTypes.RenderInches)
         renderer.setPointSize(13)
         renderer.setPointSizeUnit(QgsUnitTypes.RenderPoints)
@@ -123,6 +124,7 @@ class TestQgsPointCloudRgbRenderer(unittest.TestCase):
 
         rr = renderer.clone()
         self.assertEqual(rr.maximumScreenError(), 18)
+        self.assertEqual(rr.pointBudget(), 5000)
         self.assertEqual(rr.maximumScreenErrorUnit(), QgsUnitTypes.RenderInches)
         self.assertEqual(rr.pointSize(), 13)
         self.assertEqual(rr.pointSizeUnit(), QgsUnitTypes.RenderPoints)
@@ -150,6 +152,7 @@ class TestQgsPointCloudRgbRenderer(unittest.TestCase):
 
         r2 = QgsPointCloudRgbRenderer.create(elem, QgsReadWriteContext())
         self.assertEqual(r2.maximumScreenError(), 18)
+        self.assertEqual(r2.pointBudget(), 5000)
         self.assertEqual(r2.maximumScreenErrorUnit(), QgsUnitTypes.RenderInches)
         self.assertEqual(r2.pointSize(), 13)
         self.assertEqual(r2.pointSizeUnit(), QgsUnitTypes.RenderPoints)
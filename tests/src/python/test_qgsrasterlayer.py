@@ -53,6 +53,7 @@ from qgis.core import (Qgis,
                        QgsCoordinateTransformContext,
                        QgsCoordinateReferenceSystem,
                        QgsRasterHistogram,
+                       QgsRasterBandStats,
                        QgsCubicRasterResampler,
                        QgsBilinearRasterResampler,
                        QgsLayerDefinition,
@@ -871,6 +872,38 @@ class TestQgsRasterLayer(unittest.TestCase):
             class_values.append(c.value)
         self.assertEqual(sorted(class_values), list(range(65536)))
 
+    def testStatisticsMultipleBlocks(self):
+        """Test generic statistics computed from several blocks with no data"""
+
+        tempdir = QTemporaryDir()
+        temppath = os.path.join(tempdir.path(), 'statistics.tif')
+
+        driver = gdal.GetDriverByName('GTiff')
+        outRaster = driver.Create(temppath, 600, 520, 1, gdal.GDT_Float32, ['TILED=YES', 'BLOCKXSIZE=128', 'BLOCKYSIZE=128'])
+        outRaster.SetGeoTransform([0, 1, 0, 520, 0, -1])
+        outband = outRaster.GetRasterBand(1)
+        outband.SetNoDataValue(-9999)
+        rows, columns = np.mgrid[0:520, 0:600]
+        npdata = ((rows * 13 + columns * 7) % 101).astype(np.float32) * 0.5 - 10
+        npdata[::17, ::3] = -9999
+        outband.WriteArray(npdata)
+        outband.FlushCache()
+        outRaster.FlushCache()
+        del outRaster
+
+        layer = QgsRasterLayer(temppath, 'statistics')
+        self.assertTrue(layer.isValid())
+
+        # sum is not provided by GDAL, so the generic statistics are used
+        stats = layer.dataProvider().bandStatistics(1, QgsRasterBandStats.All, layer.extent())
+        values = npdata[npdata != -9999].astype(np.float64)
+        self.assertEqual(stats.elementCount, values.size)
+        self.assertEqual(stats.minimumValue, values.min())
+        self.assertEqual(stats.maximumValue, values.max())
+        self.assertAlmostEqual(stats.sum, values.sum(), 3)
+        self.assertAlmostEqual(stats.mean, values.mean(), 8)
+        self.assertAlmostEqual(stats.stdDev, values.std(ddof=1), 8)
+
     def testClone(self):
         myPath = os.path.join(unitTestDataPath('raster'),
                               'band1_float32_noct_epsg4326.tif')
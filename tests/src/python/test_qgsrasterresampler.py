@@ -21,7 +21,8 @@ import qgis  # NOQA
 
 import os
 
-from qgis.PyQt.QtGui import qRed
+from qgis.PyQt.QtCore import QSize
+from qgis.PyQt.QtGui import QImage, qRed, qRgba
 
 from qgis.core import (QgsRasterLayer,
                        QgsRectangle,
@@ -356,6 +357,23 @@ class TestQgsRasterResampler(unittest.TestCase):
                               ymax - 2.25 * yres)
         return extent
 
+    def testCubicResampleLargeImage(self):
+        """Images large enough to be resampled in several row bands must match a single GDAL read"""
+        width, height = 300, 200
+        image = QImage(width, height, QImage.Format_ARGB32_Premultiplied)
+        for y in range(height):
+            for x in range(width):
+                image.setPixel(x, y, qRgba((x * 7) % 256, (y * 5) % 256, (x * y) % 256, 255))
+
+        size = QSize(700, 500)
+        resampled = QgsCubicRasterResampler().resampleV2(image, size)
+        self.assertEqual(resampled.size(), size)
+
+        ds = gdal.GetDriverByName('MEM').Create('', width, height, 1, gdal.GDT_Byte)
+        ds.GetRasterBand(1).WriteRaster(0, 0, width, height, bytes(qRed(image.pixel(x, y)) for y in range(height) for x in range(width)))
+        expected = ds.GetRasterBand(1).ReadRaster(0, 0, width, height, buf_xsize=size.width(), buf_ysize=size.height(), resample_alg=gdal.GRIORA_Cubic)
+        self.assertEqual(bytes(qRed(resampled.pixel(x, y)) for y in range(size.height()) for x in range(size.width())), expected)
+
     def checkRawBlockContents(self, block, expected):
         res = []
         for r in range(block.height()):
@@ -0,0 +1,136 @@
+# -*- coding: utf-8 -*-
+"""QGIS Unit tests for the QgsServer built-in WMTS tile cache.
+
+From build dir, run: ctest -R PyQgsServerWMTSCache -V
+
+.. note:: This test needs env vars to be set before the server is
+          configured for the first time, for this
+          reason it cannot run as a test case of another server
+          test.
+
+.. note:: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+"""
+__author__ = 'QGIS contributors'
+__date__ = '18/10/2026'
+__copyright__ = 'Copyright 2026, The QGIS Project'
+
+import glob
+import os
+import shutil
+import tempfile
+
+# Needed on Qt 5 so that the serialization of XML is consistent among all executions
+os.environ['QT_HASH_SEED'] = '1'
+
+import urllib.parse
+
+from qgis.core import QgsProject
+from qgis.testing import unittest
+from qgis.PyQt.QtGui import QImage
+
+from test_qgsserver import QgsServerTestBase
+
+
+class TestQgsServerWMTSCache(QgsServerTestBase):
+    """QGIS Server built-in WMTS tile cache tests"""
+
+    # Set to True to re-generate reference files for this class
+    regenerate_reference = False
+
+    def setUp(self):
+        self.cache_dir = tempfile.mkdtemp()
+        os.environ['QGIS_SERVER_WMTS_CACHE_DIRECTORY'] = self.cache_dir
+        os.environ['QGIS_SERVER_WMTS_METATILE_SIZE'] = '2'
+        super().setUp()
+
+    def tearDown(self):
+        del os.environ['QGIS_SERVER_WMTS_CACHE_DIRECTORY']
+        del os.environ['QGIS_SERVER_WMTS_METATILE_SIZE']
+        shutil.rmtree(self.cache_dir, True)
+        super().tearDown()
+
+    def _tile_query(self, tile_matrix, row, col, style=""):
+        return "?" + "&".join(["%s=%s" % i for i in list({
+            "MAP": urllib.parse.quote(self.projectGroupsPath),
+            "SERVICE": "WMTS",
+            "VERSION": "1.0.0",
+            "REQUEST": "GetTile",
+            "LAYER": "QGIS Server Hello World",
+            "STYLE": style,
+            "TILEMATRIXSET": "EPSG:3857",
+            "TILEMATRIX": str(tile_matrix),
+            "TILEROW": str(row),
+            "TILECOL": str(col),
+            "FORMAT": "image/png"
+        }.items())])
+
+    def test_wmts_gettile_cache(self):
+        # tile matrix 0 has a single tile, the metatile is clipped to it
+        r, h = self._result(self._execute_request(self._tile_query(0, 0, 0)))
+        self._img_diff_error(r, h, "WMTS_GetTile_Project_3857_0", 20000)
+
+        cached = glob.glob(os.path.join(self.cache_dir, '*', '*', 'default', 'EPSG%3A3857', '0', '0', '0.png'))
+        self.assertEqual(len(cached), 1)
+
+        # the cached tile is served as is
+        with open(cached[0], 'rb') as f:
+            self.assertEqual(f.read(), r)
+        r2, h2 = self._result(self._execute_request(self._tile_query(0, 0, 0)))
+        self.assertEqual(r2, r)
+        self.assertEqual(h2['Content-Type'], 'image/png')
+
+    def test_wmts_gettile_metatile(self):
+        # requesting a single tile stores the whole 2x2 metatile
+        r, h = self._result(self._execute_request(self._tile_query(1, 1, 0)))
+        self.assertEqual(h['Content-Type'], 'image/png')
+
+        self.assertEqual(self._cached_tiles('default', 1), [['0', '0.png'], ['0', '1.png'], ['1', '0.png'], ['1', '1.png']])
+
+        for row in range(2):
+            for col in range(2):
+                r, h = self._result(self._execute_request(self._tile_query(1, row, col)))
+                image = QImage.fromData(r, 'PNG')
+                self.assertEqual(image.width(), 256)
+                self.assertEqual(image.height(), 256)
+
+    def _cached_tiles(self, style, tile_matrix):
+        return sorted(os.path.relpath(p, self.cache_dir).split(os.sep)[-2:]
+                      for p in glob.glob(os.path.join(self.cache_dir, '*', '*', style, 'EPSG%3A3857', str(tile_matrix), '*', '*.png')))
+
+    def test_wmts_gettile_style(self):
+        # the default style is cached along with the requests without style
+        r, h = self._result(self._execute_request(self._tile_query(0, 0, 0, 'default')))
+        self.assertEqual(h['Content-Type'], 'image/png')
+        self.assertEqual(self._cached_tiles('default', 0), [['0', '0.png']])
+
+        r2, h2 = self._result(self._execute_request(self._tile_query(0, 0, 0)))
+        self.assertEqual(r2, r)
+
+        # an unknown style is passed to WMS, whose exception is returned as is and never cached
+        r, h = self._result(self._execute_request(self._tile_query(0, 0, 0, 'unknown')))
+        self.assertNotEqual(h['Content-Type'], 'image/png')
+        self.assertIn(b'code="StyleNotDefined"', r)
+        self._assert_status_code(400, self._tile_query(0, 0, 0, 'unknown'))
+        self.assertEqual(self._cached_tiles('unknown', 0), [])
+
+    def test_wmts_gettile_metatile_max_size(self):
+        # the metatile is reduced to a single column to fit the project WMS max width
+        project = QgsProject()
+        self.assertTrue(project.read(self.projectGroupsPath))
+        project.writeEntry('WMSMaxWidth', '/', 256)
+
+        r, h = self._result(self._execute_request_project(self._tile_query(1, 1, 0), project))
+        self.assertEqual(h['Content-Type'], 'image/png')
+        self.assertEqual(self._cached_tiles('default', 1), [['0', '0.png'], ['1', '0.png']])
+
+        image = QImage.fromData(r, 'PNG')
+        self.assertEqual(image.width(), 256)
+        self.assertEqual(image.height(), 256)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,185 @@
+/***************************************************************************
+     test_qgsserver_wms_png.cpp
+     --------------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS contributors
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include "qgspalettequantizer.h"
+#include "qgswmspngwriter.h"
+
+#include <QBuffer>
+
+/**
+ * \ingroup UnitTests
+ * This is a unit test for the WMS palette quantizer and PNG encoder
+ */
+class TestQgsServerWmsPng : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void quantizeExactColors();
+    void quantizeGradient();
+    void parseFilter();
+    void writePng_data();
+    void writePng();
+    void writeIndexedPng();
+    void writePngFailure();
+
+  private:
+    QImage gradient() const;
+};
+
+void TestQgsServerWmsPng::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsServerWmsPng::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+QImage TestQgsServerWmsPng::gradient() const
+{
+  QImage image( 97, 61, QImage::Format_ARGB32 );
+  for ( int y = 0; y < image.height(); ++y )
+  {
+    for ( int x = 0; x < image.width(); ++x )
+      image.setPixel( x, y, qRgba( x * 2, y * 4, ( x * y ) & 255, ( x + y ) * 2 % 256 ) );
+  }
+  image.setDotsPerMeterX( 3780 );
+  image.setDotsPerMeterY( 3780 );
+  return image;
+}
+
+void TestQgsServerWmsPng::quantizeExactColors()
+{
+  QImage image( 40, 30, QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::transparent );
+  for ( int x = 0; x < 20; ++x )
+  {
+    image.setPixel( x, 3, qRgba( 255, 0, 0, 255 ) );
+    image.setPixel( x, 7, qRgba( 0, 0, 255, 255 ) );
+  }
+
+  // few colors are kept as is
+  const QImage result = QgsWms::quantizeImage( image, 256 );
+  QCOMPARE( result.format(), QImage::Format_Indexed8 );
+  QCOMPARE( result.colorCount(), 3 );
+  const QImage expected = image.convertToFormat( QImage::Format_ARGB32 );
+  for ( int y = 0; y < image.height(); ++y )
+  {
+    for ( int x = 0; x < image.width(); ++x )
+      QCOMPARE( result.pixel( x, y ), expected.pixel( x, y ) );
+  }
+}
+
+void TestQgsServerWmsPng::quantizeGradient()
+{
+  const QImage image = gradient();
+  for ( bool dither : { false, true } )
+  {
+    const QImage result = QgsWms::quantizeImage( image, 256, dither );
+    QCOMPARE( result.format(), QImage::Format_Indexed8 );
+    QVERIFY( result.colorCount() <= 256 );
+
+    double error = 0;
+    for ( int y = 0; y < image.height(); ++y )
+    {
+      for ( int x = 0; x < image.width(); ++x )
+      {
+        const QRgb a = image.pixel( x, y );
+        const QRgb b = result.pixel( x, y );
+        error += std::abs( qRed( a ) - qRed( b ) ) + std::abs( qGreen( a ) - qGreen( b ) )
+                 + std::abs( qBlue( a ) - qBlue( b ) ) + std::abs( qAlpha( a ) - qAlpha( b ) );
+      }
+    }
+    QVERIFY( error / ( image.width() * image.height() ) < 20 );
+  }
+}
+
+void TestQgsServerWmsPng::parseFilter()
+{
+  QCOMPARE( QgsWms::parsePngFilter( QString() ), QgsWms::PngFilter::Automatic );
+  QCOMPARE( QgsWms::parsePngFilter( QStringLiteral( "unknown" ) ), QgsWms::PngFilter::Automatic );
+  QCOMPARE( QgsWms::parsePngFilter( QStringLiteral( "none" ) ), QgsWms::PngFilter::None );
+  QCOMPARE( QgsWms::parsePngFilter( QStringLiteral( "Paeth" ) ), QgsWms::PngFilter::Paeth );
+  QCOMPARE( QgsWms::parsePngFilter( QStringLiteral( " ADAPTIVE " ) ), QgsWms::PngFilter::Adaptive );
+}
+
+void TestQgsServerWmsPng::writePng_data()
+{
+  QTest::addColumn<int>( "filter" );
+  QTest::addColumn<int>( "level" );
+  QTest::addColumn<bool>( "alpha" );
+
+  QTest::newRow( "automatic" ) << static_cast< int >( QgsWms::PngFilter::Automatic ) << -1 << true;
+  QTest::newRow( "none" ) << static_cast< int >( QgsWms::PngFilter::None ) << 0 << true;
+  QTest::newRow( "sub" ) << static_cast< int >( QgsWms::PngFilter::Sub ) << 1 << true;
+  QTest::newRow( "up" ) << static_cast< int >( QgsWms::PngFilter::Up ) << 6 << true;
+  QTest::newRow( "average" ) << static_cast< int >( QgsWms::PngFilter::Average ) << 9 << true;
+  QTest::newRow( "paeth" ) << static_cast< int >( QgsWms::PngFilter::Paeth ) << 3 << true;
+  QTest::newRow( "adaptive rgb" ) << static_cast< int >( QgsWms::PngFilter::Adaptive ) << -1 << false;
+}
+
+void TestQgsServerWmsPng::writePng()
+{
+  QFETCH( int, filter );
+  QFETCH( int, level );
+  QFETCH( bool, alpha );
+
+  QImage image = gradient();
+  if ( !alpha )
+    image = image.convertToFormat( QImage::Format_RGB32 );
+
+  QBuffer buffer;
+  buffer.open( QIODevice::WriteOnly );
+  QVERIFY( QgsWms::writePng( &buffer, image, level, static_cast< QgsWms::PngFilter >( filter ) ) );
+
+  const QImage decoded = QImage::fromData( buffer.data(), "PNG" );
+  QCOMPARE( decoded.size(), image.size() );
+  QCOMPARE( decoded.hasAlphaChannel(), alpha );
+  QCOMPARE( decoded.dotsPerMeterX(), image.dotsPerMeterX() );
+  QCOMPARE( decoded.convertToFormat( QImage::Format_ARGB32 ), image.convertToFormat( QImage::Format_ARGB32 ) );
+}
+
+void TestQgsServerWmsPng::writeIndexedPng()
+{
+  const QImage indexed = QgsWms::quantizeImage( gradient(), 256 );
+
+  QBuffer buffer;
+  buffer.open( QIODevice::WriteOnly );
+  QVERIFY( QgsWms::writePng( &buffer, indexed ) );
+
+  const QImage decoded = QImage::fromData( buffer.data(), "PNG" );
+  QCOMPARE( decoded.format(), QImage::Format_Indexed8 );
+  QCOMPARE( decoded.convertToFormat( QImage::Format_ARGB32 ), indexed.convertToFormat( QImage::Format_ARGB32 ) );
+}
+
+void TestQgsServerWmsPng::writePngFailure()
+{
+  QBuffer buffer;
+  QVERIFY( !QgsWms::writePng( &buffer, QImage() ) );
+
+  // a device which cannot be written
+  buffer.open( QIODevice::ReadOnly );
+  QVERIFY( !QgsWms::writePng( &buffer, gradient() ) );
+  QVERIFY( !QgsWms::writePng( nullptr, gradient() ) );
+}
+
+QGSTEST_MAIN( TestQgsServerWmsPng )
+#include "test_qgsserver_wms_png.moc"